@@ -0,0 +1,183 @@
+//--------------------------------------------------------------------------------------
+// Asset loader - loads meshes and textures in the background while the scene runs
+//--------------------------------------------------------------------------------------
+
+#include "AssetLoader.h"
+#include "GraphicsHelpers.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+//--------------------------------------------------------------------------------------
+// Placeholders
+//--------------------------------------------------------------------------------------
+
+// Width of the placeholder cube
+const float PLACEHOLDER_SIZE = 4.0f;
+
+// Placeholder texture colour. Works as a normal map too - RGB is a flat normal pointing straight out of the surface -
+// and the alpha gives medium specular or height. As a diffuse map it is a pale blue that stands out while loading
+const uint8_t PLACEHOLDER_COLOUR[4] = { 128, 128, 255, 128 };
+
+
+// Cube with a separate normal and full UV range on each face, for the placeholder meshes
+static MeshGeometry PlaceholderCube()
+{
+    const uint32_t faceIndices[6] = { 0, 2, 1, 1, 2, 3 };
+
+    MeshGeometry cube;
+    float halfSize = PLACEHOLDER_SIZE * 0.5f;
+    const CVector3 faceNormals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 }, { 0, 0, -1 } };
+    for (auto& normal : faceNormals)
+    {
+        // Right and up across the face as seen from outside, with clockwise triangles to face outwards
+        CVector3 up = (normal.y == 0) ? CVector3{ 0, 1, 0 } : CVector3{ 0, 0, 1 };
+        CVector3 right = Cross(up, normal);
+        uint32_t start = static_cast<uint32_t>(cube.positions.size());
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            float u = static_cast<float>(corner & 1);
+            float v = static_cast<float>(corner >> 1);
+            cube.positions.push_back((normal + right * (u * 2 - 1) - up * (v * 2 - 1)) * halfSize);
+            cube.normals.push_back(normal);
+            cube.uvs.push_back({ u, v });
+        }
+        for (uint32_t index : faceIndices)  cube.indices.push_back(start + index);
+    }
+    return cube;
+}
+
+
+// Meshes are loaded into the given library. Creates the placeholders so Direct3D must be set up already. Uses the
+// task pool's default number of threads if 0. Will throw a std::runtime_error exception on failure
+AssetLoader::AssetLoader(MeshLibrary& meshLibrary, unsigned int numThreads /*= 0*/)
+    : mMeshLibrary(meshLibrary), mTaskPool(numThreads)
+{
+    MeshGeometry cube = PlaceholderCube();
+    mPlaceholderMesh         = std::make_unique<Mesh>(cube, false, "placeholder mesh");
+    mPlaceholderMeshTangents = std::make_unique<Mesh>(cube, true,  "placeholder mesh");
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width            = 1;
+    desc.Height           = 1;
+    desc.MipLevels        = 1;
+    desc.ArraySize        = 1;
+    desc.Format           = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage            = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags        = D3D11_BIND_SHADER_RESOURCE;
+    D3D11_SUBRESOURCE_DATA initData = { PLACEHOLDER_COLOUR, 4, 0 };
+
+    ID3D11Texture2D* texture = nullptr;
+    if (FAILED(gD3DDevice->CreateTexture2D(&desc, &initData, &texture)))  throw std::runtime_error("Error creating placeholder texture");
+    mPlaceholderTexture = texture;
+    if (FAILED(gD3DDevice->CreateShaderResourceView(texture, nullptr, &mPlaceholderTextureSRV)))
+    {
+        mPlaceholderTexture->Release();
+        throw std::runtime_error("Error creating placeholder texture");
+    }
+}
+
+
+// Background work not yet finished is abandoned. The meshes loaded render the placeholders until created, so
+// release them all before the loader is destroyed
+AssetLoader::~AssetLoader()
+{
+    for (auto& entry : mTextures)
+    {
+        if (entry.second.textureSRV)  entry.second.textureSRV->Release();
+        if (entry.second.texture)     entry.second.texture->Release();
+    }
+    if (mPlaceholderTextureSRV)  mPlaceholderTextureSRV->Release();
+    if (mPlaceholderTexture)     mPlaceholderTexture->Release();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Loading
+//--------------------------------------------------------------------------------------
+
+// Return the mesh for the given file and settings from the library (see MeshLibrary::GetAsync), which renders a
+// placeholder cube until it has loaded
+MeshLibrary::Handle AssetLoader::LoadMesh(const std::string& fileName, bool requireTangents /*= false*/, unsigned int importFlags /*= 0*/)
+{
+    Mesh* placeholder = requireTangents ? mPlaceholderMeshTangents.get() : mPlaceholderMesh.get();
+    MeshLibrary::Handle mesh = mMeshLibrary.GetAsync(mTaskPool, placeholder, fileName, requireTangents, importFlags);
+
+    // Count each different mesh once in the progress
+    if (std::none_of(mMeshes.begin(), mMeshes.end(), [&](const std::weak_ptr<Mesh>& loading) { return loading.lock() == mesh; }))
+    {
+        mMeshes.push_back(mesh);
+    }
+    return mesh;
+}
+
+
+// As the LoadTexture helper function (see GraphicsHelpers.h), but the pointers are first set to a placeholder
+// texture and are changed to the texture once it has loaded, so they must stay valid until then (e.g. globals).
+// Each pointer holds its own reference to whichever texture it points at, release them as usual
+void AssetLoader::LoadTexture(const std::string& fileName, ID3D11Resource** texture, ID3D11ShaderResourceView** textureSRV)
+{
+    bool newTexture = (mTextures.count(fileName) == 0);
+    TextureEntry& entry = mTextures[fileName];
+    if (entry.texture != nullptr)
+    {
+        // Already loaded
+        *texture    = entry.texture;     entry.texture->AddRef();
+        *textureSRV = entry.textureSRV;  entry.textureSRV->AddRef();
+        return;
+    }
+
+    *texture    = mPlaceholderTexture;     mPlaceholderTexture->AddRef();
+    *textureSRV = mPlaceholderTextureSRV;  mPlaceholderTextureSRV->AddRef();
+    entry.users.push_back({ texture, textureSRV });
+    if (!newTexture)  return; // Already being loaded
+
+    // Read and decode in the background, create the texture on the render thread and replace the placeholder
+    mTaskPool.Submit([this, fileName]() -> TaskPool::Completion
+    {
+        auto textureData = std::make_shared<TextureData>();
+        if (!ReadTexture(fileName, *textureData))  throw std::runtime_error("Error loading texture " + fileName);
+
+        return [this, fileName, textureData]()
+        {
+            TextureEntry& entry = mTextures[fileName];
+            if (!CreateTexture(*textureData, &entry.texture, &entry.textureSRV))  throw std::runtime_error("Error creating texture " + fileName);
+
+            for (auto& user : entry.users)
+            {
+                (*user.first)->Release();
+                (*user.second)->Release();
+                *user.first  = entry.texture;     entry.texture->AddRef();
+                *user.second = entry.textureSRV;  entry.textureSRV->AddRef();
+            }
+            entry.users.clear();
+        };
+    });
+}
+
+
+// Create the GPU resources for assets whose background work has finished, replacing their placeholders. Call
+// once per frame. Stops after maxSeconds to keep the frame rate up while loading. Will throw a std::runtime_error
+// exception if an asset failed to load
+void AssetLoader::Update(float maxSeconds /*= 0.004f*/)
+{
+    mTaskPool.RunCompletions(maxSeconds);
+}
+
+
+unsigned int AssetLoader::NumLoaded() const
+{
+    unsigned int numLoaded = 0;
+    for (auto& weakMesh : mMeshes)
+    {
+        auto mesh = weakMesh.lock();
+        if (!mesh || mesh->IsReady())  ++numLoaded; // Released meshes are no longer waited for
+    }
+    for (auto& entry : mTextures)
+    {
+        if (entry.second.texture != nullptr)  ++numLoaded;
+    }
+    return numLoaded;
+}
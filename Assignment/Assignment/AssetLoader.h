@@ -0,0 +1,85 @@
+//--------------------------------------------------------------------------------------
+// Asset loader - loads meshes and textures in the background while the scene runs
+//--------------------------------------------------------------------------------------
+// Loading every mesh and texture one after another before the first frame leaves a blank window for a long time.
+// Instead the loader hands back each asset straight away as a placeholder - a small cube for meshes, a flat 1x1
+// texture for textures - and does the slow work on a pool of background threads: reading files, importing and
+// laying out meshes, decoding images. The render thread only creates the GPU resources, a little each frame in
+// Update, and each placeholder is replaced as its asset becomes ready.
+//
+// Textures requested more than once share one GPU texture. Call all methods from the render thread only.
+
+#include "MeshLibrary.h"
+#include "TaskPool.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifndef _ASSET_LOADER_H_INCLUDED_
+#define _ASSET_LOADER_H_INCLUDED_
+
+class AssetLoader
+{
+public:
+    // Meshes are loaded into the given library. Creates the placeholders so Direct3D must be set up already. Uses the
+    // task pool's default number of threads if 0. Will throw a std::runtime_error exception on failure
+    explicit AssetLoader(MeshLibrary& meshLibrary, unsigned int numThreads = 0);
+
+    // Background work not yet finished is abandoned. The meshes loaded render the placeholders until created, so
+    // release them all before the loader is destroyed
+    ~AssetLoader();
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+
+    // Return the mesh for the given file and settings from the library (see MeshLibrary::GetAsync), which renders a
+    // placeholder cube until it has loaded
+    MeshLibrary::Handle LoadMesh(const std::string& fileName, bool requireTangents = false, unsigned int importFlags = 0);
+
+    // As the LoadTexture helper function (see GraphicsHelpers.h), but the pointers are first set to a placeholder
+    // texture and are changed to the texture once it has loaded, so they must stay valid until then (e.g. globals).
+    // Each pointer holds its own reference to whichever texture it points at, release them as usual
+    void LoadTexture(const std::string& fileName, ID3D11Resource** texture, ID3D11ShaderResourceView** textureSRV);
+
+
+    // Create the GPU resources for assets whose background work has finished, replacing their placeholders. Call
+    // once per frame. Stops after maxSeconds to keep the frame rate up while loading. Will throw a std::runtime_error
+    // exception if an asset failed to load
+    void Update(float maxSeconds = 0.004f);
+
+    // Loading progress
+    bool         IsLoading() const { return mTaskPool.NumPending() > 0; }
+    unsigned int NumAssets() const { return static_cast<unsigned int>(mMeshes.size() + mTextures.size()); } // Different assets requested
+    unsigned int NumLoaded() const;
+
+
+private:
+    // A texture and the pointers still set to the placeholder until it is loaded
+    struct TextureEntry
+    {
+        ID3D11Resource*           texture    = nullptr; // Null until loaded
+        ID3D11ShaderResourceView* textureSRV = nullptr;
+        std::vector<std::pair<ID3D11Resource**, ID3D11ShaderResourceView**>> users;
+    };
+
+    MeshLibrary& mMeshLibrary;
+
+    // Placeholder meshes must have the same vertex layout as the meshes they stand in for
+    std::unique_ptr<Mesh>     mPlaceholderMesh;
+    std::unique_ptr<Mesh>     mPlaceholderMeshTangents;
+    ID3D11Resource*           mPlaceholderTexture    = nullptr;
+    ID3D11ShaderResourceView* mPlaceholderTextureSRV = nullptr;
+
+    std::vector<std::weak_ptr<Mesh>>    mMeshes;
+    std::map<std::string, TextureEntry> mTextures;
+
+    // Declared last so it is destroyed first, its worker threads finish before anything they use is freed
+    TaskPool mTaskPool;
+};
+
+
+#endif //_ASSET_LOADER_H_INCLUDED_
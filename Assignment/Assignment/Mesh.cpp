@@ -10,23 +10,36 @@
 
 #define NOMINMAX
 #include "Mesh.h"
-#include "Shader.h" // Needed for helper function CreateSignatureForVertexLayout
-#include "CVector2.h" 
-#include "CVector3.h" 
+#include "Shader.h" // Needed for helper function GetSignatureForVertexLayout
+#include "GraphicsHelpers.h"
+#include "MeshData.h" // For MAX_16BIT_INDEX_VERTICES
+#include "MeshTangents.h"
+#include "VertexLayout.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/DefaultLogger.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 
 
 // Pass the name of the mesh file to load. Uses assimp (http://www.assimp.org/) to support many file types
 // Optionally request tangents to be calculated (for normal and parallax mapping - see later lab)
+// Import flags are extra assimp post-processing flags (aiProcess_...) to use on top of the standard ones
 // Will throw a std::runtime_error exception on failure (since constructors can't return errors).
-Mesh::Mesh(const std::string& fileName, bool requireTangents /*= false*/)
+Mesh::Mesh(const std::string& fileName, bool requireTangents /*= false*/, unsigned int importFlags /*= 0*/)
+    : Mesh(ImportGeometry(fileName, importFlags), requireTangents, fileName)
+{
+}
+
+
+// Import the geometry of a mesh file without creating any GPU resources. Import flags are as for the constructor
+// Assimp's log is global so it is not thread-safe, pass false for verboseLog when importing on other threads
+// Will throw a std::runtime_error exception on failure
+MeshGeometry Mesh::ImportGeometry(const std::string& fileName, unsigned int importFlags /*= 0*/, bool verboseLog /*= true*/)
 {
     Assimp::Importer importer;
 
@@ -50,21 +63,15 @@ Mesh::Mesh(const std::string& fileName, bool requireTangents /*= false*/)
                                aiProcess_FindDegenerates |
                                aiProcess_RemoveRedundantMaterials |
                                aiProcess_Debone |
-                               aiProcess_RemoveComponent;
+                               aiProcess_RemoveComponent |
+                               importFlags;
 
-    // Flags to specify what mesh data to ignore
+    // Flags to specify what mesh data to ignore. Tangents are never imported, they are calculated when the
+    // Mesh is created so the same import can be used for meshes with and without tangents
     int removeComponents = aiComponent_LIGHTS | aiComponent_CAMERAS | aiComponent_TEXTURES | aiComponent_COLORS | 
-                           aiComponent_BONEWEIGHTS | aiComponent_ANIMATIONS | aiComponent_MATERIALS;
-
-    // Add / remove tangents as required by user
-    if (requireTangents)
-    {
-        assimpFlags |= aiProcess_CalcTangentSpace;
-    }
-    else
-    {
-        removeComponents |= aiComponent_TANGENTS_AND_BITANGENTS;
-    }
+                           aiComponent_BONEWEIGHTS | aiComponent_ANIMATIONS | aiComponent_MATERIALS |
+                           aiComponent_TANGENTS_AND_BITANGENTS;
+    assimpFlags &= ~aiProcess_CalcTangentSpace;
 
     // Other miscellaneous settings
     importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f); // Smoothing angle for normals
@@ -75,9 +82,9 @@ Mesh::Mesh(const std::string& fileName, bool requireTangents /*= false*/)
     importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, removeComponents);
 
     // Import mesh with assimp given above requirements - log output
-    Assimp::DefaultLogger::create("", Assimp::DefaultLogger::VERBOSE);
+    if (verboseLog)  Assimp::DefaultLogger::create("", Assimp::DefaultLogger::VERBOSE);
     const aiScene* scene = importer.ReadFile(fileName, assimpFlags);
-    Assimp::DefaultLogger::kill();
+    if (verboseLog)  Assimp::DefaultLogger::kill();
     if (scene == nullptr)  throw std::runtime_error("Error loading mesh (" + fileName + "). " + importer.GetErrorString());
     if (scene->mNumMeshes == 0)  throw std::runtime_error("No usable geometry in mesh: " + fileName);
 
@@ -88,125 +95,163 @@ Mesh::Mesh(const std::string& fileName, bool requireTangents /*= false*/)
     aiMesh* assimpMesh = scene->mMeshes[0];
     std::string subMeshName = assimpMesh->mName.C_Str();
 
-    
+    // Check for presence of position and normal data. UVs are optional.
+    if (!assimpMesh->HasPositions())  throw std::runtime_error("No position data for sub-mesh " + subMeshName + " in " + fileName);
+    if (!assimpMesh->HasNormals())  throw std::runtime_error("No normal data for sub-mesh " + subMeshName + " in " + fileName);
+    bool hasUVs = (assimpMesh->GetNumUVChannels() > 0 && assimpMesh->HasTextureCoords(0));
+    if (hasUVs && assimpMesh->mNumUVComponents[0] != 2)  throw std::runtime_error("Unsupported texture coordinates in " + subMeshName + " in " + fileName);
+    if (!assimpMesh->HasFaces())  throw std::runtime_error("No face data in " + subMeshName + " in " + fileName);
+
+
     //-----------------------------------
 
-    // Check for presence of position and normal data. Tangents and UVs are optional.
-    std::vector<D3D11_INPUT_ELEMENT_DESC> vertexElements;
-    unsigned int offset = 0;
-    
-    if (!assimpMesh->HasPositions())  throw std::runtime_error("No position data for sub-mesh " + subMeshName + " in " + fileName);
-    unsigned int positionOffset = offset;
-    vertexElements.push_back( { "Position", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, positionOffset, D3D11_INPUT_PER_VERTEX_DATA, 0 } );
-    offset += 12;
+    // Copy mesh data from assimp
+    MeshGeometry geometry;
+    unsigned int numVertices = assimpMesh->mNumVertices;
 
-    if (!assimpMesh->HasNormals())  throw std::runtime_error("No normal data for sub-mesh " + subMeshName + " in " + fileName);
-    unsigned int normalOffset = offset;
-    vertexElements.push_back( { "Normal", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, normalOffset, D3D11_INPUT_PER_VERTEX_DATA, 0 } );
-    offset += 12;
+    const CVector3* assimpPosition = reinterpret_cast<const CVector3*>(assimpMesh->mVertices);
+    geometry.positions.assign(assimpPosition, assimpPosition + numVertices);
 
-    unsigned int tangentOffset = offset;
-    if (requireTangents)
+    const CVector3* assimpNormal = reinterpret_cast<const CVector3*>(assimpMesh->mNormals);
+    geometry.normals.assign(assimpNormal, assimpNormal + numVertices);
+
+    if (hasUVs)
     {
-        if (!assimpMesh->HasTangentsAndBitangents())  throw std::runtime_error("No tangent data for sub-mesh " + subMeshName + " in " + fileName);
-        vertexElements.push_back( { "Tangent", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, tangentOffset, D3D11_INPUT_PER_VERTEX_DATA, 0 } );
-        offset += 12;
+        geometry.uvs.reserve(numVertices);
+        const aiVector3D* assimpUV = assimpMesh->mTextureCoords[0];
+        for (unsigned int vertex = 0; vertex < numVertices; ++vertex, ++assimpUV)
+        {
+            geometry.uvs.push_back(CVector2(assimpUV->x, assimpUV->y));
+        }
     }
-    
-    unsigned int uvOffset = offset;
-    if (assimpMesh->GetNumUVChannels() > 0 && assimpMesh->HasTextureCoords(0))
+
+    // Copy face data from assimp
+    geometry.indices.reserve(assimpMesh->mNumFaces * 3);
+    for (unsigned int face = 0; face < assimpMesh->mNumFaces; ++face)
     {
-        if (assimpMesh->mNumUVComponents[0] != 2)  throw std::runtime_error("Unsupported texture coordinates in " + subMeshName + " in " + fileName);
-        vertexElements.push_back( { "UV", 0, DXGI_FORMAT_R32G32_FLOAT, 0, uvOffset, D3D11_INPUT_PER_VERTEX_DATA, 0 } );
-        offset += 8;
+        geometry.indices.push_back(assimpMesh->mFaces[face].mIndices[0]);
+        geometry.indices.push_back(assimpMesh->mFaces[face].mIndices[1]);
+        geometry.indices.push_back(assimpMesh->mFaces[face].mIndices[2]);
     }
 
-    mVertexSize = offset;
+    return geometry;
+}
 
 
-    // Create a "vertex layout" to describe to DirectX what is data in each vertex of this mesh
-    auto shaderSignature = CreateSignatureForVertexLayout(vertexElements.data(), static_cast<int>(vertexElements.size()));
-    HRESULT hr = gD3DDevice->CreateInputLayout(vertexElements.data(), static_cast<UINT>(vertexElements.size()),
-                                               shaderSignature->GetBufferPointer(), shaderSignature->GetBufferSize(),
-                                               &mVertexLayout);
-    if (shaderSignature)  shaderSignature->Release();
-    if (FAILED(hr))  throw std::runtime_error("Failure creating input layout for " + fileName);
+// Create a mesh from geometry that has already been imported (see ImportGeometry). Tangents are calculated
+// here if required. The name is only used in error messages. Will throw a std::runtime_error exception on failure
+Mesh::Mesh(const MeshGeometry& geometry, bool requireTangents, const std::string& name)
+    : Mesh(PrepareBuffers(geometry, requireTangents, name), name)
+{
+}
 
 
+// Create a mesh from prepared buffer data (see PrepareBuffers). Will throw a std::runtime_error exception on failure
+Mesh::Mesh(const MeshBufferData& buffers, const std::string& name)
+{
+    Create(buffers, name);
+}
 
-    //-----------------------------------
 
-    // Create CPU-side buffers to hold current mesh data - exact content is flexible so can't use a structure for a vertex - so just a block of bytes
-    // Note: for large arrays a unique_ptr is better than a vector because vectors default-initialise all the values which is a waste of time.
-    mNumVertices = assimpMesh->mNumVertices;
-    mNumIndices  = assimpMesh->mNumFaces * 3;
-    auto vertices = std::make_unique<unsigned char[]>(mNumVertices * mVertexSize);
-    auto indices  = std::make_unique<unsigned char[]>(mNumIndices * 4); // Using 32 bit indexes (4 bytes) for each indeex
+// Create a mesh with no GPU resources yet, for a mesh loaded in the background. The placeholder mesh is
+// rendered in its place until Create is called. The placeholder must outlive this mesh
+Mesh::Mesh(Mesh* placeholder)
+    : mPlaceholder(placeholder)
+{
+}
 
 
-    //-----------------------------------
+// The vertex layouts a mesh can have
+using BasicVertexLayout    = VertexLayout<VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>,
+                                          VertexAttribute<VertexSemantic::Normal,   VertexFormat::Float3, CVector3>>;
+using TexturedVertexLayout = VertexLayout<VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>,
+                                          VertexAttribute<VertexSemantic::Normal,   VertexFormat::Float3, CVector3>,
+                                          VertexAttribute<VertexSemantic::UV,       VertexFormat::Float2, CVector2>>;
+using TangentVertexLayout  = VertexLayout<VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>,
+                                          VertexAttribute<VertexSemantic::Normal,   VertexFormat::Float3, CVector3>,
+                                          VertexAttribute<VertexSemantic::Tangent,  VertexFormat::Float3, CVector3>,
+                                          VertexAttribute<VertexSemantic::UV,       VertexFormat::Float2, CVector2>>;
+
+// Set the vertex layout of the buffers and interleave the separate geometry arrays, one for each attribute in the
+// layout, into its vertices. The number of vertices must already be set
+template <class Layout, class... Attributes>
+static void InterleaveVertices(MeshBufferData& buffers, const Attributes*... attributes)
+{
+    constexpr auto vertexElements = InputElementDescs<Layout>();
+    buffers.vertexElements.assign(vertexElements.begin(), vertexElements.end());
+    buffers.layoutKey  = Layout::Key;
+    buffers.vertexSize = Layout::Stride;
 
-    // Copy mesh data from assimp to our CPU-side vertex buffer
+    // Note: for large arrays a unique_ptr is better than a vector because vectors default-initialise all the values which is a waste of time.
+    buffers.vertices = std::make_unique<unsigned char[]>(buffers.numVertices * buffers.vertexSize);
+    Layout::Interleave(reinterpret_cast<typename Layout::Vertex*>(buffers.vertices.get()), buffers.numVertices, attributes...);
+}
 
-    CVector3* assimpPosition = reinterpret_cast<CVector3*>(assimpMesh->mVertices);
-    unsigned char* position = vertices.get() + positionOffset;
-    unsigned char* positionEnd = position + mNumVertices * mVertexSize;
-    while (position != positionEnd)
-    {
-        *(CVector3*)position = *assimpPosition;
-        position += mVertexSize;
-        ++assimpPosition;
-    }
 
-    CVector3* assimpNormal = reinterpret_cast<CVector3*>(assimpMesh->mNormals);
-    unsigned char* normal = vertices.get() + normalOffset;
-    unsigned char* normalEnd = normal + mNumVertices * mVertexSize;
-    while (normal != normalEnd)
+// Calculate tangents if required and lay out the vertex and index data of imported geometry, without using
+// Direct3D. The name is only used in error messages. Will throw a std::runtime_error exception on failure
+MeshBufferData Mesh::PrepareBuffers(const MeshGeometry& geometry, bool requireTangents, const std::string& name)
+{
+    bool hasUVs = !geometry.uvs.empty();
+
+    // Calculate tangents from the normals and texture coordinates if they are needed
+    std::vector<CVector3> tangents;
+    if (requireTangents)
     {
-        *(CVector3*)normal = *assimpNormal;
-        normal += mVertexSize;
-        ++assimpNormal;
+        if (!hasUVs)  throw std::runtime_error("No texture coordinates to calculate tangents for " + name);
+        tangents.resize(geometry.positions.size());
+        CalculateTangents(geometry.positions.data(), geometry.normals.data(), geometry.uvs.data(), static_cast<uint32_t>(geometry.positions.size()),
+                          geometry.indices.data(), static_cast<uint32_t>(geometry.indices.size()), tangents.data());
     }
 
+
+    //-----------------------------------
+
+    // Position and normal are always present. Tangents and UVs are optional.
+    MeshBufferData buffers;
+    buffers.numVertices = static_cast<unsigned int>(geometry.positions.size());
+    buffers.numIndices  = static_cast<unsigned int>(geometry.indices.size());
     if (requireTangents)
+        InterleaveVertices<TangentVertexLayout>(buffers, geometry.positions.data(), geometry.normals.data(), tangents.data(), geometry.uvs.data());
+    else if (hasUVs)
+        InterleaveVertices<TexturedVertexLayout>(buffers, geometry.positions.data(), geometry.normals.data(), geometry.uvs.data());
+    else
+        InterleaveVertices<BasicVertexLayout>(buffers, geometry.positions.data(), geometry.normals.data());
+
+
+    // Meshes with no more than MAX_16BIT_INDEX_VERTICES vertices use 16-bit indices (2 bytes each), halving the
+    // index memory and bandwidth. Otherwise 32-bit indices (4 bytes each)
+    if (buffers.numVertices <= MAX_16BIT_INDEX_VERTICES)
     {
-      CVector3* assimpTangent = reinterpret_cast<CVector3*>(assimpMesh->mTangents);
-      unsigned char* tangent =  vertices.get() + tangentOffset;
-      unsigned char* tangentEnd = tangent + mNumVertices * mVertexSize;
-      while (tangent != tangentEnd)
-      {
-        *(CVector3*)tangent = *assimpTangent;
-        tangent += mVertexSize;
-        ++assimpTangent;
-      }
+        buffers.indexFormat = DXGI_FORMAT_R16_UINT;
+        buffers.indices = std::make_unique<unsigned char[]>(buffers.numIndices * sizeof(uint16_t));
+        std::copy(geometry.indices.begin(), geometry.indices.end(), reinterpret_cast<uint16_t*>(buffers.indices.get()));
     }
-
-    if (assimpMesh->GetNumUVChannels() > 0 && assimpMesh->HasTextureCoords(0))
+    else
     {
-        aiVector3D* assimpUV = assimpMesh->mTextureCoords[0];
-        unsigned char* uv = vertices.get() + uvOffset;
-        unsigned char* uvEnd = uv + mNumVertices * mVertexSize;
-        while (uv != uvEnd)
-        {
-            *(CVector2*)uv = CVector2(assimpUV->x, assimpUV->y);
-            uv += mVertexSize;
-            ++assimpUV;
-        }
+        buffers.indexFormat = DXGI_FORMAT_R32_UINT;
+        buffers.indices = std::make_unique<unsigned char[]>(buffers.numIndices * sizeof(uint32_t));
+        std::copy(geometry.indices.begin(), geometry.indices.end(), reinterpret_cast<uint32_t*>(buffers.indices.get()));
     }
 
+    return buffers;
+}
 
-    //-----------------------------------
 
-    // Copy face data from assimp to our CPU-side index buffer
-    if (!assimpMesh->HasFaces())  throw std::runtime_error("No face data in " + subMeshName + " in " + fileName);
+// Create the GPU resources of a mesh made with a placeholder, after which it renders itself. Call on the
+// render thread. Will throw a std::runtime_error exception on failure
+void Mesh::Create(const MeshBufferData& buffers, const std::string& name)
+{
+    ReleaseBuffers();
 
-    DWORD* index = reinterpret_cast<DWORD*>(indices.get());
-    for (unsigned int face = 0; face < assimpMesh->mNumFaces; ++face)
-    {
-        *index++ = assimpMesh->mFaces[face].mIndices[0];
-        *index++ = assimpMesh->mFaces[face].mIndices[1];
-        *index++ = assimpMesh->mFaces[face].mIndices[2];
-    }
+    // Create a "vertex layout" to describe to DirectX what is data in each vertex of this mesh. Meshes with the
+    // same layout share the shader signature it needs
+    auto shaderSignature = GetSignatureForVertexLayout(buffers.layoutKey, buffers.vertexElements.data(), static_cast<int>(buffers.vertexElements.size()));
+    if (shaderSignature == nullptr)  throw std::runtime_error("Failure creating input layout for " + name);
+    HRESULT hr = gD3DDevice->CreateInputLayout(buffers.vertexElements.data(), static_cast<UINT>(buffers.vertexElements.size()),
+                                               shaderSignature->GetBufferPointer(), shaderSignature->GetBufferSize(),
+                                               &mVertexLayout);
+    if (FAILED(hr))  throw std::runtime_error("Failure creating input layout for " + name);
 
 
     //-----------------------------------
@@ -214,36 +259,62 @@ Mesh::Mesh(const std::string& fileName, bool requireTangents /*= false*/)
     D3D11_BUFFER_DESC bufferDesc;
     D3D11_SUBRESOURCE_DATA initData;
 
-    // Create GPU-side vertex buffer and copy the vertices imported by assimp into it
+    // Create GPU-side vertex buffer and copy the vertices into it
     bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER; // Indicate it is a vertex buffer
     bufferDesc.Usage = D3D11_USAGE_DEFAULT;          // Default usage for this buffer - we'll see other usages later
-    bufferDesc.ByteWidth = mNumVertices * mVertexSize; // Size of the buffer in bytes
+    bufferDesc.ByteWidth = buffers.numVertices * buffers.vertexSize; // Size of the buffer in bytes
     bufferDesc.CPUAccessFlags = 0;
     bufferDesc.MiscFlags = 0;
-    initData.pSysMem = vertices.get(); // Fill the new vertex buffer with data loaded by assimp
+    initData.pSysMem = buffers.vertices.get(); // Fill the new vertex buffer with the interleaved vertices
     
-    hr = gD3DDevice->CreateBuffer(&bufferDesc, &initData, &mVertexBuffer);
-    if (FAILED(hr))  throw std::runtime_error("Failure creating vertex buffer for " + fileName);
+    ID3D11Buffer* vertexBuffer = nullptr;
+    hr = gD3DDevice->CreateBuffer(&bufferDesc, &initData, &vertexBuffer);
+    if (FAILED(hr))
+    {
+        ReleaseBuffers();
+        throw std::runtime_error("Failure creating vertex buffer for " + name);
+    }
 
 
-    // Create GPU-side index buffer and copy the vertices imported by assimp into it
+    // Create GPU-side index buffer and copy the indices into it
     bufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER; // Indicate it is an index buffer
     bufferDesc.Usage = D3D11_USAGE_DEFAULT;         // Default usage for this buffer - we'll see other usages later
-    bufferDesc.ByteWidth = mNumIndices * sizeof(DWORD); // Size of the buffer in bytes
+    bufferDesc.ByteWidth = buffers.numIndices * (buffers.indexFormat == DXGI_FORMAT_R16_UINT ? sizeof(uint16_t) : sizeof(uint32_t));
     bufferDesc.CPUAccessFlags = 0;
     bufferDesc.MiscFlags = 0;
-    initData.pSysMem = indices.get(); // Fill the new index buffer with data loaded by assimp
+    initData.pSysMem = buffers.indices.get();
 
     hr = gD3DDevice->CreateBuffer(&bufferDesc, &initData, &mIndexBuffer);
-    if (FAILED(hr))  throw std::runtime_error("Failure creating index buffer for " + fileName);
+    if (FAILED(hr))
+    {
+        vertexBuffer->Release();
+        ReleaseBuffers();
+        throw std::runtime_error("Failure creating index buffer for " + name);
+    }
+
+    // The vertex buffer is set last as it marks the mesh as ready
+    mVertexSize   = buffers.vertexSize;
+    mNumVertices  = buffers.numVertices;
+    mNumIndices   = buffers.numIndices;
+    mIndexFormat  = buffers.indexFormat;
+    mVertexBuffer = vertexBuffer;
 }
 
 
 Mesh::~Mesh()
+{
+    ReleaseBuffers();
+}
+
+
+void Mesh::ReleaseBuffers()
 {
     if (mIndexBuffer)   mIndexBuffer ->Release();
     if (mVertexBuffer)  mVertexBuffer->Release();
     if (mVertexLayout)  mVertexLayout->Release();
+    mIndexBuffer  = nullptr;
+    mVertexBuffer = nullptr;
+    mVertexLayout = nullptr;
 }
 
 
@@ -251,6 +322,13 @@ Mesh::~Mesh()
 // It simply draws this mesh with whatever settings the GPU is currently using.
 void Mesh::Render()
 {
+    // Draw the placeholder instead until this mesh has been created (see MeshLibrary::GetAsync)
+    if (!IsReady())
+    {
+        if (mPlaceholder)  mPlaceholder->Render();
+        return;
+    }
+
     // Set vertex buffer as next data source for GPU
     UINT stride = mVertexSize;
     UINT offset = 0;
@@ -259,8 +337,8 @@ void Mesh::Render()
     // Indicate the layout of vertex buffer
     gD3DContext->IASetInputLayout(mVertexLayout);
 
-    // Set index buffer as next data source for GPU, indicate it uses 32-bit integers
-    gD3DContext->IASetIndexBuffer(mIndexBuffer, DXGI_FORMAT_R32_UINT, 0);
+    // Set index buffer as next data source for GPU, indicate whether it uses 16 or 32-bit integers
+    gD3DContext->IASetIndexBuffer(mIndexBuffer, mIndexFormat, 0);
 
     // Using triangle lists only in this class
     gD3DContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -8,35 +8,101 @@
 // expected to select these things. A later lab will introduce a more robust loader.
 
 #include "common.h"
+#include "CVector2.h"
+#include "CVector3.h"
 
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #ifndef _MESH_H_INCLUDED_
 #define _MESH_H_INCLUDED_
 
+// CPU-side geometry of a mesh as imported from file, before it is packed into vertex and index buffers.
+// Kept separate from the Mesh so that one import can be used for several meshes (see MeshLibrary.h)
+struct MeshGeometry
+{
+    std::vector<CVector3> positions;
+    std::vector<CVector3> normals;
+    std::vector<CVector2> uvs;     // Empty if the mesh has no texture coordinates
+    std::vector<uint32_t> indices; // Triangle list
+};
+
+// CPU-side vertex and index data of a mesh, laid out ready to copy into GPU buffers. Preparing this uses no
+// Direct3D so can be done on any thread, leaving only the buffer creation for the render thread (see MeshLibrary::GetAsync)
+struct MeshBufferData
+{
+    std::vector<D3D11_INPUT_ELEMENT_DESC> vertexElements; // Vertex layout
+    uint64_t                         layoutKey   = 0;     // Identifies the layout, see VertexLayout.h
+    unsigned int                     vertexSize  = 0;
+    unsigned int                     numVertices = 0;
+    std::unique_ptr<unsigned char[]> vertices;            // Interleaved vertices
+
+    unsigned int                     numIndices  = 0;
+    DXGI_FORMAT                      indexFormat = DXGI_FORMAT_R16_UINT;
+    std::unique_ptr<unsigned char[]> indices;
+};
+
+
 class Mesh
 {
 public:
     // Pass the name of the mesh file to load. Uses assimp (http://www.assimp.org/) to support many file types
     // Optionally request tangents to be calculated (for normal and parallax mapping - see later lab)
+    // Import flags are extra assimp post-processing flags (aiProcess_...) to use on top of the standard ones
     // Will throw a std::runtime_error exception on failure (since constructors can't return errors).
-    Mesh(const std::string& fileName, bool requireTangents = false);
+    Mesh(const std::string& fileName, bool requireTangents = false, unsigned int importFlags = 0);
+
+    // Create a mesh from geometry that has already been imported (see ImportGeometry). Tangents are calculated
+    // here if required. The name is only used in error messages. Will throw a std::runtime_error exception on failure
+    Mesh(const MeshGeometry& geometry, bool requireTangents, const std::string& name);
+
+    // Create a mesh from prepared buffer data (see PrepareBuffers). Will throw a std::runtime_error exception on failure
+    Mesh(const MeshBufferData& buffers, const std::string& name);
+
+    // Create a mesh with no GPU resources yet, for a mesh loaded in the background. The placeholder mesh is
+    // rendered in its place until Create is called. The placeholder must outlive this mesh
+    explicit Mesh(Mesh* placeholder);
+
     ~Mesh();
 
+    // Create the GPU resources of a mesh made with a placeholder, after which it renders itself. Call on the
+    // render thread. Will throw a std::runtime_error exception on failure
+    void Create(const MeshBufferData& buffers, const std::string& name);
+
+    // False until the GPU resources have been created
+    bool IsReady() const { return mVertexBuffer != nullptr; }
+
+
+    // Import the geometry of a mesh file without creating any GPU resources. Import flags are as for the constructor
+    // Assimp's log is global so it is not thread-safe, pass false for verboseLog when importing on other threads
+    // Will throw a std::runtime_error exception on failure
+    static MeshGeometry ImportGeometry(const std::string& fileName, unsigned int importFlags = 0, bool verboseLog = true);
+
+    // Calculate tangents if required and lay out the vertex and index data of imported geometry, without using
+    // Direct3D. The name is only used in error messages. Will throw a std::runtime_error exception on failure
+    static MeshBufferData PrepareBuffers(const MeshGeometry& geometry, bool requireTangents, const std::string& name);
+
     // The render function assumes shaders, matrices, textures, samplers etc. have been set up already.
     // It simply draws this mesh with whatever settings the GPU is currently using.
     void Render();
 
 
 private:
-    unsigned int       mVertexSize;             // Size in bytes of a single vertex (depends on what it contains, uvs, tangents etc.)
+    void ReleaseBuffers();
+
+    Mesh*              mPlaceholder  = nullptr; // Rendered instead of this mesh until it is ready
+
+    unsigned int       mVertexSize   = 0;       // Size in bytes of a single vertex (depends on what it contains, uvs, tangents etc.)
     ID3D11InputLayout* mVertexLayout = nullptr; // DirectX specification of data held in a single vertex
 
     // GPU-side vertex and index buffers
-    unsigned int       mNumVertices;
+    unsigned int       mNumVertices  = 0;
     ID3D11Buffer*      mVertexBuffer = nullptr;
 
-    unsigned int       mNumIndices;
+    unsigned int       mNumIndices   = 0;
+    DXGI_FORMAT        mIndexFormat  = DXGI_FORMAT_R16_UINT; // 16-bit indices if there are few enough vertices, otherwise 32-bit
     ID3D11Buffer*      mIndexBuffer  = nullptr;
 };
 
@@ -0,0 +1,127 @@
+//--------------------------------------------------------------------------------------
+// Library of meshes shared between all the models that use them
+//--------------------------------------------------------------------------------------
+
+#include "MeshLibrary.h"
+
+#include <tuple>
+
+
+// Return the mesh for the given file and settings (see Mesh constructor), loading it if it isn't already in
+// the library. Will throw a std::runtime_error exception on failure, as the Mesh constructor does
+MeshLibrary::Handle MeshLibrary::Get(const std::string& fileName, bool requireTangents /*= false*/, unsigned int importFlags /*= 0*/)
+{
+    MeshKey key = { fileName, requireTangents, importFlags };
+    auto entry = mMeshes.find(key);
+    if (entry != mMeshes.end())
+    {
+        Handle mesh = entry->second.lock();
+        if (mesh)
+        {
+            ++mHits;
+            return mesh;
+        }
+    }
+    ++mMisses;
+
+    // Import the file unless another variant of this mesh has already done so
+    auto& geometry = mGeometry[{ fileName, importFlags }];
+    if (!geometry)
+    {
+        geometry = std::make_unique<MeshGeometry>(Mesh::ImportGeometry(fileName, importFlags));
+        ++mImports;
+    }
+
+    Handle mesh = std::make_shared<Mesh>(*geometry, requireTangents, fileName);
+    mMeshes[key] = mesh;
+    return mesh;
+}
+
+
+// As Get, but a mesh not already in the library is returned straight away without GPU resources, rendering the
+// placeholder mesh until loading finishes. The loading is submitted to the given task pool and the mesh is
+// created when the pool's completions are run (TaskPool::RunCompletions), which will throw a std::runtime_error
+// exception on failure. Background imports are shared between variants as for Get
+MeshLibrary::Handle MeshLibrary::GetAsync(TaskPool& taskPool, Mesh* placeholder, const std::string& fileName,
+                                          bool requireTangents /*= false*/, unsigned int importFlags /*= 0*/)
+{
+    MeshKey key = { fileName, requireTangents, importFlags };
+    auto entry = mMeshes.find(key);
+    if (entry != mMeshes.end())
+    {
+        Handle mesh = entry->second.lock();
+        if (mesh)
+        {
+            ++mHits;
+            return mesh;
+        }
+    }
+    ++mMisses;
+
+    // Import the file in the background unless another variant of this mesh has already started to. The import is
+    // submitted before the tasks that wait for it, and the pool starts tasks in order, so the wait can't deadlock
+    auto& import = mAsyncGeometry[{ fileName, importFlags }];
+    if (!import.valid())
+    {
+        auto promise = std::make_shared<std::promise<std::shared_ptr<const MeshGeometry>>>();
+        import = promise->get_future().share();
+        taskPool.Submit([promise, fileName, importFlags]() -> TaskPool::Completion
+        {
+            try
+            {
+                promise->set_value(std::make_shared<const MeshGeometry>(Mesh::ImportGeometry(fileName, importFlags, false)));
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception()); // Reported by the tasks that use the import
+            }
+            return nullptr;
+        });
+        ++mImports;
+    }
+
+    // Tangents and buffer layout in the background, then the GPU buffers on the render thread. The mesh isn't kept
+    // alive by the task, if all its handles are released before then it is simply not created
+    Handle mesh = std::make_shared<Mesh>(placeholder);
+    std::weak_ptr<Mesh> weakMesh = mesh;
+    AsyncImport geometry = import;
+    taskPool.Submit([geometry, weakMesh, fileName, requireTangents]() -> TaskPool::Completion
+    {
+        auto buffers = std::make_shared<MeshBufferData>(Mesh::PrepareBuffers(*geometry.get(), requireTangents, fileName));
+        return [buffers, weakMesh, fileName]()
+        {
+            Handle mesh = weakMesh.lock();
+            if (mesh)  mesh->Create(*buffers, fileName);
+        };
+    });
+
+    mMeshes[key] = mesh;
+    return mesh;
+}
+
+
+// Free the imported geometry kept to create further variants of the meshes. Meshes already created are not
+// affected, but a new variant of a mesh will need the file to be imported again
+void MeshLibrary::ReleaseImports()
+{
+    mGeometry.clear();
+    mAsyncGeometry.clear(); // Imports still in use by background tasks are freed when those tasks finish
+}
+
+
+// Number of meshes in the library that are still in use
+unsigned int MeshLibrary::NumMeshes() const
+{
+    unsigned int numMeshes = 0;
+    for (auto& entry : mMeshes)
+    {
+        if (!entry.second.expired())  ++numMeshes;
+    }
+    return numMeshes;
+}
+
+
+bool MeshLibrary::MeshKey::operator<(const MeshKey& other) const
+{
+    return std::tie(fileName, requireTangents, importFlags) < std::tie(other.fileName, other.requireTangents, other.importFlags);
+}
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------------------------
+// Library of meshes shared between all the models that use them
+//--------------------------------------------------------------------------------------
+// Loading the same mesh file more than once wastes time (assimp import) and GPU memory (duplicate buffers). The
+// library loads each mesh once for a given file, tangent setting and import flags, then hands out shared handles
+// to it. A mesh is destroyed when the last handle to it is released.
+//
+// The variants of a mesh with and without tangents (for normal mapping) share a single import of the file: the
+// imported geometry is kept by the library and the tangents are calculated from it when that variant is created.
+// Call ReleaseImports once loading is finished to free that memory. Not thread-safe, use from one thread only.
+//
+// Meshes can also be loaded in the background with GetAsync: the import, tangents and vertex layout are done on the
+// task pool's worker threads and the GPU buffers are created when the pool's completions are run on the render
+// thread. Until then the mesh renders a placeholder.
+
+#include "Mesh.h"
+#include "TaskPool.h"
+
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+
+#ifndef _MESH_LIBRARY_H_INCLUDED_
+#define _MESH_LIBRARY_H_INCLUDED_
+
+class MeshLibrary
+{
+public:
+    // Shared handle to a mesh. The mesh stays alive while any handle to it exists
+    using Handle = std::shared_ptr<Mesh>;
+
+    // Return the mesh for the given file and settings (see Mesh constructor), loading it if it isn't already in
+    // the library. Will throw a std::runtime_error exception on failure, as the Mesh constructor does
+    Handle Get(const std::string& fileName, bool requireTangents = false, unsigned int importFlags = 0);
+
+    // As Get, but a mesh not already in the library is returned straight away without GPU resources, rendering the
+    // placeholder mesh until loading finishes. The loading is submitted to the given task pool and the mesh is
+    // created when the pool's completions are run (TaskPool::RunCompletions), which will throw a std::runtime_error
+    // exception on failure. Background imports are shared between variants as for Get
+    Handle GetAsync(TaskPool& taskPool, Mesh* placeholder, const std::string& fileName, bool requireTangents = false,
+                    unsigned int importFlags = 0);
+
+    // Free the imported geometry kept to create further variants of the meshes. Meshes already created are not
+    // affected, but a new variant of a mesh will need the file to be imported again
+    void ReleaseImports();
+
+
+    // Statistics
+    unsigned int Hits()    const { return mHits; }    // Number of Get calls that returned an existing mesh
+    unsigned int Misses()  const { return mMisses; }  // Number of Get calls that had to create a mesh
+    unsigned int Imports() const { return mImports; } // Number of files imported with assimp (misses can reuse an import)
+    unsigned int NumMeshes() const;                   // Number of meshes in the library that are still in use
+
+
+private:
+    // A mesh is identified by its file and settings
+    struct MeshKey
+    {
+        std::string  fileName;
+        bool         requireTangents;
+        unsigned int importFlags;
+
+        bool operator<(const MeshKey& other) const;
+    };
+
+    // The library doesn't keep meshes alive itself, entries for released meshes are replaced when next requested
+    std::map<MeshKey, std::weak_ptr<Mesh>> mMeshes;
+
+    // Imported geometry, by file and import flags (tangents are not part of an import)
+    std::map<std::pair<std::string, unsigned int>, std::unique_ptr<MeshGeometry>> mGeometry;
+
+    // Geometry being imported in the background, by file and import flags. Ready once the import task has finished
+    using AsyncImport = std::shared_future<std::shared_ptr<const MeshGeometry>>;
+    std::map<std::pair<std::string, unsigned int>, AsyncImport> mAsyncGeometry;
+
+    unsigned int mHits    = 0;
+    unsigned int mMisses  = 0;
+    unsigned int mImports = 0;
+};
+
+
+#endif //_MESH_LIBRARY_H_INCLUDED_
@@ -37,10 +37,12 @@ public:
 				  KeyCode turnCW, KeyCode turnCCW, KeyCode moveForward, KeyCode moveBackward );
 
 
+    // Normalising precision as for CMatrix4x4::FaceTarget, exact by default
+    template <Precision P = Precision::Exact>
     void FaceTarget(CVector3 target)
     {
         UpdateWorldMatrix();
-        mWorldMatrix.FaceTarget(target);
+        mWorldMatrix.FaceTarget<P>(target);
         mRotation = mWorldMatrix.GetEulerAngles();
     }
 
@@ -7,11 +7,14 @@
 
 #include "Scene.h"
 #include "Mesh.h"
+#include "MeshLibrary.h"
+#include "AssetLoader.h"
 #include "Model.h"
 #include "Camera.h"
 #include "State.h"
 #include "Shader.h"
 #include "Input.h"
+#include "Timer.h"
 #include "Common.h"
 
 #include "CVector2.h" 
@@ -38,16 +41,25 @@ const float MOVEMENT_SPEED = 50.0f; // 50 units per second for movement (what a
 
 
 // Meshes, models and cameras, same meaning as TL-Engine. Meshes prepared in InitGeometry function, Models & camera in InitScene
-Mesh* gCharacterMesh;
-Mesh* gCrateMesh;
-Mesh* gGroundMesh;
-Mesh* gLightMesh;
-Mesh* gTeaPotMesh;
-Mesh* gSphereMesh;
-Mesh* gCubeMesh;
-Mesh* gCubeMeshNormal;
-Mesh* gParallaxMesh;
-Mesh* gPortalMesh;
+// Meshes come from the mesh library so a file used more than once is only loaded once (see MeshLibrary.h)
+// Meshes and textures are loaded in the background by the asset loader, models show placeholders until then
+MeshLibrary gMeshLibrary;
+std::unique_ptr<AssetLoader> gAssetLoader;
+
+// Startup times in seconds from the start of InitGeometry, shown in the window title. 0 until reached
+Timer gStartupTimer;
+float gFirstFrameTime = 0; // First frame presented, with placeholders for anything still loading
+float gAllLoadedTime  = 0; // All assets loaded
+MeshLibrary::Handle gCharacterMesh;
+MeshLibrary::Handle gCrateMesh;
+MeshLibrary::Handle gGroundMesh;
+MeshLibrary::Handle gLightMesh;
+MeshLibrary::Handle gTeaPotMesh;
+MeshLibrary::Handle gSphereMesh;
+MeshLibrary::Handle gCubeMesh;
+MeshLibrary::Handle gCubeMeshNormal;
+MeshLibrary::Handle gParallaxMesh;
+MeshLibrary::Handle gPortalMesh;
 
 Model* gCharacter;
 Model* gCrate;
@@ -235,20 +247,24 @@ CMatrix4x4 CalculateLightProjectionMatrix(int lightIndex)
 // Returns true on success
 bool InitGeometry()
 {
+    gStartupTimer.Reset();
+
     // Load mesh geometry data, just like TL-Engine this doesn't create anything in the scene. Create a Model for that.
-   
+    // The meshes are loaded in the background, they render as a placeholder cube until ready (see AssetLoader.h)
     try 
     {
-        gCharacterMesh = new Mesh("Troll.x");
-        gCrateMesh     = new Mesh("CargoContainer.x");
-        gGroundMesh    = new Mesh("Ground.x");
-        gLightMesh     = new Mesh("Light.x");
-        gTeaPotMesh = new Mesh("Teapot.x");
-        gSphereMesh = new Mesh("Sphere.x");
-        gCubeMesh = new Mesh("Cube.x");
-        gCubeMeshNormal = new Mesh("Cube.x", true);
-        gParallaxMesh = new Mesh("Cube.x", true);
-        gPortalMesh = new Mesh("Portal.x");
+        gAssetLoader = std::make_unique<AssetLoader>(gMeshLibrary);
+        gCharacterMesh = gAssetLoader->LoadMesh("Troll.x");
+        gCrateMesh     = gAssetLoader->LoadMesh("CargoContainer.x");
+        gGroundMesh    = gAssetLoader->LoadMesh("Ground.x");
+        gLightMesh     = gAssetLoader->LoadMesh("Light.x");
+        gTeaPotMesh = gAssetLoader->LoadMesh("Teapot.x");
+        gSphereMesh = gAssetLoader->LoadMesh("Sphere.x");
+        gCubeMesh = gAssetLoader->LoadMesh("Cube.x");
+        gCubeMeshNormal = gAssetLoader->LoadMesh("Cube.x", true); // Reuses the import of Cube.x above, only adds tangents
+        gParallaxMesh = gAssetLoader->LoadMesh("Cube.x", true);   // Same mesh as gCubeMeshNormal
+        gPortalMesh = gAssetLoader->LoadMesh("Portal.x");
+        gMeshLibrary.ReleaseImports(); // All meshes requested, the background loading keeps the imports it still needs
        
         
     }
@@ -285,34 +301,32 @@ bool InitGeometry()
     // The LoadTexture function requires you to pass a ID3D11Resource* (e.g. &gCubeDiffuseMap), which manages the GPU memory for the
     // texture and also a ID3D11ShaderResourceView* (e.g. &gCubeDiffuseMapSRV), which allows us to use the texture in shaders
     // The function will fill in these pointers with usable data. The variables used here are globals found near the top of the file.
-    if (!LoadTexture("porcelain.jpg", &gCharacterDiffuseSpecularMap, &gCharacterDiffuseSpecularMapSRV) ||
-        !LoadTexture("CargoA.dds",               &gCrateDiffuseSpecularMap,     &gCrateDiffuseSpecularMapSRV    ) ||
-        !LoadTexture("GrassDiffuseSpecular1.dds", &gGroundDiffuseSpecularMap,    &gGroundDiffuseSpecularMapSRV   ) ||
-        !LoadTexture("porcelain.jpg", &gTeaPotDiffuseSpecularMap, &gTeaPotDiffuseSpecularMapSRV) ||
-        !LoadTexture("holo.jpg", &gSphereDiffuseSpecularMap, &gSphereDiffuseSpecularMapSRV) ||
-        !LoadTexture("mosaic.jpg", &gCube1DiffuseSpecularMap, &gCube1DiffuseSpecularMapSRV) ||
-        !LoadTexture("purple.jpg", &gCube2DiffuseSpecularMap, &gCube2DiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternDiffuseSpecular.dds", &gCubeNormalDiffuseSpecularMap, &gCubeNormalDiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternNormal.dds", &gCubeNormalMap, &gCubeNormalMapSRV) ||
-        !LoadTexture("PatternDiffuseSpecular.dds", &gParallaxDiffuseSpecularMap, &gParallaxDiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternNormalHeight.dds", &gParallaxNormalHeightMap, &gParallaxNormalHeightMapSRV) ||
-        !LoadTexture("StoneDiffuseSpecular.dds", &gSpecularDiffuseSpecularMap, &gSpecularDiffuseSpecularMapSRV) ||
-        !LoadTexture("Glass.jpg", &gMulDiffuseMap, &gMulDiffuseMapSRV) ||
-        !LoadTexture("FireAdd.png", &gAddDiffuseMap, &gAddDiffuseMapSRV) ||
-        !LoadTexture("wizard.png", &gAlphaTestDiffuseMap, &gAlphaTestDiffuseMapSRV) ||
-        !LoadTexture("secret.png", &gSecretDiffuseMap, &gSecretDiffuseMapSRV) ||
-        !LoadTexture("beach.dds", &gCubeMapDiffuseSpecularMap, &gCubeMapDiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternDiffuseSpecular.dds", &gChangeNormalDiffuseSpecularMap, &gChangeNormalDiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternDiffuseSpecular.dds", &gChange1DiffuseSpecularMap, &gChange1DiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternYellowDiffuseSpecular.dds", &gChange2DiffuseSpecularMap, &gChange2DiffuseSpecularMapSRV) ||
-        !LoadTexture("PatternNormal.dds", &gChangeNormalMap, &gChangeNormalMapSRV) ||
-        !LoadTexture("Red.png", &gCellDiffuseMap, &gCellDiffuseMapSRV) ||
-        !LoadTexture("CellGradient.png", &gCellMap, &gCellMapSRV) ||
-        !LoadTexture("Flare.jpg",                &gLightDiffuseMap,             &gLightDiffuseMapSRV))
-    {
-        gLastError = "Error loading textures";
-        return false;
-    }
+    // The asset loader fills them in with a placeholder straight away and swaps in the texture once it has loaded in the
+    // background. A failure to load is reported from UpdateScene
+    gAssetLoader->LoadTexture("porcelain.jpg", &gCharacterDiffuseSpecularMap, &gCharacterDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("CargoA.dds",               &gCrateDiffuseSpecularMap,     &gCrateDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("GrassDiffuseSpecular1.dds", &gGroundDiffuseSpecularMap,    &gGroundDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("porcelain.jpg", &gTeaPotDiffuseSpecularMap, &gTeaPotDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("holo.jpg", &gSphereDiffuseSpecularMap, &gSphereDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("mosaic.jpg", &gCube1DiffuseSpecularMap, &gCube1DiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("purple.jpg", &gCube2DiffuseSpecularMap, &gCube2DiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternDiffuseSpecular.dds", &gCubeNormalDiffuseSpecularMap, &gCubeNormalDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternNormal.dds", &gCubeNormalMap, &gCubeNormalMapSRV);
+    gAssetLoader->LoadTexture("PatternDiffuseSpecular.dds", &gParallaxDiffuseSpecularMap, &gParallaxDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternNormalHeight.dds", &gParallaxNormalHeightMap, &gParallaxNormalHeightMapSRV);
+    gAssetLoader->LoadTexture("StoneDiffuseSpecular.dds", &gSpecularDiffuseSpecularMap, &gSpecularDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("Glass.jpg", &gMulDiffuseMap, &gMulDiffuseMapSRV);
+    gAssetLoader->LoadTexture("FireAdd.png", &gAddDiffuseMap, &gAddDiffuseMapSRV);
+    gAssetLoader->LoadTexture("wizard.png", &gAlphaTestDiffuseMap, &gAlphaTestDiffuseMapSRV);
+    gAssetLoader->LoadTexture("secret.png", &gSecretDiffuseMap, &gSecretDiffuseMapSRV);
+    gAssetLoader->LoadTexture("beach.dds", &gCubeMapDiffuseSpecularMap, &gCubeMapDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternDiffuseSpecular.dds", &gChangeNormalDiffuseSpecularMap, &gChangeNormalDiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternDiffuseSpecular.dds", &gChange1DiffuseSpecularMap, &gChange1DiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternYellowDiffuseSpecular.dds", &gChange2DiffuseSpecularMap, &gChange2DiffuseSpecularMapSRV);
+    gAssetLoader->LoadTexture("PatternNormal.dds", &gChangeNormalMap, &gChangeNormalMapSRV);
+    gAssetLoader->LoadTexture("Red.png", &gCellDiffuseMap, &gCellDiffuseMapSRV);
+    gAssetLoader->LoadTexture("CellGradient.png", &gCellMap, &gCellMapSRV);
+    gAssetLoader->LoadTexture("Flare.jpg",                &gLightDiffuseMap,             &gLightDiffuseMapSRV);
 
 
 
@@ -385,22 +399,22 @@ bool InitScene()
 {
     //// Set up scene ////
 
-    gCharacter = new Model(gCharacterMesh);
-    gCrate     = new Model(gCrateMesh);
-    gGround    = new Model(gGroundMesh);
-    gTeaPot = new Model(gTeaPotMesh);
-    gSphere = new Model(gSphereMesh);
-    gCube = new Model(gCubeMesh);
-    gCubeNormal = new Model(gCubeMeshNormal);
-    gParallax = new Model(gParallaxMesh);
-    gSpecular = new Model(gCubeMesh);
-    gMul = new Model(gCubeMesh);
-    gAdd = new Model(gCubeMesh);
-    gCubeMap = new Model(gSphereMesh);
-    gAlphaTest = new Model(gCubeMesh);
-    gSecret = new Model(gPortalMesh);
-    gChangeModel = new Model(gCubeMeshNormal);
-    gCell = new Model(gTeaPotMesh);
+    gCharacter = new Model(gCharacterMesh.get());
+    gCrate     = new Model(gCrateMesh.get());
+    gGround    = new Model(gGroundMesh.get());
+    gTeaPot = new Model(gTeaPotMesh.get());
+    gSphere = new Model(gSphereMesh.get());
+    gCube = new Model(gCubeMesh.get());
+    gCubeNormal = new Model(gCubeMeshNormal.get());
+    gParallax = new Model(gParallaxMesh.get());
+    gSpecular = new Model(gCubeMesh.get());
+    gMul = new Model(gCubeMesh.get());
+    gAdd = new Model(gCubeMesh.get());
+    gCubeMap = new Model(gSphereMesh.get());
+    gAlphaTest = new Model(gCubeMesh.get());
+    gSecret = new Model(gPortalMesh.get());
+    gChangeModel = new Model(gCubeMeshNormal.get());
+    gCell = new Model(gTeaPotMesh.get());
 
 	// Initial positions, scalinG and rotation
 	gCharacter->SetPosition({ 20, 0, 0 });
@@ -441,7 +455,7 @@ bool InitScene()
     // Light set-up - using an array this time
     for (int i = 0; i < NUM_LIGHTS; ++i)
     {
-        gLights[i].model = new Model(gLightMesh);
+        gLights[i].model = new Model(gLightMesh.get());
     }
 
     gLights[0].colour = { 0.8f, 0.8f, 1.0f };
@@ -581,15 +595,20 @@ void ReleaseResources()
     delete gCell;     gCell = nullptr;
 
 
-    delete gLightMesh;     gLightMesh     = nullptr;
-    delete gGroundMesh;    gGroundMesh    = nullptr;
-    delete gCrateMesh;     gCrateMesh     = nullptr;
-    delete gCharacterMesh; gCharacterMesh = nullptr;
-    delete gTeaPotMesh; gTeaPotMesh = nullptr;
-    delete gCubeMesh;     gCubeMesh = nullptr;
-    delete gCubeMeshNormal;     gCubeMeshNormal = nullptr;
-    delete gParallaxMesh;     gParallaxMesh = nullptr;
-
+    // Releasing the last handle to a mesh destroys it
+    gLightMesh     = nullptr;
+    gGroundMesh    = nullptr;
+    gCrateMesh     = nullptr;
+    gCharacterMesh = nullptr;
+    gTeaPotMesh = nullptr;
+    gSphereMesh = nullptr;
+    gCubeMesh = nullptr;
+    gCubeMeshNormal = nullptr;
+    gParallaxMesh = nullptr;
+    gPortalMesh = nullptr;
+
+    // Meshes still loading render the loader's placeholders, so it is released after them
+    gAssetLoader = nullptr;
 }
 
 
@@ -986,6 +1005,7 @@ void RenderScene()
 
     // When drawing to the off-screen back buffer is complete, we "present" the image to the front buffer (the screen)
     gSwapChain->Present(0, 0);
+    if (gFirstFrameTime == 0)  gFirstFrameTime = gStartupTimer.GetTime();
 }
 
 
@@ -1006,6 +1026,19 @@ bool strengthIsZero = false;
 // Update models and camera. frameTime is the time passed since the last frame
 void UpdateScene(float frameTime)
 {
+    // Create the GPU resources of any meshes and textures that have finished loading in the background
+    try
+    {
+        gAssetLoader->Update();
+    }
+    catch (std::runtime_error e)
+    {
+        gLastError = e.what();
+        MessageBoxA(gHWnd, gLastError.c_str(), NULL, MB_OK);
+        DestroyWindow(gHWnd);
+        return;
+    }
+    if (gAllLoadedTime == 0 && !gAssetLoader->IsLoading())  gAllLoadedTime = gStartupTimer.GetTime();
 
     wiggle += frameTime;
     change += frameTime/2 * wiggleDirection;
@@ -1127,7 +1160,19 @@ void UpdateScene(float frameTime)
         frameTimeMs.precision(2);
         frameTimeMs << std::fixed << avgFrameTime * 1000;
         std::string windowTitle = "CO2409 Week 20: Shadow Mapping - Frame Time: " + frameTimeMs.str() +
-                                  "ms, FPS: " + std::to_string(static_cast<int>(1 / avgFrameTime + 0.5f));
+                                  "ms, FPS: " + std::to_string(static_cast<int>(1 / avgFrameTime + 0.5f)) +
+                                  " - Meshes: " + std::to_string(gMeshLibrary.NumMeshes()) +
+                                  " (" + std::to_string(gMeshLibrary.Hits()) + " hits, " + std::to_string(gMeshLibrary.Misses()) +
+                                  " misses, " + std::to_string(gMeshLibrary.Imports()) + " imports)";
+        if (gAssetLoader->IsLoading())
+        {
+            windowTitle += " - Loading: " + std::to_string(gAssetLoader->NumLoaded()) + "/" + std::to_string(gAssetLoader->NumAssets()) + " assets";
+        }
+        else
+        {
+            windowTitle += " - First frame: " + std::to_string(static_cast<int>(gFirstFrameTime * 1000)) +
+                           "ms, all loaded: " + std::to_string(static_cast<int>(gAllLoadedTime * 1000)) + "ms";
+        }
         SetWindowTextA(gHWnd, windowTitle.c_str());
         totalFrameTime = 0;
         frameCount = 0;
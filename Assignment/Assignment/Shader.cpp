@@ -5,6 +5,7 @@
 
 #include "Shader.h"
 #include <fstream>
+#include <map>
 #include <vector>
 #include <d3dcompiler.h>
 
@@ -38,6 +39,9 @@ ID3D11VertexShader* gCellShadingOutlineVertexShader = nullptr;
 ID3D11PixelShader* gCellShadingOutlinePixelShader = nullptr;
 ID3D11PixelShader* gCellShadingPixelShader = nullptr;
 
+// Signatures for vertex layouts by layout key, see GetSignatureForVertexLayout
+static std::map<uint64_t, ID3DBlob*> gVertexSignatures;
+
 
 //--------------------------------------------------------------------------------------
 // Shader creation / destruction
@@ -107,6 +111,9 @@ void ReleaseShaders()
     if (gCellShadingPixelShader)          gCellShadingPixelShader->Release();
     if (gCellShadingOutlineVertexShader)  gCellShadingOutlineVertexShader->Release();
     if (gCellShadingOutlinePixelShader)   gCellShadingOutlinePixelShader->Release();
+
+    for (auto& signature : gVertexSignatures)  signature.second->Release();
+    gVertexSignatures.clear();
 }        
 
 
@@ -220,6 +227,20 @@ ID3DBlob* CreateSignatureForVertexLayout(const D3D11_INPUT_ELEMENT_DESC vertexLa
 }
 
 
+// As CreateSignatureForVertexLayout, but each signature is only compiled once and is kept by its layout key (see
+// VertexLayout.h), so meshes sharing a layout don't each compile a shader. Don't release the returned signature,
+// ReleaseShaders does. Returns nullptr on failure
+ID3DBlob* GetSignatureForVertexLayout(uint64_t layoutKey, const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements)
+{
+    auto signature = gVertexSignatures.find(layoutKey);
+    if (signature != gVertexSignatures.end())  return signature->second;
+
+    ID3DBlob* compiledShader = CreateSignatureForVertexLayout(vertexLayout, numElements);
+    if (compiledShader)  gVertexSignatures[layoutKey] = compiledShader;
+    return compiledShader;
+}
+
+
 //--------------------------------------------------------------------------------------
 // Constant buffer creation / destruction
 //--------------------------------------------------------------------------------------
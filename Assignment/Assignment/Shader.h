@@ -70,5 +70,10 @@ ID3D11PixelShader*  LoadPixelShader (std::string shaderName);
 // Helper function. Returns nullptr on failure.
 ID3DBlob* CreateSignatureForVertexLayout(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements);
 
+// As CreateSignatureForVertexLayout, but each signature is only compiled once and is kept by its layout key (see
+// VertexLayout.h), so meshes sharing a layout don't each compile a shader. Don't release the returned signature,
+// ReleaseShaders does. Returns nullptr on failure
+ID3DBlob* GetSignatureForVertexLayout(uint64_t layoutKey, const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements);
+
 
 #endif //_SHADER_H_INCLUDED_
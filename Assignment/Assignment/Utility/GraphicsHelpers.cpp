@@ -6,22 +6,29 @@
 #include "../Shader.h"
 #include <cmath>
 #include <cctype>
-#include <atlbase.h> // C-string to unicode conversion function CA2CT
+#include <fstream>
+#include <atlbase.h> // C-string to unicode conversion function CA2CT, and CComPtr
+#include <wincodec.h>
 
 //--------------------------------------------------------------------------------------
 // Texture Loading
 //--------------------------------------------------------------------------------------
 
+// DDS files need different functions from other files, so check the filename extension (case insensitive)
+static bool IsDDSFile(const std::string& filename)
+{
+    std::string dds = ".dds";
+    return filename.size() >= 4 &&
+           std::equal(dds.rbegin(), dds.rend(), filename.rbegin(), [](unsigned char a, unsigned char b) { return std::tolower(a) == std::tolower(b); });
+}
+
 // Using Microsoft's open source DirectX Tool Kit (DirectXTK) to simplify texture loading
 // This function requires you to pass a ID3D11Resource* (e.g. &gTilesDiffuseMap), which manages the GPU memory for the
 // texture and also a ID3D11ShaderResourceView* (e.g. &gTilesDiffuseMapSRV), which allows us to use the texture in shaders
 // The function will fill in these pointers with usable data. Returns false on failure
 bool LoadTexture(std::string filename, ID3D11Resource** texture, ID3D11ShaderResourceView** textureSRV)
 {
-    // DDS files need a different function from other files
-    std::string dds = ".dds"; // So check the filename extension (case insensitive)
-    if (filename.size() >= 4 &&
-        std::equal(dds.rbegin(), dds.rend(), filename.rbegin(), [](unsigned char a, unsigned char b) { return std::tolower(a) == std::tolower(b); }))
+    if (IsDDSFile(filename))
     {
         return SUCCEEDED(DirectX::CreateDDSTextureFromFile(gD3DDevice, CA2CT(filename.c_str()), texture, textureSRV));
     }
@@ -32,6 +39,125 @@ bool LoadTexture(std::string filename, ID3D11Resource** texture, ID3D11ShaderRes
 }
 
 
+// Decode an image file held in memory to RGBA pixels with the Windows Imaging Component, which DirectXTK uses too.
+// Matches DirectXTK's choice of an sRGB format for files whose metadata says they are sRGB
+static bool DecodeImage(TextureData& textureData)
+{
+    CComPtr<IWICImagingFactory> factory;
+    if (FAILED(CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory))))  return false;
+
+    CComPtr<IWICStream> stream;
+    CComPtr<IWICBitmapDecoder> decoder;
+    CComPtr<IWICBitmapFrameDecode> frame;
+    if (FAILED(factory->CreateStream(&stream)) ||
+        FAILED(stream->InitializeFromMemory(textureData.fileData.data(), static_cast<DWORD>(textureData.fileData.size()))) ||
+        FAILED(factory->CreateDecoderFromStream(stream, nullptr, WICDecodeMetadataCacheOnDemand, &decoder)) ||
+        FAILED(decoder->GetFrame(0, &frame)) ||
+        FAILED(frame->GetSize(&textureData.width, &textureData.height)))
+    {
+        return false;
+    }
+
+    bool sRGB = false;
+    CComPtr<IWICMetadataQueryReader> metadata;
+    GUID container;
+    if (SUCCEEDED(frame->GetMetadataQueryReader(&metadata)) && SUCCEEDED(metadata->GetContainerFormat(&container)))
+    {
+        PROPVARIANT value;
+        PropVariantInit(&value);
+        if (container == GUID_ContainerFormatPng)
+        {
+            sRGB = SUCCEEDED(metadata->GetMetadataByName(L"/sRGB/RenderingIntent", &value)) && value.vt == VT_UI1;
+        }
+        else
+        {
+            sRGB = SUCCEEDED(metadata->GetMetadataByName(L"System.Image.ColorSpace", &value)) && value.vt == VT_UI2 && value.uiVal == 1;
+        }
+        PropVariantClear(&value);
+    }
+    textureData.format = sRGB ? DXGI_FORMAT_R8G8B8A8_UNORM_SRGB : DXGI_FORMAT_R8G8B8A8_UNORM;
+
+    CComPtr<IWICFormatConverter> converter;
+    UINT rowPitch = textureData.width * 4;
+    textureData.pixels.resize(static_cast<size_t>(rowPitch) * textureData.height);
+    if (FAILED(factory->CreateFormatConverter(&converter)) ||
+        FAILED(converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeErrorDiffusion, nullptr, 0, WICBitmapPaletteTypeMedianCut)) ||
+        FAILED(converter->CopyPixels(nullptr, rowPitch, static_cast<UINT>(textureData.pixels.size()), textureData.pixels.data())))
+    {
+        return false;
+    }
+
+    textureData.fileData.clear(); // Only the pixels are needed now
+    textureData.fileData.shrink_to_fit();
+    return true;
+}
+
+
+// Texture loading can also be split in two so the slow part can be done away from the render thread (see AssetLoader.h).
+// ReadTexture reads the file and, for image files (jpg, png etc.), decodes it to RGBA pixels. It uses no Direct3D so
+// can be called on any thread. CreateTexture then makes the texture and shader resource view from that data, as
+// LoadTexture does, and must be called on the render thread
+bool ReadTexture(const std::string& filename, TextureData& textureData)
+{
+    textureData = TextureData();
+
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file)  return false;
+    std::streamoff size = file.tellg();
+    if (size <= 0)  return false;
+    textureData.fileData.resize(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(textureData.fileData.data()), size))  return false;
+
+    textureData.isDDS = IsDDSFile(filename);
+    if (textureData.isDDS)  return true;
+
+    // WIC needs COM initialised on each thread that uses it. If the thread has already done so (in any mode) this
+    // fails harmlessly and must not be undone
+    HRESULT comResult = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    bool decoded = DecodeImage(textureData);
+    if (SUCCEEDED(comResult))  CoUninitialize();
+    return decoded;
+}
+
+bool CreateTexture(const TextureData& textureData, ID3D11Resource** texture, ID3D11ShaderResourceView** textureSRV)
+{
+    if (textureData.isDDS)
+    {
+        return SUCCEEDED(DirectX::CreateDDSTextureFromMemory(gD3DDevice, textureData.fileData.data(), textureData.fileData.size(), texture, textureSRV));
+    }
+
+    // Full mip-map chain generated by the GPU, as DirectXTK does for image files
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width            = textureData.width;
+    desc.Height           = textureData.height;
+    desc.MipLevels        = 0;
+    desc.ArraySize        = 1;
+    desc.Format           = textureData.format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage            = D3D11_USAGE_DEFAULT;
+    desc.BindFlags        = D3D11_BIND_SHADER_RESOURCE | D3D11_BIND_RENDER_TARGET;
+    desc.MiscFlags        = D3D11_RESOURCE_MISC_GENERATE_MIPS;
+
+    ID3D11Texture2D* newTexture = nullptr;
+    if (FAILED(gD3DDevice->CreateTexture2D(&desc, nullptr, &newTexture)))  return false;
+
+    ID3D11ShaderResourceView* newSRV = nullptr;
+    if (FAILED(gD3DDevice->CreateShaderResourceView(newTexture, nullptr, &newSRV)))
+    {
+        newTexture->Release();
+        return false;
+    }
+
+    gD3DContext->UpdateSubresource(newTexture, 0, nullptr, textureData.pixels.data(), textureData.width * 4, 0);
+    gD3DContext->GenerateMips(newSRV);
+
+    *texture    = newTexture;
+    *textureSRV = newSRV;
+    return true;
+}
+
+
 //--------------------------------------------------------------------------------------
 // Camera Helpers
 //--------------------------------------------------------------------------------------
@@ -10,8 +10,15 @@
 #include <DDSTextureLoader.h>
 
 #include "CMatrix4x4.h"
+#include "VertexLayout.h"
 #include "../Common.h"
 
+#include <array>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
 
 //--------------------------------------------------------------------------------------
 // Constant buffers
@@ -41,6 +48,82 @@ void UpdateConstantBuffer(ID3D11Buffer* buffer, const T& bufferData)
 bool LoadTexture(std::string filename, ID3D11Resource** texture, ID3D11ShaderResourceView** textureSRV);
 
 
+// Texture loading can also be split in two so the slow part can be done away from the render thread (see AssetLoader.h).
+// ReadTexture reads the file and, for image files (jpg, png etc.), decodes it to RGBA pixels. It uses no Direct3D so
+// can be called on any thread. CreateTexture then makes the texture and shader resource view from that data, as
+// LoadTexture does, and must be called on the render thread
+struct TextureData
+{
+    bool                 isDDS  = false;  // DDS files are not decoded, they are already in a GPU format
+    std::vector<uint8_t> fileData;        // Contents of a DDS file
+    unsigned int         width  = 0;      // Decoded pixels of other files, with mip-maps generated on creation
+    unsigned int         height = 0;
+    DXGI_FORMAT          format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    std::vector<uint8_t> pixels;
+};
+
+// Both return false on failure
+bool ReadTexture(const std::string& filename, TextureData& textureData);
+bool CreateTexture(const TextureData& textureData, ID3D11Resource** texture, ID3D11ShaderResourceView** textureSRV);
+
+
+//--------------------------------------------------------------------------------------
+// Vertex layouts
+//--------------------------------------------------------------------------------------
+
+// HLSL semantic name and DXGI format of the device-independent vertex elements (see VertexElement.h)
+constexpr const char* VertexSemanticName(VertexSemantic semantic)
+{
+    switch (semantic)
+    {
+        case VertexSemantic::Position: return "Position";
+        case VertexSemantic::Normal:   return "Normal";
+        case VertexSemantic::Tangent:  return "Tangent";
+        case VertexSemantic::UV:       return "UV";
+        case VertexSemantic::Bones:    return "Bones";
+        case VertexSemantic::Weights:  return "Weights";
+        case VertexSemantic::Colour:   return "Colour";
+    }
+    return "";
+}
+
+constexpr DXGI_FORMAT VertexDXGIFormat(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float2:      return DXGI_FORMAT_R32G32_FLOAT;
+        case VertexFormat::Float3:      return DXGI_FORMAT_R32G32B32_FLOAT;
+        case VertexFormat::Float4:      return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        case VertexFormat::UByte4:      return DXGI_FORMAT_R8G8B8A8_UINT;
+        case VertexFormat::UShort4Norm: return DXGI_FORMAT_R16G16B16A16_UNORM;
+        case VertexFormat::Short2Norm:  return DXGI_FORMAT_R16G16_SNORM;
+        case VertexFormat::Half2:       return DXGI_FORMAT_R16G16_FLOAT;
+        case VertexFormat::UByte4Norm:  return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+constexpr D3D11_INPUT_ELEMENT_DESC InputElementDesc(const VertexElement& element)
+{
+    return { VertexSemanticName(element.semantic), 0, VertexDXGIFormat(element.format), 0, element.offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+}
+
+// The Direct3D vertex layout description of a vertex layout declared with VertexLayout.h, generated by the compiler
+// so it always matches the vertex structure, e.g.
+//     constexpr auto gBasicVertexDesc = InputElementDescs<BasicVertexLayout>();
+template <class Layout, size_t... I>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, Layout::NumElements> InputElementDescs(std::index_sequence<I...>)
+{
+    return {{ InputElementDesc(Layout::Elements[I])... }};
+}
+
+template <class Layout>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, Layout::NumElements> InputElementDescs()
+{
+    return InputElementDescs<Layout>(std::make_index_sequence<Layout::NumElements>());
+}
+
+
 //--------------------------------------------------------------------------------------
 // Camera helpers
 //--------------------------------------------------------------------------------------
@@ -0,0 +1,267 @@
+//--------------------------------------------------------------------------------------
+// Results from the benchmark programs - printing, saving and comparing against a baseline
+//--------------------------------------------------------------------------------------
+
+#include "BenchmarkResults.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+
+//--------------------------------------------------------------------------------------
+// Printing
+//--------------------------------------------------------------------------------------
+
+void BenchmarkResults::PrintHeader()
+{
+    printf("%-30s %8s %12s %12s %9s\n", "Function", "Batch", "Scalar ns", "SIMD ns", "Speedup");
+}
+
+void BenchmarkResults::Add(const char* name, int batch, double scalarNs, double simdNs)
+{
+    mResults.push_back({ name, batch, scalarNs, simdNs });
+
+    if (scalarNs >= 0)  printf("%-30s %8d %12.2f %12.2f %8.2fx\n", name, batch, scalarNs, simdNs, scalarNs / simdNs);
+    else                printf("%-30s %8d %12s %12.2f\n", name, batch, "-", simdNs);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Saving
+//--------------------------------------------------------------------------------------
+
+// Return string with quotes and backslashes escaped for a JSON string
+static std::string EscapeJSON(const std::string& s)
+{
+    std::string escaped;
+    for (char c : s)
+    {
+        if (c == '"' || c == '\\')  escaped += '\\';
+        escaped += c;
+    }
+    return escaped;
+}
+
+// Return string with quotes doubled for a quoted CSV field
+static std::string EscapeCSV(const std::string& s)
+{
+    std::string escaped;
+    for (char c : s)
+    {
+        if (c == '"')  escaped += '"';
+        escaped += c;
+    }
+    return escaped;
+}
+
+
+bool BenchmarkResults::SaveJSON(const std::string& fileName, const std::string& configuration) const
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (file == nullptr)  return false;
+
+    fprintf(file, "{\n  \"configuration\": \"%s\",\n  \"results\": [\n", EscapeJSON(configuration).c_str());
+    for (size_t i = 0; i < mResults.size(); ++i)
+    {
+        const BenchmarkResult& r = mResults[i];
+        fprintf(file, "    { \"name\": \"%s\", \"batch\": %d, ", EscapeJSON(r.name).c_str(), r.batch);
+        if (r.scalarNs >= 0)  fprintf(file, "\"scalar_ns\": %.4f, ", r.scalarNs);
+        else                  fprintf(file, "\"scalar_ns\": null, ");
+        fprintf(file, "\"simd_ns\": %.4f }%s\n", r.simdNs, (i + 1 < mResults.size()) ? "," : "");
+    }
+    fprintf(file, "  ]\n}\n");
+
+    return fclose(file) == 0;
+}
+
+bool BenchmarkResults::SaveCSV(const std::string& fileName) const
+{
+    FILE* file = fopen(fileName.c_str(), "w");
+    if (file == nullptr)  return false;
+
+    fprintf(file, "name,batch,scalar_ns,simd_ns\n");
+    for (const BenchmarkResult& r : mResults)
+    {
+        fprintf(file, "\"%s\",%d,", EscapeCSV(r.name).c_str(), r.batch);
+        if (r.scalarNs >= 0)  fprintf(file, "%.4f", r.scalarNs);
+        fprintf(file, ",%.4f\n", r.simdNs);
+    }
+
+    return fclose(file) == 0;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Loading
+//--------------------------------------------------------------------------------------
+
+// Read a quoted string starting at text[pos], handling the escapes written by EscapeJSON (JSON) or
+// EscapeCSV (CSV). Updates pos to just after the closing quote. Returns false if the string is not terminated
+static bool ReadQuoted(const std::string& text, size_t& pos, std::string& value, bool csv)
+{
+    value.clear();
+    for (++pos; pos < text.size(); ++pos)
+    {
+        char c = text[pos];
+        if (!csv && c == '\\' && pos + 1 < text.size())
+        {
+            value += text[++pos];
+        }
+        else if (c == '"')
+        {
+            if (!csv || pos + 1 >= text.size() || text[pos + 1] != '"')
+            {
+                ++pos;
+                return true;
+            }
+            value += text[++pos];
+        }
+        else
+        {
+            value += c;
+        }
+    }
+    return false;
+}
+
+// Find "key": in text between from and end and return the position of its value, or npos if not found
+static size_t FindJSONValue(const std::string& text, const char* key, size_t from, size_t end)
+{
+    size_t pos = text.find("\"" + std::string(key) + "\"", from);
+    if (pos >= end)  return std::string::npos;
+    pos = text.find(':', pos);
+    if (pos >= end)  return std::string::npos;
+    pos = text.find_first_not_of(" \t\r\n", pos + 1);
+    return (pos < end) ? pos : std::string::npos;
+}
+
+// Read a number at text[pos], or -1 for null or a missing value
+static double ReadNumber(const std::string& text, size_t pos)
+{
+    if (pos == std::string::npos || text.compare(pos, 4, "null") == 0)  return -1.0;
+    return strtod(text.c_str() + pos, nullptr);
+}
+
+
+bool BenchmarkResults::Load(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file)  return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    mResults.clear();
+    mConfiguration.clear();
+
+    size_t start = text.find_first_not_of(" \t\r\n");
+    if (start == std::string::npos)  return false;
+
+    if (text[start] == '{')
+    {
+        // JSON - one object per result containing name, batch, scalar_ns and simd_ns
+        size_t pos = FindJSONValue(text, "configuration", start, text.size());
+        if (pos != std::string::npos && text[pos] == '"')  ReadQuoted(text, pos, mConfiguration, false);
+
+        pos = start;
+        while ((pos = FindJSONValue(text, "name", pos, text.size())) != std::string::npos)
+        {
+            BenchmarkResult r;
+            if (text[pos] != '"' || !ReadQuoted(text, pos, r.name, false))  return false;
+            size_t end = text.find('}', pos);
+            if (end == std::string::npos)  return false;
+
+            r.batch    = static_cast<int>(ReadNumber(text, FindJSONValue(text, "batch",     pos, end)));
+            r.scalarNs = ReadNumber(text, FindJSONValue(text, "scalar_ns", pos, end));
+            r.simdNs   = ReadNumber(text, FindJSONValue(text, "simd_ns",   pos, end));
+            if (r.simdNs < 0)  return false;
+            mResults.push_back(r);
+            pos = end;
+        }
+    }
+    else
+    {
+        // CSV - header line then name,batch,scalar_ns,simd_ns with an empty scalar_ns for no reference version
+        std::istringstream lines(text);
+        std::string line;
+        std::getline(lines, line);
+        while (std::getline(lines, line))
+        {
+            if (!line.empty() && line.back() == '\r')  line.pop_back();
+            if (line.empty())  continue;
+
+            BenchmarkResult r;
+            size_t pos = 0;
+            if (line[0] == '"')
+            {
+                if (!ReadQuoted(line, pos, r.name, true))  return false;
+            }
+            else
+            {
+                pos = line.find(',');
+                r.name = line.substr(0, pos);
+            }
+
+            // Remaining three fields
+            double fields[3];
+            for (double& field : fields)
+            {
+                if (pos >= line.size() || line[pos] != ',')  return false;
+                size_t next = line.find(',', pos + 1);
+                std::string value = line.substr(pos + 1, next - pos - 1);
+                field = value.empty() ? -1.0 : strtod(value.c_str(), nullptr);
+                pos = next;
+            }
+            r.batch    = static_cast<int>(fields[0]);
+            r.scalarNs = fields[1];
+            r.simdNs   = fields[2];
+            mResults.push_back(r);
+        }
+    }
+
+    return !mResults.empty();
+}
+
+
+//--------------------------------------------------------------------------------------
+// Comparing
+//--------------------------------------------------------------------------------------
+
+int BenchmarkResults::Compare(const BenchmarkResults& baseline, double thresholdPercent) const
+{
+    printf("%-30s %8s %7s %12s %12s %9s\n", "Function", "Batch", "Column", "Baseline ns", "Current ns", "Change");
+
+    int compared = 0;
+    int regressions = 0;
+    for (const BenchmarkResult& current : mResults)
+    {
+        const BenchmarkResult* base = nullptr;
+        for (const BenchmarkResult& r : baseline.mResults)
+        {
+            if (r.name == current.name && r.batch == current.batch)  base = &r;
+        }
+        if (base == nullptr)
+        {
+            printf("%-30s %8d   (not in baseline)\n", current.name.c_str(), current.batch);
+            continue;
+        }
+
+        struct Column { const char* name; double baseNs; double currentNs; };
+        for (Column column : { Column{ "Scalar", base->scalarNs, current.scalarNs }, Column{ "SIMD", base->simdNs, current.simdNs } })
+        {
+            if (column.baseNs <= 0 || column.currentNs < 0)  continue;
+
+            double change = 100.0 * (column.currentNs - column.baseNs) / column.baseNs;
+            bool regressed = change > thresholdPercent;
+            printf("%-30s %8d %7s %12.2f %12.2f %+8.1f%%%s\n", current.name.c_str(), current.batch, column.name,
+                   column.baseNs, column.currentNs, change, regressed ? "  <-- REGRESSION" : "");
+            ++compared;
+            if (regressed)  ++regressions;
+        }
+    }
+
+    printf("\n%d timings compared, %d slower than baseline by more than %g%%\n", compared, regressions, thresholdPercent);
+    return regressions;
+}
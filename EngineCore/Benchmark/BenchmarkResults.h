@@ -0,0 +1,64 @@
+//--------------------------------------------------------------------------------------
+// Results from the benchmark programs - printing, saving and comparing against a baseline
+//--------------------------------------------------------------------------------------
+// Each result is one benchmark at one batch size with two timings: a reference version (the "scalar" column,
+// e.g. plain C++ or one-at-a-time) and the optimised version (the "SIMD" column). Benchmarks with only
+// one version leave the scalar time negative.
+//
+// Results can be saved as JSON or CSV. Either file can be loaded back as a baseline, and Compare reports each
+// timing that is slower than the baseline by more than a given percentage - use this as a regression gate:
+//     math_benchmark --json baseline.json                       (on the code before a change)
+//     math_benchmark --compare baseline.json --threshold 10     (after the change, exit code 2 on regression)
+
+#ifndef _BENCHMARK_RESULTS_H_INCLUDED_
+#define _BENCHMARK_RESULTS_H_INCLUDED_
+
+#include <string>
+#include <vector>
+
+struct BenchmarkResult
+{
+    std::string name;
+    int         batch;
+    double      scalarNs; // Negative if the benchmark has no reference version
+    double      simdNs;
+};
+
+
+class BenchmarkResults
+{
+public:
+    // Add a result and print it as a row of the results table
+    void Add(const char* name, int batch, double scalarNs, double simdNs);
+
+    // Print the header row for the results table
+    static void PrintHeader();
+
+    const std::vector<BenchmarkResult>& Results() const { return mResults; }
+
+
+    // Save the results. The configuration string (e.g. instruction set) is stored in JSON files only.
+    // Return false if the file cannot be written
+    bool SaveJSON(const std::string& fileName, const std::string& configuration) const;
+    bool SaveCSV(const std::string& fileName) const;
+
+    // Load results saved by the functions above, replacing any current results. The format is chosen from the
+    // file contents. Only files written by SaveJSON/SaveCSV are supported, this is not a general JSON parser.
+    // Returns false if the file cannot be read or contains no results
+    bool Load(const std::string& fileName);
+
+    // Configuration stored in the last loaded JSON file, empty if there was none
+    const std::string& Configuration() const { return mConfiguration; }
+
+
+    // Compare these results against a baseline, printing a row for each timing present in both.
+    // Returns the number of timings slower than the baseline by more than thresholdPercent
+    int Compare(const BenchmarkResults& baseline, double thresholdPercent) const;
+
+private:
+    std::vector<BenchmarkResult> mResults;
+    std::string                  mConfiguration;
+};
+
+
+#endif //_BENCHMARK_RESULTS_H_INCLUDED_
@@ -0,0 +1,999 @@
+//--------------------------------------------------------------------------------------
+// Benchmark for the maths library
+//--------------------------------------------------------------------------------------
+// Console program, not part of the lab apps. Times the SIMD versions of the hot maths functions
+// against the plain C++ versions (or one-at-a-time versions for batch functions) and checks they give the same results.
+// Functions with only one version are timed on their own. Built as the math_benchmark target of the engine core
+// CMake build (see EngineCore/CMakeLists.txt), e.g.
+//     cmake -S EngineCore -B build -DENGINE_CORE_SIMD=AVX2 && cmake --build build && build/math_benchmark
+// Run with --help for the options to save results (JSON/CSV) and compare against a baseline (see BenchmarkResults.h)
+// Benchmark/Baselines has saved results for the SSE and AVX2 builds (Release, gcc, one x64 machine). Timings vary
+// between runs by up to ~20% so only compare against them on similar hardware with a generous --threshold
+
+#include "CMatrix4x4.h"
+#include "CQuaternion.h"
+#include "CAffine3x4.h"
+#include "CTransform.h"
+#include "BatchTransform.h"
+#include "MathTrig.h"
+#include "MathSIMD.h"
+#include "BenchmarkResults.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Results are added into this so the optimiser cannot remove the work being timed
+volatile float gSink = 0.0f;
+
+// Timings from all the benchmarks that have been run
+BenchmarkResults gResults;
+
+// Number of times each benchmark is repeated, the fastest time is used
+int gRepeats = 9;
+
+// Stops the compiler inlining a function, used for plain C++ reference versions so they are timed as a function call
+#if defined(_MSC_VER)
+    #define BENCHMARK_NOINLINE __declspec(noinline)
+#else
+    #define BENCHMARK_NOINLINE __attribute__((noinline))
+#endif
+
+
+// Random affine matrix (rotation, scale and translation) - the kind of matrix found in a node hierarchy
+CMatrix4x4 RandomMatrix(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> angle(-PI, PI);
+    std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    return MatrixScaling(scale(rng)) * MatrixRotationZ(angle(rng)) * MatrixRotationX(angle(rng)) * MatrixRotationY(angle(rng)) *
+           MatrixTranslation({ position(rng), position(rng), position(rng) });
+}
+
+
+// Time a function over several repeats and return the fastest time in nanoseconds per call
+// The function is passed the number of calls it should make
+template <class Func>
+double TimeNsPerCall(Func func, int callsPerRepeat)
+{
+    double best = 1e30;
+    for (int r = 0; r < gRepeats; ++r)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        func(callsPerRepeat);
+        auto end = std::chrono::high_resolution_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / callsPerRepeat;
+        if (ns < best)  best = ns;
+    }
+    return best;
+}
+
+
+// Largest difference between elements of two matrices
+float MaxDifference(const CMatrix4x4& m1, const CMatrix4x4& m2)
+{
+    const float* a = &m1.e00;
+    const float* b = &m2.e00;
+    float maxDiff = 0.0f;
+    for (int i = 0; i < 16; ++i)  maxDiff = std::max(maxDiff, std::abs(a[i] - b[i]));
+    return maxDiff;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Matrix multiplication
+//--------------------------------------------------------------------------------------
+
+// Multiply pairs of matrices from two arrays - independent multiplies
+void BenchmarkMatrixMultiply(int batch)
+{
+    std::mt19937 rng(1);
+    std::vector<CMatrix4x4> a(batch), b(batch), out(batch);
+    for (int i = 0; i < batch; ++i)  { a[i] = RandomMatrix(rng); b[i] = RandomMatrix(rng); }
+
+    const int totalCalls = 1 << 20;
+    double scalarNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            for (int i = 0; i < batch; ++i)  out[i] = MatrixMultiplyScalar(a[i], b[i]);
+        gSink = gSink + out[batch - 1].e33;
+    }, totalCalls);
+
+    double simdNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            for (int i = 0; i < batch; ++i)  out[i] = a[i] * b[i];
+        gSink = gSink + out[batch - 1].e33;
+    }, totalCalls);
+
+    gResults.Add("Matrix * Matrix", batch, scalarNs, simdNs);
+}
+
+
+// Concatenate a node hierarchy into absolute matrices, the same work as Mesh::Render does each frame
+// Each multiply depends on an earlier one so this measures latency as well as throughput
+void BenchmarkHierarchy(int numNodes)
+{
+    std::mt19937 rng(2);
+    std::vector<CMatrix4x4> relative(numNodes), absolute(numNodes);
+    std::vector<unsigned int> parents(numNodes);
+    for (int i = 0; i < numNodes; ++i)
+    {
+        relative[i] = RandomMatrix(rng);
+        parents[i] = (i == 0) ? 0 : std::uniform_int_distribution<int>(std::max(0, i - 4), i - 1)(rng);
+    }
+
+    const int totalCalls = 1 << 20;
+    double scalarNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += numNodes)
+        {
+            absolute[0] = relative[0];
+            for (int i = 1; i < numNodes; ++i)  absolute[i] = MatrixMultiplyScalar(relative[i], absolute[parents[i]]);
+        }
+        gSink = gSink + absolute[numNodes - 1].e33;
+    }, totalCalls);
+
+    double simdNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += numNodes)
+        {
+            absolute[0] = relative[0];
+            for (int i = 1; i < numNodes; ++i)  absolute[i] = relative[i] * absolute[parents[i]];
+        }
+        gSink = gSink + absolute[numNodes - 1].e33;
+    }, totalCalls);
+
+    gResults.Add("Node hierarchy", numNodes, scalarNs, simdNs);
+}
+
+
+// Check the SIMD multiply gives the same results as the plain C++ version. Returns false on failure
+bool CheckMatrixMultiply()
+{
+    std::mt19937 rng(3);
+    float maxDiff = 0.0f;
+    for (int i = 0; i < 10000; ++i)
+    {
+        CMatrix4x4 a = RandomMatrix(rng);
+        CMatrix4x4 b = RandomMatrix(rng);
+        maxDiff = std::max(maxDiff, MaxDifference(a * b, MatrixMultiplyScalar(a, b)));
+
+        CMatrix4x4 c = a;
+        c *= b;
+        maxDiff = std::max(maxDiff, MaxDifference(c, MatrixMultiplyScalar(a, b)));
+        c = a;
+        c *= c;
+        maxDiff = std::max(maxDiff, MaxDifference(c, MatrixMultiplyScalar(a, a)));
+    }
+    printf("Matrix multiply max difference from scalar: %g\n", maxDiff);
+    return maxDiff < 1e-3f; // Matrices contain translations of up to ~100 so allow for rounding differences from FMA
+}
+
+
+//--------------------------------------------------------------------------------------
+// Affine matrices
+//--------------------------------------------------------------------------------------
+
+// Same as BenchmarkHierarchy but comparing 4x4 matrices (in the scalar column) with 3x4 affine matrices
+// (in the SIMD column). Both use SIMD if it is available
+void BenchmarkAffineHierarchy(int numNodes)
+{
+    std::mt19937 rng(2);
+    std::vector<CMatrix4x4> relative(numNodes), absolute(numNodes);
+    std::vector<CAffine3x4> relativeAffine(numNodes), absoluteAffine(numNodes);
+    std::vector<unsigned int> parents(numNodes);
+    for (int i = 0; i < numNodes; ++i)
+    {
+        relative[i] = RandomMatrix(rng);
+        relativeAffine[i] = CAffine3x4(relative[i]);
+        parents[i] = (i == 0) ? 0 : std::uniform_int_distribution<int>(std::max(0, i - 4), i - 1)(rng);
+    }
+
+    const int totalCalls = 1 << 20;
+    double matrixNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += numNodes)
+        {
+            absolute[0] = relative[0];
+            for (int i = 1; i < numNodes; ++i)  absolute[i] = relative[i] * absolute[parents[i]];
+        }
+        gSink = gSink + absolute[numNodes - 1].e32;
+    }, totalCalls);
+
+    double affineNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += numNodes)
+        {
+            absoluteAffine[0] = relativeAffine[0];
+            for (int i = 1; i < numNodes; ++i)  absoluteAffine[i] = relativeAffine[i] * absoluteAffine[parents[i]];
+        }
+        gSink = gSink + absoluteAffine[numNodes - 1].e32;
+    }, totalCalls);
+
+    gResults.Add("Hierarchy 4x4 vs 3x4", numNodes, matrixNs, affineNs);
+}
+
+
+// Check affine multiply and inverse against the 4x4 versions. Returns false on failure
+bool CheckAffine()
+{
+    std::mt19937 rng(7);
+    float maxDiff = 0.0f;
+    for (int i = 0; i < 10000; ++i)
+    {
+        CMatrix4x4 a = RandomMatrix(rng);
+        CMatrix4x4 b = RandomMatrix(rng);
+        CAffine3x4 affineA(a), affineB(b);
+        maxDiff = std::max(maxDiff, MaxDifference(affineA.ToMatrix4x4(), a));
+        maxDiff = std::max(maxDiff, MaxDifference((affineA * affineB).ToMatrix4x4(), MatrixMultiplyScalar(a, b)));
+        maxDiff = std::max(maxDiff, MaxDifference((affineA * InverseAffine(affineA)).ToMatrix4x4(), MatrixIdentity()));
+
+        // Transforms from matrices with zero scale on some axes must not contain NaNs and must give back the matrix
+        if (i < 100)
+        {
+            CVector3 scale = { 1.0f, 1.0f, 1.0f };
+            (&scale.x)[i % 3] = 0.0f;
+            if (i % 4 == 1)  (&scale.x)[(i + 1) % 3] = 1e-8f;
+            if (i % 4 == 2)  scale = { 0.0f, 0.0f, 0.0f };
+            CMatrix4x4 m = MatrixScaling(scale) * a;
+            CTransform transform{ CAffine3x4(m) };
+            const CQuaternion& q = transform.rotation;
+            if (!std::isfinite(q.x + q.y + q.z + q.w))  maxDiff = 1.0f;
+            maxDiff = std::max(maxDiff, MaxDifference(transform.GetAffineMatrix().ToMatrix4x4(), m));
+        }
+    }
+    printf("Affine matrix max difference from 4x4: %g\n", maxDiff);
+    return maxDiff < 1e-3f;
+}
+
+
+// Normal matrices for a batch of world matrices - one at a time (scalar column) against the batched version (SIMD column)
+void BenchmarkInverseTranspose(int batch)
+{
+    std::mt19937 rng(8);
+    std::vector<CAffine3x4> in(batch), out(batch);
+    for (int i = 0; i < batch; ++i)  in[i] = CAffine3x4(RandomMatrix(rng));
+
+    const int totalCalls = 1 << 20;
+    double singleNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            for (int i = 0; i < batch; ++i)  InverseTranspose3x3(&in[i], &out[i], nullptr, 1);
+        gSink = gSink + out[batch - 1].e00;
+    }, totalCalls);
+
+    double batchNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            InverseTranspose3x3(in.data(), out.data(), nullptr, batch);
+        gSink = gSink + out[batch - 1].e00;
+    }, totalCalls);
+
+    gResults.Add("InverseTranspose3x3", batch, singleNs, batchNs);
+}
+
+
+// Check general inverse and batched inverse transpose. Returns false on failure
+bool CheckInverse()
+{
+    std::mt19937 rng(9);
+    float maxDiff = 0.0f;
+    std::vector<CAffine3x4> in(13), out(13);
+    std::vector<float> determinants(13);
+    for (int i = 0; i < 1000; ++i)
+    {
+        // A view-projection style matrix (camera near the origin). Matrices mixing large translations with
+        // small rotation values lose precision in any float inverse so keep the translation modest here
+        std::uniform_real_distribution<float> angle(-PI, PI);
+        std::uniform_real_distribution<float> position(-5.0f, 5.0f);
+        CMatrix4x4 projection = CMatrix4x4{ 1.5f, 0, 0, 0,  0, 2, 0, 0,  0, 0, 1.001f, 1,  0, 0, -0.1f, 0 };
+        CMatrix4x4 m = MatrixRotationY(angle(rng)) * MatrixRotationX(angle(rng)) * MatrixTranslation({ position(rng), position(rng), position(rng) }) * projection;
+        maxDiff = std::max(maxDiff, MaxDifference(MatrixMultiplyScalar(m, Inverse(m)), MatrixIdentity()));
+
+        // Batch includes a singular matrix and a remainder after the groups of 4
+        for (auto& matrix : in)  matrix = CAffine3x4(RandomMatrix(rng));
+        in[5] = CAffine3x4(MatrixScaling(0.0f));
+        InverseTranspose3x3(in.data(), out.data(), determinants.data(), 13);
+        for (int j = 0; j < 13; ++j)
+        {
+            CMatrix4x4 expected = MatrixIdentity();
+            float determinant = 0.0f;
+            if (j != 5)
+            {
+                CMatrix4x4 rotationScale = in[j].ToMatrix4x4();
+                rotationScale.SetRow(3, { 0, 0, 0 });
+                expected = Inverse(rotationScale, &determinant);
+                expected.Transpose();
+            }
+            else
+            {
+                expected = CMatrix4x4{ 0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 0,  0, 0, 0, 1 };
+            }
+            maxDiff = std::max({ maxDiff, MaxDifference(out[j].ToMatrix4x4(), expected), std::abs(determinants[j] - determinant) });
+        }
+    }
+    printf("Inverse max difference: %g\n", maxDiff);
+    return maxDiff < 1e-3f;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Trigonometry
+//--------------------------------------------------------------------------------------
+
+// Sine/cosine and atan2 - precise tier (scalar column) against the fast polynomial tier (SIMD column)
+void BenchmarkTrig()
+{
+    const int count = 4096;
+    std::mt19937 rng(10);
+    std::uniform_real_distribution<float> angle(-PI, PI);
+    std::vector<float> angles(count), xs(count), ys(count);
+    for (int i = 0; i < count; ++i)
+    {
+        angles[i] = angle(rng);
+        SinCosPrecise(angles[i], ys[i], xs[i]);
+    }
+
+    const int totalCalls = 1 << 20;
+    auto timeSinCos = [&](void (*sinCos)(float, float&, float&))
+    {
+        return TimeNsPerCall([&](int calls)
+        {
+            float sum = 0.0f;
+            for (int c = 0; c < calls; c += count)
+                for (int i = 0; i < count; ++i)
+                {
+                    float s, co;
+                    sinCos(angles[i], s, co);
+                    sum += s + co;
+                }
+            gSink = gSink + sum;
+        }, totalCalls);
+    };
+    auto timeAtan2 = [&](float (*atan2Func)(float, float))
+    {
+        return TimeNsPerCall([&](int calls)
+        {
+            float sum = 0.0f;
+            for (int c = 0; c < calls; c += count)
+                for (int i = 0; i < count; ++i)  sum += atan2Func(ys[i], xs[i]);
+            gSink = gSink + sum;
+        }, totalCalls);
+    };
+
+    gResults.Add("SinCos precise / fast", count, timeSinCos(SinCosPrecise), timeSinCos(SinCosFast));
+    gResults.Add("Atan2 precise / fast", count, timeAtan2(Atan2Precise), timeAtan2(Atan2Fast));
+}
+
+
+// Measure the error of both trig tiers against double precision, and check the fast tier is within the limits
+// documented in MathTrig.h. Returns false on failure
+bool CheckTrig()
+{
+    struct Range { float maxAngle; float fastLimit; };
+    bool ok = true;
+    printf("%-22s %12s %12s\n", "SinCos |angle| <=", "Precise err", "Fast err");
+    for (Range range : { Range{ 2.0f * PI, 1e-7f }, Range{ 1000.0f, 1e-7f }, Range{ 100000.0f, 1e-6f },
+                        Range{ 1e10f, 1e-6f }, Range{ 1e30f, 1e-6f } })
+    {
+        double preciseErr = 0.0, fastErr = 0.0;
+        const int steps = 1000000;
+        for (int i = -steps; i <= steps; ++i)
+        {
+            float a = range.maxAngle * i / steps;
+            double exactS = std::sin(static_cast<double>(a)), exactC = std::cos(static_cast<double>(a));
+            float s, c;
+            SinCosPrecise(a, s, c);
+            preciseErr = std::max({ preciseErr, std::abs(s - exactS), std::abs(c - exactC) });
+            SinCosFast(a, s, c);
+            fastErr = std::max({ fastErr, std::abs(s - exactS), std::abs(c - exactC) });
+        }
+        printf("%-22g %12.3g %12.3g\n", range.maxAngle, preciseErr, fastErr);
+        ok = ok && fastErr < range.fastLimit;
+    }
+    float nanS, nanC;
+    SinCosFast(std::numeric_limits<float>::quiet_NaN(), nanS, nanC);
+    ok = ok && std::isnan(nanS) && std::isnan(nanC);
+
+    double preciseErr = 0.0, fastErr = 0.0;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    for (int i = 0; i < 1000000; ++i)
+    {
+        float y = coord(rng), x = coord(rng);
+        double exact = std::atan2(static_cast<double>(y), static_cast<double>(x));
+        preciseErr = std::max(preciseErr, std::abs(Atan2Precise(y, x) - exact));
+        fastErr    = std::max(fastErr,    std::abs(Atan2Fast(y, x)    - exact));
+    }
+    printf("%-22s %12.3g %12.3g\n", "Atan2", preciseErr, fastErr);
+    ok = ok && fastErr < 2e-6f && Atan2Fast(0, 0) == 0.0f;
+
+    // Euler angles must survive a round trip through a rotation matrix with whichever tier is selected
+    float eulerErr = 0.0f;
+    std::uniform_real_distribution<float> angle(-1.5f, 1.5f); // Avoid gimbal lock
+    for (int i = 0; i < 10000; ++i)
+    {
+        CVector3 angles = { angle(rng), 2.0f * angle(rng), 2.0f * angle(rng) };
+        CVector3 result = (MatrixRotationZ(angles.z) * MatrixRotationX(angles.x) * MatrixRotationY(angles.y)).GetEulerAngles();
+        eulerErr = std::max({ eulerErr, std::abs(result.x - angles.x), std::abs(result.y - angles.y), std::abs(result.z - angles.z) });
+    }
+    printf("Euler angle round trip max difference: %g\n\n", eulerErr);
+    return ok && eulerErr < 1e-3f;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Batch transforms
+//--------------------------------------------------------------------------------------
+
+// A vertex like those in a mesh vertex buffer - transforms read and write the position within it
+struct BenchmarkVertex
+{
+    CVector3 position;
+    CVector3 normal;
+    float    uv[2];
+};
+
+std::vector<BenchmarkVertex> RandomVertices(std::mt19937& rng, int count)
+{
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<BenchmarkVertex> vertices(count);
+    for (auto& v : vertices)
+    {
+        v.position = { coord(rng), coord(rng), coord(rng) };
+        v.normal = Normalise({ coord(rng), coord(rng), coord(rng) });
+    }
+    return vertices;
+}
+
+// The three batch transforms, and plain C++ reference versions of them. The references are not inlined so they are
+// timed as a library call, like the functions they are compared with. Their arrays are declared as not overlapping
+// (__restrict, supported by all the compilers used here) so the compiler can auto-vectorise the loops, making these
+// the best the plain C++ can do
+enum class TransformKind { Points, Normals, PointsProjective };
+
+const char* TransformName(TransformKind kind, bool soa)
+{
+    switch (kind)
+    {
+        case TransformKind::Points:  return soa ? "TransformPoints (SoA)"  : "TransformPoints (strided)";
+        case TransformKind::Normals: return soa ? "TransformNormals (SoA)" : "TransformNormals (strided)";
+        default:                     return soa ? "TransformProjective (SoA)" : "TransformProjective (strided)";
+    }
+}
+
+template <TransformKind Kind>
+CVector3 ReferenceTransform(const CVector3& v, const CMatrix4x4& m)
+{
+    if (Kind == TransformKind::Normals)  return TransformNormal(v, m);
+    CVector3 p = TransformPoint(v, m);
+    if (Kind == TransformKind::PointsProjective)  p = p * (1.0f / (v.x * m.e03 + v.y * m.e13 + v.z * m.e23 + m.e33));
+    return p;
+}
+
+template <TransformKind Kind>
+BENCHMARK_NOINLINE void ReferenceTransforms(const CMatrix4x4& m, const void* __restrict in, unsigned int inStride,
+                                            CVector3* __restrict out, unsigned int count)
+{
+    const unsigned char* source = static_cast<const unsigned char*>(in);
+    for (unsigned int i = 0; i < count; ++i)  out[i] = ReferenceTransform<Kind>(*reinterpret_cast<const CVector3*>(source + i * inStride), m);
+}
+
+template <TransformKind Kind>
+BENCHMARK_NOINLINE void ReferenceTransforms(const CMatrix4x4& m, const float* __restrict inX, const float* __restrict inY, const float* __restrict inZ,
+                                            float* __restrict outX, float* __restrict outY, float* __restrict outZ, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        CVector3 p = ReferenceTransform<Kind>({ inX[i], inY[i], inZ[i] }, m);
+        outX[i] = p.x;  outY[i] = p.y;  outZ[i] = p.z;
+    }
+}
+
+template <TransformKind Kind>
+void BatchTransforms(const CMatrix4x4& m, const void* in, unsigned int inStride, CVector3* out, unsigned int count)
+{
+    if      (Kind == TransformKind::Points)   TransformPoints(m, in, inStride, out, sizeof(CVector3), count);
+    else if (Kind == TransformKind::Normals)  TransformNormals(m, in, inStride, out, sizeof(CVector3), count);
+    else                                      TransformPointsProjective(m, in, inStride, out, sizeof(CVector3), count);
+}
+
+template <TransformKind Kind>
+void BatchTransforms(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                     float* outX, float* outY, float* outZ, unsigned int count)
+{
+    if      (Kind == TransformKind::Points)   TransformPoints(m, inX, inY, inZ, outX, outY, outZ, count);
+    else if (Kind == TransformKind::Normals)  TransformNormals(m, inX, inY, inZ, outX, outY, outZ, count);
+    else                                      TransformPointsProjective(m, inX, inY, inZ, outX, outY, outZ, count);
+}
+
+
+// Transform vertex positions out of a vertex buffer into a CVector3 array, plain C++ compared to the batch function
+template <TransformKind Kind>
+void BenchmarkTransformStrided(int batch)
+{
+    std::mt19937 rng(4);
+    CMatrix4x4 m = RandomMatrix(rng);
+    auto vertices = RandomVertices(rng, batch);
+    std::vector<CVector3> out(batch);
+
+    const int totalCalls = 1 << 22;
+    double scalarNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            ReferenceTransforms<Kind>(m, &vertices[0].position, sizeof(BenchmarkVertex), out.data(), batch);
+        gSink = gSink + out[batch - 1].x;
+    }, totalCalls);
+
+    double simdNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            BatchTransforms<Kind>(m, &vertices[0].position, sizeof(BenchmarkVertex), out.data(), batch);
+        gSink = gSink + out[batch - 1].x;
+    }, totalCalls);
+
+    gResults.Add(TransformName(Kind, false), batch, scalarNs, simdNs);
+}
+
+// Same as above for SoA data
+template <TransformKind Kind>
+void BenchmarkTransformSoA(int batch)
+{
+    std::mt19937 rng(5);
+    CMatrix4x4 m = RandomMatrix(rng);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<float> x(batch), y(batch), z(batch), outX(batch), outY(batch), outZ(batch);
+    for (int i = 0; i < batch; ++i)  { x[i] = coord(rng); y[i] = coord(rng); z[i] = coord(rng); }
+
+    const int totalCalls = 1 << 22;
+    double scalarNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            ReferenceTransforms<Kind>(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), batch);
+        gSink = gSink + outX[batch - 1];
+    }, totalCalls);
+
+    double simdNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            BatchTransforms<Kind>(m, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), batch);
+        gSink = gSink + outX[batch - 1];
+    }, totalCalls);
+
+    gResults.Add(TransformName(Kind, true), batch, scalarNs, simdNs);
+}
+
+template <TransformKind Kind>
+void BenchmarkTransforms(int batch)
+{
+    BenchmarkTransformStrided<Kind>(batch);
+    BenchmarkTransformSoA<Kind>(batch);
+}
+
+
+// Check the batch transforms against single vector transforms. Returns false on failure
+bool CheckBatchTransforms()
+{
+    std::mt19937 rng(6);
+    float maxDiff = 0.0f;
+    for (int count : { 1, 3, 4, 5, 7, 8, 13, 64, 65, 200 })
+    {
+        CMatrix4x4 m = RandomMatrix(rng);
+        CMatrix4x4 projection = m * CMatrix4x4{ 1.5f, 0, 0, 0,  0, 2, 0, 0,  0, 0, 1.001f, 1,  0, 0, -0.1f, 0 };
+        auto vertices = RandomVertices(rng, count);
+        std::vector<CVector3> points(count), normals(count), projected(count);
+        TransformPoints          (m,          &vertices[0].position, sizeof(BenchmarkVertex), points.data(),    sizeof(CVector3), count);
+        TransformNormals         (m,          &vertices[0].normal,   sizeof(BenchmarkVertex), normals.data(),   sizeof(CVector3), count);
+        TransformPointsProjective(projection, &vertices[0].position, sizeof(BenchmarkVertex), projected.data(), sizeof(CVector3), count);
+
+        for (int i = 0; i < count; ++i)
+        {
+            CVector3 p = TransformPoint(vertices[i].position, m);
+            CVector3 n = TransformNormal(vertices[i].normal, m);
+            CVector3 q = TransformPoint(vertices[i].position, projection);
+            float w = vertices[i].position.x * projection.e03 + vertices[i].position.y * projection.e13 +
+                      vertices[i].position.z * projection.e23 + projection.e33;
+            q = q * (1.0f / w);
+            maxDiff = std::max({ maxDiff, Length(p - points[i]), Length(n - normals[i]), Length(q - projected[i]) });
+        }
+
+        // In-place transform of a tightly packed array
+        std::vector<CVector3> inPlace(count);
+        for (int i = 0; i < count; ++i)  inPlace[i] = vertices[i].position;
+        TransformPoints(m, inPlace.data(), inPlace.data(), count);
+        for (int i = 0; i < count; ++i)  maxDiff = std::max(maxDiff, Length(inPlace[i] - points[i]));
+
+        // In-place transform of positions in a vertex buffer - the normals after them must not change
+        auto vertexBuffer = vertices;
+        TransformPoints(m, &vertexBuffer[0].position, sizeof(BenchmarkVertex), &vertexBuffer[0].position, sizeof(BenchmarkVertex), count);
+        for (int i = 0; i < count; ++i)
+        {
+            maxDiff = std::max({ maxDiff, Length(vertexBuffer[i].position - points[i]), Length(vertexBuffer[i].normal - vertices[i].normal) });
+        }
+
+        // SoA arrays, starting at each offset from the SIMD alignment
+        for (int offset = 0; offset < 8; ++offset)
+        {
+            std::vector<float> x(count + offset), y(count + offset), z(count + offset), outX(count + offset), outY(count + offset), outZ(count + offset);
+            for (int i = 0; i < count; ++i)
+            {
+                x[i + offset] = vertices[i].position.x;  y[i + offset] = vertices[i].position.y;  z[i + offset] = vertices[i].position.z;
+            }
+            TransformPoints(m, &x[offset], &y[offset], &z[offset], &outX[offset], &outY[offset], &outZ[offset], count);
+            for (int i = 0; i < count; ++i)
+            {
+                maxDiff = std::max(maxDiff, Length(CVector3{ outX[i + offset], outY[i + offset], outZ[i + offset] } - points[i]));
+            }
+        }
+    }
+    printf("Batch transform max difference from single transforms: %g\n", maxDiff);
+    return maxDiff < 1e-3f;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Normalising
+//--------------------------------------------------------------------------------------
+
+// Normalise a batch of vectors with the given precision - one at a time (scalar column) against the batched SoA version (SIMD column)
+template <Precision P>
+void BenchmarkNormalise(const char* name, int batch)
+{
+    std::mt19937 rng(12);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<float> x(batch), y(batch), z(batch), outX(batch), outY(batch), outZ(batch);
+    for (int i = 0; i < batch; ++i)  { x[i] = coord(rng); y[i] = coord(rng); z[i] = coord(rng); }
+
+    const int totalCalls = 1 << 22;
+    double scalarNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+        {
+            for (int i = 0; i < batch; ++i)
+            {
+                CVector3 n = Normalise<P>(CVector3{ x[i], y[i], z[i] });
+                outX[i] = n.x;  outY[i] = n.y;  outZ[i] = n.z;
+            }
+        }
+        gSink = gSink + outX[batch - 1];
+    }, totalCalls);
+
+    double simdNs = TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            NormaliseVectors<P>(x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), batch);
+        gSink = gSink + outX[batch - 1];
+    }, totalCalls);
+
+    gResults.Add(name, batch, scalarNs, simdNs);
+}
+
+
+// Largest relative error in the lengths of normalised vectors and in batch lengths, for the given precision
+template <Precision P>
+double NormaliseError()
+{
+    const int count = 1003; // Not a multiple of 8 to test the remainder loop
+    std::mt19937 rng(13);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::vector<float> x(count), y(count), z(count), outX(count), outY(count), outZ(count), lengths(count);
+    for (int i = 0; i < count; ++i)  { x[i] = coord(rng); y[i] = coord(rng); z[i] = coord(rng); }
+    x[7] = y[7] = z[7] = 0.0f; // Zero vectors must give zero results
+
+    NormaliseVectors<P>(x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count);
+    VectorLengths<P>(x.data(), y.data(), z.data(), lengths.data(), count);
+
+    // Strided versions, tightly packed and with a fourth float after each vector that must not change
+    std::vector<CVector3> packed(count), packedOut(count);
+    std::vector<float> padded(count * 4), paddedOut(count * 4, 5.0f);
+    for (int i = 0; i < count; ++i)
+    {
+        packed[i] = { x[i], y[i], z[i] };
+        padded[i * 4] = x[i];  padded[i * 4 + 1] = y[i];  padded[i * 4 + 2] = z[i];
+    }
+    NormaliseVectors<P>(packed.data(), sizeof(CVector3), packedOut.data(), sizeof(CVector3), count);
+    NormaliseVectors<P>(padded.data(), 4 * sizeof(float), paddedOut.data(), 4 * sizeof(float), count);
+
+    double maxError = 0.0;
+    for (int i = 0; i < count; ++i)
+    {
+        double exactLength = std::sqrt(static_cast<double>(x[i]) * x[i] + static_cast<double>(y[i]) * y[i] + static_cast<double>(z[i]) * z[i]);
+        double normalLength = std::sqrt(static_cast<double>(outX[i]) * outX[i] + static_cast<double>(outY[i]) * outY[i] + static_cast<double>(outZ[i]) * outZ[i]);
+        CVector3 paddedResult = { paddedOut[i * 4], paddedOut[i * 4 + 1], paddedOut[i * 4 + 2] };
+        if (paddedOut[i * 4 + 3] != 5.0f || Length(paddedResult - CVector3{ outX[i], outY[i], outZ[i] }) > 1e-6f ||
+            Length(packedOut[i] - CVector3{ outX[i], outY[i], outZ[i] }) > 1e-6f)  return 1.0;
+        if (i == 7)
+        {
+            if (normalLength != 0.0 || lengths[i] != 0.0f)  return 1.0;
+            continue;
+        }
+        CVector3 single = Normalise<P>(CVector3{ x[i], y[i], z[i] });
+        double singleLength = std::sqrt(static_cast<double>(Dot(single, single)));
+        maxError = std::max({ maxError, std::abs(normalLength - 1.0), std::abs(singleLength - 1.0),
+                              std::abs(lengths[i] - exactLength) / exactLength,
+                              std::abs(Length<P>(CVector3{ x[i], y[i], z[i] }) - exactLength) / exactLength });
+    }
+    return maxError;
+}
+
+// Check each precision is within the limits documented in MathHelpers.h. Returns false on failure
+bool CheckNormalise()
+{
+    double exact = NormaliseError<Precision::Exact>();
+    double refined = NormaliseError<Precision::Refined>();
+    double raw = NormaliseError<Precision::Raw>();
+    printf("Normalise relative error - exact: %g, refined: %g, raw: %g\n", exact, refined, raw);
+#if defined(MATH_SSE)
+    return exact < 5e-7 && refined < 5e-7 && raw < 3.7e-4;
+#else
+    return exact < 5e-7 && refined < 5e-6 && raw < 1.8e-3;
+#endif
+}
+
+
+//--------------------------------------------------------------------------------------
+// Single operations
+//--------------------------------------------------------------------------------------
+
+// Time out[i] = func(i) for every element of the output array and return the time in nanoseconds per element
+template <class Out, class Func>
+double TimeEach(std::vector<Out>& out, Func func)
+{
+    const int batch = static_cast<int>(out.size());
+    const int totalCalls = 1 << 20;
+    return TimeNsPerCall([&](int calls)
+    {
+        for (int c = 0; c < calls; c += batch)
+            for (int i = 0; i < batch; ++i)  out[i] = func(i);
+        gSink = gSink + reinterpret_cast<const float&>(out[batch - 1]); // All the maths types start with a float
+    }, totalCalls);
+}
+
+
+// Inverse of world matrices - general 4x4 inverse (scalar column) against InverseAffine (SIMD column),
+// then InverseAffine on 4x4 matrices (scalar column) against 3x4 affine matrices (SIMD column)
+void BenchmarkInverseAffine(int batch)
+{
+    std::mt19937 rng(14);
+    std::vector<CMatrix4x4> in(batch), out(batch);
+    std::vector<CAffine3x4> affineIn(batch), affineOut(batch);
+    for (int i = 0; i < batch; ++i)  { in[i] = RandomMatrix(rng);  affineIn[i] = CAffine3x4(in[i]); }
+
+    double generalNs = TimeEach(out, [&](int i) { return Inverse(in[i]); });
+    double affineNs  = TimeEach(out, [&](int i) { return InverseAffine(in[i]); });
+    gResults.Add("Inverse / InverseAffine", batch, generalNs, affineNs);
+
+    double affine3x4Ns = TimeEach(affineOut, [&](int i) { return InverseAffine(affineIn[i]); });
+    gResults.Add("InverseAffine 4x4 / 3x4", batch, affineNs, affine3x4Ns);
+}
+
+
+// Euler angles from rotation matrices and quaternions
+void BenchmarkEulerAngles(int batch)
+{
+    std::mt19937 rng(15);
+    std::vector<CMatrix4x4> matrices(batch);
+    std::vector<CQuaternion> quaternions(batch);
+    std::vector<CVector3> out(batch);
+    for (int i = 0; i < batch; ++i)
+    {
+        matrices[i] = RandomMatrix(rng);
+        quaternions[i] = QuaternionFromEulerAngles(matrices[i].GetEulerAngles());
+    }
+
+    gResults.Add("GetEulerAngles (matrix)",     batch, -1.0, TimeEach(out, [&](int i) { return matrices[i].GetEulerAngles(); }));
+    gResults.Add("GetEulerAngles (quaternion)", batch, -1.0, TimeEach(out, [&](int i) { return GetEulerAngles(quaternions[i]); }));
+}
+
+
+// Turn model matrices to face target points - exact precision (scalar column) against refined (SIMD column)
+void BenchmarkFaceTarget(int batch)
+{
+    std::mt19937 rng(16);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::vector<CMatrix4x4> in(batch), out(batch);
+    std::vector<CVector3> targets(batch);
+    for (int i = 0; i < batch; ++i)  { in[i] = RandomMatrix(rng);  targets[i] = { coord(rng), coord(rng), coord(rng) }; }
+
+    double exactNs = TimeEach(out, [&](int i)
+    {
+        CMatrix4x4 m = in[i];
+        m.FaceTarget(targets[i]);
+        return m;
+    });
+    double refinedNs = TimeEach(out, [&](int i)
+    {
+        CMatrix4x4 m = in[i];
+        m.FaceTarget<Precision::Refined>(targets[i]);
+        return m;
+    });
+    gResults.Add("FaceTarget exact vs refined", batch, exactNs, refinedNs);
+}
+
+
+// Cross products of pairs of vectors
+void BenchmarkCross(int batch)
+{
+    std::mt19937 rng(17);
+    std::uniform_real_distribution<float> coord(-10.0f, 10.0f);
+    std::vector<CVector3> a(batch), b(batch), out(batch);
+    for (int i = 0; i < batch; ++i)  { a[i] = { coord(rng), coord(rng), coord(rng) };  b[i] = { coord(rng), coord(rng), coord(rng) }; }
+
+    gResults.Add("Cross", batch, -1.0, TimeEach(out, [&](int i) { return Cross(a[i], b[i]); }));
+}
+
+
+// Rotation matrix and quaternion factory functions
+void BenchmarkRotations(int batch)
+{
+    std::mt19937 rng(18);
+    std::uniform_real_distribution<float> angle(-PI, PI);
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+    std::vector<float> angles(batch);
+    std::vector<CVector3> axes(batch), eulerAngles(batch);
+    std::vector<CQuaternion> quaternions(batch), quaternionOut(batch);
+    std::vector<CMatrix4x4> matrixOut(batch);
+    for (int i = 0; i < batch; ++i)
+    {
+        angles[i] = angle(rng);
+        axes[i] = Normalise(CVector3{ coord(rng), coord(rng), coord(rng) });
+        eulerAngles[i] = { angle(rng), angle(rng), angle(rng) };
+        quaternions[i] = QuaternionFromEulerAngles(eulerAngles[i]);
+    }
+
+    gResults.Add("MatrixRotationX",             batch, -1.0, TimeEach(matrixOut,     [&](int i) { return MatrixRotationX(angles[i]); }));
+    gResults.Add("MatrixRotationY",             batch, -1.0, TimeEach(matrixOut,     [&](int i) { return MatrixRotationY(angles[i]); }));
+    gResults.Add("MatrixRotationZ",             batch, -1.0, TimeEach(matrixOut,     [&](int i) { return MatrixRotationZ(angles[i]); }));
+    gResults.Add("MatrixRotation (quaternion)", batch, -1.0, TimeEach(matrixOut,     [&](int i) { return MatrixRotation(quaternions[i]); }));
+    gResults.Add("QuaternionRotationAxis",      batch, -1.0, TimeEach(quaternionOut, [&](int i) { return QuaternionRotationAxis(axes[i], angles[i]); }));
+    gResults.Add("QuaternionFromEulerAngles",   batch, -1.0, TimeEach(quaternionOut, [&](int i) { return QuaternionFromEulerAngles(eulerAngles[i]); }));
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point
+//--------------------------------------------------------------------------------------
+
+// Benchmarks are run in groups, which can be selected with --filter
+struct BenchmarkGroup
+{
+    const char* name;
+    void (*run)();
+};
+
+const BenchmarkGroup gGroups[] =
+{
+    { "multiply",   [] { for (int batch : { 1, 16, 256, 4096 })  BenchmarkMatrixMultiply(batch); } },
+    { "hierarchy",  [] { for (int nodes : { 16, 64, 256, 1024 }) BenchmarkHierarchy(nodes);
+                         for (int nodes : { 16, 64, 256, 1024 }) BenchmarkAffineHierarchy(nodes); } },
+    { "inverse",    [] { for (int batch : { 16, 256, 4096 })     BenchmarkInverseAffine(batch);
+                         for (int batch : { 16, 256, 4096 })     BenchmarkInverseTranspose(batch); } },
+    { "euler",      [] { for (int batch : { 16, 256, 4096 })     BenchmarkEulerAngles(batch); } },
+    { "facetarget", [] { for (int batch : { 16, 256, 4096 })     BenchmarkFaceTarget(batch); } },
+    { "cross",      [] { for (int batch : { 16, 256, 4096 })     BenchmarkCross(batch); } },
+    { "rotation",   [] { for (int batch : { 16, 256, 4096 })     BenchmarkRotations(batch); } },
+    { "trig",       [] { BenchmarkTrig(); } },
+    { "transform",  [] { for (int batch : { 16, 256, 4096 })     BenchmarkTransforms<TransformKind::Points>(batch);
+                         for (int batch : { 16, 256, 4096 })     BenchmarkTransforms<TransformKind::Normals>(batch);
+                         for (int batch : { 16, 256, 4096 })     BenchmarkTransforms<TransformKind::PointsProjective>(batch); } },
+    { "normalise",  [] { for (int batch : { 16, 256, 4096 })
+                         {
+                             BenchmarkNormalise<Precision::Exact>("Normalise exact (SoA)", batch);
+                             BenchmarkNormalise<Precision::Refined>("Normalise refined (SoA)", batch);
+                             BenchmarkNormalise<Precision::Raw>("Normalise raw (SoA)", batch);
+                         } } },
+};
+
+
+void PrintUsage()
+{
+    printf("Usage: math_benchmark [options]\n"
+           "  --json <file>         save results as JSON\n"
+           "  --csv <file>          save results as CSV\n"
+           "  --compare <file>      compare results against a baseline saved with --json or --csv,\n"
+           "                        exit code 2 if any timing is slower by more than the threshold\n"
+           "  --threshold <percent> allowed slowdown for --compare (default 10)\n"
+           "  --repeats <n>         times to repeat each benchmark, the fastest is used (default 9)\n"
+           "  --filter <groups>     comma separated list of groups to run (default all):\n"
+           "                       ");
+    for (const BenchmarkGroup& group : gGroups)  printf(" %s", group.name);
+    printf("\n");
+}
+
+
+// Exit codes: 0 success, 1 results do not match the reference versions, 2 regression against baseline, 3 bad arguments or files
+int main(int argc, char* argv[])
+{
+    std::string jsonFile, csvFile, compareFile, filter;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if      (arg == "--json"      && value)  { jsonFile = value;  ++i; }
+        else if (arg == "--csv"       && value)  { csvFile = value;  ++i; }
+        else if (arg == "--compare"   && value)  { compareFile = value;  ++i; }
+        else if (arg == "--threshold" && value)  { threshold = atof(value);  ++i; }
+        else if (arg == "--repeats"   && value)  { gRepeats = std::max(1, atoi(value));  ++i; }
+        else if (arg == "--filter"    && value)  { filter = "," + std::string(value) + ",";  ++i; }
+        else
+        {
+            PrintUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 3;
+        }
+    }
+
+    // Load the baseline first so a bad file name is reported before spending time on the benchmarks
+    BenchmarkResults baseline;
+    if (!compareFile.empty() && !baseline.Load(compareFile))
+    {
+        printf("FAILED: cannot read benchmark results from %s\n", compareFile.c_str());
+        return 3;
+    }
+
+#if defined(MATH_FAST_TRIG)
+    std::string configuration = std::string(MathSIMDName()) + ", fast trig";
+#else
+    std::string configuration = MathSIMDName();
+#endif
+    printf("Maths library compiled for: %s\n\n", configuration.c_str());
+
+    if (!CheckMatrixMultiply() || !CheckAffine() || !CheckInverse() || !CheckBatchTransforms())
+    {
+        printf("FAILED: SIMD results do not match scalar results\n");
+        return 1;
+    }
+    if (!CheckNormalise())
+    {
+        printf("FAILED: normalise results outside their documented accuracy\n");
+        return 1;
+    }
+    if (!CheckTrig())
+    {
+        printf("FAILED: fast trig functions outside their documented accuracy\n");
+        return 1;
+    }
+
+    printf("\n");
+    BenchmarkResults::PrintHeader();
+    for (const BenchmarkGroup& group : gGroups)
+    {
+        if (filter.empty() || filter.find("," + std::string(group.name) + ",") != std::string::npos)  group.run();
+    }
+
+    if (!jsonFile.empty() && !gResults.SaveJSON(jsonFile, configuration))
+    {
+        printf("FAILED: cannot write %s\n", jsonFile.c_str());
+        return 3;
+    }
+    if (!csvFile.empty() && !gResults.SaveCSV(csvFile))
+    {
+        printf("FAILED: cannot write %s\n", csvFile.c_str());
+        return 3;
+    }
+
+    if (!compareFile.empty())
+    {
+        printf("\nComparing with %s\n", compareFile.c_str());
+        if (!baseline.Configuration().empty() && baseline.Configuration() != configuration)
+        {
+            printf("Warning: baseline was compiled for %s\n", baseline.Configuration().c_str());
+        }
+        if (gResults.Compare(baseline, threshold) > 0)
+        {
+            printf("FAILED: performance regression\n");
+            return 2;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,667 @@
+//--------------------------------------------------------------------------------------
+// Benchmark for the mesh import code that doesn't need assimp
+//--------------------------------------------------------------------------------------
+// Console program, not part of the lab apps. Times the node lookups done when importing a skinned mesh on
+// synthetic rigs of up to 5000 nodes (the size of a detailed motion capture character): finding each bone's
+// node by name, and finding the node holding each sub-mesh. The reference versions (the "scalar" column) are
+// the searches the importer used to do, the optimised versions use MeshNodes.h. Also times the vertex cache
+// optimisation (MeshOptimise.h) and reports the simulated vertex shader work it saves, and cluster culling
+// (MeshClusters.h) against a brute force test of every triangle, checking no visible triangle is culled, and
+// interleaving vertices with a compile-time layout (VertexLayout.h) against a run-time one. Built as the mesh_benchmark
+// target of the engine core CMake build (see EngineCore/CMakeLists.txt), e.g.
+//     cmake -S EngineCore -B build && cmake --build build && build/mesh_benchmark
+// Takes the same options as math_benchmark to save results and compare against a baseline (see BenchmarkResults.h)
+
+#include "MeshData.h"
+#include "MeshClusters.h"
+#include "MeshNodes.h"
+#include "MeshOptimise.h"
+#include "VertexLayout.h"
+#include "BenchmarkResults.h"
+#include "CMatrix4x4.h"
+#include "CVector2.h"
+#include "CVector3.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+
+// Results are added into this so the optimiser cannot remove the work being timed
+volatile unsigned int gSink = 0;
+
+// Timings from all the benchmarks that have been run
+BenchmarkResults gResults;
+
+// Number of times each benchmark is repeated, the fastest time is used
+int gRepeats = 9;
+
+// Set if an optimised version gives different results from its reference version
+bool gMismatch = false;
+
+// Vertex cache simulation results, printed after the timings
+struct CacheReport
+{
+    int              numTriangles;
+    VertexCacheStats fifoBefore, fifoAfter;
+    VertexCacheStats lruBefore,  lruAfter;
+};
+std::vector<CacheReport> gCacheReports;
+
+// Cluster culling results, printed after the timings. Totals over all the test cameras
+struct ClusterReport
+{
+    int      numTriangles;
+    uint32_t numClusters;
+    uint64_t clustersTested, frustumCulled, backfaceCulled, drawCalls;
+    uint64_t trianglesDrawn, trianglesVisible; // Drawn after cluster culling, and visible by the per-triangle test
+};
+std::vector<ClusterReport> gClusterReports;
+
+
+// Time a function over several repeats and return the fastest time in nanoseconds per item. The function
+// does all its work in one call, processing the given number of items
+template <class Func>
+double TimeNsPerItem(Func func, int items)
+{
+    double best = 1e30;
+    for (int r = 0; r < gRepeats; ++r)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        auto end = std::chrono::high_resolution_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - start).count() / items;
+        if (ns < best)  best = ns;
+    }
+    return best;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Synthetic rig
+//--------------------------------------------------------------------------------------
+
+// A skinned mesh's node hierarchy and the names of the bones in its sub-meshes, as the importer sees them
+struct Rig
+{
+    std::vector<NodeData>    nodes;
+    std::vector<std::string> boneNames; // Every node is used as a bone once, in shuffled order
+    size_t                   numSubMeshes;
+};
+
+// Build a rig with the given number of nodes. Nodes form chains of up to 8 (like limbs and fingers) branching
+// from earlier nodes, and names share a long prefix as exported rigs do, which makes string comparison slower
+Rig BuildRig(unsigned int numNodes, size_t numSubMeshes)
+{
+    std::mt19937 rng(numNodes);
+    Rig rig;
+    rig.numSubMeshes = numSubMeshes;
+    rig.nodes.resize(numNodes);
+    for (unsigned int i = 0; i < numNodes; ++i)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "Character1_Skeleton:Bone%05u", i);
+        rig.nodes[i].name = name;
+        rig.nodes[i].parentIndex = (i == 0) ? 0 : (i % 8 != 0) ? i - 1 : std::uniform_int_distribution<unsigned int>(0, i - 1)(rng);
+        if (i != 0)  rig.nodes[rig.nodes[i].parentIndex].childNodes.push_back(i);
+    }
+    for (size_t m = 0; m < numSubMeshes; ++m)
+    {
+        rig.nodes[std::uniform_int_distribution<unsigned int>(0, numNodes - 1)(rng)].subMeshes.push_back(static_cast<unsigned int>(m));
+    }
+
+    for (auto& node : rig.nodes)  rig.boneNames.push_back(node.name);
+    std::shuffle(rig.boneNames.begin(), rig.boneNames.end(), rng);
+    return rig;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Node lookup
+//--------------------------------------------------------------------------------------
+
+// Find the node for every bone by name: searching the node list for each bone against building the name index
+// once and looking each bone up in it. The index build time is included
+void BenchmarkBoneBinding(unsigned int numNodes)
+{
+    Rig rig = BuildRig(numNodes, 64);
+    std::vector<unsigned int> searched(rig.boneNames.size()), indexed(rig.boneNames.size());
+    int numBones = static_cast<int>(rig.boneNames.size());
+
+    double searchNs = TimeNsPerItem([&]()
+    {
+        for (size_t b = 0; b < rig.boneNames.size(); ++b)
+        {
+            unsigned int nodeIndex;
+            for (nodeIndex = 0; nodeIndex < rig.nodes.size(); ++nodeIndex)
+            {
+                if (rig.nodes[nodeIndex].name == rig.boneNames[b])  break;
+            }
+            searched[b] = nodeIndex;
+        }
+        gSink = gSink + searched.back();
+    }, numBones);
+
+    double indexNs = TimeNsPerItem([&]()
+    {
+        NodeNameIndex nodeNames = BuildNodeNameIndex(rig.nodes);
+        for (size_t b = 0; b < rig.boneNames.size(); ++b)  indexed[b] = FindNode(nodeNames, rig.boneNames[b]);
+        gSink = gSink + indexed.back();
+    }, numBones);
+
+    if (searched != indexed)  gMismatch = true;
+    gResults.Add("Bone binding (per bone)", numNodes, searchNs, indexNs);
+}
+
+
+// Look up nodes by name in a mesh that is already loaded (Mesh::FindNode), without the index build time
+void BenchmarkFindNode(unsigned int numNodes)
+{
+    Rig rig = BuildRig(numNodes, 64);
+    NodeNameIndex nodeNames = BuildNodeNameIndex(rig.nodes);
+    int numLookups = static_cast<int>(rig.boneNames.size());
+
+    double searchNs = TimeNsPerItem([&]()
+    {
+        unsigned int total = 0;
+        for (auto& name : rig.boneNames)
+        {
+            auto node = std::find_if(rig.nodes.begin(), rig.nodes.end(), [&](const NodeData& n) { return n.name == name; });
+            total += static_cast<unsigned int>(node - rig.nodes.begin());
+        }
+        gSink = gSink + total;
+    }, numLookups);
+
+    double indexNs = TimeNsPerItem([&]()
+    {
+        unsigned int total = 0;
+        for (auto& name : rig.boneNames)  total += FindNode(nodeNames, name);
+        gSink = gSink + total;
+    }, numLookups);
+
+    gResults.Add("FindNode", numNodes, searchNs, indexNs);
+}
+
+
+// Find the node holding each sub-mesh: searching every node's sub-mesh list for each sub-mesh against one pass
+void BenchmarkSubMeshNodes(unsigned int numNodes)
+{
+    const size_t numSubMeshes = 256;
+    Rig rig = BuildRig(numNodes, numSubMeshes);
+    std::vector<unsigned int> searched(numSubMeshes), onePass;
+
+    double searchNs = TimeNsPerItem([&]()
+    {
+        for (size_t m = 0; m < numSubMeshes; ++m)
+        {
+            unsigned int subMeshNode = 0;
+            for (unsigned int nodeIndex = 0; nodeIndex < rig.nodes.size(); ++nodeIndex)
+            {
+                for (auto& subMeshIndex : rig.nodes[nodeIndex].subMeshes)
+                {
+                    if (subMeshIndex == m)  subMeshNode = nodeIndex;
+                }
+            }
+            searched[m] = subMeshNode;
+        }
+        gSink = gSink + searched.back();
+    }, static_cast<int>(numSubMeshes));
+
+    double onePassNs = TimeNsPerItem([&]()
+    {
+        onePass = FindSubMeshNodes(rig.nodes, numSubMeshes);
+        gSink = gSink + onePass.back();
+    }, static_cast<int>(numSubMeshes));
+
+    if (searched != onePass)  gMismatch = true;
+    gResults.Add("Sub-mesh nodes (per sub-mesh)", numNodes, searchNs, onePassNs);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Vertex cache optimisation
+//--------------------------------------------------------------------------------------
+
+// A regular grid of quads, two triangles each, with shared vertices. The triangles are shuffled, as a mesh
+// exported without any cache optimisation can be. Returns the indices
+std::vector<uint32_t> BuildGrid(uint32_t quadsPerSide)
+{
+    uint32_t verticesPerSide = quadsPerSide + 1;
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < quadsPerSide; ++y)
+    {
+        for (uint32_t x = 0; x < quadsPerSide; ++x)
+        {
+            uint32_t v = y * verticesPerSide + x;
+            indices.insert(indices.end(), { v, v + verticesPerSide, v + 1,  v + 1, v + verticesPerSide, v + verticesPerSide + 1 });
+        }
+    }
+
+    std::mt19937 rng(quadsPerSide);
+    uint32_t numTriangles = static_cast<uint32_t>(indices.size() / 3);
+    for (uint32_t t = numTriangles - 1; t > 0; --t)
+    {
+        uint32_t other = std::uniform_int_distribution<uint32_t>(0, t)(rng);
+        std::swap_ranges(&indices[t * 3], &indices[t * 3 + 3], &indices[other * 3]);
+    }
+    return indices;
+}
+
+// Return the triangles of a list in a canonical form (each rotated to start with its lowest index, then sorted)
+// to check a reordering kept every triangle and its winding
+std::vector<uint32_t> CanonicalTriangles(const std::vector<uint32_t>& indices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> tri = { indices[i], indices[i + 1], indices[i + 2] };
+        std::rotate(tri.begin(), std::min_element(tri.begin(), tri.end()), tri.end());
+        triangles.push_back(tri);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    std::vector<uint32_t> result;
+    for (auto& tri : triangles)  result.insert(result.end(), tri.begin(), tri.end());
+    return result;
+}
+
+// Time the vertex cache optimisation of a shuffled grid and report the ACMR and ATVR (see MeshOptimise.h) before
+// and after with both simulated cache types. A mismatch if any triangle changes or the ACMR does not improve
+void BenchmarkVertexCache(uint32_t quadsPerSide)
+{
+    std::vector<uint32_t> input = BuildGrid(quadsPerSide), optimised;
+    uint32_t numIndices = static_cast<uint32_t>(input.size());
+    uint32_t numVertices = (quadsPerSide + 1) * (quadsPerSide + 1);
+    int numTriangles = static_cast<int>(numIndices / 3);
+
+    double optimiseNs = TimeNsPerItem([&]()
+    {
+        optimised = input;
+        OptimiseVertexCache(optimised.data(), numIndices, numVertices);
+        gSink = gSink + optimised[0];
+    }, numTriangles);
+    gResults.Add("Vertex cache (per triangle)", numTriangles, -1, optimiseNs);
+
+    VertexCacheStats fifoBefore = SimulateVertexCache(input.data(),     numIndices, numVertices, REPORT_FIFO_CACHE_SIZE, VertexCacheType::FIFO);
+    VertexCacheStats fifoAfter  = SimulateVertexCache(optimised.data(), numIndices, numVertices, REPORT_FIFO_CACHE_SIZE, VertexCacheType::FIFO);
+    VertexCacheStats lruBefore  = SimulateVertexCache(input.data(),     numIndices, numVertices, REPORT_LRU_CACHE_SIZE,  VertexCacheType::LRU);
+    VertexCacheStats lruAfter   = SimulateVertexCache(optimised.data(), numIndices, numVertices, REPORT_LRU_CACHE_SIZE,  VertexCacheType::LRU);
+    gCacheReports.push_back({ numTriangles, fifoBefore, fifoAfter, lruBefore, lruAfter });
+
+    if (CanonicalTriangles(input) != CanonicalTriangles(optimised) ||
+        fifoAfter.ACMR() >= fifoBefore.ACMR() || lruAfter.ACMR() >= lruBefore.ACMR())  gMismatch = true;
+}
+
+// Print the cache simulation results from BenchmarkVertexCache after the timings
+void PrintCacheReports()
+{
+    if (gCacheReports.empty())  return;
+    printf("\nVertex cache simulation, ACMR (ATVR) before -> after optimisation\n");
+    printf("%10s  %-34s  %-34s\n", "Triangles", "FIFO 16", "LRU 32");
+    for (const CacheReport& report : gCacheReports)
+    {
+        printf("%10d  %6.3f (%5.3f) -> %6.3f (%5.3f)      %6.3f (%5.3f) -> %6.3f (%5.3f)\n", report.numTriangles,
+               report.fifoBefore.ACMR(), report.fifoBefore.ATVR(), report.fifoAfter.ACMR(), report.fifoAfter.ATVR(),
+               report.lruBefore.ACMR(),  report.lruBefore.ATVR(),  report.lruAfter.ACMR(),  report.lruAfter.ATVR());
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Cluster culling
+//--------------------------------------------------------------------------------------
+
+// A unit sphere of the given number of segments around and half that from pole to pole, with triangles facing out
+// in vertex cache order as they would be after import. Fills positions and returns the indices
+std::vector<uint32_t> BuildSphere(uint32_t segments, std::vector<CVector3>& positions)
+{
+    const float pi = 3.14159265f;
+    uint32_t rings = segments / 2;
+    positions.clear();
+    for (uint32_t r = 0; r <= rings; ++r)
+    {
+        float theta = pi * r / rings;
+        for (uint32_t s = 0; s <= segments; ++s)
+        {
+            float phi = 2 * pi * s / segments;
+            positions.push_back({ std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi) });
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    for (uint32_t r = 0; r < rings; ++r)
+    {
+        for (uint32_t s = 0; s < segments; ++s)
+        {
+            uint32_t v = r * (segments + 1) + s, below = v + segments + 1;
+            indices.insert(indices.end(), { v, v + 1, below,  v + 1, below + 1, below });
+        }
+    }
+    OptimiseVertexCache(indices.data(), static_cast<uint32_t>(indices.size()), static_cast<uint32_t>(positions.size()));
+    return indices;
+}
+
+// A camera looking from a position towards a target: its view-projection matrix (built the same way as the apps'
+// cameras) and position
+struct TestCamera
+{
+    CMatrix4x4 viewProjection;
+    CVector3   position;
+};
+
+TestCamera BuildCamera(const CVector3& position, const CVector3& target, float fovX, float nearClip, float farClip)
+{
+    CVector3 z = Normalise(target - position);
+    CVector3 x = Normalise(Cross({ 0, 1, 0 }, z));
+    CVector3 y = Cross(z, x);
+    CMatrix4x4 world = { x.x, x.y, x.z, 0,  y.x, y.y, y.z, 0,  z.x, z.y, z.z, 0,  position.x, position.y, position.z, 1 };
+
+    float scaleX = 1.0f / std::tan(fovX * 0.5f);
+    float scaleZa = farClip / (farClip - nearClip);
+    CMatrix4x4 projection = { scaleX, 0, 0, 0,  0, scaleX * 4 / 3, 0, 0,  0, 0, scaleZa, 1,  0, 0, -nearClip * scaleZa, 0 };
+    return { InverseAffine(world) * projection, position };
+}
+
+// Reference visibility of each triangle: front-facing and not entirely outside any frustum plane. Triangles within a
+// small margin of either test count as invisible, so rounding in the cluster tests is not reported as a mismatch.
+// Returns the number visible, and sets visible[t] for each
+uint32_t VisibleTriangles(const std::vector<uint32_t>& indices, const std::vector<CVector3>& positions,
+                          const FrustumPlanes& frustum, const CVector3& camera, std::vector<bool>& visible)
+{
+    const float margin = 1e-4f;
+    uint32_t numVisible = 0;
+    visible.assign(indices.size() / 3, false);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const CVector3& p0 = positions[indices[i]];
+        const CVector3& p1 = positions[indices[i + 1]];
+        const CVector3& p2 = positions[indices[i + 2]];
+        CVector3 normal = Cross(p1 - p0, p2 - p0);
+        float length = Length(normal);
+        if (length <= 0 || Dot(normal, camera - p0) <= margin * length * Length(camera - p0))  continue;
+
+        bool outside = false;
+        for (int plane = 0; plane < 6 && !outside; ++plane)
+        {
+            auto distance = [&](const CVector3& p) { return Dot(frustum.normal[plane], p) + frustum.d[plane]; };
+            outside = distance(p0) < -margin && distance(p1) < -margin && distance(p2) < -margin;
+        }
+        if (outside)  continue;
+        visible[i / 3] = true;
+        ++numVisible;
+    }
+    return numVisible;
+}
+
+// Time cluster culling of a sphere from a set of cameras around and inside it, against testing every triangle. A
+// mismatch if a cluster breaks the size limits, the clusters don't cover the triangles in order, or a culled
+// cluster holds a triangle the per-triangle test finds visible
+void BenchmarkClusterCulling(uint32_t segments)
+{
+    std::vector<CVector3> positions;
+    std::vector<uint32_t> indices = BuildSphere(segments, positions);
+    std::vector<MeshCluster> clusters;
+    BuildClusters(indices.data(), static_cast<uint32_t>(indices.size()), positions.data(), sizeof(CVector3), clusters);
+    int numTriangles = static_cast<int>(indices.size() / 3);
+
+    uint32_t nextIndex = 0;
+    for (auto& cluster : clusters)
+    {
+        std::vector<uint32_t> vertices(indices.begin() + cluster.startIndex, indices.begin() + cluster.startIndex + cluster.numIndices);
+        std::sort(vertices.begin(), vertices.end());
+        size_t numVertices = std::unique(vertices.begin(), vertices.end()) - vertices.begin();
+        if (cluster.startIndex != nextIndex || cluster.numIndices == 0 || numVertices > MAX_CLUSTER_VERTICES ||
+            cluster.numIndices / 3 > MAX_CLUSTER_TRIANGLES)  gMismatch = true;
+        nextIndex = cluster.startIndex + cluster.numIndices;
+    }
+    if (nextIndex != indices.size())  gMismatch = true;
+
+    // Cameras at random distances looking near the sphere, with a variety of fields of view and far clip distances
+    // so the frustum cuts through the sphere in different ways. A few are inside it, where everything is back-facing
+    std::mt19937 rng(segments);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<TestCamera> cameras;
+    for (int c = 0; c < 32; ++c)
+    {
+        CVector3 direction = Normalise(CVector3{ unit(rng), unit(rng), unit(rng) });
+        float distance = (c < 4) ? 0.5f : 1.5f + 2.5f * (unit(rng) + 1);
+        CVector3 target = { unit(rng) * 0.7f, unit(rng) * 0.7f, unit(rng) * 0.7f };
+        cameras.push_back(BuildCamera(direction * distance, target, 0.6f + 0.5f * (unit(rng) + 1), 0.1f, distance + 0.5f * (unit(rng) + 1)));
+    }
+
+    ClusterReport report = { numTriangles, static_cast<uint32_t>(clusters.size()), 0, 0, 0, 0, 0, 0 };
+    std::vector<bool> visible;
+    std::vector<IndexRange> ranges;
+    for (auto& camera : cameras)
+    {
+        ClusterCullStats stats;
+        CullClusters(clusters, camera.viewProjection, camera.position, true, ranges, &stats);
+        report.clustersTested += stats.numClusters;
+        report.frustumCulled  += stats.frustumCulled;
+        report.backfaceCulled += stats.backfaceCulled;
+        report.drawCalls      += stats.numRanges;
+        report.trianglesDrawn += stats.visibleTriangles;
+        report.trianglesVisible += VisibleTriangles(indices, positions, FrustumFromMatrix(camera.viewProjection), camera.position, visible);
+
+        // Every visible triangle must be in a drawn range
+        std::vector<bool> drawn(visible.size(), false);
+        for (auto& range : ranges)
+        {
+            for (uint32_t t = range.startIndex / 3; t < (range.startIndex + range.numIndices) / 3; ++t)  drawn[t] = true;
+        }
+        for (size_t t = 0; t < visible.size(); ++t)
+        {
+            if (visible[t] && !drawn[t])  gMismatch = true;
+        }
+    }
+    gClusterReports.push_back(report);
+
+    // Per triangle timings for all the cameras: testing each triangle, against culling clusters
+    int items = numTriangles * static_cast<int>(cameras.size());
+    double triangleNs = TimeNsPerItem([&]()
+    {
+        for (auto& camera : cameras)  gSink = gSink + VisibleTriangles(indices, positions, FrustumFromMatrix(camera.viewProjection), camera.position, visible);
+    }, items);
+    double clusterNs = TimeNsPerItem([&]()
+    {
+        for (auto& camera : cameras)
+        {
+            CullClusters(clusters, camera.viewProjection, camera.position, true, ranges);
+            gSink = gSink + static_cast<unsigned int>(ranges.size());
+        }
+    }, items);
+    gResults.Add("Cluster culling (per triangle)", numTriangles, triangleNs, clusterNs);
+}
+
+// Print the cluster culling results from BenchmarkClusterCulling after the timings
+void PrintClusterReports()
+{
+    if (gClusterReports.empty())  return;
+    printf("\nCluster culling, totals over all cameras\n");
+    printf("%10s %9s %14s %14s %14s %11s %13s\n", "Triangles", "Clusters", "Tris/cluster", "Frustum culled", "Back culled",
+           "Draw calls", "Drawn/visible");
+    for (const ClusterReport& report : gClusterReports)
+    {
+        printf("%10d %9u %14.1f %13.1f%% %13.1f%% %11.1f %12.2fx\n", report.numTriangles, report.numClusters,
+               static_cast<double>(report.numTriangles) / report.numClusters,
+               100.0 * report.frustumCulled / report.clustersTested, 100.0 * report.backfaceCulled / report.clustersTested,
+               static_cast<double>(report.drawCalls) * report.numClusters / report.clustersTested,
+               report.trianglesVisible > 0 ? static_cast<double>(report.trianglesDrawn) / report.trianglesVisible : 0.0);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Vertex interleaving
+//--------------------------------------------------------------------------------------
+
+using TangentVertexLayout = VertexLayout<VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>,
+                                         VertexAttribute<VertexSemantic::Normal,   VertexFormat::Float3, CVector3>,
+                                         VertexAttribute<VertexSemantic::Tangent,  VertexFormat::Float3, CVector3>,
+                                         VertexAttribute<VertexSemantic::UV,       VertexFormat::Float2, CVector2>>;
+
+// Interleave separate position, normal, tangent and UV arrays into vertices: with the layout built at run time, as the
+// apps' mesh classes used to, against the compile-time layout. A mismatch if the vertices or layouts differ
+void BenchmarkInterleave(uint32_t numVertices)
+{
+    std::mt19937 random(numVertices);
+    std::uniform_real_distribution<float> value(-1, 1);
+    std::vector<CVector3> positions(numVertices), normals(numVertices), tangents(numVertices);
+    std::vector<CVector2> uvs(numVertices);
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        positions[v] = { value(random), value(random), value(random) };
+        normals[v]   = { value(random), value(random), value(random) };
+        tangents[v]  = { value(random), value(random), value(random) };
+        uvs[v]       = { value(random), value(random) };
+    }
+
+    // Optional elements are decided at run time, so the reference can't be specialised for this layout
+    volatile bool hasTangents = true, hasUVs = true;
+    std::vector<VertexElement> layout;
+    uint32_t offset = 0;
+    layout.push_back({ VertexSemantic::Position, VertexFormat::Float3, offset });  offset += 12;
+    layout.push_back({ VertexSemantic::Normal,   VertexFormat::Float3, offset });  offset += 12;
+    if (hasTangents) { layout.push_back({ VertexSemantic::Tangent, VertexFormat::Float3, offset });  offset += 12; }
+    if (hasUVs)      { layout.push_back({ VertexSemantic::UV,      VertexFormat::Float2, offset });  offset += 8;  }
+    uint32_t vertexSize = offset;
+
+    auto runTime = std::make_unique<unsigned char[]>(numVertices * vertexSize);
+    double runTimeNs = TimeNsPerItem([&]()
+    {
+        unsigned char* vertex = runTime.get();
+        for (uint32_t v = 0; v < numVertices; ++v)
+        {
+            *(CVector3*)(vertex + layout[0].offset) = positions[v];
+            *(CVector3*)(vertex + layout[1].offset) = normals[v];
+            if (hasTangents)  *(CVector3*)(vertex + layout[2].offset) = tangents[v];
+            if (hasUVs)       *(CVector2*)(vertex + layout[3].offset) = uvs[v];
+            vertex += vertexSize;
+        }
+        gSink = gSink + runTime[numVertices * vertexSize - 1];
+    }, numVertices);
+
+    auto compileTime = std::make_unique<TangentVertexLayout::Vertex[]>(numVertices);
+    double compileTimeNs = TimeNsPerItem([&]()
+    {
+        TangentVertexLayout::Interleave(compileTime.get(), numVertices, positions.data(), normals.data(), tangents.data(), uvs.data());
+        gSink = gSink + static_cast<unsigned int>(compileTime[numVertices - 1].Get<VertexSemantic::UV>().y);
+    }, numVertices);
+
+    if (!TangentVertexLayout::Matches(layout.data(), layout.size(), vertexSize) ||
+        VertexLayoutKey(layout.data(), layout.size(), vertexSize) != TangentVertexLayout::Key ||
+        std::memcmp(runTime.get(), compileTime.get(), numVertices * vertexSize) != 0)  gMismatch = true;
+    gResults.Add("Interleave vertices (per vertex)", numVertices, runTimeNs, compileTimeNs);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Entry point
+//--------------------------------------------------------------------------------------
+
+// Benchmarks are run in groups, which can be selected with --filter
+struct BenchmarkGroup
+{
+    const char* name;
+    void (*run)();
+};
+
+const BenchmarkGroup gGroups[] =
+{
+    { "nodes", [] { for (unsigned int nodes : { 50, 500, 5000 })  BenchmarkBoneBinding(nodes);
+                    for (unsigned int nodes : { 50, 500, 5000 })  BenchmarkFindNode(nodes);
+                    for (unsigned int nodes : { 50, 500, 5000 })  BenchmarkSubMeshNodes(nodes); } },
+    { "vertexcache", [] { for (uint32_t quads : { 32, 128, 512 })  BenchmarkVertexCache(quads); } },
+    { "clusters",    [] { for (uint32_t segments : { 32, 128, 512 })  BenchmarkClusterCulling(segments); } },
+    { "interleave",  [] { for (uint32_t vertices : { 1000, 10000, 100000 })  BenchmarkInterleave(vertices); } },
+};
+
+
+void PrintUsage()
+{
+    printf("Usage: mesh_benchmark [options]\n"
+           "  --json <file>         save results as JSON\n"
+           "  --csv <file>          save results as CSV\n"
+           "  --compare <file>      compare results against a baseline saved with --json or --csv,\n"
+           "                        exit code 2 if any timing is slower by more than the threshold\n"
+           "  --threshold <percent> allowed slowdown for --compare (default 10)\n"
+           "  --repeats <n>         times to repeat each benchmark, the fastest is used (default 9)\n"
+           "  --filter <groups>     comma separated list of groups to run (default all):\n"
+           "                       ");
+    for (const BenchmarkGroup& group : gGroups)  printf(" %s", group.name);
+    printf("\n");
+}
+
+
+// Exit codes: 0 success, 1 results do not match the reference versions, 2 regression against baseline, 3 bad arguments or files
+int main(int argc, char* argv[])
+{
+    std::string jsonFile, csvFile, compareFile, filter;
+    double threshold = 10.0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if      (arg == "--json"      && value)  { jsonFile = value;  ++i; }
+        else if (arg == "--csv"       && value)  { csvFile = value;  ++i; }
+        else if (arg == "--compare"   && value)  { compareFile = value;  ++i; }
+        else if (arg == "--threshold" && value)  { threshold = atof(value);  ++i; }
+        else if (arg == "--repeats"   && value)  { gRepeats = std::max(1, atoi(value));  ++i; }
+        else if (arg == "--filter"    && value)  { filter = "," + std::string(value) + ",";  ++i; }
+        else
+        {
+            PrintUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 3;
+        }
+    }
+
+    BenchmarkResults baseline;
+    if (!compareFile.empty() && !baseline.Load(compareFile))
+    {
+        printf("FAILED: cannot read benchmark results from %s\n", compareFile.c_str());
+        return 3;
+    }
+
+    BenchmarkResults::PrintHeader();
+    for (const BenchmarkGroup& group : gGroups)
+    {
+        if (filter.empty() || filter.find("," + std::string(group.name) + ",") != std::string::npos)  group.run();
+    }
+    PrintCacheReports();
+    PrintClusterReports();
+    if (gMismatch)
+    {
+        printf("FAILED: optimised results do not match reference results\n");
+        return 1;
+    }
+
+    if (!jsonFile.empty() && !gResults.SaveJSON(jsonFile, "mesh"))
+    {
+        printf("FAILED: cannot write %s\n", jsonFile.c_str());
+        return 3;
+    }
+    if (!csvFile.empty() && !gResults.SaveCSV(csvFile))
+    {
+        printf("FAILED: cannot write %s\n", csvFile.c_str());
+        return 3;
+    }
+
+    if (!compareFile.empty())
+    {
+        printf("\nComparing with %s\n", compareFile.c_str());
+        if (gResults.Compare(baseline, threshold) > 0)
+        {
+            printf("FAILED: performance regression\n");
+            return 2;
+        }
+    }
+
+    return 0;
+}
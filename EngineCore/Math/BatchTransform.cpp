@@ -0,0 +1,569 @@
+//--------------------------------------------------------------------------------------
+// Transforming arrays of points and normals by a matrix, and normalising arrays of vectors
+//--------------------------------------------------------------------------------------
+// The SIMD code works on 4 or 8 vectors at once with their x, y and z values in separate registers. SoA data is
+// loaded that way directly, strided data is loaded in blocks of 4 vectors then transposed.
+
+#include "BatchTransform.h"
+#include "MathSIMD.h"
+
+#include <cstdint>
+
+
+// The three kinds of transform. Points have w = 1, normals have w = 0, projective points are divided by w after transformation
+enum class TransformType { Point, Normal, Projective };
+
+
+/*-----------------------------------------------------------------------------------------
+    Single vectors
+-----------------------------------------------------------------------------------------*/
+
+// Transform one vector with plain C++. Used for the remainders after the SIMD loops, or for everything without SIMD
+template <TransformType Type>
+static inline void TransformOne(const CMatrix4x4& m, float x, float y, float z, float& outX, float& outY, float& outZ)
+{
+    float rx = x * m.e00 + y * m.e10 + z * m.e20;
+    float ry = x * m.e01 + y * m.e11 + z * m.e21;
+    float rz = x * m.e02 + y * m.e12 + z * m.e22;
+    if (Type != TransformType::Normal)
+    {
+        rx += m.e30;
+        ry += m.e31;
+        rz += m.e32;
+    }
+    if (Type == TransformType::Projective)
+    {
+        float invW = 1.0f / (x * m.e03 + y * m.e13 + z * m.e23 + m.e33);
+        rx *= invW;
+        ry *= invW;
+        rz *= invW;
+    }
+    outX = rx;
+    outY = ry;
+    outZ = rz;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    SIMD helpers
+-----------------------------------------------------------------------------------------*/
+// The matrix elements are each copied into all the lanes of a register once, before the loop over the vectors
+
+#if defined(MATH_SSE)
+
+// a * b + c, fused if the target supports it
+static inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+{
+#if defined(MATH_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+
+// Matrix elements in all 4 lanes of a register, e[row][column]
+struct MatrixLanes4
+{
+    __m128 e[4][4];
+
+    explicit MatrixLanes4(const CMatrix4x4& m)
+    {
+        const float* elements = &m.e00;
+        for (int i = 0; i < 16; ++i)  e[i / 4][i % 4] = _mm_set1_ps(elements[i]);
+    }
+};
+
+// Transform 4 vectors held in x, y and z registers, results replace the inputs
+template <TransformType Type>
+static inline void Transform4(const MatrixLanes4& m, __m128& x, __m128& y, __m128& z)
+{
+    // Same order of operations as TransformOne, so results only differ by fused multiply-add rounding
+    __m128 rx = MulAdd(z, m.e[2][0], MulAdd(y, m.e[1][0], _mm_mul_ps(x, m.e[0][0])));
+    __m128 ry = MulAdd(z, m.e[2][1], MulAdd(y, m.e[1][1], _mm_mul_ps(x, m.e[0][1])));
+    __m128 rz = MulAdd(z, m.e[2][2], MulAdd(y, m.e[1][2], _mm_mul_ps(x, m.e[0][2])));
+    if (Type != TransformType::Normal)
+    {
+        rx = _mm_add_ps(rx, m.e[3][0]);
+        ry = _mm_add_ps(ry, m.e[3][1]);
+        rz = _mm_add_ps(rz, m.e[3][2]);
+    }
+    if (Type == TransformType::Projective)
+    {
+        __m128 rw = _mm_add_ps(MulAdd(z, m.e[2][3], MulAdd(y, m.e[1][3], _mm_mul_ps(x, m.e[0][3]))), m.e[3][3]);
+        __m128 invW = _mm_div_ps(_mm_set1_ps(1.0f), rw);
+        rx = _mm_mul_ps(rx, invW);
+        ry = _mm_mul_ps(ry, invW);
+        rz = _mm_mul_ps(rz, invW);
+    }
+    x = rx;
+    y = ry;
+    z = rz;
+}
+
+// Load 4 strided vectors into x, y and z registers. Tightly packed vectors (CVector3 arrays) are read with three loads
+// covering exactly the 4 vectors. Otherwise 4 floats are read from each vector and transposed, so there must be readable
+// memory for one float after the last vector - callers only do this when there is another vector after the block
+static inline void LoadStrided4(const unsigned char* source, unsigned int stride, __m128& x, __m128& y, __m128& z)
+{
+    if (stride == sizeof(CVector3))
+    {
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+        const float* v = reinterpret_cast<const float*>(source);
+        __m128 a = _mm_loadu_ps(v);
+        __m128 b = _mm_loadu_ps(v + 4);
+        __m128 c = _mm_loadu_ps(v + 8);
+        __m128 b2b3c0c1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128 a1a2b0b0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 2, 1));
+        __m128 b3b3c2c2 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+        __m128 a2a2b1b1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+        __m128 c0c0c3c3 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+        x = _mm_shuffle_ps(a, b2b3c0c1, _MM_SHUFFLE(3, 0, 3, 0));
+        y = _mm_shuffle_ps(a1a2b0b0, b3b3c2c2, _MM_SHUFFLE(2, 0, 2, 0));
+        z = _mm_shuffle_ps(a2a2b1b1, c0c0c3c3, _MM_SHUFFLE(2, 0, 2, 0));
+    }
+    else
+    {
+        __m128 v0 = _mm_loadu_ps(reinterpret_cast<const float*>(source));
+        __m128 v1 = _mm_loadu_ps(reinterpret_cast<const float*>(source + stride));
+        __m128 v2 = _mm_loadu_ps(reinterpret_cast<const float*>(source + stride * 2));
+        __m128 v3 = _mm_loadu_ps(reinterpret_cast<const float*>(source + stride * 3));
+        _MM_TRANSPOSE4_PS(v0, v1, v2, v3);
+        x = v0;
+        y = v1;
+        z = v2;
+    }
+}
+
+// Store 4 vectors from x, y and z registers to strided memory. Only x, y and z of each vector are written
+static inline void StoreStrided4(unsigned char* dest, unsigned int stride, __m128 x, __m128 y, __m128 z)
+{
+    if (stride == sizeof(CVector3))
+    {
+        // Reverse of the shuffles in LoadStrided4
+        float* v = reinterpret_cast<float*>(dest);
+        __m128 x0y0x1y1 = _mm_unpacklo_ps(x, y);
+        __m128 x2y2x3y3 = _mm_unpackhi_ps(x, y);
+        __m128 z0z0x1x1 = _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0));
+        __m128 y1y1z1z1 = _mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z2z3x3y3 = _mm_shuffle_ps(z, x2y2x3y3, _MM_SHUFFLE(3, 2, 3, 2));
+        _mm_storeu_ps(v,     _mm_shuffle_ps(x0y0x1y1, z0z0x1x1, _MM_SHUFFLE(2, 0, 1, 0)));
+        _mm_storeu_ps(v + 4, _mm_shuffle_ps(y1y1z1z1, x2y2x3y3, _MM_SHUFFLE(1, 0, 2, 0)));
+        _mm_storeu_ps(v + 8, _mm_shuffle_ps(z2z3x3y3, z2z3x3y3, _MM_SHUFFLE(1, 3, 2, 0)));
+    }
+    else
+    {
+        // Transpose back to one vector per register then write x,y and z - a fourth float may be other vertex data
+        __m128 w = z;
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        for (__m128 v : { x, y, z, w })
+        {
+            float* result = reinterpret_cast<float*>(dest);
+            _mm_storel_pi(reinterpret_cast<__m64*>(result), v);
+            _mm_store_ss(result + 2, _mm_movehl_ps(v, v));
+            dest += stride;
+        }
+    }
+}
+
+#endif // MATH_SSE
+
+#if defined(MATH_AVX)
+
+static inline __m256 MulAdd(__m256 a, __m256 b, __m256 c)
+{
+#if defined(MATH_FMA)
+    return _mm256_fmadd_ps(a, b, c);
+#else
+    return _mm256_add_ps(_mm256_mul_ps(a, b), c);
+#endif
+}
+
+// Matrix elements in all 8 lanes of a register, e[row][column]
+struct MatrixLanes8
+{
+    __m256 e[4][4];
+
+    explicit MatrixLanes8(const CMatrix4x4& m)
+    {
+        const float* elements = &m.e00;
+        for (int i = 0; i < 16; ++i)  e[i / 4][i % 4] = _mm256_set1_ps(elements[i]);
+    }
+};
+
+// Transform 8 vectors held in x, y and z registers, results replace the inputs
+template <TransformType Type>
+static inline void Transform8(const MatrixLanes8& m, __m256& x, __m256& y, __m256& z)
+{
+    // Same order of operations as TransformOne, so results only differ by fused multiply-add rounding
+    __m256 rx = MulAdd(z, m.e[2][0], MulAdd(y, m.e[1][0], _mm256_mul_ps(x, m.e[0][0])));
+    __m256 ry = MulAdd(z, m.e[2][1], MulAdd(y, m.e[1][1], _mm256_mul_ps(x, m.e[0][1])));
+    __m256 rz = MulAdd(z, m.e[2][2], MulAdd(y, m.e[1][2], _mm256_mul_ps(x, m.e[0][2])));
+    if (Type != TransformType::Normal)
+    {
+        rx = _mm256_add_ps(rx, m.e[3][0]);
+        ry = _mm256_add_ps(ry, m.e[3][1]);
+        rz = _mm256_add_ps(rz, m.e[3][2]);
+    }
+    if (Type == TransformType::Projective)
+    {
+        __m256 rw = _mm256_add_ps(MulAdd(z, m.e[2][3], MulAdd(y, m.e[1][3], _mm256_mul_ps(x, m.e[0][3]))), m.e[3][3]);
+        __m256 invW = _mm256_div_ps(_mm256_set1_ps(1.0f), rw);
+        rx = _mm256_mul_ps(rx, invW);
+        ry = _mm256_mul_ps(ry, invW);
+        rz = _mm256_mul_ps(rz, invW);
+    }
+    x = rx;
+    y = ry;
+    z = rz;
+}
+
+#endif // MATH_AVX
+
+
+/*-----------------------------------------------------------------------------------------
+    Kernels
+-----------------------------------------------------------------------------------------*/
+
+// Transform count vectors in SoA layout. If all the arrays have the same alignment (usual when they come from the same
+// allocator) and there are enough vectors, the first few are transformed singly so the main loop can use aligned loads
+// and stores. Each group of inputs is read before its outputs are written so in-place transforms are safe
+template <TransformType Type>
+static void TransformSoA(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                              float* outX, float* outY, float* outZ, unsigned int count)
+{
+    unsigned int i = 0;
+
+#if defined(MATH_SSE)
+#if defined(MATH_AVX)
+    const uintptr_t alignMask = 31;
+#else
+    const uintptr_t alignMask = 15;
+#endif
+    uintptr_t offset = reinterpret_cast<uintptr_t>(outX) & alignMask;
+    bool aligned = offset % sizeof(float) == 0 &&
+                   (reinterpret_cast<uintptr_t>(inX)  & alignMask) == offset && (reinterpret_cast<uintptr_t>(inY)  & alignMask) == offset &&
+                   (reinterpret_cast<uintptr_t>(inZ)  & alignMask) == offset && (reinterpret_cast<uintptr_t>(outY) & alignMask) == offset &&
+                   (reinterpret_cast<uintptr_t>(outZ) & alignMask) == offset;
+    if (aligned && offset != 0)
+    {
+        // Not worth transforming vectors singly to align small batches
+        aligned = count >= 64;
+        if (aligned)
+        {
+            unsigned int peel = static_cast<unsigned int>((alignMask + 1 - offset) / sizeof(float));
+            for (; i < peel; ++i)  TransformOne<Type>(m, inX[i], inY[i], inZ[i], outX[i], outY[i], outZ[i]);
+        }
+    }
+
+#if defined(MATH_AVX)
+    MatrixLanes8 lanes(m);
+    if (aligned)
+    {
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_load_ps(inX + i), y = _mm256_load_ps(inY + i), z = _mm256_load_ps(inZ + i);
+            Transform8<Type>(lanes, x, y, z);
+            _mm256_store_ps(outX + i, x);  _mm256_store_ps(outY + i, y);  _mm256_store_ps(outZ + i, z);
+        }
+    }
+    else
+    {
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(inX + i), y = _mm256_loadu_ps(inY + i), z = _mm256_loadu_ps(inZ + i);
+            Transform8<Type>(lanes, x, y, z);
+            _mm256_storeu_ps(outX + i, x);  _mm256_storeu_ps(outY + i, y);  _mm256_storeu_ps(outZ + i, z);
+        }
+    }
+#else
+    MatrixLanes4 lanes(m);
+    if (aligned)
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_load_ps(inX + i), y = _mm_load_ps(inY + i), z = _mm_load_ps(inZ + i);
+            Transform4<Type>(lanes, x, y, z);
+            _mm_store_ps(outX + i, x);  _mm_store_ps(outY + i, y);  _mm_store_ps(outZ + i, z);
+        }
+    }
+    else
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(inX + i), y = _mm_loadu_ps(inY + i), z = _mm_loadu_ps(inZ + i);
+            Transform4<Type>(lanes, x, y, z);
+            _mm_storeu_ps(outX + i, x);  _mm_storeu_ps(outY + i, y);  _mm_storeu_ps(outZ + i, z);
+        }
+    }
+#endif
+#endif
+
+    // Remainder (or everything if there is no SIMD support)
+    for (; i < count; ++i)  TransformOne<Type>(m, inX[i], inY[i], inZ[i], outX[i], outY[i], outZ[i]);
+}
+
+
+// Transform strided data, 4 vectors at a time with SIMD (see LoadStrided4 / StoreStrided4), then any remainder singly
+template <TransformType Type>
+static void TransformStrided(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count)
+{
+    const unsigned char* source = static_cast<const unsigned char*>(in);
+    unsigned char*       dest   = static_cast<unsigned char*>(out);
+    unsigned int i = 0;
+
+#if defined(MATH_SSE)
+    if (count > 4)
+    {
+        // Unless the input is tightly packed, a block needs another vector after it (see LoadStrided4)
+        unsigned int blockEnd = (inStride == sizeof(CVector3)) ? count : count - 1;
+        MatrixLanes4 lanes(m);
+        for (; i + 4 <= blockEnd; i += 4)
+        {
+            __m128 x, y, z;
+            LoadStrided4(source, inStride, x, y, z);
+            Transform4<Type>(lanes, x, y, z);
+            StoreStrided4(dest, outStride, x, y, z);
+            source += inStride  * 4;
+            dest   += outStride * 4;
+        }
+    }
+#endif
+
+    // Remainder (or everything if there is no SIMD support)
+    for (; i < count; ++i)
+    {
+        const float* v = reinterpret_cast<const float*>(source);
+        float* result  = reinterpret_cast<float*>(dest);
+        TransformOne<Type>(m, v[0], v[1], v[2], result[0], result[1], result[2]);
+        source += inStride;
+        dest   += outStride;
+    }
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Strided arrays
+-----------------------------------------------------------------------------------------*/
+
+// Transform count points (w = 1) read from in with inStride bytes between each, writing to out with outStride bytes between each
+void TransformPoints(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count)
+{
+    TransformStrided<TransformType::Point>(m, in, inStride, out, outStride, count);
+}
+
+// Transform count normals (w = 0) read from in with inStride bytes between each, writing to out with outStride bytes between each
+void TransformNormals(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count)
+{
+    TransformStrided<TransformType::Normal>(m, in, inStride, out, outStride, count);
+}
+
+// Transform count points (w = 1) by a projection matrix and divide by the resulting w
+void TransformPointsProjective(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count)
+{
+    TransformStrided<TransformType::Projective>(m, in, inStride, out, outStride, count);
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    SoA arrays
+-----------------------------------------------------------------------------------------*/
+
+void TransformPoints(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                          float* outX, float* outY, float* outZ, unsigned int count)
+{
+    TransformSoA<TransformType::Point>(m, inX, inY, inZ, outX, outY, outZ, count);
+}
+
+void TransformNormals(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                           float* outX, float* outY, float* outZ, unsigned int count)
+{
+    TransformSoA<TransformType::Normal>(m, inX, inY, inZ, outX, outY, outZ, count);
+}
+
+void TransformPointsProjective(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                                    float* outX, float* outY, float* outZ, unsigned int count)
+{
+    TransformSoA<TransformType::Projective>(m, inX, inY, inZ, outX, outY, outZ, count);
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Normalising
+-----------------------------------------------------------------------------------------*/
+
+// Inverse square roots of 4 or 8 values with the given precision, matching InvSqrt in MathHelpers.h
+#if defined(MATH_AVX)
+template <Precision P>
+static __m256 InvSqrt8(__m256 x)
+{
+    if (P == Precision::Exact)  return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(x));
+    __m256 estimate = _mm256_rsqrt_ps(x);
+    if (P == Precision::Raw)  return estimate;
+    __m256 halfXEstimateSq = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), x), _mm256_mul_ps(estimate, estimate));
+    return _mm256_mul_ps(estimate, _mm256_sub_ps(_mm256_set1_ps(1.5f), halfXEstimateSq));
+}
+#endif
+
+#if defined(MATH_SSE)
+template <Precision P>
+static __m128 InvSqrt4(__m128 x)
+{
+    if (P == Precision::Exact)  return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(x));
+    __m128 estimate = _mm_rsqrt_ps(x);
+    if (P == Precision::Raw)  return estimate;
+    __m128 halfXEstimateSq = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), x), _mm_mul_ps(estimate, estimate));
+    return _mm_mul_ps(estimate, _mm_sub_ps(_mm_set1_ps(1.5f), halfXEstimateSq));
+}
+#endif
+
+
+// Normalise count vectors in SoA layout, or just calculate their lengths if outLengths is not null (outX/Y/Z are then unused)
+// 8 at a time with AVX, 4 at a time with SSE, then any remainder with plain C++
+template <Precision P>
+static void NormaliseSoA(const float* inX, const float* inY, const float* inZ,
+                         float* outX, float* outY, float* outZ, float* outLengths, unsigned int count)
+{
+    unsigned int i = 0;
+
+#if defined(MATH_AVX)
+    {
+        // Lanes with lengthSq below EPSILON are masked to zero, as Normalise does. For lengths the value is
+        // clamped instead so the fast versions don't calculate 0 * infinity
+        __m256 epsilon = _mm256_set1_ps(EPSILON);
+        __m256 minimum = _mm256_set1_ps(FLT_MIN);
+        for (; i + 8 <= count; i += 8)
+        {
+            __m256 x = _mm256_loadu_ps(inX + i);
+            __m256 y = _mm256_loadu_ps(inY + i);
+            __m256 z = _mm256_loadu_ps(inZ + i);
+            __m256 lengthSq = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)), _mm256_mul_ps(z, z));
+            if (outLengths)
+            {
+                __m256 length = (P == Precision::Exact) ? _mm256_sqrt_ps(lengthSq) :
+                                _mm256_mul_ps(lengthSq, InvSqrt8<P>(_mm256_max_ps(lengthSq, minimum)));
+                _mm256_storeu_ps(outLengths + i, length);
+            }
+            else
+            {
+                __m256 invLength = _mm256_and_ps(InvSqrt8<P>(lengthSq), _mm256_cmp_ps(lengthSq, epsilon, _CMP_GE_OQ));
+                _mm256_storeu_ps(outX + i, _mm256_mul_ps(x, invLength));
+                _mm256_storeu_ps(outY + i, _mm256_mul_ps(y, invLength));
+                _mm256_storeu_ps(outZ + i, _mm256_mul_ps(z, invLength));
+            }
+        }
+    }
+#endif
+
+#if defined(MATH_SSE)
+    {
+        __m128 epsilon = _mm_set1_ps(EPSILON);
+        __m128 minimum = _mm_set1_ps(FLT_MIN);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(inX + i);
+            __m128 y = _mm_loadu_ps(inY + i);
+            __m128 z = _mm_loadu_ps(inZ + i);
+            __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            if (outLengths)
+            {
+                __m128 length = (P == Precision::Exact) ? _mm_sqrt_ps(lengthSq) :
+                                _mm_mul_ps(lengthSq, InvSqrt4<P>(_mm_max_ps(lengthSq, minimum)));
+                _mm_storeu_ps(outLengths + i, length);
+            }
+            else
+            {
+                __m128 invLength = _mm_and_ps(InvSqrt4<P>(lengthSq), _mm_cmpge_ps(lengthSq, epsilon));
+                _mm_storeu_ps(outX + i, _mm_mul_ps(x, invLength));
+                _mm_storeu_ps(outY + i, _mm_mul_ps(y, invLength));
+                _mm_storeu_ps(outZ + i, _mm_mul_ps(z, invLength));
+            }
+        }
+    }
+#endif
+
+    // Remainder (or everything if there is no SIMD support)
+    for (; i < count; ++i)
+    {
+        CVector3 v = { inX[i], inY[i], inZ[i] };
+        if (outLengths)
+        {
+            outLengths[i] = Length<P>(v);
+        }
+        else
+        {
+            v = Normalise<P>(v);
+            outX[i] = v.x;
+            outY[i] = v.y;
+            outZ[i] = v.z;
+        }
+    }
+}
+
+
+// Normalise count vectors read from in with inStride bytes between each, writing to out with outStride bytes between each
+// With SSE this works in blocks of 4 vectors like the strided transforms (see LoadStrided4 / StoreStrided4), then any
+// remainder singly. Zero length vectors are masked to zero as in NormaliseSoA
+template <Precision P>
+void NormaliseVectors(const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count)
+{
+    const unsigned char* source = static_cast<const unsigned char*>(in);
+    unsigned char*       dest   = static_cast<unsigned char*>(out);
+    unsigned int i = 0;
+
+#if defined(MATH_SSE)
+    if (count > 4)
+    {
+        // Unless the input is tightly packed, a block needs another vector after it (see LoadStrided4)
+        unsigned int blockEnd = (inStride == sizeof(CVector3)) ? count : count - 1;
+        __m128 epsilon = _mm_set1_ps(EPSILON);
+        for (; i + 4 <= blockEnd; i += 4)
+        {
+            __m128 x, y, z;
+            LoadStrided4(source, inStride, x, y, z);
+            __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            __m128 invLength = _mm_and_ps(InvSqrt4<P>(lengthSq), _mm_cmpge_ps(lengthSq, epsilon));
+            StoreStrided4(dest, outStride, _mm_mul_ps(x, invLength), _mm_mul_ps(y, invLength), _mm_mul_ps(z, invLength));
+            source += inStride  * 4;
+            dest   += outStride * 4;
+        }
+    }
+#endif
+
+    // Remainder (or everything if there is no SIMD support)
+    for (; i < count; ++i)
+    {
+        const float* v = reinterpret_cast<const float*>(source);
+        CVector3 result = Normalise<P>(CVector3{ v[0], v[1], v[2] });
+        float* r = reinterpret_cast<float*>(dest);
+        r[0] = result.x;
+        r[1] = result.y;
+        r[2] = result.z;
+        source += inStride;
+        dest   += outStride;
+    }
+}
+
+// Normalise count vectors stored in separate x, y and z arrays
+template <Precision P>
+void NormaliseVectors(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, unsigned int count)
+{
+    NormaliseSoA<P>(inX, inY, inZ, outX, outY, outZ, nullptr, count);
+}
+
+// Write the lengths of count vectors stored in separate x, y and z arrays to outLengths
+template <Precision P>
+void VectorLengths(const float* inX, const float* inY, const float* inZ, float* outLengths, unsigned int count)
+{
+    NormaliseSoA<P>(inX, inY, inZ, nullptr, nullptr, nullptr, outLengths, count);
+}
+
+
+// Instantiate the templates above for each precision
+#define INSTANTIATE_NORMALISE(P) \
+    template void NormaliseVectors<P>(const void*, unsigned int, void*, unsigned int, unsigned int); \
+    template void NormaliseVectors<P>(const float*, const float*, const float*, float*, float*, float*, unsigned int); \
+    template void VectorLengths<P>(const float*, const float*, const float*, float*, unsigned int);
+
+INSTANTIATE_NORMALISE(Precision::Exact)
+INSTANTIATE_NORMALISE(Precision::Refined)
+INSTANTIATE_NORMALISE(Precision::Raw)
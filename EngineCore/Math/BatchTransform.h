@@ -0,0 +1,111 @@
+//--------------------------------------------------------------------------------------
+// Transforming arrays of points and normals by a matrix, and normalising arrays of vectors
+//--------------------------------------------------------------------------------------
+// Code in .cpp file
+// Works on many vectors at once to make use of SIMD (SoA data 4 at a time with SSE or 8 with AVX, strided data
+// in blocks of 4 - see MathSIMD.h), for CPU work on whole meshes such as skinning or calculating bounds.
+//
+// Two data layouts are supported:
+// - Strided: an array of structures where each element starts with x,y,z floats, e.g. a CVector3 array or
+//   the position in a vertex buffer. The stride is the distance in bytes between the start of each element
+// - SoA (structure of arrays): separate arrays of x, y and z values
+// Output can be the same memory as the input (transform in place), but must not partly overlap it.
+//
+// Matrices are used in the same way as the rest of this library, i.e. vectors are rows multiplied on the
+// left of the matrix: transformed = v * m
+
+#ifndef _BATCH_TRANSFORM_H_DEFINED_
+#define _BATCH_TRANSFORM_H_DEFINED_
+
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+
+
+/*-----------------------------------------------------------------------------------------
+    Single vectors
+-----------------------------------------------------------------------------------------*/
+
+// Transform a point by a matrix (treats the point as having w = 1, so translation is included)
+constexpr CVector3 TransformPoint(const CVector3& p, const CMatrix4x4& m)
+{
+    return { p.x * m.e00 + p.y * m.e10 + p.z * m.e20 + m.e30,
+             p.x * m.e01 + p.y * m.e11 + p.z * m.e21 + m.e31,
+             p.x * m.e02 + p.y * m.e12 + p.z * m.e22 + m.e32 };
+}
+
+// Transform a normal or other direction by a matrix (treats the vector as having w = 0, so no translation)
+// Result is not normalised. If the matrix has non-uniform scaling the inverse transpose should be passed
+constexpr CVector3 TransformNormal(const CVector3& n, const CMatrix4x4& m)
+{
+    return { n.x * m.e00 + n.y * m.e10 + n.z * m.e20,
+             n.x * m.e01 + n.y * m.e11 + n.z * m.e21,
+             n.x * m.e02 + n.y * m.e12 + n.z * m.e22 };
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Strided arrays
+-----------------------------------------------------------------------------------------*/
+
+// Transform count points (w = 1) read from in with inStride bytes between each, writing to out with outStride bytes between each
+void TransformPoints(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count);
+
+// Transform count normals (w = 0) read from in with inStride bytes between each, writing to out with outStride bytes between each
+// Results are not normalised. If the matrix has non-uniform scaling the inverse transpose should be passed
+void TransformNormals(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count);
+
+// Transform count points (w = 1) by a projection matrix (or a matrix that includes one) and divide by the resulting w
+// Read from in with inStride bytes between each, writing to out with outStride bytes between each
+void TransformPointsProjective(const CMatrix4x4& m, const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count);
+
+
+// Versions of the above for tightly packed CVector3 arrays
+inline void TransformPoints(const CMatrix4x4& m, const CVector3* in, CVector3* out, unsigned int count)
+{
+    TransformPoints(m, in, sizeof(CVector3), out, sizeof(CVector3), count);
+}
+inline void TransformNormals(const CMatrix4x4& m, const CVector3* in, CVector3* out, unsigned int count)
+{
+    TransformNormals(m, in, sizeof(CVector3), out, sizeof(CVector3), count);
+}
+inline void TransformPointsProjective(const CMatrix4x4& m, const CVector3* in, CVector3* out, unsigned int count)
+{
+    TransformPointsProjective(m, in, sizeof(CVector3), out, sizeof(CVector3), count);
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    SoA arrays
+-----------------------------------------------------------------------------------------*/
+
+// Same as the functions above for points and normals stored in separate x, y and z arrays
+void TransformPoints(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                          float* outX, float* outY, float* outZ, unsigned int count);
+
+void TransformNormals(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                           float* outX, float* outY, float* outZ, unsigned int count);
+
+void TransformPointsProjective(const CMatrix4x4& m, const float* inX, const float* inY, const float* inZ,
+                                                    float* outX, float* outY, float* outZ, unsigned int count);
+
+
+/*-----------------------------------------------------------------------------------------
+    Normalising
+-----------------------------------------------------------------------------------------*/
+// Batch versions of Normalise and Length from CVector3.h, with the same choice of square root precision (see
+// MathHelpers.h). Zero length vectors normalise to zero, as for Normalise. Instantiated for all three precisions
+
+// Normalise count vectors read from in with inStride bytes between each, writing to out with outStride bytes between each
+template <Precision P = Precision::Exact>
+void NormaliseVectors(const void* in, unsigned int inStride, void* out, unsigned int outStride, unsigned int count);
+
+// Same for vectors stored in separate x, y and z arrays
+template <Precision P = Precision::Exact>
+void NormaliseVectors(const float* inX, const float* inY, const float* inZ, float* outX, float* outY, float* outZ, unsigned int count);
+
+// Write the lengths of count vectors stored in separate x, y and z arrays to outLengths
+template <Precision P = Precision::Exact>
+void VectorLengths(const float* inX, const float* inY, const float* inZ, float* outLengths, unsigned int count);
+
+
+#endif // _BATCH_TRANSFORM_H_DEFINED_
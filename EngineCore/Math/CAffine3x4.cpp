@@ -0,0 +1,216 @@
+//--------------------------------------------------------------------------------------
+// Affine 3x4 matrix class to hold world transforms (position, rotation, scale, shear)
+//--------------------------------------------------------------------------------------
+
+#include "CAffine3x4.h"
+
+
+/*-----------------------------------------------------------------------------------------
+    Member functions
+-----------------------------------------------------------------------------------------*/
+
+// Set a single row (range 0-3) of the matrix using a CVector3
+// Can be used to set position or x,y,z axes in a matrix
+void CAffine3x4::SetRow(int iRow, const CVector3& v)
+{
+    float* pfElts = &e00 + iRow; // Elements of a row are 4 floats apart
+    pfElts[0] = v.x;
+    pfElts[4] = v.y;
+    pfElts[8] = v.z;
+}
+
+// Get a single row (range 0-3) of the matrix into a CVector3
+// Can be used to access position or x,y,z axes from a matrix
+CVector3 CAffine3x4::GetRow(int iRow) const
+{
+    const float* pfElts = &e00 + iRow;
+    return CVector3(pfElts[0], pfElts[4], pfElts[8]);
+}
+
+
+// Post-multiply this matrix by the given one
+CAffine3x4& CAffine3x4::operator*=(const CAffine3x4& m)
+{
+    *this = *this * m;
+    return *this;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Operators
+-----------------------------------------------------------------------------------------*/
+
+#if defined(MATH_SSE)
+// a * b + c, fused if the target supports it
+static inline __m128 MulAdd(__m128 a, __m128 b, __m128 c)
+{
+#if defined(MATH_FMA)
+    return _mm_fmadd_ps(a, b, c);
+#else
+    return _mm_add_ps(_mm_mul_ps(a, b), c);
+#endif
+}
+#endif
+
+// Matrix-matrix multiplication - same meaning as for CMatrix4x4 (apply m1 then m2), but only 36 multiplies
+// Each column of the result is a weighted sum of the columns of m1, the weights being the elements of the
+// matching column of m2: out.col(j) = m1.col(0) * m2.e0j + m1.col(1) * m2.e1j + m1.col(2) * m2.e2j
+// The missing column of m1 is 0,0,0,1 so the last row of m2 (its translation) is simply added to e3j
+CAffine3x4 operator*(const CAffine3x4& m1, const CAffine3x4& m2)
+{
+    CAffine3x4 mOut;
+
+#if defined(MATH_SSE)
+    __m128 a0 = _mm_loadu_ps(&m1.e00);
+    __m128 a1 = _mm_loadu_ps(&m1.e01);
+    __m128 a2 = _mm_loadu_ps(&m1.e02);
+    const __m128 translationMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+
+    const float* b = &m2.e00;
+    float* out = &mOut.e00;
+    for (int col = 0; col < 3; ++col)
+    {
+        __m128 bCol = _mm_loadu_ps(b + col * 4);
+        __m128 r = _mm_and_ps(bCol, translationMask);
+        r = MulAdd(a0, _mm_shuffle_ps(bCol, bCol, _MM_SHUFFLE(0, 0, 0, 0)), r);
+        r = MulAdd(a1, _mm_shuffle_ps(bCol, bCol, _MM_SHUFFLE(1, 1, 1, 1)), r);
+        r = MulAdd(a2, _mm_shuffle_ps(bCol, bCol, _MM_SHUFFLE(2, 2, 2, 2)), r);
+        _mm_storeu_ps(out + col * 4, r);
+    }
+#else
+    mOut = AffineMultiplyScalar(m1, m2);
+#endif
+
+    return mOut;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return the inverse of the given matrix
+// Invert the upper-left 3x3 with cofactors, then transform the negative translation by it
+CAffine3x4 InverseAffine(const CAffine3x4& m)
+{
+    CAffine3x4 mOut;
+
+    // Calculate determinant of upper left 3x3
+    float det0 = m.e11*m.e22 - m.e12*m.e21;
+    float det1 = m.e12*m.e20 - m.e10*m.e22;
+    float det2 = m.e10*m.e21 - m.e11*m.e20;
+    float det = m.e00*det0 + m.e01*det1 + m.e02*det2;
+
+    // Calculate inverse of upper left 3x3
+    float invDet = 1.0f / det;
+    mOut.e00 = invDet * det0;
+    mOut.e10 = invDet * det1;
+    mOut.e20 = invDet * det2;
+
+    mOut.e01 = invDet * (m.e21*m.e02 - m.e22*m.e01);
+    mOut.e11 = invDet * (m.e22*m.e00 - m.e20*m.e02);
+    mOut.e21 = invDet * (m.e20*m.e01 - m.e21*m.e00);
+
+    mOut.e02 = invDet * (m.e01*m.e12 - m.e02*m.e11);
+    mOut.e12 = invDet * (m.e02*m.e10 - m.e00*m.e12);
+    mOut.e22 = invDet * (m.e00*m.e11 - m.e01*m.e10);
+
+    // Transform negative translation by inverted 3x3 to get inverse
+    mOut.e30 = -m.e30*mOut.e00 - m.e31*mOut.e10 - m.e32*mOut.e20;
+    mOut.e31 = -m.e30*mOut.e01 - m.e31*mOut.e11 - m.e32*mOut.e21;
+    mOut.e32 = -m.e30*mOut.e02 - m.e31*mOut.e12 - m.e32*mOut.e22;
+
+    return mOut;
+}
+
+
+// Calculate the inverse transpose of the upper-left 3x3 of count matrices, optionally returning the determinants
+// The inverse transpose is the matrix of cofactors divided by the determinant. With SSE, groups of 4 matrices are
+// transposed so each register holds the same element from 4 matrices, then the calculation is the same as scalar
+void InverseTranspose3x3(const CAffine3x4* in, CAffine3x4* out, float* determinants, unsigned int count)
+{
+    unsigned int i = 0;
+
+#if defined(MATH_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        // Column c of matrix k is at in[k].e00 + c * 4. Transposing gives element e0c, e1c, e2c, e3c from all 4 matrices
+        const float* m0 = &in[i].e00;
+        const float* m1 = &in[i + 1].e00;
+        const float* m2 = &in[i + 2].e00;
+        const float* m3 = &in[i + 3].e00;
+        __m128 e00 = _mm_loadu_ps(m0),     e10 = _mm_loadu_ps(m1),     e20 = _mm_loadu_ps(m2),     unused0 = _mm_loadu_ps(m3);
+        __m128 e01 = _mm_loadu_ps(m0 + 4), e11 = _mm_loadu_ps(m1 + 4), e21 = _mm_loadu_ps(m2 + 4), unused1 = _mm_loadu_ps(m3 + 4);
+        __m128 e02 = _mm_loadu_ps(m0 + 8), e12 = _mm_loadu_ps(m1 + 8), e22 = _mm_loadu_ps(m2 + 8), unused2 = _mm_loadu_ps(m3 + 8);
+        _MM_TRANSPOSE4_PS(e00, e10, e20, unused0);
+        _MM_TRANSPOSE4_PS(e01, e11, e21, unused1);
+        _MM_TRANSPOSE4_PS(e02, e12, e22, unused2);
+
+        // Cofactors
+        __m128 c00 = _mm_sub_ps(_mm_mul_ps(e11, e22), _mm_mul_ps(e12, e21));
+        __m128 c01 = _mm_sub_ps(_mm_mul_ps(e12, e20), _mm_mul_ps(e10, e22));
+        __m128 c02 = _mm_sub_ps(_mm_mul_ps(e10, e21), _mm_mul_ps(e11, e20));
+        __m128 c10 = _mm_sub_ps(_mm_mul_ps(e02, e21), _mm_mul_ps(e01, e22));
+        __m128 c11 = _mm_sub_ps(_mm_mul_ps(e00, e22), _mm_mul_ps(e02, e20));
+        __m128 c12 = _mm_sub_ps(_mm_mul_ps(e01, e20), _mm_mul_ps(e00, e21));
+        __m128 c20 = _mm_sub_ps(_mm_mul_ps(e01, e12), _mm_mul_ps(e02, e11));
+        __m128 c21 = _mm_sub_ps(_mm_mul_ps(e02, e10), _mm_mul_ps(e00, e12));
+        __m128 c22 = _mm_sub_ps(_mm_mul_ps(e00, e11), _mm_mul_ps(e01, e10));
+
+        // Determinant, and its reciprocal (set to 0 where the determinant is 0 so singular matrices give zeros)
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e00, c00), _mm_mul_ps(e01, c01)), _mm_mul_ps(e02, c02));
+        __m128 invDet = _mm_and_ps(_mm_div_ps(_mm_set1_ps(1.0f), det), _mm_cmpneq_ps(det, zero));
+        if (determinants != nullptr)  _mm_storeu_ps(determinants + i, det);
+
+        // Scale cofactors and transpose back to columns, the fourth element of each column (translation) is 0
+        __m128 col0m0 = _mm_mul_ps(c00, invDet), col0m1 = _mm_mul_ps(c10, invDet), col0m2 = _mm_mul_ps(c20, invDet), col0m3 = zero;
+        __m128 col1m0 = _mm_mul_ps(c01, invDet), col1m1 = _mm_mul_ps(c11, invDet), col1m2 = _mm_mul_ps(c21, invDet), col1m3 = zero;
+        __m128 col2m0 = _mm_mul_ps(c02, invDet), col2m1 = _mm_mul_ps(c12, invDet), col2m2 = _mm_mul_ps(c22, invDet), col2m3 = zero;
+        _MM_TRANSPOSE4_PS(col0m0, col0m1, col0m2, col0m3);
+        _MM_TRANSPOSE4_PS(col1m0, col1m1, col1m2, col1m3);
+        _MM_TRANSPOSE4_PS(col2m0, col2m1, col2m2, col2m3);
+
+        float* o0 = &out[i].e00;
+        float* o1 = &out[i + 1].e00;
+        float* o2 = &out[i + 2].e00;
+        float* o3 = &out[i + 3].e00;
+        _mm_storeu_ps(o0, col0m0);  _mm_storeu_ps(o0 + 4, col1m0);  _mm_storeu_ps(o0 + 8, col2m0);
+        _mm_storeu_ps(o1, col0m1);  _mm_storeu_ps(o1 + 4, col1m1);  _mm_storeu_ps(o1 + 8, col2m1);
+        _mm_storeu_ps(o2, col0m2);  _mm_storeu_ps(o2 + 4, col1m2);  _mm_storeu_ps(o2 + 8, col2m2);
+        _mm_storeu_ps(o3, col0m3);  _mm_storeu_ps(o3 + 4, col1m3);  _mm_storeu_ps(o3 + 8, col2m3);
+    }
+#endif
+
+    // Remainder (or everything if there is no SIMD support)
+    for (; i < count; ++i)
+    {
+        const CAffine3x4& m = in[i];
+        float c00 = m.e11*m.e22 - m.e12*m.e21;
+        float c01 = m.e12*m.e20 - m.e10*m.e22;
+        float c02 = m.e10*m.e21 - m.e11*m.e20;
+        float c10 = m.e02*m.e21 - m.e01*m.e22;
+        float c11 = m.e00*m.e22 - m.e02*m.e20;
+        float c12 = m.e01*m.e20 - m.e00*m.e21;
+        float c20 = m.e01*m.e12 - m.e02*m.e11;
+        float c21 = m.e02*m.e10 - m.e00*m.e12;
+        float c22 = m.e00*m.e11 - m.e01*m.e10;
+
+        float det = m.e00*c00 + m.e01*c01 + m.e02*c02;
+        float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+        if (determinants != nullptr)  determinants[i] = det;
+
+        out[i] = CAffine3x4{ { c00 * invDet, c01 * invDet, c02 * invDet },
+                             { c10 * invDet, c11 * invDet, c12 * invDet },
+                             { c20 * invDet, c21 * invDet, c22 * invDet },
+                             { 0, 0, 0 } };
+    }
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Compile-time checks
+-----------------------------------------------------------------------------------------*/
+
+static_assert(CAffine3x4(MatrixTranslation({ 1, 2, 3 })).ToMatrix4x4().e32 == 3, "CMatrix4x4 conversion must be lossless");
+static_assert(CAffine3x4(MatrixScaling({ 1, 2, 3 })).e11 == 2 && AffineIdentity().e22 == 1, "CAffine3x4 must be constexpr");
@@ -0,0 +1,168 @@
+//--------------------------------------------------------------------------------------
+// Affine 3x4 matrix class to hold world transforms (position, rotation, scale, shear)
+//--------------------------------------------------------------------------------------
+// Most code in .cpp file
+// A world matrix always has 0,0,0,1 in its right-hand column, so there is no need to store it. This class
+// holds the other 12 elements of a CMatrix4x4, which saves memory and bandwidth when updating hierarchies
+// and makes combining two matrices 36 multiplies rather than 64. It converts to and from CMatrix4x4 without
+// loss, but only affine matrices can be held (not projection matrices).
+//
+// The elements are stored column by column: e00,e10,e20,e30 then e01,e11,e21,e31 then e02,e12,e22,e32.
+// Element names are the same as CMatrix4x4 (eRC is row R column C). This is the "packed" layout for the GPU,
+// the 48 bytes can be copied directly into a constant buffer and read in HLSL as a row_major float3x4 (see
+// gBoneMatrices in Common.hlsli). A CMatrix4x4 takes 64 bytes.
+
+#ifndef _CAFFINE3X4_H_DEFINED_
+#define _CAFFINE3X4_H_DEFINED_
+
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include "MathSIMD.h"
+
+
+class MATH_MATRIX_ALIGN CAffine3x4
+{
+// Concrete class - public access
+public:
+    // Matrix elements, stored by column (see above). The missing column is always 0,0,0,1
+    float e00, e10, e20, e30;
+    float e01, e11, e21, e31;
+    float e02, e12, e22, e32;
+
+
+    /*-----------------------------------------------------------------------------------------
+        Constructors
+    -----------------------------------------------------------------------------------------*/
+
+    // Default constructor - leaves values uninitialised (for performance)
+    CAffine3x4() {}
+
+    // Construct from the x, y and z axes and the position (i.e. the first three elements of each row of a CMatrix4x4)
+    constexpr CAffine3x4(const CVector3& xAxis, const CVector3& yAxis, const CVector3& zAxis, const CVector3& position)
+        : e00(xAxis.x), e10(yAxis.x), e20(zAxis.x), e30(position.x),
+          e01(xAxis.y), e11(yAxis.y), e21(zAxis.y), e31(position.y),
+          e02(xAxis.z), e12(yAxis.z), e22(zAxis.z), e32(position.z) {}
+
+    // Construct from a CMatrix4x4. The right-hand column of the matrix is ignored, it should be 0,0,0,1
+    constexpr explicit CAffine3x4(const CMatrix4x4& m)
+        : CAffine3x4(m.GetXAxis(), m.GetYAxis(), m.GetZAxis(), m.GetPosition()) {}
+
+
+    /*-----------------------------------------------------------------------------------------
+        Member functions
+    -----------------------------------------------------------------------------------------*/
+
+    // Return the equivalent CMatrix4x4 (lossless)
+    constexpr CMatrix4x4 ToMatrix4x4() const
+    {
+        return CMatrix4x4{ e00, e01, e02, 0,
+                           e10, e11, e12, 0,
+                           e20, e21, e22, 0,
+                           e30, e31, e32, 1 };
+    }
+
+    // Initialise this matrix with a pointer to 12 floats in the same column by column order as this class
+    // That is also the order of the first three rows of a matrix for column vectors (e.g. from a model file)
+    void SetColumns(const float* columnValues)  { std::copy(columnValues, columnValues + 12, &e00); }
+
+    // Set a single row (range 0-3) of the matrix using a CVector3
+    // Can be used to set position or x,y,z axes in a matrix
+    void SetRow(int iRow, const CVector3& v);
+
+    // Get a single row (range 0-3) of the matrix into a CVector3
+    // Can be used to access position or x,y,z axes from a matrix
+    CVector3 GetRow(int iRow) const;
+
+    // Helper functions
+    constexpr CVector3 GetXAxis() const { return { e00, e01, e02 }; }
+    constexpr CVector3 GetYAxis() const { return { e10, e11, e12 }; }
+    constexpr CVector3 GetZAxis() const { return { e20, e21, e22 }; }
+    constexpr CVector3 GetPosition() const  { return { e30, e31, e32 }; }
+    CVector3 GetScale() const  { return { Length(GetXAxis()), Length(GetYAxis()) , Length(GetZAxis()) }; }
+
+    // Post-multiply this matrix by the given one
+    CAffine3x4& operator*=(const CAffine3x4& m);
+};
+
+// The packed layout relies on there being no padding
+static_assert(sizeof(CAffine3x4) == 12 * sizeof(float), "CAffine3x4 must be 48 bytes to upload to the GPU");
+
+
+/*-----------------------------------------------------------------------------------------
+    Operators
+-----------------------------------------------------------------------------------------*/
+
+// Matrix-matrix multiplication - same meaning as for CMatrix4x4 (apply m1 then m2), but only 36 multiplies
+// Uses SSE if available (selected at build time, see MathSIMD.h), otherwise plain C++
+CAffine3x4 operator*(const CAffine3x4& m1, const CAffine3x4& m2);
+
+// Matrix-matrix multiplication always using plain C++. Reference version for checking the SIMD code,
+// and constexpr so it can combine constant matrices at compile time
+constexpr CAffine3x4 AffineMultiplyScalar(const CAffine3x4& m1, const CAffine3x4& m2)
+{
+    return CAffine3x4{ { m1.e00*m2.e00 + m1.e01*m2.e10 + m1.e02*m2.e20,
+                         m1.e00*m2.e01 + m1.e01*m2.e11 + m1.e02*m2.e21,
+                         m1.e00*m2.e02 + m1.e01*m2.e12 + m1.e02*m2.e22 },
+
+                       { m1.e10*m2.e00 + m1.e11*m2.e10 + m1.e12*m2.e20,
+                         m1.e10*m2.e01 + m1.e11*m2.e11 + m1.e12*m2.e21,
+                         m1.e10*m2.e02 + m1.e11*m2.e12 + m1.e12*m2.e22 },
+
+                       { m1.e20*m2.e00 + m1.e21*m2.e10 + m1.e22*m2.e20,
+                         m1.e20*m2.e01 + m1.e21*m2.e11 + m1.e22*m2.e21,
+                         m1.e20*m2.e02 + m1.e21*m2.e12 + m1.e22*m2.e22 },
+
+                       { m1.e30*m2.e00 + m1.e31*m2.e10 + m1.e32*m2.e20 + m2.e30,
+                         m1.e30*m2.e01 + m1.e31*m2.e11 + m1.e32*m2.e21 + m2.e31,
+                         m1.e30*m2.e02 + m1.e31*m2.e12 + m1.e32*m2.e22 + m2.e32 } };
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return an identity matrix
+constexpr CAffine3x4 AffineIdentity()
+{
+    return CAffine3x4{ { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 }, { 0, 0, 0 } };
+}
+
+// Return the inverse of the given matrix. Uses the same method as InverseAffine for CMatrix4x4
+CAffine3x4 InverseAffine(const CAffine3x4& m);
+
+
+// Calculate the inverse transpose of the upper-left 3x3 of count matrices. This is the "normal matrix": transform
+// normals by it (TransformNormal) to keep them perpendicular to surfaces when a world matrix has non-uniform scaling.
+// Results have zero translation. Works on 4 matrices at a time with SSE. In-place (out == in) is allowed
+// If determinants is not null, the determinant of each 3x3 is written there (negative means the matrix mirrors).
+// A matrix with a zero determinant (e.g. a scale of 0) has no inverse, its result is all zeros.
+void InverseTranspose3x3(const CAffine3x4* in, CAffine3x4* out, float* determinants, unsigned int count);
+
+// Single matrix version of the above
+inline CAffine3x4 InverseTranspose3x3(const CAffine3x4& m, float* determinant = nullptr)
+{
+    CAffine3x4 mOut;
+    InverseTranspose3x3(&m, &mOut, determinant, 1);
+    return mOut;
+}
+
+
+// Transform a point by an affine matrix (translation is included)
+constexpr CVector3 TransformPoint(const CVector3& p, const CAffine3x4& m)
+{
+    return { p.x * m.e00 + p.y * m.e10 + p.z * m.e20 + m.e30,
+             p.x * m.e01 + p.y * m.e11 + p.z * m.e21 + m.e31,
+             p.x * m.e02 + p.y * m.e12 + p.z * m.e22 + m.e32 };
+}
+
+// Transform a normal or other direction by an affine matrix (no translation). Result is not normalised
+constexpr CVector3 TransformNormal(const CVector3& n, const CAffine3x4& m)
+{
+    return { n.x * m.e00 + n.y * m.e10 + n.z * m.e20,
+             n.x * m.e01 + n.y * m.e11 + n.z * m.e21,
+             n.x * m.e02 + n.y * m.e12 + n.z * m.e22 };
+}
+
+
+#endif // _CAFFINE3X4_H_DEFINED_
@@ -0,0 +1,93 @@
+//--------------------------------------------------------------------------------------
+// Bounding volume class - axis-aligned box and sphere
+//--------------------------------------------------------------------------------------
+
+#include "CBounds.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return bounds around the given points, which are stride bytes apart. The sphere is centred on the box
+CBounds BoundsFromPoints(const void* points, unsigned int count, unsigned int stride /*= sizeof(CVector3)*/)
+{
+    CBounds bounds;
+    if (count == 0)  return bounds;
+
+    auto point = [&](unsigned int i) { return CVector3(reinterpret_cast<const float*>(static_cast<const char*>(points) + i * stride)); };
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        CVector3 p = point(i);
+        bounds.minimum = { std::min(bounds.minimum.x, p.x), std::min(bounds.minimum.y, p.y), std::min(bounds.minimum.z, p.z) };
+        bounds.maximum = { std::max(bounds.maximum.x, p.x), std::max(bounds.maximum.y, p.y), std::max(bounds.maximum.z, p.z) };
+    }
+
+    // Second pass for the sphere radius, comparing squared distances
+    bounds.centre = bounds.BoxCentre();
+    float radiusSquared = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        CVector3 offset = point(i) - bounds.centre;
+        radiusSquared = std::max(radiusSquared, Dot(offset, offset));
+    }
+    bounds.radius = std::sqrt(radiusSquared);
+    return bounds;
+}
+
+
+// Return bounds containing both the given bounds. Either can be empty
+CBounds MergeBounds(const CBounds& b1, const CBounds& b2)
+{
+    if (b1.IsEmpty())  return b2;
+    if (b2.IsEmpty())  return b1;
+
+    CBounds bounds;
+    bounds.minimum = { std::min(b1.minimum.x, b2.minimum.x), std::min(b1.minimum.y, b2.minimum.y), std::min(b1.minimum.z, b2.minimum.z) };
+    bounds.maximum = { std::max(b1.maximum.x, b2.maximum.x), std::max(b1.maximum.y, b2.maximum.y), std::max(b1.maximum.z, b2.maximum.z) };
+
+    // Smallest sphere around both spheres. If one contains the other use that one, otherwise the new sphere
+    // touches the far side of each, with its centre on the line between the two centres
+    CVector3 offset = b2.centre - b1.centre;
+    float distance = Length(offset);
+    if (distance + b2.radius <= b1.radius)
+    {
+        bounds.centre = b1.centre;
+        bounds.radius = b1.radius;
+    }
+    else if (distance + b1.radius <= b2.radius)
+    {
+        bounds.centre = b2.centre;
+        bounds.radius = b2.radius;
+    }
+    else
+    {
+        bounds.radius = (distance + b1.radius + b2.radius) * 0.5f;
+        bounds.centre = b1.centre + offset * ((bounds.radius - b1.radius) / distance);
+    }
+    return bounds;
+}
+
+
+// Return bounds containing the given bounds after transforming by an affine matrix
+CBounds TransformBounds(const CBounds& b, const CAffine3x4& m)
+{
+    if (b.IsEmpty())  return b;
+
+    // The extent of the transformed box along each world axis is the sum of the absolute contributions of the
+    // box's three half-sizes, i.e. the half-sizes transformed by the matrix with all its elements made positive
+    CVector3 centre = TransformPoint(b.BoxCentre(), m);
+    CVector3 extents = b.BoxExtents();
+    CVector3 newExtents = { extents.x * std::abs(m.e00) + extents.y * std::abs(m.e10) + extents.z * std::abs(m.e20),
+                            extents.x * std::abs(m.e01) + extents.y * std::abs(m.e11) + extents.z * std::abs(m.e21),
+                            extents.x * std::abs(m.e02) + extents.y * std::abs(m.e12) + extents.z * std::abs(m.e22) };
+
+    CVector3 scale = m.GetScale();
+    float maxScale = std::max(scale.x, std::max(scale.y, scale.z));
+
+    return { centre - newExtents, centre + newExtents, TransformPoint(b.centre, m), b.radius * maxScale };
+}
@@ -0,0 +1,72 @@
+//--------------------------------------------------------------------------------------
+// Bounding volume class - axis-aligned box and sphere
+//--------------------------------------------------------------------------------------
+// Code in .cpp file
+// Holds both an axis-aligned bounding box (AABB) and a bounding sphere around the same points. Boxes are tighter
+// for most shapes, spheres are quicker to test and don't change size when rotated, so culling and picking code
+// can use whichever suits. Default constructed bounds are empty (contain no points).
+
+#ifndef _CBOUNDS_H_DEFINED_
+#define _CBOUNDS_H_DEFINED_
+
+#include "CVector3.h"
+#include "CAffine3x4.h"
+
+#include <cfloat>
+
+
+class CBounds
+{
+// Concrete class - public access
+public:
+    // Axis-aligned box. For empty bounds minimum is greater than maximum
+    CVector3 minimum;
+    CVector3 maximum;
+
+    // Sphere. Negative radius for empty bounds
+    CVector3 centre;
+    float    radius;
+
+
+    /*-----------------------------------------------------------------------------------------
+        Constructors
+    -----------------------------------------------------------------------------------------*/
+
+    // Default constructor - empty bounds
+    constexpr CBounds() : minimum{ FLT_MAX, FLT_MAX, FLT_MAX }, maximum{ -FLT_MAX, -FLT_MAX, -FLT_MAX },
+                          centre{ 0, 0, 0 }, radius(-1) {}
+
+    // Construct from a box and sphere
+    constexpr CBounds(const CVector3& boxMin, const CVector3& boxMax, const CVector3& sphereCentre, float sphereRadius)
+        : minimum(boxMin), maximum(boxMax), centre(sphereCentre), radius(sphereRadius) {}
+
+
+    /*-----------------------------------------------------------------------------------------
+        Member functions
+    -----------------------------------------------------------------------------------------*/
+
+    constexpr bool IsEmpty() const  { return radius < 0; }
+
+    // Centre and half-size of the box
+    constexpr CVector3 BoxCentre()  const  { return (minimum + maximum) * 0.5f; }
+    constexpr CVector3 BoxExtents() const  { return (maximum - minimum) * 0.5f; }
+};
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return bounds around the given points, which are stride bytes apart (e.g. positions in a vertex buffer). The
+// sphere is centred on the box, which is quick and never much worse than the smallest sphere for mesh shapes
+CBounds BoundsFromPoints(const void* points, unsigned int count, unsigned int stride = sizeof(CVector3));
+
+// Return bounds containing both the given bounds. Either can be empty
+CBounds MergeBounds(const CBounds& b1, const CBounds& b2);
+
+// Return bounds containing the given bounds after transforming by an affine matrix. The box is the smallest
+// axis-aligned box around the transformed box, the sphere radius is scaled by the largest axis scale
+CBounds TransformBounds(const CBounds& b, const CAffine3x4& m);
+
+
+#endif // _CBOUNDS_H_DEFINED_
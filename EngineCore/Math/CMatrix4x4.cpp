@@ -0,0 +1,283 @@
+//--------------------------------------------------------------------------------------
+// Matrix4x4 class (cut down version) to hold matrices for 3D
+//--------------------------------------------------------------------------------------
+
+#include "CMatrix4x4.h"
+#include "CAffine3x4.h"
+#include "MathTrig.h"
+
+#include <algorithm>
+
+/*-----------------------------------------------------------------------------------------
+    Member functions
+-----------------------------------------------------------------------------------------*/
+
+// Set a single row (range 0-3) of the matrix using a CVector3. Fourth element left unchanged
+// Can be used to set position or x,y,z axes in a matrix
+void CMatrix4x4::SetRow(int iRow, const CVector3& v)
+{
+    float* pfElts = &e00 + iRow * 4;
+    pfElts[0] = v.x;
+    pfElts[1] = v.y;
+    pfElts[2] = v.z;
+}
+
+// Get a single row (range 0-3) of the matrix into a CVector3. Fourth element is ignored
+// Can be used to access position or x,y,z axes from a matrix
+CVector3 CMatrix4x4::GetRow(int iRow) const
+{
+    const float* pfElts = &e00 + iRow * 4;
+    return CVector3(pfElts[0], pfElts[1], pfElts[2]);
+}
+
+
+// Post-multiply this matrix by the given one
+CMatrix4x4& CMatrix4x4::operator*=(const CMatrix4x4& m)
+{
+#if defined(MATH_AVX)
+    // AVX version calculates into a temporary so there is no special case for multiplying by self
+    *this = *this * m;
+#else
+    if (this == &m)
+    {
+        // Special case of multiplying by self - no copy optimisations so use binary version
+        *this = m * m;
+    }
+    else
+    {
+        float t0, t1, t2;
+
+        t0 = e00 * m.e00 + e01 * m.e10 + e02 * m.e20 + e03 * m.e30;
+        t1 = e00 * m.e01 + e01 * m.e11 + e02 * m.e21 + e03 * m.e31;
+        t2 = e00 * m.e02 + e01 * m.e12 + e02 * m.e22 + e03 * m.e32;
+        e03 = e00 * m.e03 + e01 * m.e13 + e02 * m.e23 + e03 * m.e33;
+        e00 = t0;
+        e01 = t1;
+        e02 = t2;
+
+        t0 = e10 * m.e00 + e11 * m.e10 + e12 * m.e20 + e13 * m.e30;
+        t1 = e10 * m.e01 + e11 * m.e11 + e12 * m.e21 + e13 * m.e31;
+        t2 = e10 * m.e02 + e11 * m.e12 + e12 * m.e22 + e13 * m.e32;
+        e13 = e10 * m.e03 + e11 * m.e13 + e12 * m.e23 + e13 * m.e33;
+        e10 = t0;
+        e11 = t1;
+        e12 = t2;
+
+        t0 = e20 * m.e00 + e21 * m.e10 + e22 * m.e20 + e23 * m.e30;
+        t1 = e20 * m.e01 + e21 * m.e11 + e22 * m.e21 + e23 * m.e31;
+        t2 = e20 * m.e02 + e21 * m.e12 + e22 * m.e22 + e23 * m.e32;
+        e23 = e20 * m.e03 + e21 * m.e13 + e22 * m.e23 + e23 * m.e33;
+        e20 = t0;
+        e21 = t1;
+        e22 = t2;
+
+        t0 = e30 * m.e00 + e31 * m.e10 + e32 * m.e20 + e33 * m.e30;
+        t1 = e30 * m.e01 + e31 * m.e11 + e32 * m.e21 + e33 * m.e31;
+        t2 = e30 * m.e02 + e31 * m.e12 + e32 * m.e22 + e33 * m.e32;
+        e33 = e30 * m.e03 + e31 * m.e13 + e32 * m.e23 + e33 * m.e33;
+        e30 = t0;
+        e31 = t1;
+        e32 = t2;
+    }
+#endif
+    return *this;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// The following functions create a new matrix holding a particular transformation
+// Identity, translation and scaling are constexpr and defined in the header
+
+// Return an X-axis rotation matrix of the given angle (in radians)
+CMatrix4x4 MatrixRotationX(float x)
+{
+    float sX, cX;
+    SinCos(x, sX, cX);
+
+    return CMatrix4x4{ 1,   0,   0,  0,
+                       0,  cX,  sX,  0,
+                       0, -sX,  cX,  0,
+                       0,   0,   0,  1 };
+}
+
+// Return a Y-axis rotation matrix of the given angle (in radians)
+CMatrix4x4 MatrixRotationY(float y)
+{
+    float sY, cY;
+    SinCos(y, sY, cY);
+
+    return CMatrix4x4{ cY,   0, -sY,  0,
+                        0,   1,   0,  0,
+                       sY,   0,  cY,  0,
+                        0,   0,   0,  1 };
+}
+
+// Return a Z-axis rotation matrix of the given angle (in radians)
+CMatrix4x4 MatrixRotationZ(float z)
+{
+    float sZ, cZ;
+    SinCos(z, sZ, cZ);
+
+    return CMatrix4x4{ cZ,  sZ,  0,  0,
+                      -sZ,  cZ,  0,  0,
+                        0,   0,  1,  0,
+                        0,   0,  0,  1 };
+}
+
+
+// Return the inverse of given matrix assuming that it is an affine matrix
+// Advanced calulation needed to get the view matrix from the camera's positioning matrix
+CMatrix4x4 InverseAffine(const CMatrix4x4& m)
+{
+    // The right-hand column is not needed, use the 3x4 version which does the work
+    return InverseAffine(CAffine3x4(m)).ToMatrix4x4();
+}
+
+// Return the inverse of any 4x4 matrix
+// Uses cofactors, with the 2x2 determinants from the top two rows (s) and bottom two rows (c) each calculated once
+CMatrix4x4 Inverse(const CMatrix4x4& m, float* determinant /*= nullptr*/)
+{
+    float s0 = m.e00*m.e11 - m.e10*m.e01;
+    float s1 = m.e00*m.e12 - m.e10*m.e02;
+    float s2 = m.e00*m.e13 - m.e10*m.e03;
+    float s3 = m.e01*m.e12 - m.e11*m.e02;
+    float s4 = m.e01*m.e13 - m.e11*m.e03;
+    float s5 = m.e02*m.e13 - m.e12*m.e03;
+
+    float c5 = m.e22*m.e33 - m.e32*m.e23;
+    float c4 = m.e21*m.e33 - m.e31*m.e23;
+    float c3 = m.e21*m.e32 - m.e31*m.e22;
+    float c2 = m.e20*m.e33 - m.e30*m.e23;
+    float c1 = m.e20*m.e32 - m.e30*m.e22;
+    float c0 = m.e20*m.e31 - m.e30*m.e21;
+
+    float det = s0*c5 - s1*c4 + s2*c3 + s3*c2 - s4*c1 + s5*c0;
+    if (determinant != nullptr)  *determinant = det;
+    float invDet = (det != 0.0f) ? 1.0f / det : 0.0f;
+
+    return CMatrix4x4{ ( m.e11*c5 - m.e12*c4 + m.e13*c3) * invDet,
+                       (-m.e01*c5 + m.e02*c4 - m.e03*c3) * invDet,
+                       ( m.e31*s5 - m.e32*s4 + m.e33*s3) * invDet,
+                       (-m.e21*s5 + m.e22*s4 - m.e23*s3) * invDet,
+
+                       (-m.e10*c5 + m.e12*c2 - m.e13*c1) * invDet,
+                       ( m.e00*c5 - m.e02*c2 + m.e03*c1) * invDet,
+                       (-m.e30*s5 + m.e32*s2 - m.e33*s1) * invDet,
+                       ( m.e20*s5 - m.e22*s2 + m.e23*s1) * invDet,
+
+                       ( m.e10*c4 - m.e11*c2 + m.e13*c0) * invDet,
+                       (-m.e00*c4 + m.e01*c2 - m.e03*c0) * invDet,
+                       ( m.e30*s4 - m.e31*s2 + m.e33*s0) * invDet,
+                       (-m.e20*s4 + m.e21*s2 - m.e23*s0) * invDet,
+
+                       (-m.e10*c3 + m.e11*c1 - m.e12*c0) * invDet,
+                       ( m.e00*c3 - m.e01*c1 + m.e02*c0) * invDet,
+                       (-m.e30*s3 + m.e31*s1 - m.e32*s0) * invDet,
+                       ( m.e20*s3 - m.e21*s1 + m.e22*s0) * invDet };
+}
+
+
+// Return the inverse transpose of the upper-left 3x3 of the given matrix, with no translation
+CMatrix4x4 InverseTranspose3x3(const CMatrix4x4& m, float* determinant /*= nullptr*/)
+{
+    return InverseTranspose3x3(CAffine3x4(m), determinant).ToMatrix4x4();
+}
+
+
+// Make this matrix an affine 3D transformation matrix to face from current position to given target (in the Z direction)
+// Will retain the matrix's current scaling. Square roots use the given precision (see MathHelpers.h)
+template <Precision P>
+void CMatrix4x4::FaceTarget(const CVector3& target)
+{
+    // Use cross product of target direction and up vector to give third axis, then orthogonalise
+    // Normalise returns a zero vector if it fails, which is quicker to test than the length
+    CVector3 axisX, axisY, axisZ;
+    axisZ = Normalise<P>(target - GetPosition());
+    if (axisZ.x == 0 && axisZ.y == 0 && axisZ.z == 0) return;
+    axisX = Normalise<P>(Cross({0, 1, 0}, axisZ));
+    if (axisX.x == 0 && axisX.y == 0 && axisX.z == 0) return;
+    axisY = Cross(axisZ, axisX); // Will already be normalised
+
+    // Set rows of matrix, restoring existing scale. Position will be unchanged, 4th column
+    // taken from unit matrix
+    CVector3 scale = { Length<P>(GetXAxis()), Length<P>(GetYAxis()), Length<P>(GetZAxis()) };
+    SetRow(0, axisX * scale.x);
+    SetRow(1, axisY * scale.y);
+    SetRow(2, axisZ * scale.z);
+}
+
+// Instantiate FaceTarget for each precision
+template void CMatrix4x4::FaceTarget<Precision::Exact>(const CVector3&);
+template void CMatrix4x4::FaceTarget<Precision::Refined>(const CVector3&);
+template void CMatrix4x4::FaceTarget<Precision::Raw>(const CVector3&);
+
+
+// Return the rotation stored in this matrix as Euler angles
+// The sines and cosines of the angles are read from the matrix, then converted to angles with Atan2 (see MathTrig.h)
+CVector3 CMatrix4x4::GetEulerAngles()
+{
+    // Inverse scaling of each axis to extract rotational values only
+    float invScaleX = InvSqrt(e00*e00 + e01*e01 + e02*e02);
+    float invScaleY = InvSqrt(e10*e10 + e11*e11 + e12*e12);
+    float invScaleZ = InvSqrt(e20*e20 + e21*e21 + e22*e22);
+
+    float sX, cX, sY, cY, sZ, cZ;
+
+    sX = -e21 * invScaleZ;
+    cX = std::sqrt(std::max(1.0f - sX*sX, 0.0f)); // Rounding can push sX slightly above 1
+
+    // If no gimbal lock...
+    if (cX > 0.001f)
+    {
+        // Each pair of values below shares the factor 1/cX, which Atan2 ignores, so it is not needed
+        sZ = e01 * invScaleX;
+        cZ = e11 * invScaleY;
+        sY = e20 * invScaleZ;
+        cY = e22 * invScaleZ;
+    }
+    else
+    {
+        // Gimbal lock - force Z angle to 0
+        sZ = 0.0f;
+        cZ = 1.0f;
+        sY = -e02 * invScaleX;
+        cY =  e00 * invScaleX;
+    }
+
+    return { Atan2(sX, cX), Atan2(sY, cY), Atan2(sZ, cZ) };
+}
+
+
+
+// Transpose the matrix (rows become columns). There are two ways to store a matrix, by rows or by columns.
+// Different apps use different methods. Use Transpose to swap when necessary.
+void CMatrix4x4::Transpose()
+{
+    std::swap(e01, e10);
+    std::swap(e02, e20);
+    std::swap(e03, e30);
+    std::swap(e12, e21);
+    std::swap(e13, e31);
+    std::swap(e23, e32);
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Compile-time checks
+-----------------------------------------------------------------------------------------*/
+// These fail the build if the constexpr functions in the header stop working at compile time
+
+static_assert(MatrixIdentity().e00 == 1 && MatrixIdentity().e01 == 0 && MatrixIdentity().e33 == 1, "MatrixIdentity must be constexpr");
+static_assert(MatrixTranslation({ 1, 2, 3 }).GetPosition().z == 3, "MatrixTranslation must be constexpr");
+static_assert(MatrixScaling(2).e11 == 2 && MatrixScaling({ 1, 2, 3 }).e22 == 3, "MatrixScaling must be constexpr");
+
+// Scale then translate - translation is not scaled, scale is kept in the axes
+constexpr CMatrix4x4 kScaleTranslate = MatrixMultiplyScalar(MatrixScaling(3), MatrixTranslation({ 10, -10, 20 }));
+static_assert(kScaleTranslate.e00 == 3 && kScaleTranslate.GetPosition().y == -10, "MatrixMultiplyScalar must be constexpr");
+
+// Translate then scale - translation is scaled
+constexpr CMatrix4x4 kTranslateScale = MatrixMultiplyScalar(MatrixTranslation({ 10, -10, 20 }), MatrixScaling(3));
+static_assert(kTranslateScale.GetPosition().x == 30 && kTranslateScale.e33 == 1, "MatrixMultiplyScalar must use row-vector order");
@@ -0,0 +1,220 @@
+//--------------------------------------------------------------------------------------
+// Matrix4x4 class (cut down version) to hold matrices for 3D
+//--------------------------------------------------------------------------------------
+// Most code in .cpp file. CMatrix4x4 is an aggregate of floats so it is a literal type, matrices can
+// be built at compile time with brace initialisation or the constexpr functions in this header
+
+#ifndef _CMATRIX4X4_H_DEFINED_
+#define _CMATRIX4X4_H_DEFINED_
+
+#include "CVector3.h"
+#include "MathSIMD.h"
+#include <cmath>
+#include <algorithm>
+
+
+// Matrix class
+// Storage can be 16-byte aligned for the SIMD code by defining MATH_ALIGN_MATRICES (see MathSIMD.h)
+class MATH_MATRIX_ALIGN CMatrix4x4
+{
+// Concrete class - public access
+public:
+	// Matrix elements
+	float e00, e01, e02, e03;
+	float e10, e11, e12, e13;
+	float e20, e21, e22, e23;
+	float e30, e31, e32, e33;
+
+ 
+    /*-----------------------------------------------------------------------------------------
+        Member functions
+    -----------------------------------------------------------------------------------------*/
+
+	// Set a single row (range 0-3) of the matrix using a CVector3. Fourth element left unchanged
+    // Can be used to set position or x,y,z axes in a matrix
+    void SetRow(int iRow, const CVector3& v);
+
+    // Get a single row (range 0-3) of the matrix into a CVector3. Fourth element is ignored
+    // Can be used to access position or x,y,z axes from a matrix
+    CVector3 GetRow(int iRow) const;
+
+    // Initialise this matrix with a pointer to 16 floats 
+    // Copies element by element because the source may not have the same alignment as a CMatrix4x4
+    void SetValues(const float* matrixValues)  { std::copy(matrixValues, matrixValues + 16, &e00); }
+
+ 
+    // Helper functions
+    constexpr CVector3 GetXAxis() const { return { e00, e01, e02 }; }
+    constexpr CVector3 GetYAxis() const { return { e10, e11, e12 }; }
+    constexpr CVector3 GetZAxis() const { return { e20, e21, e22 }; }
+    constexpr CVector3 GetPosition() const  { return { e30, e31, e32 }; }
+    CVector3 GetEulerAngles();
+    CVector3 GetScale() const  { return { Length(GetXAxis()), Length(GetYAxis()) , Length(GetZAxis()) }; }
+
+    // Post-multiply this matrix by the given one
+    CMatrix4x4& operator*=(const CMatrix4x4& m);
+
+    // Make this matrix an affine 3D transformation matrix to face from current position to given
+    // target (in the Z direction). Can pass up vector for the constructed matrix and specify
+    // handedness (right-handed Z axis will face away from target)
+    // Will retain the matrix's current scaling. Normalising uses exact square roots by default, per-frame callers can
+    // opt in to a faster precision (see MathHelpers.h), e.g. m.FaceTarget<Precision::Refined>(target)
+    template <Precision P = Precision::Exact>
+    void FaceTarget(const CVector3& target);
+
+
+    // Transpose the matrix (rows become columns). There are two ways to store a matrix, by rows or by columns.
+    // Different apps use different methods. Use Transpose to swap when necessary.
+    void Transpose();
+};
+
+
+/*-----------------------------------------------------------------------------------------
+    Operators
+-----------------------------------------------------------------------------------------*/
+
+// Matrix-matrix multiplication always using plain C++ whatever instruction set has been selected.
+// Reference version for checking and benchmarking the SIMD code. Also constexpr, so use this to
+// combine constant matrices at compile time (operator* can't be constexpr as it uses intrinsics)
+constexpr CMatrix4x4 MatrixMultiplyScalar(const CMatrix4x4& m1, const CMatrix4x4& m2)
+{
+    return CMatrix4x4{ m1.e00*m2.e00 + m1.e01*m2.e10 + m1.e02*m2.e20 + m1.e03*m2.e30,
+                       m1.e00*m2.e01 + m1.e01*m2.e11 + m1.e02*m2.e21 + m1.e03*m2.e31,
+                       m1.e00*m2.e02 + m1.e01*m2.e12 + m1.e02*m2.e22 + m1.e03*m2.e32,
+                       m1.e00*m2.e03 + m1.e01*m2.e13 + m1.e02*m2.e23 + m1.e03*m2.e33,
+
+                       m1.e10*m2.e00 + m1.e11*m2.e10 + m1.e12*m2.e20 + m1.e13*m2.e30,
+                       m1.e10*m2.e01 + m1.e11*m2.e11 + m1.e12*m2.e21 + m1.e13*m2.e31,
+                       m1.e10*m2.e02 + m1.e11*m2.e12 + m1.e12*m2.e22 + m1.e13*m2.e32,
+                       m1.e10*m2.e03 + m1.e11*m2.e13 + m1.e12*m2.e23 + m1.e13*m2.e33,
+
+                       m1.e20*m2.e00 + m1.e21*m2.e10 + m1.e22*m2.e20 + m1.e23*m2.e30,
+                       m1.e20*m2.e01 + m1.e21*m2.e11 + m1.e22*m2.e21 + m1.e23*m2.e31,
+                       m1.e20*m2.e02 + m1.e21*m2.e12 + m1.e22*m2.e22 + m1.e23*m2.e32,
+                       m1.e20*m2.e03 + m1.e21*m2.e13 + m1.e22*m2.e23 + m1.e23*m2.e33,
+
+                       m1.e30*m2.e00 + m1.e31*m2.e10 + m1.e32*m2.e20 + m1.e33*m2.e30,
+                       m1.e30*m2.e01 + m1.e31*m2.e11 + m1.e32*m2.e21 + m1.e33*m2.e31,
+                       m1.e30*m2.e02 + m1.e31*m2.e12 + m1.e32*m2.e22 + m1.e33*m2.e32,
+                       m1.e30*m2.e03 + m1.e31*m2.e13 + m1.e32*m2.e23 + m1.e33*m2.e33 };
+}
+
+
+// Matrix-matrix multiplication
+// Uses AVX if available (selected at build time, see MathSIMD.h), otherwise plain C++. Each row of the result is a
+// weighted sum of the rows of m2, the weights being the elements of the matching row of m1. The AVX version does two
+// rows at once. An SSE version (one row at a time) benchmarked slower than the plain C++, which the compiler already
+// vectorises, so SSE builds use MatrixMultiplyScalar. Inline because a multiply only takes a few nanoseconds, as a
+// function call the overhead cancelled out the gain from the SIMD code
+inline CMatrix4x4 operator*(const CMatrix4x4& m1, const CMatrix4x4& m2)
+{
+#if defined(MATH_AVX)
+    // Each row of m2 copied into both halves of a 256-bit register
+    const float* b = &m2.e00;
+    __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b));
+    __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 4));
+    __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 8));
+    __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b + 12));
+
+    // Shuffles work within each 128-bit half, so each half broadcasts an element from its own row of m1
+    CMatrix4x4 mOut;
+    const float* a = &m1.e00;
+    float* out = &mOut.e00;
+    for (int row = 0; row < 4; row += 2)
+    {
+        __m256 a01 = _mm256_loadu_ps(a + row * 4);
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x00), b0);
+#if defined(MATH_FMA)
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1, r);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2, r);
+        r = _mm256_fmadd_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3, r);
+#else
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0x55), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xAA), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a01, a01, 0xFF), b3));
+#endif
+        _mm256_storeu_ps(out + row * 4, r);
+    }
+    return mOut;
+#else
+    return MatrixMultiplyScalar(m1, m2);
+#endif
+}
+
+
+/*-----------------------------------------------------------------------------------------
+  Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// The following functions create a new matrix holding a particular transformation
+// They can be used as temporaries in calculations, e.g.
+//     CMatrix4x4 m = MatrixScaling( 3.0f ) * MatrixTranslation( CVector3(10.0f, -10.0f, 20.0f) );
+// Identity, translation and scaling are constexpr so constant transforms can be built at compile time:
+//     constexpr CMatrix4x4 m = MatrixMultiplyScalar(MatrixScaling(3.0f), MatrixTranslation({ 10.0f, -10.0f, 20.0f }));
+
+// Return an identity matrix
+constexpr CMatrix4x4 MatrixIdentity()
+{
+    return CMatrix4x4{ 1, 0, 0, 0,
+                       0, 1, 0, 0,
+                       0, 0, 1, 0,
+                       0, 0, 0, 1 };
+}
+
+// Return a translation matrix of the given vector
+constexpr CMatrix4x4 MatrixTranslation(const CVector3& t)
+{
+    return CMatrix4x4  { 1,   0,   0,  0,
+                         0,   1,   0,  0,
+                         0,   0,   1,  0,
+                       t.x, t.y, t.z,  1 };
+}
+
+
+// Return an X-axis rotation matrix of the given angle (in radians)
+CMatrix4x4 MatrixRotationX(float x);
+
+// Return a Y-axis rotation matrix of the given angle (in radians)
+CMatrix4x4 MatrixRotationY(float y);
+
+// Return a Z-axis rotation matrix of the given angle (in radians)
+CMatrix4x4 MatrixRotationZ(float z);
+
+
+// Return a matrix that is a scaling in X,Y and Z of the values in the given vector
+constexpr CMatrix4x4 MatrixScaling(const CVector3& s)
+{
+    return CMatrix4x4{ s.x,   0,   0,  0,
+                       0,   s.y,   0,  0,
+                       0,     0, s.z,  0,
+                       0,     0,   0,  1 };
+}
+
+// Return a matrix that is a uniform scaling of the given amount
+constexpr CMatrix4x4 MatrixScaling(const float s)
+{
+    return CMatrix4x4{ s, 0, 0, 0,
+                       0, s, 0, 0,
+                       0, 0, s, 0,
+                       0, 0, 0, 1 };
+}
+
+
+
+// Return the inverse of given matrix assuming that it is an affine matrix
+// Advanced calulation needed to get the view matrix from the camera's positioning matrix
+CMatrix4x4 InverseAffine(const CMatrix4x4& m);
+
+// Return the inverse of any 4x4 matrix, including projection matrices, e.g. the inverse view-projection matrix
+// converts points on the screen back into the world (picking). Slower than InverseAffine, use that where possible.
+// If determinant is not null the determinant of the matrix is written there. A matrix with a zero determinant
+// has no inverse, the result is then all zeros
+CMatrix4x4 Inverse(const CMatrix4x4& m, float* determinant = nullptr);
+
+// Return the inverse transpose of the upper-left 3x3 of the given matrix, with no translation. Use this matrix to
+// transform normals when the matrix has non-uniform scaling. See CAffine3x4.h for a batched version
+// If determinant is not null the determinant of the 3x3 is written there. Result is all zeros if it is 0
+CMatrix4x4 InverseTranspose3x3(const CMatrix4x4& m, float* determinant = nullptr);
+
+
+#endif // _CMATRIX4X4_H_DEFINED_
@@ -0,0 +1,200 @@
+//--------------------------------------------------------------------------------------
+// Quaternion class (cut down version) to hold rotations in 3D
+//--------------------------------------------------------------------------------------
+
+#include "CQuaternion.h"
+#include "MathTrig.h"
+
+
+/*-----------------------------------------------------------------------------------------
+    Operators
+-----------------------------------------------------------------------------------------*/
+
+// Follow the rotation in this quaternion with the given one
+CQuaternion& CQuaternion::operator*= (const CQuaternion& q)
+{
+    *this = *this * q;
+    return *this;
+}
+
+
+// Combine rotations - rotate by q1 then by q2 (same order as matrix multiplication)
+// This is the quaternion product q2q1, which applies q1 first
+CQuaternion operator* (const CQuaternion& q1, const CQuaternion& q2)
+{
+    return CQuaternion{ q2.w * q1.x + q2.x * q1.w + q2.y * q1.z - q2.z * q1.y,
+                        q2.w * q1.y - q2.x * q1.z + q2.y * q1.w + q2.z * q1.x,
+                        q2.w * q1.z + q2.x * q1.y - q2.y * q1.x + q2.z * q1.w,
+                        q2.w * q1.w - q2.x * q1.x - q2.y * q1.y - q2.z * q1.z };
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return an X, Y or Z-axis rotation of the given angle (in radians)
+CQuaternion QuaternionRotationX(float x)
+{
+    float s, c;
+    SinCos(x * 0.5f, s, c);
+    return CQuaternion{ s, 0, 0, c };
+}
+
+CQuaternion QuaternionRotationY(float y)
+{
+    float s, c;
+    SinCos(y * 0.5f, s, c);
+    return CQuaternion{ 0, s, 0, c };
+}
+
+CQuaternion QuaternionRotationZ(float z)
+{
+    float s, c;
+    SinCos(z * 0.5f, s, c);
+    return CQuaternion{ 0, 0, s, c };
+}
+
+// Return a rotation of the given angle (in radians) around the given axis. The axis must be normalised
+CQuaternion QuaternionRotationAxis(const CVector3& axis, float angle)
+{
+    float s, c;
+    SinCos(angle * 0.5f, s, c);
+    return CQuaternion{ axis.x * s, axis.y * s, axis.z * s, c };
+}
+
+
+// Return the rotation given by Euler angles, applied in the order Z, X then Y - the same as a model's
+// rotation matrix: MatrixRotationZ(a.z) * MatrixRotationX(a.x) * MatrixRotationY(a.y)
+// This is the product of the three single axis rotations above, multiplied out
+CQuaternion QuaternionFromEulerAngles(const CVector3& angles)
+{
+    float sX, cX, sY, cY, sZ, cZ;
+    SinCos(angles.x * 0.5f, sX, cX);
+    SinCos(angles.y * 0.5f, sY, cY);
+    SinCos(angles.z * 0.5f, sZ, cZ);
+
+    return CQuaternion{ cY * sX * cZ + sY * cX * sZ,
+                        sY * cX * cZ - cY * sX * sZ,
+                        cY * cX * sZ - sY * sX * cZ,
+                        cY * cX * cZ + sY * sX * sZ };
+}
+
+
+// Return the rotation held in the given matrix. The matrix's X, Y and Z axes should be normalised (no scaling)
+// Uses the largest of w, x, y or z to calculate the others to avoid dividing by small values
+CQuaternion QuaternionFromMatrix(const CMatrix4x4& m)
+{
+    float trace = m.e00 + m.e11 + m.e22;
+    if (trace > 0.0f)
+    {
+        float s = 0.5f / std::sqrt(trace + 1.0f);
+        return CQuaternion{ (m.e12 - m.e21) * s, (m.e20 - m.e02) * s, (m.e01 - m.e10) * s, 0.25f / s };
+    }
+    else if (m.e00 > m.e11 && m.e00 > m.e22)
+    {
+        float s = 0.5f / std::sqrt(1.0f + m.e00 - m.e11 - m.e22);
+        return CQuaternion{ 0.25f / s, (m.e01 + m.e10) * s, (m.e20 + m.e02) * s, (m.e12 - m.e21) * s };
+    }
+    else if (m.e11 > m.e22)
+    {
+        float s = 0.5f / std::sqrt(1.0f + m.e11 - m.e00 - m.e22);
+        return CQuaternion{ (m.e01 + m.e10) * s, 0.25f / s, (m.e12 + m.e21) * s, (m.e20 - m.e02) * s };
+    }
+    else
+    {
+        float s = 0.5f / std::sqrt(1.0f + m.e22 - m.e00 - m.e11);
+        return CQuaternion{ (m.e20 + m.e02) * s, (m.e12 + m.e21) * s, 0.25f / s, (m.e01 - m.e10) * s };
+    }
+}
+
+
+// Return a rotation matrix (no scaling or translation) matching the given quaternion, which must be normalised
+CMatrix4x4 MatrixRotation(const CQuaternion& q)
+{
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return CMatrix4x4{ 1 - 2 * (yy + zz),     2 * (xy + wz),     2 * (xz - wy), 0,
+                           2 * (xy - wz), 1 - 2 * (xx + zz),     2 * (yz + wx), 0,
+                           2 * (xz + wy),     2 * (yz - wx), 1 - 2 * (xx + yy), 0,
+                                       0,                 0,                 0, 1 };
+}
+
+
+// Return the Euler angles (Z, X then Y order) of the given quaternion
+CVector3 GetEulerAngles(const CQuaternion& q)
+{
+    return MatrixRotation(q).GetEulerAngles();
+}
+
+
+// Return the given vector rotated by the quaternion. Same result as transforming the vector by MatrixRotation(q)
+// Optimised form of the quaternion product q v q* (with q applied on the right of row vectors as for matrices)
+CVector3 Rotate(const CVector3& v, const CQuaternion& q)
+{
+    CVector3 qv = { q.x, q.y, q.z };
+    CVector3 t = 2.0f * Cross(qv, v);
+    return v + q.w * t + Cross(qv, t);
+}
+
+
+// Return the given quaternion normalised (unit length)
+CQuaternion Normalise(const CQuaternion& q)
+{
+    float lengthSq = Dot(q, q);
+
+    // Zero length quaternions have no meaningful rotation, return identity
+    if (IsZero(lengthSq))
+    {
+        return QuaternionIdentity();
+    }
+    else
+    {
+        float invLength = InvSqrt(lengthSq);
+        return CQuaternion{ q.x * invLength, q.y * invLength, q.z * invLength, q.w * invLength };
+    }
+}
+
+// Interpolate between two rotations using constant angular speed, t = 0 gives q1, t = 1 gives q2
+CQuaternion Slerp(const CQuaternion& q1, const CQuaternion& q2, float t)
+{
+    // q and -q are the same rotation, choose the sign of q2 that gives the shortest path
+    float cosAngle = Dot(q1, q2);
+    float sign = 1.0f;
+    if (cosAngle < 0.0f)
+    {
+        cosAngle = -cosAngle;
+        sign = -1.0f;
+    }
+
+    // Very close rotations give a near-zero sin below, but lerp is accurate there anyway
+    if (cosAngle > 0.9995f)
+    {
+        return Nlerp(q1, q2, t);
+    }
+
+    float angle = std::acos(cosAngle);
+    float invSin = 1.0f / std::sin(angle);
+    float w1 = std::sin((1.0f - t) * angle) * invSin;
+    float w2 = std::sin(t * angle) * invSin * sign;
+    return CQuaternion{ q1.x * w1 + q2.x * w2, q1.y * w1 + q2.y * w2, q1.z * w1 + q2.z * w2, q1.w * w1 + q2.w * w2 };
+}
+
+// Interpolate between two rotations using linear interpolation then renormalising, t = 0 gives q1, t = 1 gives q2
+CQuaternion Nlerp(const CQuaternion& q1, const CQuaternion& q2, float t)
+{
+    float w1 = 1.0f - t;
+    float w2 = (Dot(q1, q2) < 0.0f) ? -t : t; // Shortest path as above
+    return Normalise(CQuaternion{ q1.x * w1 + q2.x * w2, q1.y * w1 + q2.y * w2, q1.z * w1 + q2.z * w2, q1.w * w1 + q2.w * w2 });
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Compile-time checks
+-----------------------------------------------------------------------------------------*/
+// These fail the build if the constexpr functions in the header stop working at compile time
+
+static_assert(QuaternionIdentity().w == 1 && Dot(QuaternionIdentity(), QuaternionIdentity()) == 1, "QuaternionIdentity must be constexpr");
+static_assert(Inverse(CQuaternion{ 1, 2, 3, 4 }).x == -1 && Inverse(CQuaternion{ 1, 2, 3, 4 }).w == 4, "Inverse must be constexpr");
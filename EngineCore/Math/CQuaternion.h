@@ -0,0 +1,121 @@
+//--------------------------------------------------------------------------------------
+// Quaternion class (cut down version) to hold rotations in 3D
+//--------------------------------------------------------------------------------------
+// Most code in .cpp file, simple constexpr functions are defined here
+// A quaternion stores a rotation in 4 floats. Compared to a matrix it is smaller, quicker to combine,
+// can be smoothly interpolated (slerp / nlerp) and easily renormalised to remove accumulated error.
+// Convert it to a matrix (MatrixRotation) when it is needed for rendering.
+//
+// Conventions match the matrix functions in CMatrix4x4.h: rotations are left-handed (DirectX) and
+// q1 * q2 means rotate by q1 then by q2, so MatrixRotation(q1 * q2) == MatrixRotation(q1) * MatrixRotation(q2)
+
+#ifndef _CQUATERNION_H_DEFINED_
+#define _CQUATERNION_H_DEFINED_
+
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include <cmath>
+
+
+class CQuaternion
+{
+// Concrete class - public access
+public:
+    // Quaternion components - x, y, z are the vector part, w the scalar part
+    float x;
+    float y;
+    float z;
+    float w;
+
+    /*-----------------------------------------------------------------------------------------
+        Constructors
+    -----------------------------------------------------------------------------------------*/
+
+    // Default constructor - leaves values uninitialised (for performance)
+    CQuaternion() {}
+
+    // Construct with 4 values
+    constexpr CQuaternion(const float xIn, const float yIn, const float zIn, const float wIn)
+        : x(xIn), y(yIn), z(zIn), w(wIn) {}
+
+
+    /*-----------------------------------------------------------------------------------------
+        Member functions
+    -----------------------------------------------------------------------------------------*/
+
+    // Follow the rotation in this quaternion with the given one
+    CQuaternion& operator*= (const CQuaternion& q);
+};
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member operators
+-----------------------------------------------------------------------------------------*/
+
+// Combine rotations - rotate by q1 then by q2 (same order as matrix multiplication)
+CQuaternion operator* (const CQuaternion& q1, const CQuaternion& q2);
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// The following functions create a new quaternion holding a particular rotation, in the same way as the matrix functions
+
+// Return a quaternion that represents no rotation
+constexpr CQuaternion QuaternionIdentity()
+{
+    return CQuaternion{ 0, 0, 0, 1 };
+}
+
+// Return an X, Y or Z-axis rotation of the given angle (in radians)
+CQuaternion QuaternionRotationX(float x);
+CQuaternion QuaternionRotationY(float y);
+CQuaternion QuaternionRotationZ(float z);
+
+// Return a rotation of the given angle (in radians) around the given axis. The axis must be normalised
+CQuaternion QuaternionRotationAxis(const CVector3& axis, float angle);
+
+// Return the rotation given by Euler angles, applied in the order Z, X then Y - the same as a model's
+// rotation matrix: MatrixRotationZ(a.z) * MatrixRotationX(a.x) * MatrixRotationY(a.y)
+CQuaternion QuaternionFromEulerAngles(const CVector3& angles);
+
+// Return the rotation held in the given matrix. The matrix's X, Y and Z axes should be normalised (no scaling)
+CQuaternion QuaternionFromMatrix(const CMatrix4x4& m);
+
+
+// Return a rotation matrix (no scaling or translation) matching the given quaternion, which must be normalised
+CMatrix4x4 MatrixRotation(const CQuaternion& q);
+
+// Return the Euler angles (Z, X then Y order as above) of the given quaternion
+CVector3 GetEulerAngles(const CQuaternion& q);
+
+// Return the given vector rotated by the quaternion. Same result as transforming the vector by MatrixRotation(q)
+CVector3 Rotate(const CVector3& v, const CQuaternion& q);
+
+
+// Dot product of two quaternions - the cosine of half the angle between the rotations if they are normalised
+constexpr float Dot(const CQuaternion& q1, const CQuaternion& q2)
+{
+    return q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+}
+
+// Return the given quaternion normalised (unit length). Rotations should always be normalised, renormalise
+// occasionally when quaternions are repeatedly combined to remove accumulated rounding errors
+CQuaternion Normalise(const CQuaternion& q);
+
+// Return the inverse of the given rotation. Only valid for normalised quaternions (which is the conjugate)
+constexpr CQuaternion Inverse(const CQuaternion& q)
+{
+    return CQuaternion{ -q.x, -q.y, -q.z, q.w };
+}
+
+
+// Interpolate between two rotations, t = 0 gives q1, t = 1 gives q2. Both use the shortest path between the rotations
+// - Slerp: constant angular speed, more expensive
+// - Nlerp: linear interpolation then renormalise, cheap and close enough to Slerp for small angles (e.g. animation keys)
+CQuaternion Slerp(const CQuaternion& q1, const CQuaternion& q2, float t);
+CQuaternion Nlerp(const CQuaternion& q1, const CQuaternion& q2, float t);
+
+
+#endif // _CQUATERNION_H_DEFINED_
@@ -0,0 +1,109 @@
+//--------------------------------------------------------------------------------------
+// Transform class holding position, rotation and scale separately (TRS)
+//--------------------------------------------------------------------------------------
+
+#include "CTransform.h"
+
+
+/*-----------------------------------------------------------------------------------------
+    Constructors
+-----------------------------------------------------------------------------------------*/
+
+// Construct from a matrix by separating it into position, rotation and scale
+// The matrix must be affine and have no shear (i.e. built from scaling, rotation and translation)
+// An axis with (near) zero scale has no direction, so it is given a zero scale and a unit axis at right angles to the
+// others for the rotation. A matrix with all three scales zero gives an identity rotation
+CTransform::CTransform(const CAffine3x4& m)
+{
+    position = m.GetPosition();
+    scale = m.GetScale();
+
+    // A mirrored matrix (negative determinant) can't be held in a quaternion, put the mirroring in the scale instead
+    if (Dot(Cross(m.GetXAxis(), m.GetYAxis()), m.GetZAxis()) < 0.0f)
+    {
+        scale.x = -scale.x;
+    }
+
+    // Remove scale from the axes to leave a pure rotation
+    CVector3 axes[3] = { m.GetXAxis(), m.GetYAxis(), m.GetZAxis() };
+    float* scales = &scale.x;
+    bool valid[3];
+    int numValid = 0;
+    int lastValid = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        valid[i] = !IsZero(scales[i]);
+        if (valid[i])
+        {
+            axes[i] = axes[i] * (1.0f / scales[i]);
+            lastValid = i;
+            ++numValid;
+        }
+        else
+        {
+            scales[i] = 0.0f;
+        }
+    }
+
+    if (numValid == 0)
+    {
+        rotation = QuaternionIdentity();
+        return;
+    }
+    if (numValid == 1)
+    {
+        // Next axis is any unit vector at right angles to the valid one, using the world axis least in line with it
+        const CVector3& axis = axes[lastValid];
+        CVector3 other = (std::abs(axis.x) < 0.5f) ? CVector3{ 1, 0, 0 } : CVector3{ 0, 1, 0 };
+        axes[(lastValid + 1) % 3] = Normalise(Cross(axis, other));
+        valid[(lastValid + 1) % 3] = true;
+    }
+    if (numValid < 3)
+    {
+        // Remaining axis from the other two, in the order that keeps the axes right-handed (x = y*z, y = z*x, z = x*y)
+        for (int i = 0; i < 3; ++i)
+        {
+            if (!valid[i])  axes[i] = Normalise(Cross(axes[(i + 1) % 3], axes[(i + 2) % 3]));
+        }
+    }
+
+    CMatrix4x4 rotationMatrix = MatrixIdentity();
+    rotationMatrix.SetRow(0, axes[0]);
+    rotationMatrix.SetRow(1, axes[1]);
+    rotationMatrix.SetRow(2, axes[2]);
+    rotation = Normalise(QuaternionFromMatrix(rotationMatrix));
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return the matrix for this transform. Rows of the rotation matrix are scaled, then the
+// position is put in the bottom row - no matrix multiplications needed
+CAffine3x4 CTransform::GetAffineMatrix() const
+{
+    const CQuaternion& q = rotation;
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return CAffine3x4{ { scale.x * (1 - 2 * (yy + zz)), scale.x * 2 * (xy + wz),       scale.x * 2 * (xz - wy)       },
+                       { scale.y * 2 * (xy - wz),       scale.y * (1 - 2 * (xx + zz)), scale.y * 2 * (yz + wx)       },
+                       { scale.z * 2 * (xz + wy),       scale.z * 2 * (yz - wx),       scale.z * (1 - 2 * (xx + yy)) },
+                       position };
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Interpolate between two transforms, t = 0 gives t1, t = 1 gives t2
+// Position and scale are interpolated linearly, rotation uses Slerp
+CTransform Interpolate(const CTransform& t1, const CTransform& t2, float t)
+{
+    return CTransform{ t1.position + (t2.position - t1.position) * t,
+                       Slerp(t1.rotation, t2.rotation, t),
+                       t1.scale + (t2.scale - t1.scale) * t };
+}
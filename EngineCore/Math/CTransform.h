@@ -0,0 +1,84 @@
+//--------------------------------------------------------------------------------------
+// Transform class holding position, rotation and scale separately (TRS)
+//--------------------------------------------------------------------------------------
+// Code in .cpp file
+// An alternative to keeping a full matrix for things that are moved, rotated and scaled each frame.
+// Changing one part does not need the matrix to be rebuilt from several matrices multiplied together,
+// and rotations can be combined, interpolated and renormalised as quaternions. Call GetMatrix when the
+// matrix is actually needed (e.g. for rendering), it is built directly from the three parts.
+//
+// The matrix is the same as MatrixScaling(scale) * MatrixRotation(rotation) * MatrixTranslation(position),
+// i.e. scale, then rotate, then move. A transform cannot hold a matrix with shear.
+
+#ifndef _CTRANSFORM_H_DEFINED_
+#define _CTRANSFORM_H_DEFINED_
+
+#include "CVector3.h"
+#include "CQuaternion.h"
+#include "CMatrix4x4.h"
+#include "CAffine3x4.h"
+
+
+class CTransform
+{
+// Concrete class - public access
+public:
+    CVector3    position;
+    CQuaternion rotation; // Must be kept normalised
+    CVector3    scale;
+
+    /*-----------------------------------------------------------------------------------------
+        Constructors
+    -----------------------------------------------------------------------------------------*/
+
+    // Default constructor - leaves values uninitialised (for performance)
+    CTransform() {}
+
+    // Construct from position, rotation and scale
+    constexpr CTransform(const CVector3& positionIn, const CQuaternion& rotationIn, const CVector3& scaleIn = { 1, 1, 1 })
+        : position(positionIn), rotation(rotationIn), scale(scaleIn) {}
+
+    // Construct from a matrix by separating it into position, rotation and scale
+    // The matrix must be affine and have no shear (i.e. built from scaling, rotation and translation)
+    // Axes with zero scale (e.g. a model scaled to 0) keep a zero scale and get a valid rotation
+    explicit CTransform(const CAffine3x4& m);
+    explicit CTransform(const CMatrix4x4& m) : CTransform(CAffine3x4(m)) {}
+
+
+    /*-----------------------------------------------------------------------------------------
+        Member functions
+    -----------------------------------------------------------------------------------------*/
+
+    // Return the matrix for this transform. The affine version is smaller and quicker to combine
+    CAffine3x4 GetAffineMatrix() const;
+    CMatrix4x4 GetMatrix() const  { return GetAffineMatrix().ToMatrix4x4(); }
+
+    // Local axes of the transform (normalised, so not including scale)
+    CVector3 GetXAxis() const  { return Rotate({ 1, 0, 0 }, rotation); }
+    CVector3 GetYAxis() const  { return Rotate({ 0, 1, 0 }, rotation); }
+    CVector3 GetZAxis() const  { return Rotate({ 0, 0, 1 }, rotation); }
+
+    // Rotate in local space, i.e. around the transform's own axes (like pre-multiplying a matrix by a rotation)
+    void RotateLocal(const CQuaternion& q)  { rotation = q * rotation; }
+
+    // Rotate in world space, i.e. around the world axes (like post-multiplying a matrix by a rotation). Position is not rotated
+    void RotateWorld(const CQuaternion& q)  { rotation = rotation * q; }
+};
+
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Return a transform with no translation, rotation or scaling
+constexpr CTransform TransformIdentity()
+{
+    return CTransform{ { 0, 0, 0 }, QuaternionIdentity(), { 1, 1, 1 } };
+}
+
+// Interpolate between two transforms, t = 0 gives t1, t = 1 gives t2
+// Position and scale are interpolated linearly, rotation uses Slerp
+CTransform Interpolate(const CTransform& t1, const CTransform& t2, float t);
+
+
+#endif // _CTRANSFORM_H_DEFINED_
@@ -2,7 +2,8 @@
 // Vector2 class (cut down version), mainly used for texture coordinates (UVs)
 // but can be used for 2D points as well
 //--------------------------------------------------------------------------------------
-// Code in .cpp file
+// Constructors, operators and Dot are constexpr and defined here so they can be evaluated at
+// compile time (e.g. constant UVs in vertex data) and inlined. Other code in .cpp file
 
 #ifndef _CVECTOR2_H_DEFINED_
 #define _CVECTOR2_H_DEFINED_
@@ -26,18 +27,12 @@ public:
     CVector2() {}
 
     // Construct with 2 values
-    CVector2(const float xIn, const float yIn)
-    {
-        x = xIn;
-        y = yIn;
-    }
+    constexpr CVector2(const float xIn, const float yIn)
+        : x(xIn), y(yIn) {}
 
     // Construct using a pointer to 2 floats
-    CVector2(const float* pfElts)
-    {
-        x = pfElts[0];
-        y = pfElts[1];
-    }
+    constexpr CVector2(const float* pfElts)
+        : x(pfElts[0]), y(pfElts[1]) {}
 
 
     /*-----------------------------------------------------------------------------------------
@@ -45,16 +40,34 @@ public:
     -----------------------------------------------------------------------------------------*/
 
     // Addition of another vector to this one, e.g. Position += Velocity
-    CVector2& operator+= (const CVector2& v);
+    constexpr CVector2& operator+= (const CVector2& v)
+    {
+        x += v.x;
+        y += v.y;
+        return *this;
+    }
 
     // Subtraction of another vector from this one, e.g. Velocity -= Gravity
-    CVector2& operator-= (const CVector2& v);
+    constexpr CVector2& operator-= (const CVector2& v)
+    {
+        x -= v.x;
+        y -= v.y;
+        return *this;
+    }
 
     // Negate this vector (e.g. Velocity = -Velocity)
-    CVector2& operator- ();
+    constexpr CVector2& operator- ()
+    {
+        x = -x;
+        y = -y;
+        return *this;
+    }
 
     // Plus sign in front of vector - called unary positive and usually does nothing. Included for completeness (e.g. Velocity = +Velocity)
-    CVector2& operator+ ();
+    constexpr CVector2& operator+ ()
+    {
+        return *this;
+    }
 };
 
 
@@ -63,10 +76,16 @@ public:
 -----------------------------------------------------------------------------------------*/
 
 // Vector-vector addition
-CVector2 operator+ (const CVector2& v, const CVector2& w);
+constexpr CVector2 operator+ (const CVector2& v, const CVector2& w)
+{
+    return CVector2{ v.x + w.x, v.y + w.y };
+}
 
 // Vector-vector subtraction
-CVector2 operator- (const CVector2& v, const CVector2& w);
+constexpr CVector2 operator- (const CVector2& v, const CVector2& w)
+{
+    return CVector2{ v.x - w.x, v.y - w.y };
+}
 
 
 /*-----------------------------------------------------------------------------------------
@@ -74,7 +93,10 @@ Non-member functions
 -----------------------------------------------------------------------------------------*/
 
 // Dot product of two given vectors (order not important) - non-member version
-float Dot(const CVector2& v1, const CVector2& v2);
+constexpr float Dot(const CVector2& v1, const CVector2& v2)
+{
+    return v1.x * v2.x + v1.y * v2.y;
+}
 
 // Return unit length vector in the same direction as given one
 CVector2 Normalise(const CVector2& v);
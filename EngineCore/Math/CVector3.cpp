@@ -0,0 +1,18 @@
+//--------------------------------------------------------------------------------------
+// Vector3 class (cut down version), to hold points and vectors
+//--------------------------------------------------------------------------------------
+
+#include "CVector3.h"
+
+
+/*-----------------------------------------------------------------------------------------
+    Compile-time checks
+-----------------------------------------------------------------------------------------*/
+// These fail the build if the constexpr functions in the header stop working at compile time
+
+static_assert(CVector3{ 1, 2, 3 }.y == 2, "CVector3 constructor must be constexpr");
+static_assert(Dot(CVector3{ 1, 2, 3 }, CVector3{ 4, 5, 6 }) == 32, "Dot must be constexpr");
+static_assert(Cross(CVector3{ 1, 0, 0 }, CVector3{ 0, 1, 0 }).z == 1, "Cross must be constexpr (X cross Y = Z)");
+static_assert((CVector3{ 1, 2, 3 } + CVector3{ 1, 1, 1 } - CVector3{ 2, 3, 4 }).x == 0, "Vector addition/subtraction must be constexpr");
+static_assert((2.0f * CVector3{ 1, 2, 3 } * 0.5f).z == 3, "Vector-scalar multiplication must be constexpr");
+static_assert((CVector3{ 1, 2, 3 } += CVector3{ 1, 1, 1 }).x == 2, "Compound assignment must be constexpr");
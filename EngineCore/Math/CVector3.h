@@ -0,0 +1,156 @@
+//--------------------------------------------------------------------------------------
+// Vector3 class (cut down version), to hold points and vectors
+//--------------------------------------------------------------------------------------
+// Constructors, operators, Dot and Cross are constexpr and defined here so they can be evaluated
+// at compile time (e.g. constant vertex data) and inlined. Normalise and Length are templates on the square root
+// precision (see MathHelpers.h) so are also defined here. The .cpp file holds compile-time checks
+
+#ifndef _CVECTOR3_H_DEFINED_
+#define _CVECTOR3_H_DEFINED_
+
+#include "MathHelpers.h"
+#include <cmath>
+
+class CVector3
+{
+// Concrete class - public access
+public:
+    // Vector components
+    float x;
+	float y;
+	float z;
+
+    /*-----------------------------------------------------------------------------------------
+        Constructors
+    -----------------------------------------------------------------------------------------*/
+
+	// Default constructor - leaves values uninitialised (for performance)
+	CVector3() {}
+
+	// Construct with 3 values
+	constexpr CVector3(const float xIn, const float yIn, const float zIn)
+		: x(xIn), y(yIn), z(zIn) {}
+	
+    // Construct using a pointer to three floats
+    constexpr CVector3(const float* pfElts)
+        : x(pfElts[0]), y(pfElts[1]), z(pfElts[2]) {}
+
+
+    /*-----------------------------------------------------------------------------------------
+        Member functions
+    -----------------------------------------------------------------------------------------*/
+
+    // Addition of another vector to this one, e.g. Position += Velocity
+    constexpr CVector3& operator+= (const CVector3& v)
+    {
+        x += v.x;
+        y += v.y;
+        z += v.z;
+        return *this;
+    }
+
+    // Subtraction of another vector from this one, e.g. Velocity -= Gravity
+    constexpr CVector3& operator-= (const CVector3& v)
+    {
+        x -= v.x;
+        y -= v.y;
+        z -= v.z;
+        return *this;
+    }
+
+    // Negate this vector (e.g. Velocity = -Velocity)
+    constexpr CVector3& operator- ()
+    {
+        x = -x;
+        y = -y;
+        z = -z;
+        return *this;
+    }
+
+    // Plus sign in front of vector - called unary positive and usually does nothing. Included for completeness (e.g. Velocity = +Velocity)
+    constexpr CVector3& operator+ ()
+    {
+        return *this;
+    }
+
+    // Multiply vector by scalar (scales vector);
+    constexpr CVector3& operator*= (const float s)
+    {
+        x *= s;
+        y *= s;
+        z *= s;
+        return *this;
+    }
+};
+	
+
+/*-----------------------------------------------------------------------------------------
+    Non-member operators
+-----------------------------------------------------------------------------------------*/
+
+// Vector-vector addition
+constexpr CVector3 operator+ (const CVector3& v, const CVector3& w)
+{
+    return CVector3{ v.x + w.x, v.y + w.y, v.z + w.z };
+}
+
+// Vector-vector subtraction
+constexpr CVector3 operator- (const CVector3& v, const CVector3& w)
+{
+    return CVector3{ v.x - w.x, v.y - w.y, v.z - w.z };
+}
+
+// Vector-scalar multiplication
+constexpr CVector3 operator* (const CVector3& v, float s)
+{
+    return CVector3{ v.x * s, v.y * s, v.z * s };
+}
+constexpr CVector3 operator* (float s, const CVector3& v)
+{
+    return CVector3{ v.x * s, v.y * s, v.z * s };
+}
+
+/*-----------------------------------------------------------------------------------------
+    Non-member functions
+-----------------------------------------------------------------------------------------*/
+
+// Dot product of two given vectors (order not important) - non-member version
+constexpr float Dot(const CVector3& v1, const CVector3& v2)
+{
+    return v1.x * v2.x + v1.y * v2.y + v1.z * v2.z;
+}
+
+// Cross product of two given vectors (order is important) - non-member version
+constexpr CVector3 Cross(const CVector3& v1, const CVector3& v2)
+{
+    return CVector3{ v1.y * v2.z - v1.z * v2.y, v1.z * v2.x - v1.x * v2.z, v1.x * v2.y - v1.y * v2.x };
+}
+
+// Return unit length vector in the same direction as given one. Zero length vectors return zero
+// Precision of the square root can be chosen, see MathHelpers.h (e.g. Normalise<Precision::Refined>(v))
+template <Precision P = Precision::Exact>
+inline CVector3 Normalise(const CVector3& v)
+{
+    float lengthSq = Dot(v, v);
+
+    // Ensure vector is not zero length (use MathHelpers.h float approx. fn with default epsilon)
+    if (IsZero(lengthSq))
+    {
+        return CVector3{ 0.0f, 0.0f, 0.0f };
+    }
+    else
+    {
+        float invLength = InvSqrt<P>(lengthSq);
+        return CVector3{ v.x * invLength, v.y * invLength, v.z * invLength };
+    }
+}
+
+// Returns length of a vector. Precision of the square root can be chosen as for Normalise
+template <Precision P = Precision::Exact>
+inline float Length(const CVector3& v)
+{
+    return Sqrt<P>(Dot(v, v));
+}
+
+
+#endif // _CVECTOR3_H_DEFINED_
@@ -0,0 +1,95 @@
+//--------------------------------------------------------------------------------------
+// Math convenience functions
+//--------------------------------------------------------------------------------------
+
+#ifndef _MATH_HELPERS_H_DEFINED_
+#define _MATH_HELPERS_H_DEFINED_
+
+#include "MathSIMD.h"
+#include <cmath>
+#include <cfloat>
+#include <cstring>
+#include <cstdint>
+
+
+// Surprisingly, pi is not *officially* defined anywhere in C++
+constexpr float PI = 3.14159265359f;
+
+
+
+// Test if a float value is approximately 0
+// Epsilon value is the range around zero that is considered equal to zero
+constexpr float EPSILON = 0.5e-6f; // For 32-bit floats, requires zero to 6 decimal places
+inline bool IsZero(const float x)
+{
+    return std::abs(x) < EPSILON;
+}
+
+
+// Precision of the square root functions below and the functions built on them (Normalise, Length and the batch
+// versions in BatchTransform.h). Chosen at compile time with a template parameter, e.g. Normalise<Precision::Refined>(v),
+// so per-frame code can opt into the fast versions while tools keep exact results. Relative errors:
+//   - Exact:   sqrt and divide, correctly rounded. The default
+//   - Refined: hardware reciprocal square root estimate then one Newton-Raphson step, under 5e-7 (a few ulp)
+//   - Raw:     hardware estimate only, up to 3.7e-4. Fine for lighting directions, not for anything accumulated
+// Without SSE there is no hardware estimate, so Refined and Raw start from the integer "fast inverse square root"
+// approximation with two and one Newton-Raphson steps instead (errors about 5e-6 and 1.8e-3)
+enum class Precision { Exact, Refined, Raw };
+
+
+// 1 / Sqrt. Used often (e.g. normalising) and can be optimised, so it gets its own function
+// x must be greater than zero for the Refined and Raw versions
+template <Precision P = Precision::Exact>
+inline float InvSqrt(const float x)
+{
+    if (P == Precision::Exact)
+    {
+        return 1.0f / std::sqrt(x);
+    }
+
+#if defined(MATH_SSE)
+    float estimate = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+    if (P == Precision::Raw)  return estimate;
+#else
+    // Initial estimate from the bits of the float, the exponent halved and negated, plus one Newton-Raphson step
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    bits = 0x5f3759df - (bits >> 1);
+    float estimate;
+    std::memcpy(&estimate, &bits, sizeof(estimate));
+    estimate = estimate * (1.5f - 0.5f * x * estimate * estimate);
+    if (P == Precision::Raw)  return estimate;
+#endif
+
+    // Newton-Raphson step, roughly doubles the number of correct bits
+    return estimate * (1.5f - 0.5f * x * estimate * estimate);
+}
+
+// Square root with the chosen precision. The fast versions multiply by the inverse square root
+template <Precision P = Precision::Exact>
+inline float Sqrt(const float x)
+{
+    if (P == Precision::Exact)
+    {
+        return std::sqrt(x);
+    }
+
+    // Clamping avoids 0 * infinity for x = 0, giving 0 * large value = 0
+    return x * InvSqrt<P>(x > FLT_MIN ? x : FLT_MIN);
+}
+
+
+// Pass an angle in degrees, returns the angle in radians
+constexpr float ToRadians(float d)
+{
+    return  d * PI / 180.0f;
+}
+
+// Pass an angle in radians, returns the angle in degrees
+constexpr float ToDegrees(float r)
+{
+    return  r * 180.0f / PI;
+}
+
+
+#endif // _MATH_HELPERS_H_DEFINED_
@@ -0,0 +1,63 @@
+//--------------------------------------------------------------------------------------
+// Build-time selection of SIMD instruction sets used by the maths classes
+//--------------------------------------------------------------------------------------
+// The maths code has a plain C++ (scalar) version of each of its hot functions, plus SSE and AVX
+// versions. Which one is compiled is decided here from the compiler's own target settings:
+//   - AVX is used if the compiler is targetting it (/arch:AVX or /arch:AVX2 in Visual Studio, -mavx with gcc/clang)
+//   - SSE is used on any x86/x64 target that supports it (always the case for x64 builds)
+//   - Otherwise (e.g. ARM) the scalar code is used
+// Define MATH_NO_SIMD in the project settings to force the scalar code everywhere (e.g. to check results)
+//
+// Define MATH_ALIGN_MATRICES to store CMatrix4x4 on 16-byte boundaries so the SIMD code can use
+// aligned loads and stores. Off by default because 32-bit Windows only guarantees 8-byte alignment
+// for heap memory, so containers of matrices would need an aligned allocator
+
+#ifndef _MATH_SIMD_H_DEFINED_
+#define _MATH_SIMD_H_DEFINED_
+
+#if !defined(MATH_NO_SIMD)
+    #if defined(__AVX__)
+        #define MATH_AVX 1
+    #endif
+
+    #if defined(MATH_AVX) || defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+        #define MATH_SSE 1
+    #endif
+
+    // Fused multiply-add is only used if the compiler has been told the target supports it (/arch:AVX2, -mfma)
+    #if defined(MATH_AVX) && (defined(__FMA__) || defined(__AVX2__))
+        #define MATH_FMA 1
+    #endif
+#endif
+
+#if defined(MATH_AVX)
+    #include <immintrin.h>
+#elif defined(MATH_SSE)
+    #include <xmmintrin.h>
+#endif
+
+
+// Alignment of matrix storage, see comment at top of file
+#if defined(MATH_ALIGN_MATRICES)
+    #define MATH_MATRIX_ALIGN alignas(16)
+#else
+    #define MATH_MATRIX_ALIGN
+#endif
+
+
+// Name of the instruction set the maths code was compiled for - for benchmark / log output
+inline const char* MathSIMDName()
+{
+#if defined(MATH_AVX) && defined(MATH_FMA)
+    return "AVX+FMA";
+#elif defined(MATH_AVX)
+    return "AVX";
+#elif defined(MATH_SSE)
+    return "SSE";
+#else
+    return "Scalar";
+#endif
+}
+
+
+#endif // _MATH_SIMD_H_DEFINED_
@@ -0,0 +1,124 @@
+//--------------------------------------------------------------------------------------
+// Trigonometry functions for the maths classes, with a choice of accuracy
+//--------------------------------------------------------------------------------------
+// All code in this header so the functions can be inlined into the matrix and quaternion builders
+// Rotations nearly always need the sine and cosine of the same angle, so SinCos returns both. There are two tiers:
+//   - SinCosPrecise / Atan2Precise: the standard library, correctly rounded or within 1 ulp. Compilers merge
+//     the separate sin and cos calls into one sincos call where the library has it
+//   - SinCosFast / Atan2Fast: polynomial approximations, no library calls or tables. Max absolute error:
+//       SinCosFast - 1e-7 for |angle| <= 1000, 1e-6 for |angle| <= 100000
+//       Atan2Fast  - 2e-6 radians (about 1e-4 degrees) for all inputs
+//     These figures are checked by MathBenchmark. Larger angles would lose accuracy in the range reduction, so
+//     SinCosFast passes them (and infinities and NaNs) to the precise version. Keep angles wrapped (as the camera
+//     and model controls do) to stay on the fast path
+//
+// SinCos and Atan2 are the versions used by the rest of the maths code (rotation builders, Euler angle extraction).
+// They are the precise versions unless MATH_FAST_TRIG is defined in the project settings. The fast errors are far
+// below anything visible, but results will differ slightly from DirectXMath or other tools using the library functions
+
+#ifndef _MATH_TRIG_H_DEFINED_
+#define _MATH_TRIG_H_DEFINED_
+
+#include "MathHelpers.h"
+#include <cmath>
+
+
+/*-----------------------------------------------------------------------------------------
+    Precise tier
+-----------------------------------------------------------------------------------------*/
+
+// Get the sine and cosine of the given angle (in radians) using the standard library
+inline void SinCosPrecise(const float angle, float& s, float& c)
+{
+    s = std::sin(angle);
+    c = std::cos(angle);
+}
+
+// Return the angle (in radians, range -PI to PI) of the point (x, y) from the x-axis, using the standard library
+inline float Atan2Precise(const float y, const float x)
+{
+    return std::atan2(y, x);
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Fast tier
+-----------------------------------------------------------------------------------------*/
+
+// Get the sine and cosine of the given angle (in radians) using polynomials. See top of file for accuracy
+inline void SinCosFast(const float angle, float& s, float& c)
+{
+    // Beyond this the reduction below loses accuracy, and the quadrant would eventually overflow an int. Written
+    // so NaNs also take the library path
+    if (!(std::abs(angle) <= 100000.0f))
+    {
+        SinCosPrecise(angle, s, c);
+        return;
+    }
+
+    // Reduce the angle to y in the range -PI/4 to PI/4, where angle = y + quadrant * PI/2. PI/2 is split
+    // into three parts so that quadrant * part is exact for the first two (Cody-Waite reduction)
+    const float quadrantF = angle * (2.0f / PI) + (angle >= 0.0f ? 0.5f : -0.5f);
+    const int   quadrant  = static_cast<int>(quadrantF);
+    const float q = static_cast<float>(quadrant);
+    const float y = ((angle - q * 1.5703125f) - q * 4.837512969970703125e-4f) - q * 7.549789948768648e-8f;
+
+    // Minimax polynomials for sine and cosine over -PI/4 to PI/4 (coefficients from the Cephes library)
+    const float y2 = y * y;
+    const float sinY = y + y * y2 * (-1.6666654611e-1f + y2 * (8.3321608736e-3f + y2 * -1.9515295891e-4f));
+    const float cosY = 1.0f - 0.5f * y2 + y2 * y2 * (4.166664568298827e-2f + y2 * (-1.388731625493765e-3f + y2 * 2.443315711809948e-5f));
+
+    // Rotate the result into the correct quadrant: odd quadrants swap sine and cosine, then the signs are flipped
+    // for quadrants 2 and 3 (sine) and 1 and 2 (cosine). Written without branches, the angles are often unpredictable
+    const bool  swap  = (quadrant & 1) != 0;
+    const float signS = (quadrant & 2) ? -1.0f : 1.0f;
+    const float signC = ((quadrant + 1) & 2) ? -1.0f : 1.0f;
+    s = (swap ? cosY : sinY) * signS;
+    c = (swap ? sinY : cosY) * signC;
+}
+
+// Return the angle (in radians, range -PI to PI) of the point (x, y) from the x-axis using a polynomial. See top of file for accuracy
+// Returns 0 for (0, 0) like the library version
+inline float Atan2Fast(const float y, const float x)
+{
+    // Approximate atan for a ratio in the range 0 to 1, then use symmetry to get the other octants
+    const float absX = std::abs(x);
+    const float absY = std::abs(y);
+    const float maxXY = absX > absY ? absX : absY;
+    if (maxXY == 0.0f)  return 0.0f;
+    const float a = (absX > absY ? absY : absX) / maxXY;
+    const float a2 = a * a;
+    float angle = a * (0.99997726f + a2 * (-0.33262347f + a2 * (0.19354346f + a2 * (-0.11643287f + a2 * (0.05265332f + a2 * -0.01172120f)))));
+
+    if (absY > absX)  angle = 0.5f * PI - angle;
+    if (x < 0.0f)     angle = PI - angle;
+    return y < 0.0f ? -angle : angle;
+}
+
+
+/*-----------------------------------------------------------------------------------------
+    Selected tier
+-----------------------------------------------------------------------------------------*/
+
+// Get the sine and cosine of the given angle (in radians). Fast or precise depending on MATH_FAST_TRIG
+inline void SinCos(const float angle, float& s, float& c)
+{
+#if defined(MATH_FAST_TRIG)
+    SinCosFast(angle, s, c);
+#else
+    SinCosPrecise(angle, s, c);
+#endif
+}
+
+// Return the angle (in radians, range -PI to PI) of the point (x, y) from the x-axis. Fast or precise depending on MATH_FAST_TRIG
+inline float Atan2(const float y, const float x)
+{
+#if defined(MATH_FAST_TRIG)
+    return Atan2Fast(y, x);
+#else
+    return Atan2Precise(y, x);
+#endif
+}
+
+
+#endif // _MATH_TRIG_H_DEFINED_
@@ -0,0 +1,357 @@
+//--------------------------------------------------------------------------------------
+// meshcook - cooks mesh files into the mesh cache offline
+//--------------------------------------------------------------------------------------
+// Console program, not part of the lab apps. Imports each mesh file and saves the cooked mesh next to it, exactly
+// as Mesh does the first time it loads a file (see MeshImport.h and MeshCache.h), so the apps never need to run
+// the assimp import themselves. Files are converted in parallel and a line is printed for each with its timings and sizes.
+// Built as the meshcook target of the engine core CMake build when assimp is found (see EngineCore/CMakeLists.txt), e.g.
+//     meshcook --tangents both Skinning
+
+#include "MeshImport.h"
+#include "MeshCache.h"
+#include "MeshClusters.h"
+#include "MeshOptimise.h"
+#include "MeshSimplify.h"
+#include "VertexPacking.h"
+#include "Timer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+
+// File types that are cooked when a directory is given
+const char* const gMeshExtensions[] = { ".x", ".fbx", ".obj" };
+
+bool IsMeshFile(const fs::path& path)
+{
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    for (const char* meshExtension : gMeshExtensions)
+    {
+        if (extension == meshExtension)  return true;
+    }
+    return false;
+}
+
+
+// One file to cook with one set of settings, and the results
+struct CookJob
+{
+    std::string fileName;
+    bool        requireTangents;
+    uint32_t    compactVertices;
+    uint32_t    numLODs;
+
+    enum class Result { Cooked, UpToDate, Failed } result = Result::Failed;
+    std::string error;
+    double      importSeconds = 0;
+    double      saveSeconds = 0;
+    uintmax_t   sourceSize = 0;
+    uintmax_t   cookedSize = 0;
+    size_t      numSubMeshes = 0;
+    size_t      numVertices = 0;
+    size_t      numTriangles = 0;
+    size_t      vertexBytes = 0; // Total size of all vertices
+    size_t      indexBytes = 0;  // Total size of all indices
+    size_t      indexBytesSaved = 0; // Compared to using 32-bit indices throughout
+    size_t      numClusters = 0;
+    size_t      lodTriangles[MAX_MESH_LODS] = {}; // Total triangles in each simplified LOD
+    float       lodErrors[MAX_MESH_LODS] = {};    // Largest error in each LOD over all sub-meshes
+    VertexPackingErrors packingErrors; // Only measured when the file is cooked
+    MeshOptimiseStats   cacheStats;    // Likewise
+};
+
+
+// Cook one file unless there is already an up-to-date cooked mesh (or force is set)
+void Cook(CookJob& job, bool force)
+{
+    uint64_t key = MeshCacheKey(job.fileName, MeshImportSettings(job.requireTangents, job.compactVertices, job.numLODs));
+    if (key == 0)
+    {
+        job.error = "cannot read file";
+        return;
+    }
+    std::string cookedFile = CookedMeshFileName(job.fileName, key);
+
+    std::error_code error;
+    job.sourceSize = fs::file_size(job.fileName, error);
+
+    MeshData mesh;
+    Timer timer;
+    if (!force && LoadCookedMesh(cookedFile, key, mesh))
+    {
+        job.result = CookJob::Result::UpToDate;
+    }
+    else
+    {
+        try
+        {
+            ImportMesh(job.fileName, job.requireTangents, mesh); // No logging, assimp's logger is shared by all threads
+            if (job.numLODs != 0)  GenerateLODs(mesh, job.numLODs);
+            OptimiseMesh(mesh, DEFAULT_OVERDRAW_THRESHOLD, &job.cacheStats);
+            BuildMeshClusters(mesh);
+            if (job.compactVertices != 0)  PackVertices(mesh, job.compactVertices, &job.packingErrors);
+        }
+        catch (const std::runtime_error& e)
+        {
+            job.error = e.what();
+            return;
+        }
+        job.importSeconds = timer.GetLapTime();
+
+        if (!SaveCookedMesh(cookedFile, key, mesh))
+        {
+            job.error = "cannot write " + cookedFile;
+            return;
+        }
+        job.saveSeconds = timer.GetLapTime();
+        job.result = CookJob::Result::Cooked;
+    }
+
+    job.cookedSize = fs::file_size(cookedFile, error);
+    job.numSubMeshes = mesh.subMeshes.size();
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        job.numVertices += subMesh.numVertices;
+        job.numTriangles += subMesh.numIndices / 3;
+        job.vertexBytes += static_cast<size_t>(subMesh.numVertices) * subMesh.vertexSize;
+        job.indexBytes  += static_cast<size_t>(subMesh.numIndices) * IndexFormatSize(subMesh.indexFormat);
+        job.indexBytesSaved += static_cast<size_t>(subMesh.numIndices) * (sizeof(uint32_t) - IndexFormatSize(subMesh.indexFormat));
+        job.numClusters += subMesh.clusters.size();
+        for (size_t l = 0; l < subMesh.lods.size(); ++l)
+        {
+            job.lodTriangles[l] += subMesh.lods[l].numIndices / 3;
+            job.lodErrors[l] = std::max(job.lodErrors[l], subMesh.lods[l].error);
+        }
+    }
+}
+
+
+void PrintJob(const CookJob& job)
+{
+    const char* variant = job.requireTangents ? " (tangents)" : "";
+    if (job.result == CookJob::Result::Failed)
+    {
+        printf("FAILED   %s%s: %s\n", job.fileName.c_str(), variant, job.error.c_str());
+        return;
+    }
+
+    printf("%-8s %s%s\n", (job.result == CookJob::Result::Cooked) ? "cooked" : "cached", job.fileName.c_str(), variant);
+    printf("         %zu sub-meshes, %zu vertices, %zu triangles, %.1f KB source -> %.1f KB cooked",
+           job.numSubMeshes, job.numVertices, job.numTriangles, job.sourceSize / 1024.0, job.cookedSize / 1024.0);
+    if (job.result == CookJob::Result::Cooked)  printf(", import %.1f ms, save %.1f ms", job.importSeconds * 1000, job.saveSeconds * 1000);
+    printf("\n");
+    if (job.numVertices > 0)  printf("         %.1f bytes per vertex\n", static_cast<double>(job.vertexBytes) / job.numVertices);
+    if (job.numTriangles > 0)
+    {
+        printf("         %.1f KB indices, %.1f KB saved by 16-bit indices\n", job.indexBytes / 1024.0, job.indexBytesSaved / 1024.0);
+    }
+    if (job.numClusters > 0)
+    {
+        printf("         %zu culling clusters, %.1f triangles per cluster\n", job.numClusters, static_cast<double>(job.numTriangles) / job.numClusters);
+    }
+    if (job.numTriangles > 0 && job.lodTriangles[0] > 0)
+    {
+        printf("         LOD triangles (error):");
+        for (uint32_t l = 0; l < MAX_MESH_LODS && job.lodTriangles[l] > 0; ++l)  printf(" %zu (%g)", job.lodTriangles[l], job.lodErrors[l]);
+        printf("\n");
+    }
+    if (job.result == CookJob::Result::Cooked && job.numTriangles > 0)
+    {
+        const MeshOptimiseStats& stats = job.cacheStats;
+        printf("         vertex cache ACMR (ATVR): FIFO %u %.3f (%.3f) -> %.3f (%.3f), LRU %u %.3f (%.3f) -> %.3f (%.3f)\n",
+               REPORT_FIFO_CACHE_SIZE, stats.fifoBefore.ACMR(), stats.fifoBefore.ATVR(), stats.fifoAfter.ACMR(), stats.fifoAfter.ATVR(),
+               REPORT_LRU_CACHE_SIZE,  stats.lruBefore.ACMR(),  stats.lruBefore.ATVR(),  stats.lruAfter.ACMR(),  stats.lruAfter.ATVR());
+    }
+    if (job.result == CookJob::Result::Cooked && job.compactVertices != 0)
+    {
+        const VertexPackingErrors& errors = job.packingErrors;
+        printf("         packing errors: position %g, normal %.4f deg, tangent %.4f deg, uv %g, weight %g\n",
+               errors.position, errors.normalDegrees, errors.tangentDegrees, errors.uv, errors.weight);
+    }
+}
+
+
+// Return VERTEX_COMPACT_... flags from a comma separated list of element names, or 0 if any name is not recognised
+uint32_t ParseCompactElements(const std::string& list)
+{
+    uint32_t flags = 0;
+    size_t start = 0;
+    while (start <= list.size())
+    {
+        size_t end = std::min(list.find(',', start), list.size());
+        std::string name = list.substr(start, end - start);
+        if      (name == "all")        flags |= VERTEX_COMPACT_ALL;
+        else if (name == "positions")  flags |= VERTEX_COMPACT_POSITIONS;
+        else if (name == "normals")    flags |= VERTEX_COMPACT_NORMALS;
+        else if (name == "uvs")        flags |= VERTEX_COMPACT_UVS;
+        else if (name == "weights")    flags |= VERTEX_COMPACT_WEIGHTS;
+        else                           return 0;
+        start = end + 1;
+    }
+    return flags;
+}
+
+
+void PrintUsage()
+{
+    printf("Usage: meshcook [options] <files or directories>...\n"
+           "Cooks mesh files (.x, .fbx, .obj in directories) into the mesh cache, next to each file\n"
+           "  --tangents <no|yes|both> cook the variant without tangents, with tangents (for normal mapping) or both (default no)\n"
+           "  --jobs <n>               number of files to cook at once (default: number of hardware threads)\n"
+           "  --recursive              search sub-directories too\n"
+           "  --force                  cook files even if there is an up-to-date cooked mesh\n"
+           "  --serial                 convert the sub-meshes of each file one at a time, to check the output is the same\n"
+           "  --compact <elements>     pack vertex elements into compact formats, any of positions,normals,uvs,weights or all\n"
+           "                           (comma separated), must match what the app loads with (see VertexPacking.h)\n"
+           "  --lods <n>               generate n simplified LODs for each sub-mesh (up to 5, default 0), must match what\n"
+           "                           the app loads with (see MeshSimplify.h)\n");
+}
+
+
+// Exit codes: 0 success, 1 one or more files failed, 2 bad arguments
+int main(int argc, char* argv[])
+{
+    bool withoutTangents = true, withTangents = false;
+    unsigned int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    bool recursive = false, force = false, serial = false;
+    uint32_t compactVertices = 0, numLODs = 0;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        if (arg == "--tangents" && value)
+        {
+            std::string variants = value;
+            withoutTangents = (variants == "no"  || variants == "both");
+            withTangents    = (variants == "yes" || variants == "both");
+            if (!withoutTangents && !withTangents)
+            {
+                PrintUsage();
+                return 2;
+            }
+            ++i;
+        }
+        else if (arg == "--compact" && value)
+        {
+            compactVertices = ParseCompactElements(value);
+            if (compactVertices == 0)
+            {
+                PrintUsage();
+                return 2;
+            }
+            ++i;
+        }
+        else if (arg == "--lods" && value)
+        {
+            int lods = atoi(value);
+            if (lods < 0 || lods > static_cast<int>(MAX_MESH_LODS))
+            {
+                PrintUsage();
+                return 2;
+            }
+            numLODs = static_cast<uint32_t>(lods);
+            ++i;
+        }
+        else if (arg == "--jobs" && value)  { numThreads = std::max(1, atoi(value));  ++i; }
+        else if (arg == "--recursive")      { recursive = true; }
+        else if (arg == "--force")          { force = true; }
+        else if (arg == "--serial")         { serial = true; }
+        else if (!arg.empty() && arg[0] != '-')
+        {
+            paths.push_back(arg);
+        }
+        else
+        {
+            PrintUsage();
+            return (arg == "--help" || arg == "-h") ? 0 : 2;
+        }
+    }
+    if (paths.empty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+
+    // Collect the files to cook - files given directly are cooked whatever their extension
+    std::vector<std::string> files;
+    for (const std::string& path : paths)
+    {
+        std::error_code error;
+        if (fs::is_directory(path, error))
+        {
+            auto addFile = [&](const fs::directory_entry& entry)
+            {
+                if (entry.is_regular_file(error) && IsMeshFile(entry.path()))  files.push_back(entry.path().string());
+            };
+            if (recursive)  for (auto& entry : fs::recursive_directory_iterator(path, error))  addFile(entry);
+            else            for (auto& entry : fs::directory_iterator(path, error))            addFile(entry);
+        }
+        else
+        {
+            files.push_back(path);
+        }
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<CookJob> jobs;
+    for (const std::string& file : files)
+    {
+        if (withoutTangents)  jobs.push_back({ file, false, compactVertices, numLODs });
+        if (withTangents)     jobs.push_back({ file, true,  compactVertices, numLODs });
+    }
+    numThreads = std::min(numThreads, static_cast<unsigned int>(std::max<size_t>(jobs.size(), 1)));
+
+    // When several files are cooked at once each converts its sub-meshes serially, rather than every file
+    // starting a thread per hardware thread. A single file uses all the threads for its sub-meshes
+    SetImportThreads((serial || numThreads > 1) ? 1 : 0);
+
+
+    // Each thread takes the next job until there are none left. Results are printed as each job finishes
+    Timer timer;
+    std::atomic<size_t> nextJob(0);
+    std::mutex printMutex;
+    auto worker = [&]()
+    {
+        for (size_t j = nextJob++; j < jobs.size(); j = nextJob++)
+        {
+            Cook(jobs[j], force);
+            std::lock_guard<std::mutex> lock(printMutex);
+            PrintJob(jobs[j]);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < numThreads; ++t)  threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)  thread.join();
+
+
+    // Summary
+    int cooked = 0, upToDate = 0, failed = 0;
+    uintmax_t sourceSize = 0, cookedSize = 0;
+    for (const CookJob& job : jobs)
+    {
+        if      (job.result == CookJob::Result::Cooked)    ++cooked;
+        else if (job.result == CookJob::Result::UpToDate)  ++upToDate;
+        else                                               ++failed;
+        sourceSize += job.sourceSize;
+        cookedSize += job.cookedSize;
+    }
+    printf("\n%zu meshes: %d cooked, %d up to date, %d failed. %.1f KB source -> %.1f KB cooked in %.2f s using %u threads\n",
+           jobs.size(), cooked, upToDate, failed, sourceSize / 1024.0, cookedSize / 1024.0, timer.GetTime(), numThreads);
+
+    return (failed > 0) ? 1 : 0;
+}
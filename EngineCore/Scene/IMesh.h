@@ -0,0 +1,46 @@
+//--------------------------------------------------------------------------------------
+// Interface to a renderable mesh
+//--------------------------------------------------------------------------------------
+// The engine core has no graphics API code so it builds on any platform. Model works through this
+// interface, and each app implements it with its own renderer (e.g. the Direct3D 11 Mesh class in Skinning).
+
+#ifndef _IMESH_H_INCLUDED_
+#define _IMESH_H_INCLUDED_
+
+#include "CAffine3x4.h"
+#include "CBounds.h"
+
+#include <vector>
+
+class IMesh
+{
+public:
+    virtual ~IMesh() {}
+
+    // How many nodes are in the hierarchy for this mesh. Nodes can control individual parts (rigid body animation),
+    // or bones (skinned animation), or they can be dummy nodes to create child parts in a more convenient way
+    virtual unsigned int NumberNodes() = 0;
+
+    // The default matrix for a given node - used to set the initial position for a new model
+    virtual CAffine3x4 GetNodeDefaultMatrix(unsigned int node) = 0;
+
+    // The parent of a given node. The root node (0) is its own parent. Parents come before their children
+    virtual unsigned int GetNodeParent(unsigned int node) = 0;
+
+    // Bounds of the geometry a given node moves, in the node's own space (see MeshBounds.h). Empty if it moves none
+    virtual const CBounds& GetNodeBounds(unsigned int node) = 0;
+
+    // Levels of detail (see MeshSimplify.h). LOD 0 is the full detail mesh, LODs 1 to NumberLODs() are simplified
+    // versions with fewer triangles. The error of a LOD is the furthest its surface may be from the full detail
+    // surface in mesh units, the largest over all sub-meshes (0 for LOD 0, increasing with each LOD)
+    virtual unsigned int NumberLODs() = 0;
+    virtual float GetLODError(unsigned int lod) = 0;
+    virtual unsigned int NumberTriangles(unsigned int lod) = 0;
+
+    // Render the mesh with the given matrices, one for each node relative to its parent (the first is the world matrix),
+    // using the given LOD
+    virtual void Render(std::vector<CAffine3x4>& modelMatrices, unsigned int lod) = 0;
+};
+
+
+#endif //_IMESH_H_INCLUDED_
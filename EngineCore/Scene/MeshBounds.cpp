@@ -0,0 +1,115 @@
+//--------------------------------------------------------------------------------------
+// Mesh bounding volumes - boxes and spheres for sub-meshes and nodes, calculated at import
+//--------------------------------------------------------------------------------------
+
+#include "MeshBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+//--------------------------------------------------------------------------------------
+// Helper functions
+//--------------------------------------------------------------------------------------
+
+// Return the byte offset of an element in a sub-mesh's vertices, or -1 if it has no such element. Throws a
+// std::runtime_error exception if the element is not in the expected format
+static int ElementOffset(const SubMeshData& subMesh, VertexSemantic semantic, VertexFormat format)
+{
+    for (auto& element : subMesh.layout)
+    {
+        if (element.semantic == semantic)
+        {
+            if (element.format != format)  throw std::runtime_error("Mesh bounds need full precision vertices");
+            return static_cast<int>(element.offset);
+        }
+    }
+    return -1;
+}
+
+
+// Call a function for each bone influence in a skinned sub-mesh: function(node, position) for every non-zero weight
+template <typename Function>
+static void ForEachInfluence(const SubMeshData& subMesh, int positionOffset, int bonesOffset, int weightsOffset, Function function)
+{
+    for (uint32_t v = 0; v < subMesh.numVertices; ++v)
+    {
+        const unsigned char* vertex = subMesh.vertices + static_cast<size_t>(v) * subMesh.vertexSize;
+        CVector3 position(reinterpret_cast<const float*>(vertex + positionOffset));
+        const uint8_t* bones = vertex + bonesOffset;
+        const float* weights = reinterpret_cast<const float*>(vertex + weightsOffset);
+        for (int i = 0; i < 4; ++i)
+        {
+            if (weights[i] > 0)  function(bones[i], position);
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Bounds calculation
+//--------------------------------------------------------------------------------------
+
+void CalculateBounds(MeshData& mesh)
+{
+    // Sub-meshes
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        int positionOffset = ElementOffset(subMesh, VertexSemantic::Position, VertexFormat::Float3);
+        if (positionOffset < 0)  throw std::runtime_error("Mesh bounds need vertex positions");
+        subMesh.bounds = BoundsFromPoints(subMesh.vertices + positionOffset, subMesh.numVertices, subMesh.vertexSize);
+    }
+
+    for (auto& node : mesh.nodes)  node.bounds = CBounds();
+
+    if (!mesh.hasBones)
+    {
+        // Rigid mesh, sub-mesh vertices are already in the space of the node holding them
+        for (auto& node : mesh.nodes)
+        {
+            for (unsigned int subMesh : node.subMeshes)  node.bounds = MergeBounds(node.bounds, mesh.subMeshes[subMesh].bounds);
+        }
+        return;
+    }
+
+    // Skinned mesh, each node's bounds contain the vertices it influences in bone space. Two passes over the
+    // influences, first for the boxes then for the sphere radii (around the box centres)
+    std::vector<float> radiusSquared(mesh.nodes.size(), 0.0f);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (auto& subMesh : mesh.subMeshes)
+        {
+            int positionOffset = ElementOffset(subMesh, VertexSemantic::Position, VertexFormat::Float3);
+            int bonesOffset    = ElementOffset(subMesh, VertexSemantic::Bones,    VertexFormat::UByte4);
+            int weightsOffset  = ElementOffset(subMesh, VertexSemantic::Weights,  VertexFormat::Float4);
+            if (bonesOffset < 0 || weightsOffset < 0)  throw std::runtime_error("Skinned mesh bounds need bones and weights");
+
+            ForEachInfluence(subMesh, positionOffset, bonesOffset, weightsOffset, [&](unsigned int nodeIndex, const CVector3& position)
+            {
+                if (nodeIndex >= mesh.nodes.size())  return;
+                NodeData& node = mesh.nodes[nodeIndex];
+                CVector3 p = TransformPoint(position, node.offsetMatrix);
+                if (pass == 0)
+                {
+                    node.bounds.minimum = { std::min(node.bounds.minimum.x, p.x), std::min(node.bounds.minimum.y, p.y), std::min(node.bounds.minimum.z, p.z) };
+                    node.bounds.maximum = { std::max(node.bounds.maximum.x, p.x), std::max(node.bounds.maximum.y, p.y), std::max(node.bounds.maximum.z, p.z) };
+                }
+                else
+                {
+                    CVector3 offset = p - node.bounds.centre;
+                    radiusSquared[nodeIndex] = std::max(radiusSquared[nodeIndex], Dot(offset, offset));
+                }
+            });
+        }
+
+        // Between the passes set the sphere centres of nodes that have any influences
+        for (size_t i = 0; i < mesh.nodes.size(); ++i)
+        {
+            CBounds& bounds = mesh.nodes[i].bounds;
+            if (bounds.minimum.x > bounds.maximum.x)  continue;
+            if (pass == 0)  bounds.centre = bounds.BoxCentre();
+            else            bounds.radius = std::sqrt(radiusSquared[i]);
+        }
+    }
+}
@@ -0,0 +1,23 @@
+//--------------------------------------------------------------------------------------
+// Mesh bounding volumes - boxes and spheres for sub-meshes and nodes, calculated at import
+//--------------------------------------------------------------------------------------
+// Bounds are calculated once when a mesh is imported and stored in cooked meshes, so culling and picking never
+// need to read vertex data. Each sub-mesh has bounds around its vertices (in the space its vertices are stored
+// in). Each node has bounds in its own space, so its world bounds are its bounds transformed by its world matrix:
+//     Rigid meshes   - a node's bounds contain the sub-meshes it holds
+//     Skinned meshes - a node's bounds contain every vertex the node (bone) has any weight on, transformed into
+//                      bone space by the node's offset matrix. Wherever the bones move the mesh stays inside
+//                      the union of its bones' world bounds
+
+#ifndef _MESH_BOUNDS_H_INCLUDED_
+#define _MESH_BOUNDS_H_INCLUDED_
+
+#include "MeshData.h"
+
+
+// Calculate the bounds of all sub-meshes and nodes in the given mesh data. Positions must be Float3 and, for
+// skinned meshes, bones UByte4 and weights Float4 - i.e. call before packing vertices (see VertexPacking.h)
+void CalculateBounds(MeshData& mesh);
+
+
+#endif //_MESH_BOUNDS_H_INCLUDED_
@@ -0,0 +1,461 @@
+//--------------------------------------------------------------------------------------
+// Cache of cooked meshes - binary mesh files that load without importing the original file
+//--------------------------------------------------------------------------------------
+
+#include "MeshCache.h"
+#include "Hash.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+#include <type_traits>
+
+
+//--------------------------------------------------------------------------------------
+// Cooked file format
+//--------------------------------------------------------------------------------------
+// All offsets are in bytes from the start of the file. Vertex and index blocks start on 16 byte boundaries.
+//     CookedHeader
+//     CookedSubMesh[numSubMeshes]
+//     VertexElement[numElements]      - vertex layouts for all sub-meshes
+//     CookedNode[numNodes]
+//     uint32_t[numNodeIndexes]        - child node and sub-mesh lists for all nodes
+//     char[]                          - node names (not null terminated)
+//     CookedLOD[numSubMeshes * numLODs] - simplified LODs, numLODs for each sub-mesh in turn
+//     CookedCluster[numClusters]      - clusters for all sub-meshes
+//     vertex and index blocks for each sub-mesh, followed by its LOD index blocks
+
+struct CookedHeader
+{
+    char     magic[4]; // "CMSH"
+    uint32_t version;
+    uint64_t key;
+    uint64_t fileSize;
+
+    uint32_t numSubMeshes;
+    uint32_t numElements;
+    uint32_t numNodes;
+    uint32_t numNodeIndexes;
+    uint32_t namesSize;
+    uint32_t hasBones;
+    float    positionScale[3]; // See MeshData
+    float    positionBias[3];
+    uint32_t numLODs;          // For each sub-mesh, see SubMeshData
+    uint32_t numClusters;
+    uint32_t padding;
+
+    uint64_t subMeshesOffset;
+    uint64_t elementsOffset;
+    uint64_t nodesOffset;
+    uint64_t nodeIndexesOffset;
+    uint64_t namesOffset;
+    uint64_t lodsOffset;
+    uint64_t clustersOffset;
+};
+
+struct CookedBounds
+{
+    float minimum[3]; // See CBounds
+    float maximum[3];
+    float centre[3];
+    float radius;
+};
+
+struct CookedSubMesh
+{
+    uint32_t firstElement; // Into the VertexElement array
+    uint32_t numElements;
+    uint32_t vertexSize;
+    uint32_t numVertices;
+    uint32_t numIndices;
+    uint32_t indexFormat;
+    CookedBounds bounds;
+    uint32_t firstCluster; // Into the CookedCluster array
+    uint32_t numClusters;
+    uint64_t verticesOffset;
+    uint64_t indicesOffset;
+};
+
+struct CookedLOD
+{
+    uint64_t indicesOffset; // LODs that are the same as the one before share its indices
+    uint32_t numIndices;
+    float    error;
+};
+
+struct CookedCluster
+{
+    uint32_t startIndex; // See MeshCluster
+    uint32_t numIndices;
+    float    centre[3];
+    float    radius;
+    float    coneAxis[3];
+    float    coneCos;
+    float    coneSin;
+};
+
+struct CookedNode
+{
+    float    defaultMatrix[12]; // In CAffine3x4 order
+    float    offsetMatrix[12];
+    uint32_t parentIndex;
+    uint32_t nameOffset; // Into the names block
+    uint32_t nameLength;
+    uint32_t firstChild; // Into the node index array
+    uint32_t numChildren;
+    uint32_t firstSubMesh;
+    uint32_t numSubMeshes;
+    CookedBounds bounds;
+    uint32_t padding;
+};
+
+static_assert(std::is_trivially_copyable<VertexElement>::value && sizeof(VertexElement) == 12, "VertexElement is stored directly in cooked files");
+static_assert(sizeof(CAffine3x4) >= 12 * sizeof(float), "CAffine3x4 must hold 12 floats");
+static_assert(sizeof(CVector3) == 3 * sizeof(float), "CVector3 must be 3 floats");
+
+// Bounds are stored and loaded with these
+static CookedBounds CookBounds(const CBounds& b)
+{
+    return { { b.minimum.x, b.minimum.y, b.minimum.z }, { b.maximum.x, b.maximum.y, b.maximum.z },
+             { b.centre.x,  b.centre.y,  b.centre.z },  b.radius };
+}
+
+static CBounds UncookBounds(const CookedBounds& b)
+{
+    return { CVector3(b.minimum), CVector3(b.maximum), CVector3(b.centre), b.radius };
+}
+
+static const char COOKED_MAGIC[4] = { 'C', 'M', 'S', 'H' };
+
+
+//--------------------------------------------------------------------------------------
+// Cache keys
+//--------------------------------------------------------------------------------------
+
+uint64_t MeshCacheKey(const std::string& sourceFile, uint64_t importSettings)
+{
+    MappedFile source;
+    if (!source.Open(sourceFile))  return 0;
+
+    uint64_t key = HashBytes(source.Data(), source.Size());
+    key = HashValue(importSettings, key);
+    key = HashValue(COOKED_MESH_VERSION, key);
+    return (key != 0) ? key : 1; // 0 is reserved for failure
+}
+
+std::string CookedMeshFileName(const std::string& sourceFile, uint64_t key)
+{
+    char keyText[17];
+    snprintf(keyText, sizeof(keyText), "%016llx", static_cast<unsigned long long>(key));
+    return sourceFile + "." + keyText + ".cmesh";
+}
+
+
+//--------------------------------------------------------------------------------------
+// Saving
+//--------------------------------------------------------------------------------------
+
+// Append data to a byte array, returning the offset it was written at
+static uint64_t Append(std::vector<unsigned char>& file, const void* data, size_t size)
+{
+    uint64_t offset = file.size();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    file.insert(file.end(), bytes, bytes + size);
+    return offset;
+}
+
+// Pad a byte array with zeros to a multiple of the given alignment
+static void Align(std::vector<unsigned char>& file, size_t alignment)
+{
+    file.resize((file.size() + alignment - 1) / alignment * alignment, 0);
+}
+
+
+// Return a name for the temporary file written before a cooked file, unique to this process, thread and call
+static std::string TempFileName(const std::string& cookedFile)
+{
+    static std::atomic<unsigned int> counter{ 0 };
+#ifdef _WIN32
+    unsigned long processId = GetCurrentProcessId();
+#else
+    unsigned long processId = static_cast<unsigned long>(getpid());
+#endif
+    unsigned long long threadId = std::hash<std::thread::id>()(std::this_thread::get_id());
+    char suffix[80];
+    snprintf(suffix, sizeof(suffix), ".%lu.%llx.%u.tmp", processId, threadId, counter++);
+    return cookedFile + suffix;
+}
+
+bool SaveCookedMesh(const std::string& cookedFile, uint64_t key, const MeshData& mesh)
+{
+    // Build the tables first, then write header, tables and data blocks into one array
+    CookedHeader header = {};
+    std::memcpy(header.magic, COOKED_MAGIC, 4);
+    header.version = COOKED_MESH_VERSION;
+    header.key = key;
+    header.numSubMeshes = static_cast<uint32_t>(mesh.subMeshes.size());
+    header.numNodes = static_cast<uint32_t>(mesh.nodes.size());
+    header.hasBones = mesh.hasBones ? 1 : 0;
+    header.numLODs = mesh.subMeshes.empty() ? 0 : static_cast<uint32_t>(mesh.subMeshes[0].lods.size());
+    std::memcpy(header.positionScale, &mesh.positionScale.x, sizeof(header.positionScale));
+    std::memcpy(header.positionBias,  &mesh.positionBias.x,  sizeof(header.positionBias));
+
+    std::vector<CookedSubMesh> subMeshes(mesh.subMeshes.size());
+    std::vector<VertexElement> elements;
+    std::vector<CookedCluster> clusters;
+    for (size_t i = 0; i < mesh.subMeshes.size(); ++i)
+    {
+        const SubMeshData& subMesh = mesh.subMeshes[i];
+        CookedSubMesh& cooked = subMeshes[i];
+        cooked.firstElement = static_cast<uint32_t>(elements.size());
+        cooked.numElements  = static_cast<uint32_t>(subMesh.layout.size());
+        cooked.vertexSize   = subMesh.vertexSize;
+        cooked.numVertices  = subMesh.numVertices;
+        cooked.numIndices   = subMesh.numIndices;
+        cooked.indexFormat  = static_cast<uint32_t>(subMesh.indexFormat);
+        cooked.bounds       = CookBounds(subMesh.bounds);
+        cooked.firstCluster = static_cast<uint32_t>(clusters.size());
+        cooked.numClusters  = static_cast<uint32_t>(subMesh.clusters.size());
+        if (subMesh.lods.size() != header.numLODs)  return false;
+        elements.insert(elements.end(), subMesh.layout.begin(), subMesh.layout.end());
+        for (auto& cluster : subMesh.clusters)
+        {
+            clusters.push_back({ cluster.startIndex, cluster.numIndices, { cluster.centre.x, cluster.centre.y, cluster.centre.z }, cluster.radius,
+                                 { cluster.coneAxis.x, cluster.coneAxis.y, cluster.coneAxis.z }, cluster.coneCos, cluster.coneSin });
+        }
+    }
+    header.numElements = static_cast<uint32_t>(elements.size());
+    header.numClusters = static_cast<uint32_t>(clusters.size());
+
+    std::vector<CookedNode> nodes(mesh.nodes.size());
+    std::vector<uint32_t> nodeIndexes;
+    std::string names;
+    for (size_t i = 0; i < mesh.nodes.size(); ++i)
+    {
+        const NodeData& node = mesh.nodes[i];
+        CookedNode& cooked = nodes[i];
+        std::memcpy(cooked.defaultMatrix, &node.defaultMatrix.e00, sizeof(cooked.defaultMatrix));
+        std::memcpy(cooked.offsetMatrix,  &node.offsetMatrix.e00,  sizeof(cooked.offsetMatrix));
+        cooked.parentIndex  = node.parentIndex;
+        cooked.nameOffset   = static_cast<uint32_t>(names.size());
+        cooked.nameLength   = static_cast<uint32_t>(node.name.size());
+        cooked.firstChild   = static_cast<uint32_t>(nodeIndexes.size());
+        cooked.numChildren  = static_cast<uint32_t>(node.childNodes.size());
+        nodeIndexes.insert(nodeIndexes.end(), node.childNodes.begin(), node.childNodes.end());
+        cooked.firstSubMesh = static_cast<uint32_t>(nodeIndexes.size());
+        cooked.numSubMeshes = static_cast<uint32_t>(node.subMeshes.size());
+        cooked.bounds       = CookBounds(node.bounds);
+        nodeIndexes.insert(nodeIndexes.end(), node.subMeshes.begin(), node.subMeshes.end());
+        names += node.name;
+    }
+    header.numNodeIndexes = static_cast<uint32_t>(nodeIndexes.size());
+    header.namesSize = static_cast<uint32_t>(names.size());
+    std::vector<CookedLOD> lods(mesh.subMeshes.size() * header.numLODs);
+
+
+    // Tables - the header, sub-mesh and LOD tables are written again at the end once all offsets are known
+    std::vector<unsigned char> file;
+    Append(file, &header, sizeof(header));
+    header.subMeshesOffset   = Append(file, subMeshes.data(),   subMeshes.size()   * sizeof(CookedSubMesh));
+    header.elementsOffset    = Append(file, elements.data(),    elements.size()    * sizeof(VertexElement));
+    header.nodesOffset       = Append(file, nodes.data(),       nodes.size()       * sizeof(CookedNode));
+    header.nodeIndexesOffset = Append(file, nodeIndexes.data(), nodeIndexes.size() * sizeof(uint32_t));
+    header.namesOffset       = Append(file, names.data(),       names.size());
+    header.lodsOffset        = Append(file, lods.data(),        lods.size()        * sizeof(CookedLOD));
+    header.clustersOffset    = Append(file, clusters.data(),    clusters.size()    * sizeof(CookedCluster));
+
+    // Vertex and index blocks
+    for (size_t i = 0; i < mesh.subMeshes.size(); ++i)
+    {
+        const SubMeshData& subMesh = mesh.subMeshes[i];
+        Align(file, 16);
+        subMeshes[i].verticesOffset = Append(file, subMesh.vertices, static_cast<size_t>(subMesh.numVertices) * subMesh.vertexSize);
+        Align(file, 16);
+        subMeshes[i].indicesOffset = Append(file, subMesh.indices, static_cast<size_t>(subMesh.numIndices) * IndexFormatSize(subMesh.indexFormat));
+        for (uint32_t l = 0; l < header.numLODs; ++l)
+        {
+            const SubMeshLOD& lod = subMesh.lods[l];
+            CookedLOD& cooked = lods[i * header.numLODs + l];
+            cooked.numIndices = lod.numIndices;
+            cooked.error = lod.error;
+            if (l > 0 && lod.indices == subMesh.lods[l - 1].indices)
+            {
+                cooked.indicesOffset = lods[i * header.numLODs + l - 1].indicesOffset;
+                continue;
+            }
+            Align(file, 16);
+            cooked.indicesOffset = Append(file, lod.indices, static_cast<size_t>(lod.numIndices) * IndexFormatSize(subMesh.indexFormat));
+        }
+    }
+    header.fileSize = file.size();
+    std::memcpy(file.data(), &header, sizeof(header));
+    if (!subMeshes.empty())  std::memcpy(file.data() + header.subMeshesOffset, subMeshes.data(), subMeshes.size() * sizeof(CookedSubMesh));
+    if (!lods.empty())       std::memcpy(file.data() + header.lodsOffset,      lods.data(),      lods.size()      * sizeof(CookedLOD));
+
+
+    // Write to a temporary file then rename it over the cooked file, which replaces it in one step so readers see
+    // either the old file or the complete new one. The temporary name is unique to this process, thread and call, so
+    // processes cooking the same mesh at once (e.g. meshcook and a running app) each write their own file
+    std::string tempFile = TempFileName(cookedFile);
+    FILE* out = fopen(tempFile.c_str(), "wb");
+    if (out == nullptr)  return false;
+    bool ok = fwrite(file.data(), 1, file.size(), out) == file.size();
+    ok = (fclose(out) == 0) && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(tempFile.c_str(), cookedFile.c_str(), MOVEFILE_REPLACE_EXISTING) != 0; // rename fails if the target exists
+#else
+    ok = ok && std::rename(tempFile.c_str(), cookedFile.c_str()) == 0;
+#endif
+    if (!ok)
+    {
+        std::remove(tempFile.c_str());
+        return false;
+    }
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Loading
+//--------------------------------------------------------------------------------------
+
+// Return true if an array of count items of the given size at offset lies within a file of the given size
+static bool InFile(uint64_t offset, uint64_t count, uint64_t itemSize, uint64_t fileSize)
+{
+    return offset <= fileSize && count <= (fileSize - offset) / itemSize;
+}
+
+// Return true if a vertex element read from a file has a known semantic and format and lies within a vertex of the given size
+static bool ValidElement(const VertexElement& element, uint32_t vertexSize)
+{
+    return static_cast<uint32_t>(element.semantic) <= static_cast<uint32_t>(VertexSemantic::Colour) &&
+           static_cast<uint32_t>(element.format)   <= static_cast<uint32_t>(VertexFormat::UByte4Norm) &&
+           element.offset <= vertexSize && VertexFormatSize(element.format) <= vertexSize - element.offset;
+}
+
+
+bool LoadCookedMesh(const std::string& cookedFile, uint64_t key, MeshData& mesh)
+{
+    MappedFile file;
+    if (!file.Open(cookedFile) || file.Size() < sizeof(CookedHeader))  return false;
+
+    // Check the header, that every table lies within the file and that vertex layouts fit their vertices, so a
+    // damaged file is rejected here rather than causing bad reads later. Contents are otherwise trusted
+    const unsigned char* data = file.Data();
+    const uint64_t size = file.Size();
+    const CookedHeader& header = *reinterpret_cast<const CookedHeader*>(data);
+    if (std::memcmp(header.magic, COOKED_MAGIC, 4) != 0 || header.version != COOKED_MESH_VERSION ||
+        header.key != key || header.fileSize != size)  return false;
+
+    if (!InFile(header.subMeshesOffset,   header.numSubMeshes,   sizeof(CookedSubMesh), size) ||
+        !InFile(header.elementsOffset,    header.numElements,    sizeof(VertexElement), size) ||
+        !InFile(header.nodesOffset,       header.numNodes,       sizeof(CookedNode),    size) ||
+        !InFile(header.nodeIndexesOffset, header.numNodeIndexes, sizeof(uint32_t),      size) ||
+        !InFile(header.namesOffset,       header.namesSize,      1,                     size) ||
+        header.numLODs > MAX_MESH_LODS ||
+        !InFile(header.lodsOffset, static_cast<uint64_t>(header.numSubMeshes) * header.numLODs, sizeof(CookedLOD), size) ||
+        !InFile(header.clustersOffset, header.numClusters, sizeof(CookedCluster), size))  return false;
+
+    const CookedSubMesh* subMeshes   = reinterpret_cast<const CookedSubMesh*>(data + header.subMeshesOffset);
+    const VertexElement* elements    = reinterpret_cast<const VertexElement*>(data + header.elementsOffset);
+    const CookedNode*    nodes       = reinterpret_cast<const CookedNode*>   (data + header.nodesOffset);
+    const uint32_t*      nodeIndexes = reinterpret_cast<const uint32_t*>     (data + header.nodeIndexesOffset);
+    const char*          names       = reinterpret_cast<const char*>         (data + header.namesOffset);
+    const CookedLOD*     lods        = reinterpret_cast<const CookedLOD*>    (data + header.lodsOffset);
+    const CookedCluster* clusters    = reinterpret_cast<const CookedCluster*>(data + header.clustersOffset);
+
+
+    // Fill the sub-mesh and node arrays. Vertex and index data stays in the mapped file
+    std::vector<SubMeshData> newSubMeshes(header.numSubMeshes);
+    for (uint32_t i = 0; i < header.numSubMeshes; ++i)
+    {
+        const CookedSubMesh& cooked = subMeshes[i];
+        IndexFormat indexFormat = static_cast<IndexFormat>(cooked.indexFormat);
+        if (cooked.firstElement > header.numElements || cooked.numElements > header.numElements - cooked.firstElement ||
+            cooked.firstCluster > header.numClusters || cooked.numClusters > header.numClusters - cooked.firstCluster ||
+            (indexFormat != IndexFormat::UInt32 && indexFormat != IndexFormat::UInt16) || cooked.vertexSize == 0 ||
+            !InFile(cooked.verticesOffset, cooked.numVertices, cooked.vertexSize, size) ||
+            !InFile(cooked.indicesOffset,  cooked.numIndices,  IndexFormatSize(indexFormat), size))  return false;
+
+        for (uint32_t e = 0; e < cooked.numElements; ++e)
+        {
+            if (!ValidElement(elements[cooked.firstElement + e], cooked.vertexSize))  return false;
+        }
+
+        SubMeshData& subMesh = newSubMeshes[i];
+        subMesh.layout.assign(elements + cooked.firstElement, elements + cooked.firstElement + cooked.numElements);
+        subMesh.vertexSize  = cooked.vertexSize;
+        subMesh.numVertices = cooked.numVertices;
+        subMesh.vertices    = data + cooked.verticesOffset;
+        subMesh.numIndices  = cooked.numIndices;
+        subMesh.indexFormat = indexFormat;
+        subMesh.indices     = data + cooked.indicesOffset;
+        subMesh.bounds      = UncookBounds(cooked.bounds);
+
+        subMesh.lods.resize(header.numLODs);
+        for (uint32_t l = 0; l < header.numLODs; ++l)
+        {
+            const CookedLOD& cookedLOD = lods[i * header.numLODs + l];
+            if (!InFile(cookedLOD.indicesOffset, cookedLOD.numIndices, IndexFormatSize(indexFormat), size))  return false;
+            subMesh.lods[l].numIndices = cookedLOD.numIndices;
+            subMesh.lods[l].indices    = data + cookedLOD.indicesOffset;
+            subMesh.lods[l].error      = cookedLOD.error;
+        }
+
+        subMesh.clusters.resize(cooked.numClusters);
+        for (uint32_t c = 0; c < cooked.numClusters; ++c)
+        {
+            const CookedCluster& cookedCluster = clusters[cooked.firstCluster + c];
+            if (cookedCluster.startIndex > cooked.numIndices || cookedCluster.numIndices > cooked.numIndices - cookedCluster.startIndex)  return false;
+            MeshCluster& cluster = subMesh.clusters[c];
+            cluster.startIndex = cookedCluster.startIndex;
+            cluster.numIndices = cookedCluster.numIndices;
+            cluster.centre     = CVector3(cookedCluster.centre);
+            cluster.radius     = cookedCluster.radius;
+            cluster.coneAxis   = CVector3(cookedCluster.coneAxis);
+            cluster.coneCos    = cookedCluster.coneCos;
+            cluster.coneSin    = cookedCluster.coneSin;
+        }
+    }
+
+    std::vector<NodeData> newNodes(header.numNodes);
+    for (uint32_t i = 0; i < header.numNodes; ++i)
+    {
+        const CookedNode& cooked = nodes[i];
+        if (cooked.nameOffset > header.namesSize || cooked.nameLength > header.namesSize - cooked.nameOffset ||
+            cooked.firstChild > header.numNodeIndexes || cooked.numChildren > header.numNodeIndexes - cooked.firstChild ||
+            cooked.firstSubMesh > header.numNodeIndexes || cooked.numSubMeshes > header.numNodeIndexes - cooked.firstSubMesh ||
+            cooked.parentIndex >= header.numNodes)  return false;
+
+        NodeData& node = newNodes[i];
+        node.name.assign(names + cooked.nameOffset, cooked.nameLength);
+        node.defaultMatrix.SetColumns(cooked.defaultMatrix);
+        node.offsetMatrix.SetColumns(cooked.offsetMatrix);
+        node.parentIndex = cooked.parentIndex;
+        node.bounds = UncookBounds(cooked.bounds);
+        node.childNodes.assign(nodeIndexes + cooked.firstChild,   nodeIndexes + cooked.firstChild   + cooked.numChildren);
+        node.subMeshes.assign (nodeIndexes + cooked.firstSubMesh, nodeIndexes + cooked.firstSubMesh + cooked.numSubMeshes);
+        for (unsigned int child : node.childNodes)      if (child >= header.numNodes)         return false;
+        for (unsigned int subMesh : node.subMeshes)     if (subMesh >= header.numSubMeshes)   return false;
+    }
+
+    mesh.subMeshes = std::move(newSubMeshes);
+    mesh.nodes = std::move(newNodes);
+    mesh.hasBones = header.hasBones != 0;
+    mesh.positionScale = CVector3(header.positionScale);
+    mesh.positionBias  = CVector3(header.positionBias);
+    mesh.buffers.clear();
+    mesh.mappedFile = std::move(file);
+    return true;
+}
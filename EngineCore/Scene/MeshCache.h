@@ -0,0 +1,46 @@
+//--------------------------------------------------------------------------------------
+// Cache of cooked meshes - binary mesh files that load without importing the original file
+//--------------------------------------------------------------------------------------
+// Importing a mesh file (parsing it and running all the processing steps) is slow. The result of an import is
+// saved as a cooked mesh file, which holds the MeshData exactly as it is laid out in memory: vertex blocks,
+// index buffers (including simplified LODs), culling clusters, vertex layouts and the node hierarchy. Loading maps the file into
+// memory, so the vertex and index data is used in place with no parsing or copying.
+//
+// Cooked files are stored next to the source file, named with a key made from a hash of the source file
+// contents, the import settings and the cooked format version: e.g. Man.x -> Man.x.0123456789abcdef.cmesh
+// Changing any of these gives a new key, so stale cooked files are never used (they can be deleted at any time).
+// Cooked files are for the platform that wrote them (little-endian, same struct layout), they are not for distribution.
+
+#ifndef _MESH_CACHE_H_INCLUDED_
+#define _MESH_CACHE_H_INCLUDED_
+
+#include "MeshData.h"
+
+#include <cstdint>
+#include <string>
+
+// Version of the cooked file format. Increase this when the format changes or when the import code changes
+// the data it produces, so existing cooked files are rebuilt
+const uint32_t COOKED_MESH_VERSION = 6;
+
+
+// Return the cache key for a source mesh file imported with the given settings (any value that identifies
+// the settings, e.g. a hash of the import flags). Returns 0 if the source file cannot be read
+uint64_t MeshCacheKey(const std::string& sourceFile, uint64_t importSettings);
+
+// Return the name of the cooked file for the given source file and key
+std::string CookedMeshFileName(const std::string& sourceFile, uint64_t key);
+
+
+// Save mesh data as a cooked mesh file. The file is written under a temporary name unique to the calling process
+// and thread, then renamed, so a partly written file is never loaded even if several processes cook the same
+// mesh at once. Returns false on failure
+bool SaveCookedMesh(const std::string& cookedFile, uint64_t key, const MeshData& mesh);
+
+// Load a cooked mesh file into the given mesh data, replacing its contents. The file stays mapped into
+// memory (in mesh.mappedFile) and the sub-meshes point at the vertex and index data in it.
+// Returns false if the file does not exist, was saved with a different key or version, or is damaged
+bool LoadCookedMesh(const std::string& cookedFile, uint64_t key, MeshData& mesh);
+
+
+#endif //_MESH_CACHE_H_INCLUDED_
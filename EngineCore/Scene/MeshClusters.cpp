@@ -0,0 +1,241 @@
+//--------------------------------------------------------------------------------------
+// Mesh clusters - small groups of triangles culled on the CPU before drawing
+//--------------------------------------------------------------------------------------
+
+#include "MeshClusters.h"
+#include "CBounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+//--------------------------------------------------------------------------------------
+// Building clusters
+//--------------------------------------------------------------------------------------
+
+// Fill in the bounding sphere and normal cone of a cluster from the triangles it covers
+static void ClusterBounds(MeshCluster& cluster, const uint32_t* indices, const std::vector<uint32_t>& vertices,
+                          const unsigned char* positions, uint32_t stride)
+{
+    auto position = [&](uint32_t v) { return CVector3(reinterpret_cast<const float*>(positions + static_cast<size_t>(v) * stride)); };
+
+    // Sphere around the cluster's vertices, which contains its triangles
+    CVector3 points[MAX_CLUSTER_VERTICES];
+    for (size_t i = 0; i < vertices.size(); ++i)  points[i] = position(vertices[i]);
+    CBounds bounds = BoundsFromPoints(points, static_cast<unsigned int>(vertices.size()));
+    cluster.centre = bounds.centre;
+    cluster.radius = bounds.radius;
+
+    // Cone axis is the average of the triangle normals, the half-angle reaches the normal furthest from it.
+    // Zero area triangles are never drawn so they don't count. Normals face the side the triangle is seen from
+    CVector3 normals[MAX_CLUSTER_TRIANGLES];
+    uint32_t numNormals = 0;
+    CVector3 axis = { 0, 0, 0 };
+    for (uint32_t i = cluster.startIndex; i < cluster.startIndex + cluster.numIndices; i += 3)
+    {
+        CVector3 p0 = position(indices[i]);
+        CVector3 normal = Cross(position(indices[i + 1]) - p0, position(indices[i + 2]) - p0);
+        float length = Length(normal);
+        if (length <= 0)  continue;
+        normals[numNormals] = normal * (1.0f / length);
+        axis += normals[numNormals++];
+    }
+
+    float axisLength = Length(axis);
+    cluster.coneAxis = { 0, 0, 0 };
+    cluster.coneCos = 0;
+    cluster.coneSin = 1;
+    if (numNormals == 0 || axisLength <= 0)  return;
+
+    axis = axis * (1.0f / axisLength);
+    float minDot = 1;
+    for (uint32_t i = 0; i < numNormals; ++i)  minDot = std::min(minDot, Dot(axis, normals[i]));
+    if (minDot <= 0)  return; // Triangles face more than a hemisphere, some are always front-facing
+
+    cluster.coneAxis = axis;
+    cluster.coneCos = minDot;
+    cluster.coneSin = std::sqrt(std::max(0.0f, 1 - minDot * minDot));
+}
+
+
+void BuildClusters(const uint32_t* indices, uint32_t numIndices, const void* positions, uint32_t stride,
+                   std::vector<MeshCluster>& clusters)
+{
+    const unsigned char* positionBytes = static_cast<const unsigned char*>(positions);
+    numIndices -= numIndices % 3;
+    if (numIndices == 0)  return;
+
+    // Which cluster each vertex was last added to, so a vertex is only counted once per cluster
+    uint32_t numVertices = *std::max_element(indices, indices + numIndices) + 1;
+    std::vector<uint32_t> lastCluster(numVertices, ~0u);
+    std::vector<uint32_t> clusterVertices;
+    clusterVertices.reserve(MAX_CLUSTER_VERTICES);
+
+    MeshCluster cluster;
+    uint32_t clusterNumber = static_cast<uint32_t>(clusters.size());
+    for (uint32_t i = 0; i < numIndices; i += 3)
+    {
+        uint32_t newVertices = 0;
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            // Count each new vertex once, even if the triangle repeats it
+            uint32_t v = indices[i + c];
+            if (lastCluster[v] != clusterNumber && (c < 1 || v != indices[i]) && (c < 2 || v != indices[i + 1]))  ++newVertices;
+        }
+
+        if (clusterVertices.size() + newVertices > MAX_CLUSTER_VERTICES || cluster.numIndices / 3 == MAX_CLUSTER_TRIANGLES)
+        {
+            ClusterBounds(cluster, indices, clusterVertices, positionBytes, stride);
+            clusters.push_back(cluster);
+            cluster = MeshCluster();
+            cluster.startIndex = i;
+            clusterVertices.clear();
+            ++clusterNumber;
+        }
+
+        for (uint32_t c = 0; c < 3; ++c)
+        {
+            uint32_t v = indices[i + c];
+            if (lastCluster[v] != clusterNumber)
+            {
+                lastCluster[v] = clusterNumber;
+                clusterVertices.push_back(v);
+            }
+        }
+        cluster.numIndices += 3;
+    }
+    ClusterBounds(cluster, indices, clusterVertices, positionBytes, stride);
+    clusters.push_back(cluster);
+}
+
+
+void BuildMeshClusters(MeshData& mesh)
+{
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        subMesh.clusters.clear();
+        if (subMesh.numIndices == 0)  continue;
+
+        const unsigned char* positions = nullptr;
+        for (auto& element : subMesh.layout)
+        {
+            if (element.semantic == VertexSemantic::Position)
+            {
+                if (element.format != VertexFormat::Float3)  throw std::runtime_error("Mesh clusters need full precision positions");
+                positions = subMesh.vertices + element.offset;
+            }
+        }
+        if (positions == nullptr)  throw std::runtime_error("Mesh clusters need vertex positions");
+
+        // Clustering works on 32-bit indices whatever the sub-mesh's index format
+        std::vector<uint32_t> indices(subMesh.numIndices);
+        for (uint32_t i = 0; i < subMesh.numIndices; ++i)
+        {
+            indices[i] = (subMesh.indexFormat == IndexFormat::UInt16) ? static_cast<const uint16_t*>(subMesh.indices)[i]
+                                                                      : static_cast<const uint32_t*>(subMesh.indices)[i];
+        }
+        BuildClusters(indices.data(), subMesh.numIndices, positions, subMesh.vertexSize, subMesh.clusters);
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Culling
+//--------------------------------------------------------------------------------------
+
+FrustumPlanes FrustumFromMatrix(const CMatrix4x4& m)
+{
+    // Clip space position is p * m, so each clip coordinate is p dotted with a column. A point is inside when
+    // -w <= x <= w, -w <= y <= w and 0 <= z <= w, each of which is a plane
+    const float planes[6][4] =
+    {
+        { m.e03 + m.e00, m.e13 + m.e10, m.e23 + m.e20, m.e33 + m.e30 }, // Left
+        { m.e03 - m.e00, m.e13 - m.e10, m.e23 - m.e20, m.e33 - m.e30 }, // Right
+        { m.e03 + m.e01, m.e13 + m.e11, m.e23 + m.e21, m.e33 + m.e31 }, // Bottom
+        { m.e03 - m.e01, m.e13 - m.e11, m.e23 - m.e21, m.e33 - m.e31 }, // Top
+        { m.e02,         m.e12,         m.e22,         m.e32         }, // Near
+        { m.e03 - m.e02, m.e13 - m.e12, m.e23 - m.e22, m.e33 - m.e32 }, // Far
+    };
+
+    FrustumPlanes frustum;
+    for (int i = 0; i < 6; ++i)
+    {
+        CVector3 normal = { planes[i][0], planes[i][1], planes[i][2] };
+        float length = Length(normal);
+        float scale = (length > 0) ? 1.0f / length : 0.0f;
+        frustum.normal[i] = normal * scale;
+        frustum.d[i] = planes[i][3] * scale;
+    }
+    return frustum;
+}
+
+
+bool SphereOutsideFrustum(const FrustumPlanes& frustum, const CVector3& centre, float radius)
+{
+    for (int i = 0; i < 6; ++i)
+    {
+        if (Dot(frustum.normal[i], centre) + frustum.d[i] < -radius)  return true;
+    }
+    return false;
+}
+
+
+// A triangle is back-facing if the camera is behind its plane. With every normal within the cone's half-angle a
+// of its axis, that holds for the whole cluster when every direction from the camera into the sphere is within
+// 90 - a degrees of the axis - i.e. the sphere is inside a cone of that half-angle from the camera. For a sphere at
+// distance D and angle t from the axis, that is when D sin(90 - a - t) >= radius, expanded below
+bool ClusterBackFacing(const MeshCluster& cluster, const CVector3& cameraPosition)
+{
+    if (cluster.coneCos <= 0)  return false;
+
+    CVector3 toCluster = cluster.centre - cameraPosition;
+    float along  = Dot(toCluster, cluster.coneAxis);                              // D cos t
+    float across = std::sqrt(std::max(0.0f, Dot(toCluster, toCluster) - along * along)); // D sin t
+    return cluster.coneCos * along - cluster.coneSin * across >= cluster.radius;
+}
+
+
+void CullClusters(const std::vector<MeshCluster>& clusters, const CMatrix4x4& viewProjection, const CVector3& cameraPosition,
+                  bool cullBackfaces, std::vector<IndexRange>& visibleRanges, ClusterCullStats* stats /*= nullptr*/)
+{
+    visibleRanges.clear();
+    FrustumPlanes frustum = FrustumFromMatrix(viewProjection);
+
+    ClusterCullStats counts;
+    counts.numClusters = static_cast<uint32_t>(clusters.size());
+    for (auto& cluster : clusters)
+    {
+        if (SphereOutsideFrustum(frustum, cluster.centre, cluster.radius))
+        {
+            ++counts.frustumCulled;
+            continue;
+        }
+        if (cullBackfaces && ClusterBackFacing(cluster, cameraPosition))
+        {
+            ++counts.backfaceCulled;
+            continue;
+        }
+
+        // Extend the last range if this cluster follows straight on from it
+        counts.visibleTriangles += cluster.numIndices / 3;
+        if (!visibleRanges.empty() && visibleRanges.back().startIndex + visibleRanges.back().numIndices == cluster.startIndex)
+        {
+            visibleRanges.back().numIndices += cluster.numIndices;
+        }
+        else
+        {
+            visibleRanges.push_back({ cluster.startIndex, cluster.numIndices });
+        }
+    }
+    counts.numRanges = static_cast<uint32_t>(visibleRanges.size());
+
+    if (stats != nullptr)
+    {
+        stats->numClusters      += counts.numClusters;
+        stats->frustumCulled    += counts.frustumCulled;
+        stats->backfaceCulled   += counts.backfaceCulled;
+        stats->numRanges        += counts.numRanges;
+        stats->visibleTriangles += counts.visibleTriangles;
+    }
+}
@@ -0,0 +1,83 @@
+//--------------------------------------------------------------------------------------
+// Mesh clusters - small groups of triangles culled on the CPU before drawing
+//--------------------------------------------------------------------------------------
+// Culling whole sub-meshes (see MeshBounds.h) draws every triangle of a large mesh that is partly on screen, and
+// always draws the half of a closed mesh facing away from the camera. Splitting each sub-mesh into clusters of up
+// to MAX_CLUSTER_VERTICES vertices and MAX_CLUSTER_TRIANGLES triangles, each with bounds, lets most of that be
+// skipped. Each cluster stores:
+//     - Bounding sphere - culled if it is entirely outside any plane of the view frustum
+//     - Normal cone     - an axis and half-angle containing every triangle normal in the cluster. If the camera is
+//                         behind every triangle wherever it is in the sphere, the whole cluster is back-facing
+// Clusters are consecutive runs of the sub-mesh's triangles in their optimised order (see MeshOptimise.h), so the
+// index data is unchanged and visible clusters next to each other are drawn with a single draw call.
+// The limits match the cluster (meshlet) sizes used by GPU culling, so the same clusters would suit that later.
+
+#ifndef _MESH_CLUSTERS_H_INCLUDED_
+#define _MESH_CLUSTERS_H_INCLUDED_
+
+#include "MeshData.h"
+#include "CMatrix4x4.h"
+#include "CVector3.h"
+
+#include <cstdint>
+#include <vector>
+
+
+// Limits on the size of each cluster
+const uint32_t MAX_CLUSTER_VERTICES  = 64;
+const uint32_t MAX_CLUSTER_TRIANGLES = 124;
+
+
+// Split a triangle list into clusters, appending them to the given vector. Positions are Float3, stride bytes apart.
+// A new cluster is started whenever the next triangle would take the current one over either limit
+void BuildClusters(const uint32_t* indices, uint32_t numIndices, const void* positions, uint32_t stride,
+                   std::vector<MeshCluster>& clusters);
+
+// Build the clusters for every sub-mesh in the mesh data (full detail only, the LODs are not clustered). Positions
+// must be Float3, i.e. call before packing vertices (see VertexPacking.h). Call after OptimiseMesh, which reorders
+// the triangles the clusters refer to
+void BuildMeshClusters(MeshData& mesh);
+
+
+// A run of indices to draw - one or more consecutive visible clusters
+struct IndexRange
+{
+    uint32_t startIndex;
+    uint32_t numIndices;
+};
+
+// Counts of clusters tested and culled. Add them up over several calls to report totals
+struct ClusterCullStats
+{
+    uint32_t numClusters      = 0;
+    uint32_t frustumCulled    = 0;
+    uint32_t backfaceCulled   = 0;
+    uint32_t numRanges        = 0; // Draw calls needed for the visible clusters
+    uint32_t visibleTriangles = 0;
+};
+
+// The six planes of the view frustum for a view-projection matrix (row vectors, D3D clip space with z from 0 to
+// w). Plane normals point into the frustum and are normalised, so dot(normal, p) + d is the distance inside
+struct FrustumPlanes
+{
+    CVector3 normal[6];
+    float    d[6];
+};
+
+FrustumPlanes FrustumFromMatrix(const CMatrix4x4& viewProjection);
+
+// Return true if a sphere is entirely outside the frustum
+bool SphereOutsideFrustum(const FrustumPlanes& frustum, const CVector3& centre, float radius);
+
+// Return true if the camera is behind every triangle in a cluster, wherever they are within its sphere
+bool ClusterBackFacing(const MeshCluster& cluster, const CVector3& cameraPosition);
+
+// Cull clusters against the frustum of a view-projection matrix and, if cullBackfaces is set, by their normal cones,
+// replacing the contents of visibleRanges with the index runs to draw. The matrix and camera position must be in the
+// space the clusters are in - for a mesh drawn with a world matrix pass world * viewProjection and the camera
+// position transformed by the inverse world matrix. Optionally adds to cull counts
+void CullClusters(const std::vector<MeshCluster>& clusters, const CMatrix4x4& viewProjection, const CVector3& cameraPosition,
+                  bool cullBackfaces, std::vector<IndexRange>& visibleRanges, ClusterCullStats* stats = nullptr);
+
+
+#endif //_MESH_CLUSTERS_H_INCLUDED_
@@ -0,0 +1,122 @@
+//--------------------------------------------------------------------------------------
+// Device-independent mesh data - geometry and node hierarchy ready to upload to the GPU
+//--------------------------------------------------------------------------------------
+// This is what a mesh file is converted into before any graphics API objects are created. It is produced
+// by importing a mesh file or by loading a cooked mesh from the mesh cache (see MeshCache.h), and the
+// renderer's mesh class creates its vertex buffers, index buffers and input layouts from it.
+
+#ifndef _MESH_DATA_H_INCLUDED_
+#define _MESH_DATA_H_INCLUDED_
+
+#include "CAffine3x4.h"
+#include "CBounds.h"
+#include "CVector3.h"
+#include "MappedFile.h"
+#include "VertexElement.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+// Data type of the indices in a sub-mesh. Sub-meshes with no more than MAX_16BIT_INDEX_VERTICES vertices use
+// 16-bit indices, halving the index memory and bandwidth
+enum class IndexFormat : uint32_t
+{
+    UInt32,
+    UInt16,
+};
+
+const uint32_t MAX_16BIT_INDEX_VERTICES = 65536;
+
+// Size in bytes of a single index
+inline uint32_t IndexFormatSize(IndexFormat format)  { return (format == IndexFormat::UInt16) ? 2 : 4; }
+
+
+// A simplified level of detail (LOD) of a sub-mesh - fewer triangles using the same vertices (see MeshSimplify.h)
+struct SubMeshLOD
+{
+    uint32_t    numIndices = 0;
+    const void* indices = nullptr; // Same index format as the sub-mesh. Points into the MeshData buffers like the sub-mesh data
+    float       error = 0;         // Largest expected distance from the full detail surface, in mesh units
+};
+
+// Most simplified LODs a sub-mesh can have, not counting the full detail geometry
+const uint32_t MAX_MESH_LODS = 5;
+
+
+// A small run of a sub-mesh's full detail triangles with bounds for culling them as a group (see MeshClusters.h)
+struct MeshCluster
+{
+    uint32_t startIndex = 0; // Into the sub-mesh indices
+    uint32_t numIndices = 0;
+
+    CVector3 centre = { 0, 0, 0 }; // Bounding sphere, in the space the vertices are stored in
+    float    radius = 0;
+
+    CVector3 coneAxis = { 0, 0, 0 }; // Normal cone - every triangle normal is within the cone's half-angle of its axis
+    float    coneCos  = 0;           // Cosine and sine of the half-angle. coneCos <= 0 if the triangles face too many
+    float    coneSin  = 1;           // ways for the cluster to ever be back-facing
+};
+
+
+// Geometry using a single material. The vertex and index data is not owned by this structure, it points
+// into the buffers held by the MeshData containing it
+struct SubMeshData
+{
+    std::vector<VertexElement> layout;    // Elements in each vertex
+    uint32_t                   vertexSize = 0;  // Size in bytes of a single vertex
+
+    uint32_t                   numVertices = 0;
+    const unsigned char*       vertices = nullptr;
+
+    uint32_t                   numIndices = 0; // Triangle list, three indices per triangle
+    IndexFormat                indexFormat = IndexFormat::UInt32;
+    const void*                indices = nullptr; // uint16_t or uint32_t depending on indexFormat
+
+    CBounds                    bounds; // Around the vertices, in the space they are stored in (see MeshBounds.h)
+
+    std::vector<SubMeshLOD>    lods; // Simplified LODs, each with about half the triangles of the one before. Either
+                                     // empty or the same number for every sub-mesh in a mesh
+
+    std::vector<MeshCluster>   clusters; // Full detail triangles split into clusters for culling, empty if not built
+};
+
+
+// A node in the mesh hierarchy, see Mesh.h
+struct NodeData
+{
+    std::string  name;
+
+    CAffine3x4   defaultMatrix; // Starting position/rotation/scale for this node. Relative to parent
+    CAffine3x4   offsetMatrix;  // Transform from skinned mesh root to bone root, identity if not a bone
+
+    unsigned int parentIndex;   // Index of the parent node. Root node refers to itself (0)
+
+    std::vector<unsigned int> childNodes; // Indexes into the nodes vector
+    std::vector<unsigned int> subMeshes;  // Indexes into the subMeshes vector
+
+    CBounds      bounds;        // In this node's space, empty if it has no geometry (see MeshBounds.h)
+};
+
+
+struct MeshData
+{
+    std::vector<SubMeshData> subMeshes;
+    std::vector<NodeData>    nodes;     // First entry is root, remainder are stored in depth-first order
+    bool                     hasBones = false; // If any sub-mesh has bones then all sub-meshes are given bones
+
+    // Compact positions (see VertexPacking.h) are decoded with: position = packed * positionScale + positionBias
+    // Full precision positions are unchanged by the default values
+    CVector3                 positionScale = { 1, 1, 1 };
+    CVector3                 positionBias  = { 0, 0, 0 };
+
+    // Memory holding the vertex and index data that the sub-meshes point to - either blocks allocated when
+    // importing a mesh file or a cooked mesh file mapped into memory
+    std::vector<std::unique_ptr<unsigned char[]>> buffers;
+    MappedFile                                    mappedFile;
+};
+
+
+#endif //_MESH_DATA_H_INCLUDED_
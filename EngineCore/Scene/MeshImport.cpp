@@ -0,0 +1,530 @@
+//--------------------------------------------------------------------------------------
+// Mesh import - converts mesh files into device-independent mesh data using assimp
+//--------------------------------------------------------------------------------------
+
+#include "MeshImport.h"
+#include "MeshCache.h"
+#include "MeshBounds.h"
+#include "MeshClusters.h"
+#include "MeshNodes.h"
+#include "MeshOptimise.h"
+#include "MeshSimplify.h"
+#include "VertexPacking.h"
+#include "CVector2.h"
+#include "CVector3.h"
+#include "Hash.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/DefaultLogger.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+
+//--------------------------------------------------------------------------------------
+// Import settings
+//--------------------------------------------------------------------------------------
+
+// Increase this when the import settings or the conversion code below change, so existing cooked meshes are rebuilt
+static const uint64_t MESH_IMPORT_VERSION = 4;
+
+// Bone indexes are stored in vertices as bytes (VertexFormat::UByte4) so a bone node must have an index up to this
+static const unsigned int MAX_BONE_NODE = 255;
+
+// Flags for processing the mesh. Assimp provides a huge amount of control - right click any of these
+// and "Peek Definition" to see documention above each constant. Also returns flags for the mesh data to ignore
+// Triangle and vertex order is left to OptimiseMesh (see MeshOptimise.h), which also covers the LODs
+static unsigned int ImportFlags(bool requireTangents, int& removeComponents)
+{
+    unsigned int assimpFlags = aiProcess_MakeLeftHanded |
+                               aiProcess_GenSmoothNormals |
+                               aiProcess_FixInfacingNormals |
+                               aiProcess_GenUVCoords | 
+                               aiProcess_TransformUVCoords |
+                               aiProcess_FlipUVs |
+                               aiProcess_FlipWindingOrder |
+                               aiProcess_Triangulate |
+                               aiProcess_JoinIdenticalVertices |
+                               aiProcess_SortByPType |
+                               aiProcess_FindInvalidData | 
+                               aiProcess_OptimizeMeshes |
+                               aiProcess_FindInstances |
+                               aiProcess_FindDegenerates |
+                               aiProcess_RemoveRedundantMaterials |
+                               aiProcess_Debone |
+                               aiProcess_SplitByBoneCount | 
+                               aiProcess_LimitBoneWeights |
+                               aiProcess_RemoveComponent;
+
+    // Flags to specify what mesh data to ignore
+    removeComponents = aiComponent_LIGHTS | aiComponent_CAMERAS | aiComponent_TEXTURES | aiComponent_COLORS | 
+                       aiComponent_ANIMATIONS | aiComponent_MATERIALS;
+
+    // Add / remove tangents as required by user
+    if (requireTangents)
+    {
+        assimpFlags |= aiProcess_CalcTangentSpace;
+    }
+    else
+    {
+        removeComponents |= aiComponent_TANGENTS_AND_BITANGENTS;
+    }
+
+    return assimpFlags;
+}
+
+
+// Return a value identifying the import settings, for the mesh cache key (see MeshCacheKey). Covers everything
+// that affects the imported data, so changing the settings or the import code gives a new key. The compact
+// vertex elements are those packed after import (VERTEX_COMPACT_... flags, see VertexPacking.h)
+uint64_t MeshImportSettings(bool requireTangents, uint32_t compactVertices /*= 0*/, uint32_t numLODs /*= 0*/)
+{
+    int removeComponents;
+    unsigned int assimpFlags = ImportFlags(requireTangents, removeComponents);
+    uint64_t settings = HashValue(compactVertices, HashValue(MESH_IMPORT_VERSION, HashValue(assimpFlags, HashValue(removeComponents))));
+    return (numLODs != 0) ? HashValue(numLODs, settings) : settings; // Keys without LODs are unchanged
+}
+
+
+//--------------------------------------------------------------------------------------
+// Node hierarchy
+//--------------------------------------------------------------------------------------
+
+// Build the array of nodes from the assimp node hierarchy, in depth-first order. Uses an explicit stack rather
+// than recursion so very deep hierarchies (e.g. long bone chains) can't overflow the call stack
+static void ReadNodes(std::vector<NodeData>& nodes, aiNode* rootNode)
+{
+    // Nodes waiting to be read, with their parent and their position in the parent's child list. Children are
+    // pushed in reverse so they come off the stack in order, giving the same order as a recursive traversal
+    struct PendingNode
+    {
+        aiNode*      assimpNode;
+        unsigned int parentIndex;
+        unsigned int childSlot;
+    };
+    std::vector<PendingNode> stack;
+    stack.push_back({ rootNode, 0, 0 });
+
+    nodes.clear();
+    while (!stack.empty())
+    {
+        PendingNode pending = stack.back();
+        stack.pop_back();
+        aiNode* assimpNode = pending.assimpNode;
+
+        unsigned int thisIndex = static_cast<unsigned int>(nodes.size());
+        nodes.emplace_back();
+        auto& node = nodes.back();
+        node.parentIndex = pending.parentIndex;
+        if (thisIndex != 0)  nodes[pending.parentIndex].childNodes[pending.childSlot] = thisIndex;
+
+        node.name = assimpNode->mName.C_Str();
+
+        node.defaultMatrix.SetColumns(&assimpNode->mTransformation.a1); // Assimp matrices are for column vectors, so their first three rows are the columns of our affine matrix
+        node.offsetMatrix = AffineIdentity(); // Set for bones when the geometry is read
+
+        node.subMeshes.assign(assimpNode->mMeshes, assimpNode->mMeshes + assimpNode->mNumMeshes);
+
+        node.childNodes.resize(assimpNode->mNumChildren); // Filled in as each child is read
+        for (unsigned int i = assimpNode->mNumChildren; i-- > 0; )
+        {
+            stack.push_back({ assimpNode->mChildren[i], thisIndex, i });
+        }
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Sub-mesh conversion
+//--------------------------------------------------------------------------------------
+
+// Number of threads used to convert the sub-meshes of a mesh, 0 for one per hardware thread (see SetImportThreads)
+static std::atomic<unsigned int> gImportThreads(0);
+
+
+// The parts of a converted sub-mesh that can't be written into the mesh data while other sub-meshes are being
+// converted at the same time. They are added to the mesh data in sub-mesh order once all the conversions are done
+struct StagedSubMesh
+{
+    std::unique_ptr<unsigned char[]> vertices;
+    std::unique_ptr<unsigned char[]> indices;
+    std::vector<std::pair<unsigned int, const aiMatrix4x4*>> boneOffsets; // Node index and offset matrix of each bone
+    std::exception_ptr               error; // Set if the conversion failed
+};
+
+
+// Copy the triangles of an assimp mesh into an index buffer of the given index type (uint16_t or uint32_t)
+template <typename Index>
+static void CopyFaces(const aiMesh* assimpMesh, Index* index)
+{
+    for (unsigned int face = 0; face < assimpMesh->mNumFaces; ++face)
+    {
+        *index++ = static_cast<Index>(assimpMesh->mFaces[face].mIndices[0]);
+        *index++ = static_cast<Index>(assimpMesh->mFaces[face].mIndices[1]);
+        *index++ = static_cast<Index>(assimpMesh->mFaces[face].mIndices[2]);
+    }
+}
+
+
+// Convert one assimp mesh into a sub-mesh, with its vertex and index buffers and bone offsets staged. Bones are
+// found with the node name index, and subMeshNode is the node holding this sub-mesh (see MeshNodes.h). Only reads
+// shared data so several sub-meshes can be converted at once. Will throw a std::runtime_error exception on failure
+static void ConvertSubMesh(const aiScene* scene, unsigned int m, bool requireTangents, bool hasBones, const NodeNameIndex& nodeNames,
+                           unsigned int subMeshNode, const std::string& fileName, SubMeshData& subMesh, StagedSubMesh& staged)
+{
+    const aiMesh* assimpMesh = scene->mMeshes[m];
+    std::string subMeshName = assimpMesh->mName.C_Str();
+
+
+    //-----------------------------------
+
+    // Check for presence of position and normal data. Tangents and UVs are optional.
+    auto& vertexElements = subMesh.layout;
+    unsigned int offset = 0;
+
+    if (!assimpMesh->HasPositions())  throw std::runtime_error("No position data for sub-mesh " + subMeshName + " in " + fileName);
+    unsigned int positionOffset = offset;
+    vertexElements.push_back( { VertexSemantic::Position, VertexFormat::Float3, positionOffset } );
+    offset += 12;
+
+    if (!assimpMesh->HasNormals())  throw std::runtime_error("No normal data for sub-mesh " + subMeshName + " in " + fileName);
+    unsigned int normalOffset = offset;
+    vertexElements.push_back( { VertexSemantic::Normal, VertexFormat::Float3, normalOffset } );
+    offset += 12;
+
+    unsigned int tangentOffset = offset;
+    if (requireTangents)
+    {
+        if (!assimpMesh->HasTangentsAndBitangents())  throw std::runtime_error("No tangent data for sub-mesh " + subMeshName + " in " + fileName);
+        vertexElements.push_back( { VertexSemantic::Tangent, VertexFormat::Float3, tangentOffset } );
+        offset += 12;
+    }
+
+    unsigned int uvOffset = offset;
+    if (assimpMesh->GetNumUVChannels() > 0 && assimpMesh->HasTextureCoords(0))
+    {
+        if (assimpMesh->mNumUVComponents[0] != 2)  throw std::runtime_error("Unsupported texture coordinates in " + subMeshName + " in " + fileName);
+        vertexElements.push_back( { VertexSemantic::UV, VertexFormat::Float2, uvOffset } );
+        offset += 8;
+    }
+
+    unsigned int bonesOffset = offset;
+    if (hasBones)
+    {
+        vertexElements.push_back( { VertexSemantic::Bones,   VertexFormat::UByte4, bonesOffset } );
+        offset += 4;
+        vertexElements.push_back( { VertexSemantic::Weights, VertexFormat::Float4, bonesOffset + 4 } );
+        offset += 16;
+    }
+
+    subMesh.vertexSize = offset;
+
+
+
+    //-----------------------------------
+
+    // Create CPU-side buffers to hold current mesh data - exact content is flexible so can't use a structure for a vertex - so just a block of bytes
+    // Note: for large arrays a unique_ptr is better than a vector because vectors default-initialise all the values which is a waste of time.
+    subMesh.numVertices = assimpMesh->mNumVertices;
+    subMesh.numIndices  = assimpMesh->mNumFaces * 3;
+    subMesh.indexFormat = (subMesh.numVertices <= MAX_16BIT_INDEX_VERTICES) ? IndexFormat::UInt16 : IndexFormat::UInt32; // 2 or 4 bytes per index
+    auto vertices = std::make_unique<unsigned char[]>(subMesh.numVertices * subMesh.vertexSize);
+    auto indices  = std::make_unique<unsigned char[]>(subMesh.numIndices * IndexFormatSize(subMesh.indexFormat));
+    unsigned char* vertexData = vertices.get();
+    subMesh.vertices = vertexData;
+    subMesh.indices  = indices.get();
+    staged.vertices = std::move(vertices); // The mesh data will own the buffers, the sub-mesh points into them
+    staged.indices  = std::move(indices);
+
+
+    //-----------------------------------
+
+    // Copy mesh data from assimp to our CPU-side vertex buffer
+
+    CVector3* assimpPosition = reinterpret_cast<CVector3*>(assimpMesh->mVertices);
+    unsigned char* position = vertexData + positionOffset;
+    unsigned char* positionEnd = position + subMesh.numVertices * subMesh.vertexSize;
+    while (position != positionEnd)
+    {
+        *(CVector3*)position = *assimpPosition;
+        position += subMesh.vertexSize;
+        ++assimpPosition;
+    }
+
+    CVector3* assimpNormal = reinterpret_cast<CVector3*>(assimpMesh->mNormals);
+    unsigned char* normal = vertexData + normalOffset;
+    unsigned char* normalEnd = normal + subMesh.numVertices * subMesh.vertexSize;
+    while (normal != normalEnd)
+    {
+        *(CVector3*)normal = *assimpNormal;
+        normal += subMesh.vertexSize;
+        ++assimpNormal;
+    }
+
+    if (requireTangents)
+    {
+        CVector3* assimpTangent = reinterpret_cast<CVector3*>(assimpMesh->mTangents);
+        unsigned char* tangent =  vertexData + tangentOffset;
+        unsigned char* tangentEnd = tangent + subMesh.numVertices * subMesh.vertexSize;
+        while (tangent != tangentEnd)
+        {
+            *(CVector3*)tangent = *assimpTangent;
+            tangent += subMesh.vertexSize;
+            ++assimpTangent;
+        }
+    }
+
+    if (assimpMesh->GetNumUVChannels() > 0 && assimpMesh->HasTextureCoords(0))
+    {
+        aiVector3D* assimpUV = assimpMesh->mTextureCoords[0];
+        unsigned char* uv = vertexData + uvOffset;
+        unsigned char* uvEnd = uv + subMesh.numVertices * subMesh.vertexSize;
+        while (uv != uvEnd)
+        {
+            *(CVector2*)uv = CVector2(assimpUV->x, assimpUV->y);
+            uv += subMesh.vertexSize;
+            ++assimpUV;
+        }
+    }
+
+
+    if (hasBones)
+    {
+        if (assimpMesh->HasBones())
+        {
+            // Set all bones and weights to 0 to start with
+            unsigned char* bones = vertexData + bonesOffset;
+            unsigned char* bonesEnd = bones + subMesh.numVertices * subMesh.vertexSize;
+            while (bones != bonesEnd)
+            {
+                memset(bones, 0, 20);
+                bones += subMesh.vertexSize;
+            }
+
+            // Go through each assimp bone
+            bones = vertexData + bonesOffset;
+            for (unsigned int i = 0; i < assimpMesh->mNumBones; ++i)
+            {
+                // Get offset matrix for the bone (transform from skinned mesh root to bone root
+                aiBone* assimpBone = assimpMesh->mBones[i];
+                std::string boneName = assimpBone->mName.C_Str();
+                unsigned int nodeIndex = FindNode(nodeNames, boneName);
+                if (nodeIndex == NO_NODE)  throw std::runtime_error("Bone with no matching node in " + fileName);
+                if (nodeIndex > MAX_BONE_NODE)  throw std::runtime_error("Bone node index too large for vertex data in " + fileName);
+
+                // The node's offset matrix is set once all the sub-meshes are converted
+                staged.boneOffsets.push_back({ nodeIndex, &assimpBone->mOffsetMatrix });
+
+                // Go through each weight of the bone and update the vertex it influences
+                // Find the first 0 weight on that vertex and put the new influence / weight there.
+                // A vertex can only have up to 4 influences
+                for (unsigned int j = 0; j < assimpBone->mNumWeights; ++j)
+                {
+                    unsigned int vertexIndex = assimpBone->mWeights[j].mVertexId;
+                    unsigned char* bone = bones + vertexIndex * subMesh.vertexSize;
+                    float* weight = (float*)(bone + 4);
+                    float* lastWeight = weight + 3;
+                    while (*weight != 0.0f && weight != lastWeight)
+                    {
+                        bone++; weight++;
+                    }
+                    if (*weight == 0.0f)
+                    {
+                        *bone = nodeIndex;
+                        *weight = assimpBone->mWeights[j].mWeight;
+                    }
+                }
+            }
+        }
+        else
+        {
+            // In a mesh that uses skinning any sub-meshes that don't contain bones are given bones so the whole mesh can use one shader
+            // Every vertex is fully weighted to the node holding the sub-mesh
+            if (subMeshNode > MAX_BONE_NODE)  throw std::runtime_error("Bone node index too large for vertex data in " + fileName);
+            unsigned char* bones = vertexData + bonesOffset;
+            unsigned char* bonesEnd = bones + subMesh.numVertices * subMesh.vertexSize;
+            while (bones != bonesEnd)
+            {
+                memset(bones, 0, 20);
+                bones[0] = subMeshNode;
+                *(float*)(bones + 4) = 1.0f;
+                bones += subMesh.vertexSize;
+            }
+
+        }
+    }
+        
+
+
+    //-----------------------------------
+
+    // Copy face data from assimp to our CPU-side index buffer
+    if (!assimpMesh->HasFaces())  throw std::runtime_error("No face data in " + subMeshName + " in " + fileName);
+
+    if (subMesh.indexFormat == IndexFormat::UInt16)  CopyFaces(assimpMesh, reinterpret_cast<uint16_t*>(staged.indices.get()));
+    else                                             CopyFaces(assimpMesh, reinterpret_cast<uint32_t*>(staged.indices.get()));
+}
+
+
+// Set the number of threads used to convert the sub-meshes of a mesh after assimp has imported it
+void SetImportThreads(unsigned int numThreads)
+{
+    gImportThreads = numThreads;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Import
+//--------------------------------------------------------------------------------------
+
+// Import a mesh file into device-independent mesh data, replacing its contents. Optionally calculate tangents
+// (for normal and parallax mapping). Will throw a std::runtime_error exception on failure.
+// Verbose logging uses assimp's global logger so it must only be used when one import is running at a time
+void ImportMesh(const std::string& fileName, bool requireTangents, MeshData& mesh, bool verboseLog /*= false*/)
+{
+    Assimp::Importer importer;
+    mesh = MeshData();
+
+    int removeComponents;
+    unsigned int assimpFlags = ImportFlags(requireTangents, removeComponents);
+
+    // Other miscellaneous settings
+    importer.SetPropertyFloat(AI_CONFIG_PP_GSN_MAX_SMOOTHING_ANGLE, 80.0f); // Smoothing angle for normals
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBP_REMOVE, aiPrimitiveType_POINT | aiPrimitiveType_LINE);  // Remove points and lines (keep triangles only)
+    importer.SetPropertyBool(AI_CONFIG_PP_FD_REMOVE, true);                 // Remove degenerate triangles
+    importer.SetPropertyBool(AI_CONFIG_PP_DB_ALL_OR_NONE, true);            // Default to removing bones/weights from meshes that don't need skinning
+
+	// Set maximum bones that can affect one vertex, and also maximum bones affecting a single mesh
+    unsigned int maxBonesPerVertex = 4; // The shaders support 4 bones per verted (null bones are added if necessary)
+    unsigned int maxBonesPerMesh = 256; // Bone indexes are stored in a byte, so no more than 256 
+    importer.SetPropertyInteger(AI_CONFIG_PP_LBW_MAX_WEIGHTS, maxBonesPerVertex);
+    importer.SetPropertyInteger(AI_CONFIG_PP_SBBC_MAX_BONES, maxBonesPerMesh);
+  
+    importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, removeComponents);
+
+    // Import mesh with assimp given above requirements - optionally log output
+    if (verboseLog)  Assimp::DefaultLogger::create("", Assimp::DefaultLogger::VERBOSE);
+    const aiScene* scene = importer.ReadFile(fileName, assimpFlags);
+    if (verboseLog)  Assimp::DefaultLogger::kill();
+    if (scene == nullptr)  throw std::runtime_error("Error loading mesh (" + fileName + "). " + importer.GetErrorString());
+    if (scene->mNumMeshes == 0)  throw std::runtime_error("No usable geometry in mesh: " + fileName);
+
+
+    //-----------------------------------
+
+    //*********************************************************************//
+    // Read node hierachy - each node has a matrix and contains sub-meshes //
+
+    auto& nodes = mesh.nodes;
+    ReadNodes(nodes, scene->mRootNode);
+
+
+
+    //******************************************//
+    // Read geometry - multiple parts supported //
+
+	mesh.hasBones = false;
+	for (unsigned int m = 0; m < scene->mNumMeshes; ++m)
+        if (scene->mMeshes[m]->HasBones())  mesh.hasBones = true;
+
+
+    // A mesh is made of sub-meshes, each one can have a different material (texture)
+    // Import each sub-mesh in the file to seperate index / vertex data. The sub-meshes are independent so they are
+    // converted in parallel, each thread taking the next sub-mesh until there are none left
+    unsigned int numSubMeshes = scene->mNumMeshes;
+    mesh.subMeshes.resize(numSubMeshes);
+
+    // Skinned sub-meshes look up their bones by name, others are bound to the node holding them. Both are
+    // found once here rather than by searching the nodes for every bone / sub-mesh
+    NodeNameIndex nodeNames;
+    std::vector<unsigned int> subMeshNodes;
+    if (mesh.hasBones)
+    {
+        nodeNames = BuildNodeNameIndex(nodes);
+        subMeshNodes = FindSubMeshNodes(nodes, numSubMeshes);
+    }
+
+    std::vector<StagedSubMesh> staged(numSubMeshes);
+    auto convertSubMesh = [&](unsigned int m)
+    {
+        try
+        {
+            ConvertSubMesh(scene, m, requireTangents, mesh.hasBones, nodeNames, mesh.hasBones ? subMeshNodes[m] : 0,
+                           fileName, mesh.subMeshes[m], staged[m]);
+        }
+        catch (...)
+        {
+            staged[m].error = std::current_exception();
+        }
+    };
+
+    unsigned int numThreads = gImportThreads;
+    if (numThreads == 0)  numThreads = std::max(1u, std::thread::hardware_concurrency());
+    numThreads = std::min(numThreads, numSubMeshes);
+    if (numThreads <= 1)
+    {
+        for (unsigned int m = 0; m < numSubMeshes; ++m)  convertSubMesh(m);
+    }
+    else
+    {
+        std::atomic<unsigned int> nextSubMesh(0);
+        auto worker = [&]()
+        {
+            for (unsigned int m = nextSubMesh++; m < numSubMeshes; m = nextSubMesh++)  convertSubMesh(m);
+        };
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < numThreads; ++t)  threads.emplace_back(worker);
+        worker();
+        for (auto& thread : threads)  thread.join();
+    }
+
+    // Finish in sub-mesh order so the result is the same however many threads were used: report the error from
+    // the first sub-mesh that failed, then hand the buffers over to the mesh data and set the bone offset matrices
+    for (auto& subMesh : staged)
+    {
+        if (subMesh.error)  std::rethrow_exception(subMesh.error);
+    }
+    for (auto& subMesh : staged)
+    {
+        mesh.buffers.push_back(std::move(subMesh.vertices));
+        mesh.buffers.push_back(std::move(subMesh.indices));
+
+        // Assimp matrices are for column vectors, so their first three rows are the columns of our affine matrix
+        for (auto& boneOffset : subMesh.boneOffsets)
+        {
+            nodes[boneOffset.first].offsetMatrix.SetColumns(&boneOffset.second->a1);
+        }
+    }
+
+    // Bounds need the full precision vertices and the bone offset matrices
+    CalculateBounds(mesh);
+}
+
+
+// Fill mesh data for a mesh file from the mesh cache if there is a cooked mesh for these settings, otherwise
+// import the file, generate simplified LODs, optimise the triangle and vertex order, build culling clusters, pack the selected vertex elements
+// into compact formats and save a cooked mesh so the next load can skip the import. Returns true if the cooked mesh
+// was used. Will throw a std::runtime_error exception if the import fails
+bool LoadMesh(const std::string& fileName, bool requireTangents, MeshData& mesh, bool verboseLog /*= false*/,
+              uint32_t compactVertices /*= 0*/, uint32_t numLODs /*= 0*/)
+{
+    // If the file can't be read there is no key, the import will then fail and report the error
+    uint64_t key = MeshCacheKey(fileName, MeshImportSettings(requireTangents, compactVertices, numLODs));
+    if (key != 0 && LoadCookedMesh(CookedMeshFileName(fileName, key), key, mesh))  return true;
+
+    ImportMesh(fileName, requireTangents, mesh, verboseLog);
+    if (numLODs != 0)  GenerateLODs(mesh, numLODs); // Simplification needs the full precision vertices
+    OptimiseMesh(mesh);                             // So does overdraw sorting
+    BuildMeshClusters(mesh);                        // And cluster bounds, using the optimised triangle order
+    if (compactVertices != 0)  PackVertices(mesh, compactVertices);
+    if (key != 0)  SaveCookedMesh(CookedMeshFileName(fileName, key), key, mesh);
+    return false;
+}
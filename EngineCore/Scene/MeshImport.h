@@ -0,0 +1,44 @@
+//--------------------------------------------------------------------------------------
+// Mesh import - converts mesh files into device-independent mesh data using assimp
+//--------------------------------------------------------------------------------------
+// This is the CPU side of loading a mesh: import and post-processing with assimp (http://www.assimp.org/),
+// vertex packing, bone weight assignment and reading the node hierarchy. It has no graphics API code so
+// meshes can be cooked offline (see the meshcook tool) as well as in the apps, which then create their GPU
+// resources from the MeshData. Needs the assimp library, so it is only in the CMake build when assimp is found.
+
+#ifndef _MESH_IMPORT_H_INCLUDED_
+#define _MESH_IMPORT_H_INCLUDED_
+
+#include "MeshData.h"
+
+#include <cstdint>
+#include <string>
+
+
+// Return a value identifying the import settings, for the mesh cache key (see MeshCacheKey). Covers everything
+// that affects the imported data, so changing the settings or the import code gives a new key. The compact
+// vertex elements are those packed after import (VERTEX_COMPACT_... flags, see VertexPacking.h), numLODs is the
+// number of simplified LODs generated for each sub-mesh (see MeshSimplify.h)
+uint64_t MeshImportSettings(bool requireTangents, uint32_t compactVertices = 0, uint32_t numLODs = 0);
+
+// Import a mesh file into device-independent mesh data, replacing its contents. Optionally calculate tangents
+// (for normal and parallax mapping). Will throw a std::runtime_error exception on failure.
+// Verbose logging uses assimp's global logger so it must only be used when one import is running at a time
+void ImportMesh(const std::string& fileName, bool requireTangents, MeshData& mesh, bool verboseLog = false);
+
+// Fill mesh data for a mesh file from the mesh cache if there is a cooked mesh for these settings, otherwise
+// import the file, generate numLODs simplified LODs for each sub-mesh (see MeshSimplify.h), optimise the triangle
+// and vertex order for the GPU's caches (see MeshOptimise.h), split the sub-meshes into culling clusters (see
+// MeshClusters.h), pack the selected vertex elements into compact formats (VERTEX_COMPACT_... flags, see
+// VertexPacking.h) and save a cooked mesh so the next load can skip the import. Returns true if the cooked mesh was used. Failing to save the cooked mesh is not an error (e.g. read-only
+// folder), the file is just imported again next time. Will throw a std::runtime_error exception if the import fails
+bool LoadMesh(const std::string& fileName, bool requireTangents, MeshData& mesh, bool verboseLog = false,
+              uint32_t compactVertices = 0, uint32_t numLODs = 0);
+
+// Set the number of threads used to convert the sub-meshes of a mesh after assimp has imported it. 0 (the
+// default) uses one per hardware thread, 1 converts them one after another on the calling thread. The imported
+// data is the same either way, serial conversion is for checking that and for callers already running imports in parallel
+void SetImportThreads(unsigned int numThreads);
+
+
+#endif //_MESH_IMPORT_H_INCLUDED_
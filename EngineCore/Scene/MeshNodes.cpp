@@ -0,0 +1,31 @@
+//--------------------------------------------------------------------------------------
+// Mesh node lookup - finding nodes by name and the nodes holding each sub-mesh
+//--------------------------------------------------------------------------------------
+
+#include "MeshNodes.h"
+
+
+NodeNameIndex BuildNodeNameIndex(const std::vector<NodeData>& nodes)
+{
+    NodeNameIndex nodeNames;
+    nodeNames.reserve(nodes.size());
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+        nodeNames.emplace(nodes[i].name, i); // Does nothing if the name is already present, so the first node is kept
+    }
+    return nodeNames;
+}
+
+
+std::vector<unsigned int> FindSubMeshNodes(const std::vector<NodeData>& nodes, size_t numSubMeshes)
+{
+    std::vector<unsigned int> subMeshNodes(numSubMeshes, 0);
+    for (unsigned int i = 0; i < nodes.size(); ++i)
+    {
+        for (unsigned int subMesh : nodes[i].subMeshes)
+        {
+            if (subMesh < numSubMeshes)  subMeshNodes[subMesh] = i;
+        }
+    }
+    return subMeshNodes;
+}
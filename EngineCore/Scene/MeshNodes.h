@@ -0,0 +1,43 @@
+//--------------------------------------------------------------------------------------
+// Mesh node lookup - finding nodes by name and the nodes holding each sub-mesh
+//--------------------------------------------------------------------------------------
+// Skinned meshes refer to their bones by name, and large rigs (e.g. motion capture characters) can have
+// thousands of nodes. Searching the node list for every bone is O(bones x nodes), so the names are put in a
+// hash table once and each lookup is then constant time. Similarly the node holding each sub-mesh is found
+// with one pass over the hierarchy rather than a search per sub-mesh.
+
+#ifndef _MESH_NODES_H_INCLUDED_
+#define _MESH_NODES_H_INCLUDED_
+
+#include "MeshData.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+// Returned when there is no node with a given name
+const unsigned int NO_NODE = ~0u;
+
+// Node index for each node name
+typedef std::unordered_map<std::string, unsigned int> NodeNameIndex;
+
+
+// Build the name index for a node hierarchy. Where several nodes have the same name the first is used, as a
+// search through the nodes in order would find
+NodeNameIndex BuildNodeNameIndex(const std::vector<NodeData>& nodes);
+
+// Return the index of the node with the given name, or NO_NODE if there is none
+inline unsigned int FindNode(const NodeNameIndex& nodeNames, const std::string& name)
+{
+    auto node = nodeNames.find(name);
+    return (node != nodeNames.end()) ? node->second : NO_NODE;
+}
+
+
+// Return the index of the node holding each sub-mesh. Sub-meshes held by no node are given the root (0), if
+// several nodes hold a sub-mesh the last is used
+std::vector<unsigned int> FindSubMeshNodes(const std::vector<NodeData>& nodes, size_t numSubMeshes);
+
+
+#endif //_MESH_NODES_H_INCLUDED_
@@ -0,0 +1,465 @@
+//--------------------------------------------------------------------------------------
+// Mesh optimisation - ordering triangles and vertices for the GPU's vertex caches
+//--------------------------------------------------------------------------------------
+
+#include "MeshOptimise.h"
+#include "CVector3.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+
+const uint32_t NO_TRIANGLE = ~0u;
+
+
+//--------------------------------------------------------------------------------------
+// Cache simulation
+//--------------------------------------------------------------------------------------
+
+// FIFO cache simulated with a time stamp for each vertex: the count of vertices added to the cache when it was
+// last added. A vertex is still in the cache if fewer than cacheSize vertices have been added since
+class FIFOCache
+{
+public:
+    FIFOCache(uint32_t numVertices, uint32_t cacheSize) : mStamps(numVertices, 0), mTime(cacheSize + 1), mCacheSize(cacheSize) {}
+
+    // Draw a vertex, returning true if it had to be transformed
+    bool Miss(uint32_t vertex)
+    {
+        if (mTime - mStamps[vertex] <= mCacheSize)  return false;
+        mStamps[vertex] = mTime++;
+        return true;
+    }
+
+    // Empty the cache - moving time on evicts everything
+    void Reset()  { mTime += mCacheSize + 1; }
+
+private:
+    std::vector<uint32_t> mStamps;
+    uint32_t              mTime;
+    uint32_t              mCacheSize;
+};
+
+
+VertexCacheStats SimulateVertexCache(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices,
+                                     uint32_t cacheSize, VertexCacheType type)
+{
+    VertexCacheStats stats;
+    stats.numTriangles = numIndices / 3;
+
+    std::vector<bool> used(numVertices, false);
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        if (!used[indices[i]])  ++stats.numVertices;
+        used[indices[i]] = true;
+    }
+
+    if (type == VertexCacheType::FIFO)
+    {
+        FIFOCache cache(numVertices, cacheSize);
+        for (uint32_t i = 0; i < numIndices; ++i)  stats.numTransforms += cache.Miss(indices[i]) ? 1 : 0;
+    }
+    else
+    {
+        // Most recently used first. Small enough that searching it is quicker than anything cleverer
+        std::vector<uint32_t> cache;
+        cache.reserve(cacheSize + 1);
+        for (uint32_t i = 0; i < numIndices; ++i)
+        {
+            auto found = std::find(cache.begin(), cache.end(), indices[i]);
+            if (found != cache.end())
+            {
+                std::rotate(cache.begin(), found, found + 1);
+            }
+            else
+            {
+                ++stats.numTransforms;
+                cache.insert(cache.begin(), indices[i]);
+                if (cache.size() > cacheSize)  cache.pop_back();
+            }
+        }
+    }
+    return stats;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Vertex cache optimisation
+//--------------------------------------------------------------------------------------
+// Each vertex is scored from its position in a simulated LRU cache (recently used vertices score higher, the three
+// from the last triangle a little less so the next triangle doesn't double back) plus a boost for vertices with
+// few triangles left to draw, so lone triangles are finished off rather than left to cost a cache miss later.
+// The next triangle drawn is the highest scoring (the sum of its vertex scores) of those using a cached vertex.
+// Constants are from Tom Forsyth's article
+
+const uint32_t FORSYTH_CACHE_SIZE   = 32;
+const float    CACHE_DECAY_POWER    = 1.5f;
+const float    LAST_TRIANGLE_SCORE  = 0.75f;
+const float    VALENCE_BOOST_SCALE  = 2.0f;
+const float    VALENCE_BOOST_POWER  = 0.5f;
+const uint32_t MAX_VALENCE_TABLE    = 32; // Valence scores above this are calculated as needed
+
+struct VertexScoreTables
+{
+    float cache[FORSYTH_CACHE_SIZE];
+    float valence[MAX_VALENCE_TABLE];
+
+    VertexScoreTables()
+    {
+        for (uint32_t i = 0; i < FORSYTH_CACHE_SIZE; ++i)
+        {
+            cache[i] = (i < 3) ? LAST_TRIANGLE_SCORE
+                               : std::pow(1.0f - static_cast<float>(i - 3) / (FORSYTH_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+        }
+        valence[0] = 0;
+        for (uint32_t i = 1; i < MAX_VALENCE_TABLE; ++i)  valence[i] = VALENCE_BOOST_SCALE * std::pow(static_cast<float>(i), -VALENCE_BOOST_POWER);
+    }
+};
+
+// Score of a vertex with the given position in the cache (-1 if not in it) and number of triangles left to draw
+static float VertexScore(const VertexScoreTables& tables, int cachePosition, uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0)  return -1; // Not needed again
+    float score = (cachePosition >= 0) ? tables.cache[cachePosition] : 0;
+    score += (remainingTriangles < MAX_VALENCE_TABLE) ? tables.valence[remainingTriangles]
+                                                       : VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+    return score;
+}
+
+
+void OptimiseVertexCache(uint32_t* indices, uint32_t numIndices, uint32_t numVertices)
+{
+    static const VertexScoreTables tables;
+    uint32_t numTriangles = numIndices / 3;
+    if (numTriangles == 0)  return;
+
+    // Triangles using each vertex. Each vertex's list is kept with the triangles not yet drawn first, the first
+    // remainingTriangles[v] entries, so drawing a triangle swaps it out of the lists of its vertices
+    std::vector<uint32_t> remainingTriangles(numVertices, 0);
+    for (uint32_t i = 0; i < numTriangles * 3; ++i)  ++remainingTriangles[indices[i]];
+    std::vector<uint32_t> firstTriangle(numVertices + 1, 0);
+    for (uint32_t v = 0; v < numVertices; ++v)  firstTriangle[v + 1] = firstTriangle[v] + remainingTriangles[v];
+    std::vector<uint32_t> vertexTriangles(numTriangles * 3);
+    {
+        std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+        for (uint32_t i = 0; i < numTriangles * 3; ++i)  vertexTriangles[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<int>   cachePositions(numVertices, -1);
+    std::vector<float> vertexScores(numVertices);
+    for (uint32_t v = 0; v < numVertices; ++v)  vertexScores[v] = VertexScore(tables, -1, remainingTriangles[v]);
+
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool>  drawn(numTriangles, false);
+    uint32_t bestTriangle = 0;
+    for (uint32_t t = 0; t < numTriangles; ++t)
+    {
+        const uint32_t* tri = indices + t * 3;
+        triangleScores[t] = vertexScores[tri[0]] + vertexScores[tri[1]] + vertexScores[tri[2]];
+        if (triangleScores[t] > triangleScores[bestTriangle])  bestTriangle = t;
+    }
+
+    std::vector<uint32_t> output(numTriangles * 3);
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t cacheCount = 0;
+    uint32_t nextInputTriangle = 0; // Where to look for a triangle when no cached vertex has any left
+
+    for (uint32_t drawnCount = 0; drawnCount < numTriangles; ++drawnCount)
+    {
+        if (bestTriangle == NO_TRIANGLE)
+        {
+            while (drawn[nextInputTriangle])  ++nextInputTriangle;
+            bestTriangle = nextInputTriangle;
+        }
+
+        // Draw the triangle and remove it from its vertices' lists
+        const uint32_t* tri = indices + bestTriangle * 3;
+        std::memcpy(&output[drawnCount * 3], tri, 3 * sizeof(uint32_t));
+        drawn[bestTriangle] = true;
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t v = tri[c];
+            uint32_t* list = &vertexTriangles[firstTriangle[v]];
+            uint32_t last = --remainingTriangles[v];
+            *std::find(list, list + last + 1, bestTriangle) = list[last];
+            list[last] = bestTriangle;
+        }
+
+        // The triangle's vertices move to the front of the cache, pushing the others back. Up to three drop out
+        uint32_t newCache[FORSYTH_CACHE_SIZE + 3] = { tri[0], tri[1], tri[2] };
+        uint32_t newCount = 3;
+        for (uint32_t c = 0; c < cacheCount; ++c)
+        {
+            uint32_t v = cache[c];
+            if (v != tri[0] && v != tri[1] && v != tri[2])  newCache[newCount++] = v;
+        }
+
+        // Rescore the vertices whose position changed, then the triangles using them, picking the best triangle
+        // using a vertex still in the cache
+        for (uint32_t c = 0; c < newCount; ++c)
+        {
+            uint32_t v = newCache[c];
+            cachePositions[v] = (c < FORSYTH_CACHE_SIZE) ? static_cast<int>(c) : -1;
+            vertexScores[v] = VertexScore(tables, cachePositions[v], remainingTriangles[v]);
+        }
+        bestTriangle = NO_TRIANGLE;
+        float bestScore = -1;
+        for (uint32_t c = 0; c < newCount; ++c)
+        {
+            uint32_t v = newCache[c];
+            for (uint32_t i = firstTriangle[v]; i < firstTriangle[v] + remainingTriangles[v]; ++i)
+            {
+                uint32_t t = vertexTriangles[i];
+                const uint32_t* other = indices + t * 3;
+                triangleScores[t] = vertexScores[other[0]] + vertexScores[other[1]] + vertexScores[other[2]];
+                if (c < FORSYTH_CACHE_SIZE && triangleScores[t] > bestScore)
+                {
+                    bestScore = triangleScores[t];
+                    bestTriangle = t;
+                }
+            }
+        }
+
+        cacheCount = std::min(newCount, FORSYTH_CACHE_SIZE);
+        std::copy(newCache, newCache + cacheCount, cache);
+    }
+
+    std::copy(output.begin(), output.end(), indices);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Overdraw optimisation
+//--------------------------------------------------------------------------------------
+
+void OptimiseOverdraw(uint32_t* indices, uint32_t numIndices, const void* positions, uint32_t stride,
+                      uint32_t numVertices, float threshold)
+{
+    uint32_t numTriangles = numIndices / 3;
+    if (numTriangles < 2)  return;
+
+    auto position = [&](uint32_t v) { return CVector3(reinterpret_cast<const float*>(static_cast<const char*>(positions) + v * stride)); };
+    FIFOCache cache(numVertices, REPORT_FIFO_CACHE_SIZE);
+    auto triangleMisses = [&](uint32_t t)
+    {
+        return (cache.Miss(indices[t * 3]) ? 1u : 0u) + (cache.Miss(indices[t * 3 + 1]) ? 1u : 0u) + (cache.Miss(indices[t * 3 + 2]) ? 1u : 0u);
+    };
+
+    // Hard boundaries where the cache restarts - a triangle with no vertex in the cache
+    std::vector<uint32_t> hardStarts;
+    for (uint32_t t = 0; t < numTriangles; ++t)
+    {
+        if (triangleMisses(t) == 3)  hardStarts.push_back(t);
+    }
+    hardStarts.push_back(numTriangles);
+
+    // Soft boundaries within each run: start a new cluster once the current one's ACMR is within the threshold of
+    // the whole run's. Clusters start with an empty cache as they will be drawn after some other cluster
+    std::vector<uint32_t> clusterStarts;
+    for (size_t h = 0; h + 1 < hardStarts.size(); ++h)
+    {
+        uint32_t start = hardStarts[h], end = hardStarts[h + 1];
+        cache.Reset();
+        uint32_t runMisses = 0;
+        for (uint32_t t = start; t < end; ++t)  runMisses += triangleMisses(t);
+        float targetACMR = threshold * runMisses / (end - start);
+
+        cache.Reset();
+        uint32_t clusterStart = start, clusterMisses = 0;
+        clusterStarts.push_back(start);
+        for (uint32_t t = start; t + 1 < end; ++t)
+        {
+            clusterMisses += triangleMisses(t);
+            if (clusterMisses <= targetACMR * (t + 1 - clusterStart))
+            {
+                clusterStart = t + 1;
+                clusterMisses = 0;
+                clusterStarts.push_back(clusterStart);
+                cache.Reset();
+            }
+        }
+    }
+    clusterStarts.push_back(numTriangles);
+    size_t numClusters = clusterStarts.size() - 1;
+
+
+    // Area weighted centre and normal of each cluster and the mesh centre
+    std::vector<CVector3> clusterCentres(numClusters), clusterNormals(numClusters);
+    CVector3 meshCentre = { 0, 0, 0 };
+    float meshArea = 0;
+    for (size_t c = 0; c < numClusters; ++c)
+    {
+        CVector3 centre = { 0, 0, 0 }, normal = { 0, 0, 0 };
+        float area = 0;
+        for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+        {
+            CVector3 p0 = position(indices[t * 3]), p1 = position(indices[t * 3 + 1]), p2 = position(indices[t * 3 + 2]);
+            CVector3 n = Cross(p1 - p0, p2 - p0);
+            float triangleArea = Length(n);
+            centre += (p0 + p1 + p2) * (triangleArea / 3);
+            normal += n;
+            area += triangleArea;
+        }
+        meshCentre += centre;
+        meshArea += area;
+        clusterCentres[c] = (area > 0) ? centre * (1 / area) : position(indices[clusterStarts[c] * 3]);
+        float normalLength = Length(normal);
+        clusterNormals[c] = (normalLength > 0) ? normal * (1 / normalLength) : CVector3{ 0, 0, 0 };
+    }
+    if (meshArea > 0)  meshCentre *= 1 / meshArea;
+
+    // Clusters facing away from the mesh centre, and furthest out, are drawn first
+    std::vector<float> sortKeys(numClusters);
+    for (size_t c = 0; c < numClusters; ++c)  sortKeys[c] = Dot(clusterCentres[c] - meshCentre, clusterNormals[c]);
+    std::vector<uint32_t> order(numClusters);
+    for (uint32_t c = 0; c < numClusters; ++c)  order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(numTriangles * 3);
+    for (uint32_t c : order)  output.insert(output.end(), indices + clusterStarts[c] * 3, indices + clusterStarts[c + 1] * 3);
+    std::copy(output.begin(), output.end(), indices);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Vertex fetch optimisation
+//--------------------------------------------------------------------------------------
+
+std::vector<uint32_t> VertexFetchRemap(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices)
+{
+    std::vector<uint32_t> remap(numVertices, ~0u);
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < numIndices; ++i)
+    {
+        if (remap[indices[i]] == ~0u)  remap[indices[i]] = next++;
+    }
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        if (remap[v] == ~0u)  remap[v] = next++;
+    }
+    return remap;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Whole meshes
+//--------------------------------------------------------------------------------------
+
+// Index lists are optimised as 32-bit whatever the sub-mesh's index format
+static std::vector<uint32_t> ReadIndices(const void* indices, uint32_t numIndices, IndexFormat format)
+{
+    std::vector<uint32_t> result(numIndices);
+    if (format == IndexFormat::UInt16)
+    {
+        const uint16_t* indices16 = static_cast<const uint16_t*>(indices);
+        for (uint32_t i = 0; i < numIndices; ++i)  result[i] = indices16[i];
+    }
+    else if (numIndices > 0)
+    {
+        std::memcpy(result.data(), indices, numIndices * sizeof(uint32_t));
+    }
+    return result;
+}
+
+static std::unique_ptr<unsigned char[]> WriteIndices(const std::vector<uint32_t>& indices, IndexFormat format)
+{
+    auto buffer = std::make_unique<unsigned char[]>(std::max<size_t>(indices.size() * IndexFormatSize(format), 1));
+    if (format == IndexFormat::UInt16)
+    {
+        uint16_t* indices16 = reinterpret_cast<uint16_t*>(buffer.get());
+        for (size_t i = 0; i < indices.size(); ++i)  indices16[i] = static_cast<uint16_t>(indices[i]);
+    }
+    else if (!indices.empty())
+    {
+        std::memcpy(buffer.get(), indices.data(), indices.size() * sizeof(uint32_t));
+    }
+    return buffer;
+}
+
+// Replace a block the mesh data points to with a new one, freeing the old one if the mesh data owns it (i.e. not a
+// mapped file). Returns the new block
+static const unsigned char* ReplaceBuffer(MeshData& mesh, const void* oldBuffer, std::unique_ptr<unsigned char[]> newBuffer)
+{
+    for (auto& buffer : mesh.buffers)
+    {
+        if (buffer.get() == oldBuffer)  buffer.reset();
+    }
+    mesh.buffers.push_back(std::move(newBuffer));
+    return mesh.buffers.back().get();
+}
+
+
+void OptimiseMesh(MeshData& mesh, float overdrawThreshold /*= DEFAULT_OVERDRAW_THRESHOLD*/, MeshOptimiseStats* stats /*= nullptr*/)
+{
+    MeshOptimiseStats totals;
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        if (subMesh.numIndices == 0 || subMesh.numVertices == 0)  continue;
+
+        // Overdraw sorting needs full precision positions
+        const unsigned char* positions = nullptr;
+        for (auto& element : subMesh.layout)
+        {
+            if (element.semantic == VertexSemantic::Position && element.format == VertexFormat::Float3)  positions = subMesh.vertices + element.offset;
+        }
+        auto optimiseTriangles = [&](std::vector<uint32_t>& indices)
+        {
+            uint32_t numIndices = static_cast<uint32_t>(indices.size());
+            OptimiseVertexCache(indices.data(), numIndices, subMesh.numVertices);
+            if (overdrawThreshold > 0 && positions != nullptr)
+            {
+                OptimiseOverdraw(indices.data(), numIndices, positions, subMesh.vertexSize, subMesh.numVertices, overdrawThreshold);
+            }
+        };
+
+        std::vector<uint32_t> indices = ReadIndices(subMesh.indices, subMesh.numIndices, subMesh.indexFormat);
+        totals.fifoBefore += SimulateVertexCache(indices.data(), subMesh.numIndices, subMesh.numVertices, REPORT_FIFO_CACHE_SIZE, VertexCacheType::FIFO);
+        totals.lruBefore  += SimulateVertexCache(indices.data(), subMesh.numIndices, subMesh.numVertices, REPORT_LRU_CACHE_SIZE,  VertexCacheType::LRU);
+        optimiseTriangles(indices);
+
+        // LODs get their own triangle order. LODs that are the same as the one before share its indices
+        std::vector<std::vector<uint32_t>> lodIndices(subMesh.lods.size());
+        std::vector<bool> sameAsPrevious(subMesh.lods.size(), false);
+        for (size_t l = 0; l < subMesh.lods.size(); ++l)
+        {
+            sameAsPrevious[l] = (l > 0 && subMesh.lods[l].indices == subMesh.lods[l - 1].indices);
+            if (sameAsPrevious[l])  continue;
+            lodIndices[l] = ReadIndices(subMesh.lods[l].indices, subMesh.lods[l].numIndices, subMesh.indexFormat);
+            optimiseTriangles(lodIndices[l]);
+        }
+
+        // Vertices in the order the full detail triangles use them, all index lists updated to match
+        std::vector<uint32_t> remap = VertexFetchRemap(indices.data(), subMesh.numIndices, subMesh.numVertices);
+        for (auto& index : indices)  index = remap[index];
+        for (auto& lod : lodIndices)
+        {
+            for (auto& index : lod)  index = remap[index];
+        }
+        auto vertices = std::make_unique<unsigned char[]>(static_cast<size_t>(subMesh.numVertices) * subMesh.vertexSize);
+        for (uint32_t v = 0; v < subMesh.numVertices; ++v)
+        {
+            std::memcpy(vertices.get() + static_cast<size_t>(remap[v]) * subMesh.vertexSize, subMesh.vertices + static_cast<size_t>(v) * subMesh.vertexSize, subMesh.vertexSize);
+        }
+
+        totals.fifoAfter += SimulateVertexCache(indices.data(), subMesh.numIndices, subMesh.numVertices, REPORT_FIFO_CACHE_SIZE, VertexCacheType::FIFO);
+        totals.lruAfter  += SimulateVertexCache(indices.data(), subMesh.numIndices, subMesh.numVertices, REPORT_LRU_CACHE_SIZE,  VertexCacheType::LRU);
+
+        // Point the sub-mesh at the new blocks
+        subMesh.vertices = ReplaceBuffer(mesh, subMesh.vertices, std::move(vertices));
+        subMesh.indices  = ReplaceBuffer(mesh, subMesh.indices, WriteIndices(indices, subMesh.indexFormat));
+        for (size_t l = 0; l < subMesh.lods.size(); ++l)
+        {
+            if (sameAsPrevious[l])
+            {
+                subMesh.lods[l].indices = subMesh.lods[l - 1].indices;
+                continue;
+            }
+            subMesh.lods[l].indices = ReplaceBuffer(mesh, subMesh.lods[l].indices, WriteIndices(lodIndices[l], subMesh.indexFormat));
+        }
+    }
+
+    if (stats != nullptr)  *stats = totals;
+}
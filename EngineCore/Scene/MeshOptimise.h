@@ -0,0 +1,96 @@
+//--------------------------------------------------------------------------------------
+// Mesh optimisation - ordering triangles and vertices for the GPU's vertex caches
+//--------------------------------------------------------------------------------------
+// The GPU keeps recently transformed vertices in a small post-transform cache, so a vertex shared by several
+// triangles is only shaded again if it has dropped out of the cache by the time the next of them is drawn.
+// The order of the triangles decides how often that happens, measured as:
+//     ACMR - average cache miss ratio, vertices shaded per triangle. 3 is the worst, about 0.5 the best possible
+//            for large regular meshes
+//     ATVR - average transform to vertex ratio, times each vertex is shaded. 1 is ideal, independent of mesh shape
+// Three passes improve the order, run on each sub-mesh (and each LOD) when a mesh is imported:
+//     - Vertex cache: triangles are reordered with Tom Forsyth's "Linear-Speed Vertex Cache Optimisation", which
+//       greedily picks the next triangle using vertices that are in the cache and have few triangles left
+//     - Overdraw (optional): the cache-friendly order is cut into clusters where the cache restarts anyway (or
+//       where the ACMR is within a threshold of the cluster's), and the clusters are sorted so those facing out
+//       from the mesh centre are drawn first. They tend to hide the rest, so fewer pixels are shaded twice
+//       (Sander et al., "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw", the Tipsify paper)
+//     - Vertex fetch: vertices are stored in the order they are first used so the pre-transform fetches read
+//       memory in sequence
+// The results are measured by simulating FIFO and LRU caches, so the gain can be checked without a GPU.
+
+#ifndef _MESH_OPTIMISE_H_INCLUDED_
+#define _MESH_OPTIMISE_H_INCLUDED_
+
+#include "MeshData.h"
+
+#include <cstdint>
+#include <vector>
+
+
+// Cache replacement policies. Older GPUs used a FIFO of transformed vertices, an LRU is closer to newer hardware
+// and what the vertex cache optimisation models
+enum class VertexCacheType
+{
+    FIFO,
+    LRU,
+};
+
+// Cache sizes used for reporting
+const uint32_t REPORT_FIFO_CACHE_SIZE = 16;
+const uint32_t REPORT_LRU_CACHE_SIZE  = 32;
+
+// Vertex cache simulation results. Counts rather than ratios so results for several sub-meshes can be added together
+struct VertexCacheStats
+{
+    uint64_t numTriangles  = 0;
+    uint64_t numVertices   = 0; // Vertices used by the triangles
+    uint64_t numTransforms = 0; // Cache misses, i.e. vertex shader runs
+
+    float ACMR() const  { return numTriangles > 0 ? static_cast<float>(numTransforms) / numTriangles : 0; }
+    float ATVR() const  { return numVertices  > 0 ? static_cast<float>(numTransforms) / numVertices  : 0; }
+
+    VertexCacheStats& operator+=(const VertexCacheStats& s)
+    {
+        numTriangles += s.numTriangles;  numVertices += s.numVertices;  numTransforms += s.numTransforms;
+        return *this;
+    }
+};
+
+// Vertex cache results before and after optimising a mesh, see OptimiseMesh
+struct MeshOptimiseStats
+{
+    VertexCacheStats fifoBefore, fifoAfter; // REPORT_FIFO_CACHE_SIZE entry FIFO
+    VertexCacheStats lruBefore,  lruAfter;  // REPORT_LRU_CACHE_SIZE entry LRU
+};
+
+
+// Simulate drawing a triangle list through a post-transform cache of the given size and type
+VertexCacheStats SimulateVertexCache(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices,
+                                     uint32_t cacheSize, VertexCacheType type);
+
+
+// Reorder a triangle list in place for the post-transform vertex cache. The triangles are unchanged, only their order
+void OptimiseVertexCache(uint32_t* indices, uint32_t numIndices, uint32_t numVertices);
+
+// Reorder clusters of a cache-optimised triangle list in place to reduce overdraw. Positions are Float3, stride
+// bytes apart. Clusters are split wherever the cache restarts and wherever their ACMR is within threshold of
+// their whole run (e.g. 1.05 allows ACMR to rise by up to 5% in return for more, smaller clusters to sort)
+void OptimiseOverdraw(uint32_t* indices, uint32_t numIndices, const void* positions, uint32_t stride,
+                      uint32_t numVertices, float threshold);
+
+// Return the new position of each vertex so they are in the order the triangles first use them. Vertices no
+// triangle uses go at the end in their original order
+std::vector<uint32_t> VertexFetchRemap(const uint32_t* indices, uint32_t numIndices, uint32_t numVertices);
+
+
+// Overdraw threshold used by the mesh loader and meshcook, see OptimiseOverdraw
+const float DEFAULT_OVERDRAW_THRESHOLD = 1.05f;
+
+// Run all the passes on every sub-mesh in the mesh data and their LODs (see MeshSimplify.h): vertex cache, then
+// overdraw if overdrawThreshold is not 0 (needs Float3 positions), then vertex fetch (using the full detail triangle
+// order). Call after generating LODs and before packing vertices. Optionally returns the cache simulation results
+// over all sub-meshes before and after (full detail only)
+void OptimiseMesh(MeshData& mesh, float overdrawThreshold = DEFAULT_OVERDRAW_THRESHOLD, MeshOptimiseStats* stats = nullptr);
+
+
+#endif //_MESH_OPTIMISE_H_INCLUDED_
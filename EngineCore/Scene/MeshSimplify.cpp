@@ -0,0 +1,453 @@
+//--------------------------------------------------------------------------------------
+// Mesh simplification - generating levels of detail (LODs) with quadric error edge collapse
+//--------------------------------------------------------------------------------------
+
+#include "MeshSimplify.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+
+//--------------------------------------------------------------------------------------
+// Quadrics
+//--------------------------------------------------------------------------------------
+
+// Symmetric 4x4 matrix giving the sum of squared distances from a point to a set of planes: for a plane with unit
+// normal n and offset d the squared distance is (n.p + d)^2 = p.(n n^T).p + 2d n.p + d^2. Doubles as the sums
+// lose precision quickly in floats
+struct Quadric
+{
+    double a00, a11, a22, a01, a02, a12; // n n^T
+    double b0, b1, b2;                   // d n
+    double c;                            // d^2
+};
+
+static void AddPlane(Quadric& q, const CVector3& normal, float offset, double weight)
+{
+    double x = normal.x, y = normal.y, z = normal.z, d = offset;
+    q.a00 += weight * x * x;  q.a11 += weight * y * y;  q.a22 += weight * z * z;
+    q.a01 += weight * x * y;  q.a02 += weight * x * z;  q.a12 += weight * y * z;
+    q.b0  += weight * x * d;  q.b1  += weight * y * d;  q.b2  += weight * z * d;
+    q.c   += weight * d * d;
+}
+
+static Quadric operator+(const Quadric& q, const Quadric& r)
+{
+    return { q.a00 + r.a00, q.a11 + r.a11, q.a22 + r.a22, q.a01 + r.a01, q.a02 + r.a02, q.a12 + r.a12,
+             q.b0 + r.b0, q.b1 + r.b1, q.b2 + r.b2, q.c + r.c };
+}
+
+// Sum of squared distances from a point to the quadric's planes
+static float QuadricError(const Quadric& q, const CVector3& p)
+{
+    double x = p.x, y = p.y, z = p.z;
+    double error = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z + 2 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z) +
+                   2 * (q.b0 * x + q.b1 * y + q.b2 * z) + q.c;
+    return static_cast<float>(std::max(error, 0.0));
+}
+
+
+//--------------------------------------------------------------------------------------
+// Simplification
+//--------------------------------------------------------------------------------------
+
+// How a vertex may move
+enum class VertexKind : uint8_t
+{
+    Manifold, // Surrounded by triangles, can collapse onto any neighbour
+    Border,   // On an open edge, can only collapse along the edge
+    Locked,   // On a seam or a non-manifold edge, never moves
+};
+
+// Border planes are weighted above the surface planes so collapses that pull a border inwards are costly
+const double BORDER_WEIGHT = 10.0;
+
+// Collapses are rejected if they turn any triangle by more than about 75 degrees (cosine of the angle). Turning
+// further than that is usually the first step towards a triangle folding over
+const float FLIP_COS_ANGLE = 0.25f;
+
+// Largest difference between the bone weights of two vertices that can collapse together, as the sum of the
+// absolute differences of each bone's weight (0 = identical, 2 = no bones in common)
+const float MAX_WEIGHT_DIFFERENCE = 0.25f;
+
+
+// Return the byte offset of an element in a sub-mesh's vertices, or -1 if it has no such element. Throws a
+// std::runtime_error exception if the element is not in the expected format
+static int ElementOffset(const SubMeshData& subMesh, VertexSemantic semantic, VertexFormat format)
+{
+    for (auto& element : subMesh.layout)
+    {
+        if (element.semantic == semantic)
+        {
+            if (element.format != format)  throw std::runtime_error("Mesh simplification needs full precision vertices");
+            return static_cast<int>(element.offset);
+        }
+    }
+    return -1;
+}
+
+
+std::vector<SimplifiedIndices> SimplifySubMesh(const SubMeshData& subMesh, const std::vector<uint32_t>& targetIndexCounts)
+{
+    const uint32_t numVertices = subMesh.numVertices;
+    int positionOffset = ElementOffset(subMesh, VertexSemantic::Position, VertexFormat::Float3);
+    int bonesOffset    = ElementOffset(subMesh, VertexSemantic::Bones,    VertexFormat::UByte4);
+    int weightsOffset  = ElementOffset(subMesh, VertexSemantic::Weights,  VertexFormat::Float4);
+    if (positionOffset < 0)  throw std::runtime_error("Mesh simplification needs vertex positions");
+    bool hasWeights = (bonesOffset >= 0 && weightsOffset >= 0);
+
+    std::vector<CVector3> positions(numVertices);
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        positions[v] = CVector3(reinterpret_cast<const float*>(subMesh.vertices + static_cast<size_t>(v) * subMesh.vertexSize + positionOffset));
+    }
+
+    // Sum of the absolute differences of each bone's weight in two vertices
+    auto weightDifference = [&](uint32_t v1, uint32_t v2)
+    {
+        const unsigned char* vertex1 = subMesh.vertices + static_cast<size_t>(v1) * subMesh.vertexSize;
+        const unsigned char* vertex2 = subMesh.vertices + static_cast<size_t>(v2) * subMesh.vertexSize;
+        const uint8_t* bones1 = vertex1 + bonesOffset;
+        const uint8_t* bones2 = vertex2 + bonesOffset;
+        const float* weights1 = reinterpret_cast<const float*>(vertex1 + weightsOffset);
+        const float* weights2 = reinterpret_cast<const float*>(vertex2 + weightsOffset);
+        float difference = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            // Each bone used by the first vertex against the weight of the same bone in the second
+            if (weights1[i] > 0)
+            {
+                float other = 0;
+                for (int j = 0; j < 4; ++j)  if (bones2[j] == bones1[i] && weights2[j] > 0)  other += weights2[j];
+                difference += std::abs(weights1[i] - other);
+            }
+
+            // Bones used by the second vertex but not the first
+            if (weights2[i] > 0)
+            {
+                bool shared = false;
+                for (int j = 0; j < 4; ++j)  if (bones1[j] == bones2[i] && weights1[j] > 0)  shared = true;
+                if (!shared)  difference += weights2[i];
+            }
+        }
+        return difference;
+    };
+
+    // Work with 32-bit indices throughout
+    std::vector<uint32_t> indices(subMesh.numIndices);
+    if (subMesh.indexFormat == IndexFormat::UInt16)
+    {
+        const uint16_t* indices16 = static_cast<const uint16_t*>(subMesh.indices);
+        std::copy(indices16, indices16 + subMesh.numIndices, indices.begin());
+    }
+    else
+    {
+        std::memcpy(indices.data(), subMesh.indices, subMesh.numIndices * sizeof(uint32_t));
+    }
+
+
+    //-----------------------------------
+
+    // Weld vertices at the same position - vertices split on UV or normal seams become one welded vertex with
+    // several "wedges". Topology and quadrics use the welded vertices
+    std::vector<uint32_t> weld(numVertices);
+    std::vector<uint32_t> numWedges(numVertices, 0);
+    {
+        std::vector<uint32_t> order(numVertices);
+        for (uint32_t v = 0; v < numVertices; ++v)  order[v] = v;
+        auto less = [&](uint32_t a, uint32_t b)
+        {
+            const CVector3& p = positions[a];
+            const CVector3& q = positions[b];
+            return (p.x != q.x) ? p.x < q.x : (p.y != q.y) ? p.y < q.y : (p.z != q.z) ? p.z < q.z : a < b;
+        };
+        std::sort(order.begin(), order.end(), less);
+        for (uint32_t i = 0; i < numVertices; )
+        {
+            uint32_t end = i + 1;
+            const CVector3& p = positions[order[i]];
+            while (end < numVertices && positions[order[end]].x == p.x && positions[order[end]].y == p.y && positions[order[end]].z == p.z)  ++end;
+            for (uint32_t j = i; j < end; ++j)  weld[order[j]] = order[i]; // Lowest index in the group, as the sort puts it first
+            numWedges[order[i]] = end - i;
+            i = end;
+        }
+    }
+
+    // Directed edges from each welded vertex, stored contiguously for each vertex
+    std::vector<uint32_t> edgeStart(numVertices + 1, 0);
+    std::vector<uint32_t> edges(indices.size());
+    for (size_t i = 0; i < indices.size(); ++i)  ++edgeStart[weld[indices[i]] + 1];
+    for (uint32_t v = 0; v < numVertices; ++v)  edgeStart[v + 1] += edgeStart[v];
+    {
+        std::vector<uint32_t> fill(edgeStart.begin(), edgeStart.end() - 1);
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                uint32_t from = weld[indices[t + c]];
+                uint32_t to   = weld[indices[t + (c + 1) % 3]];
+                edges[fill[from]++] = to;
+            }
+        }
+    }
+    auto countEdges = [&](uint32_t from, uint32_t to)
+    {
+        return static_cast<int>(std::count(edges.begin() + edgeStart[from], edges.begin() + edgeStart[from + 1], to));
+    };
+
+    // Classify each welded vertex. An edge with no matching edge in the opposite direction is an open border, an
+    // edge used more than once in the same direction is non-manifold
+    std::vector<VertexKind> kinds(numVertices, VertexKind::Manifold);
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        if (weld[v] == v && numWedges[v] > 1)  kinds[v] = VertexKind::Locked;
+    }
+    for (uint32_t from = 0; from < numVertices; ++from)
+    {
+        for (uint32_t e = edgeStart[from]; e < edgeStart[from + 1]; ++e)
+        {
+            uint32_t to = edges[e];
+            if (countEdges(from, to) > 1)
+            {
+                kinds[from] = kinds[to] = VertexKind::Locked;
+            }
+            else if (countEdges(to, from) == 0)
+            {
+                if (kinds[from] == VertexKind::Manifold)  kinds[from] = VertexKind::Border;
+                if (kinds[to]   == VertexKind::Manifold)  kinds[to]   = VertexKind::Border;
+            }
+        }
+    }
+
+    // Quadric for each welded vertex from the planes of the triangles around it, plus planes at right angles to
+    // the triangles along open borders
+    std::vector<Quadric> quadrics(numVertices, Quadric{});
+    for (size_t t = 0; t < indices.size(); t += 3)
+    {
+        uint32_t v[3] = { weld[indices[t]], weld[indices[t + 1]], weld[indices[t + 2]] };
+        CVector3 normal = Cross(positions[v[1]] - positions[v[0]], positions[v[2]] - positions[v[0]]);
+        float length = Length(normal);
+        if (length == 0)  continue;
+        normal = normal * (1.0f / length);
+        float offset = -Dot(normal, positions[v[0]]);
+        for (int c = 0; c < 3; ++c)  AddPlane(quadrics[v[c]], normal, offset, 1.0);
+
+        for (int c = 0; c < 3; ++c)
+        {
+            uint32_t from = v[c], to = v[(c + 1) % 3];
+            if (countEdges(to, from) != 0)  continue;
+            CVector3 edgeNormal = Cross(positions[to] - positions[from], normal);
+            float edgeLength = Length(edgeNormal);
+            if (edgeLength == 0)  continue;
+            edgeNormal = edgeNormal * (1.0f / edgeLength);
+            float edgeOffset = -Dot(edgeNormal, positions[from]);
+            AddPlane(quadrics[from], edgeNormal, edgeOffset, BORDER_WEIGHT);
+            AddPlane(quadrics[to],   edgeNormal, edgeOffset, BORDER_WEIGHT);
+        }
+    }
+
+
+    //-----------------------------------
+
+    // Collapse edges in passes until each target is reached. In each pass the cheapest collapses are made first,
+    // and each collapse freezes the triangles around it for the rest of the pass so later collapses in the same
+    // pass never see out of date triangles
+    std::vector<SimplifiedIndices> results;
+    float maxError = 0; // Squared
+    size_t nextTarget = 0;
+    auto addResults = [&]()
+    {
+        while (nextTarget < targetIndexCounts.size() && indices.size() <= targetIndexCounts[nextTarget])
+        {
+            results.push_back({ indices, std::sqrt(maxError) });
+            ++nextTarget;
+        }
+    };
+    addResults();
+
+    struct Collapse
+    {
+        uint32_t from, to;
+        float    cost;
+    };
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> triangleStart(numVertices + 1);
+    std::vector<uint32_t> vertexTriangles;
+    std::vector<uint8_t>  frozen(numVertices);
+
+    while (nextTarget < targetIndexCounts.size())
+    {
+        // Triangles around each (unwelded) vertex
+        std::fill(triangleStart.begin(), triangleStart.end(), 0);
+        for (uint32_t index : indices)  ++triangleStart[index + 1];
+        for (uint32_t v = 0; v < numVertices; ++v)  triangleStart[v + 1] += triangleStart[v];
+        vertexTriangles.resize(indices.size());
+        {
+            std::vector<uint32_t> fill(triangleStart.begin(), triangleStart.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)  vertexTriangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+
+        // Number of current triangles using both vertices - 1 for an open edge
+        auto sharedTriangles = [&](uint32_t v1, uint32_t v2)
+        {
+            int count = 0;
+            for (uint32_t i = triangleStart[v1]; i < triangleStart[v1 + 1]; ++i)
+            {
+                const uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+                if (triangle[0] == v2 || triangle[1] == v2 || triangle[2] == v2)  ++count;
+            }
+            return count;
+        };
+
+        // Cost of every allowed collapse. Only vertices that are not split can move, so a collapse is a simple
+        // replacement of one vertex index with another
+        collapses.clear();
+        auto addCollapse = [&](uint32_t from, uint32_t to)
+        {
+            if (from == to)  return;
+            VertexKind kind = kinds[weld[from]];
+            if (kind == VertexKind::Locked)  return;
+            if (kind == VertexKind::Border && (kinds[weld[to]] == VertexKind::Manifold || sharedTriangles(from, to) != 1))  return;
+            if (hasWeights && weightDifference(from, to) > MAX_WEIGHT_DIFFERENCE)  return;
+
+            collapses.push_back({ from, to, QuadricError(quadrics[weld[from]] + quadrics[weld[to]], positions[to]) });
+        };
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                uint32_t v1 = indices[t + c], v2 = indices[t + (c + 1) % 3];
+                addCollapse(v1, v2);
+                addCollapse(v2, v1);
+            }
+        }
+        std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+        // Make the collapses, cheapest first, until enough triangles have gone for the current target
+        size_t numTriangles = indices.size() / 3;
+        size_t targetTriangles = targetIndexCounts[nextTarget] / 3;
+        std::fill(frozen.begin(), frozen.end(), 0);
+        size_t numCollapses = 0;
+        for (const Collapse& collapse : collapses)
+        {
+            if (numTriangles <= targetTriangles)  break;
+            uint32_t from = collapse.from, to = collapse.to;
+            if (frozen[from] || frozen[to])  continue;
+
+            // Reject the collapse if any remaining triangle around the moving vertex would turn too far (or flip over)
+            bool flips = false;
+            size_t removed = 0;
+            for (uint32_t i = triangleStart[from]; i < triangleStart[from + 1] && !flips; ++i)
+            {
+                const uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+                if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+                {
+                    ++removed;
+                    continue;
+                }
+                CVector3 p[3], moved[3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    p[c] = positions[triangle[c]];
+                    moved[c] = (triangle[c] == from) ? positions[to] : p[c];
+                }
+                CVector3 normal      = Cross(p[1] - p[0], p[2] - p[0]);
+                CVector3 movedNormal = Cross(moved[1] - moved[0], moved[2] - moved[0]);
+                flips = Dot(normal, movedNormal) <= FLIP_COS_ANGLE * Length(normal) * Length(movedNormal);
+            }
+            if (flips)  continue;
+
+            // Replace the vertex in its triangles now, they are frozen for the rest of the pass so nothing else
+            // reads them. The quadric of the kept vertex takes on the error of the removed one
+            for (uint32_t i = triangleStart[from]; i < triangleStart[from + 1]; ++i)
+            {
+                uint32_t* triangle = &indices[vertexTriangles[i] * 3];
+                for (int c = 0; c < 3; ++c)
+                {
+                    frozen[triangle[c]] = 1;
+                    if (triangle[c] == from)  triangle[c] = to;
+                }
+            }
+            quadrics[weld[to]] = quadrics[weld[to]] + quadrics[weld[from]];
+            maxError = std::max(maxError, collapse.cost);
+            numTriangles -= removed;
+            ++numCollapses;
+        }
+
+        // Remove the triangles that collapsed to lines
+        size_t kept = 0;
+        for (size_t t = 0; t < indices.size(); t += 3)
+        {
+            uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+            if (a == b || b == c || c == a)  continue;
+            indices[kept++] = a;  indices[kept++] = b;  indices[kept++] = c;
+        }
+        indices.resize(kept);
+
+        if (numCollapses == 0)
+        {
+            // Nothing more can collapse, the remaining LODs are all the same as the current one
+            while (nextTarget < targetIndexCounts.size())
+            {
+                results.push_back({ indices, std::sqrt(maxError) });
+                ++nextTarget;
+            }
+        }
+        addResults();
+    }
+    return results;
+}
+
+
+void GenerateLODs(MeshData& mesh, uint32_t numLODs)
+{
+    numLODs = std::min(numLODs, MAX_MESH_LODS);
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        subMesh.lods.clear();
+        if (numLODs == 0)  continue;
+
+        std::vector<uint32_t> targets;
+        uint32_t numTriangles = subMesh.numIndices / 3;
+        for (uint32_t lod = 0; lod < numLODs; ++lod)
+        {
+            numTriangles = std::max(numTriangles / 2, 1u);
+            targets.push_back(numTriangles * 3);
+        }
+        std::vector<SimplifiedIndices> simplified = SimplifySubMesh(subMesh, targets);
+
+        // Store each LOD's indices in the sub-mesh's index format. A LOD the same as the one before (simplification
+        // stopped early) shares its indices
+        uint32_t indexSize = IndexFormatSize(subMesh.indexFormat);
+        for (size_t lod = 0; lod < simplified.size(); ++lod)
+        {
+            const std::vector<uint32_t>& lodIndices = simplified[lod].indices;
+            SubMeshLOD subMeshLOD;
+            subMeshLOD.numIndices = static_cast<uint32_t>(lodIndices.size());
+            subMeshLOD.error = simplified[lod].error;
+            if (lod > 0 && lodIndices == simplified[lod - 1].indices)
+            {
+                subMeshLOD.indices = subMesh.lods.back().indices;
+            }
+            else
+            {
+                auto buffer = std::make_unique<unsigned char[]>(lodIndices.size() * indexSize);
+                if (subMesh.indexFormat == IndexFormat::UInt16)
+                {
+                    uint16_t* indices16 = reinterpret_cast<uint16_t*>(buffer.get());
+                    for (size_t i = 0; i < lodIndices.size(); ++i)  indices16[i] = static_cast<uint16_t>(lodIndices[i]);
+                }
+                else
+                {
+                    std::memcpy(buffer.get(), lodIndices.data(), lodIndices.size() * sizeof(uint32_t));
+                }
+                subMeshLOD.indices = buffer.get();
+                mesh.buffers.push_back(std::move(buffer));
+            }
+            subMesh.lods.push_back(subMeshLOD);
+        }
+    }
+}
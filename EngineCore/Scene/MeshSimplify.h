@@ -0,0 +1,48 @@
+//--------------------------------------------------------------------------------------
+// Mesh simplification - generating levels of detail (LODs) with quadric error edge collapse
+//--------------------------------------------------------------------------------------
+// Distant models cover few pixels, so drawing all their triangles wastes vertex work and gives tiny triangles
+// that shade inefficiently. Each sub-mesh can be given a chain of simplified LODs, each with about half the
+// triangles of the one before. LODs only have new indices - they reuse the sub-mesh's vertices, so they cost
+// little memory and switching LOD doesn't change any buffers.
+//
+// Simplification repeatedly collapses an edge by moving one of its vertices onto the other, picking the cheapest
+// collapses first. The cost is the quadric error: the sum of squared distances from the new position to the planes
+// of the original triangles around both vertices, so collapses on flat areas are nearly free and those changing
+// the silhouette are expensive. To keep the mesh looking right:
+//     - Seams (vertices split because their UVs or normals differ either side) never move, so textures and
+//       hard edges stay intact. Other vertices can collapse onto them
+//     - Open borders only collapse along the border
+//     - Vertices only collapse onto vertices with similar bone weights, so skinning deforms the LOD in the same way
+//     - Collapses that would flip a triangle over are rejected
+// The error recorded for each LOD is the square root of the largest collapse cost, an estimate of the furthest
+// any part of the surface has moved. Models use it to pick a LOD that is within a pixel or so of the original.
+
+#ifndef _MESH_SIMPLIFY_H_INCLUDED_
+#define _MESH_SIMPLIFY_H_INCLUDED_
+
+#include "MeshData.h"
+
+#include <cstdint>
+#include <vector>
+
+
+// One simplified LOD of a sub-mesh
+struct SimplifiedIndices
+{
+    std::vector<uint32_t> indices;
+    float                 error = 0; // See SubMeshLOD
+};
+
+
+// Simplify a sub-mesh's triangles to each of the given index counts in turn (largest first), returning one LOD for
+// each. A LOD stops early if no more edges can collapse, any further LODs are then the same. Positions must be Float3
+// and, if present, bones UByte4 and weights Float4 - i.e. call before packing vertices (see VertexPacking.h)
+std::vector<SimplifiedIndices> SimplifySubMesh(const SubMeshData& subMesh, const std::vector<uint32_t>& targetIndexCounts);
+
+// Add numLODs simplified LODs (up to MAX_MESH_LODS) to every sub-mesh in the mesh data, each targeting half the
+// triangles of the one before. The new index buffers are added to the mesh's buffers. Call before packing vertices
+void GenerateLODs(MeshData& mesh, uint32_t numLODs);
+
+
+#endif //_MESH_SIMPLIFY_H_INCLUDED_
@@ -0,0 +1,59 @@
+//--------------------------------------------------------------------------------------
+// Tangent calculation for meshes that were imported without tangents
+//--------------------------------------------------------------------------------------
+
+#include "MeshTangents.h"
+
+#include <cmath>
+
+
+// Calculate a unit tangent for each vertex of an indexed triangle list. The tangent points along the direction
+// of increasing u, averaged over the triangles using the vertex (larger triangles contribute more), and is made
+// perpendicular to the vertex normal. Vertices whose triangles have no usable texture mapping get any tangent
+// perpendicular to the normal. Indices must be less than numVertices, tangents must have room for numVertices
+void CalculateTangents(const CVector3* positions, const CVector3* normals, const CVector2* uvs, uint32_t numVertices,
+                       const uint32_t* indices, uint32_t numIndices, CVector3* tangents)
+{
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        tangents[v] = { 0, 0, 0 };
+    }
+
+    // Each triangle's edges are a combination of the tangent and bitangent given by the change in uv along them:
+    //     edge1 = du1 * T + dv1 * B,  edge2 = du2 * T + dv2 * B
+    // Solving for T and leaving out the 1/determinant scale keeps the weighting by triangle area (the determinant
+    // is the area in uv space, and only its sign matters for the direction)
+    const uint32_t* indicesEnd = indices + numIndices - numIndices % 3;
+    for (const uint32_t* index = indices; index != indicesEnd; index += 3)
+    {
+        uint32_t i0 = index[0], i1 = index[1], i2 = index[2];
+        CVector3 edge1 = positions[i1] - positions[i0];
+        CVector3 edge2 = positions[i2] - positions[i0];
+        CVector2 uvEdge1 = uvs[i1] - uvs[i0];
+        CVector2 uvEdge2 = uvs[i2] - uvs[i0];
+
+        float determinant = uvEdge1.x * uvEdge2.y - uvEdge2.x * uvEdge1.y;
+        if (determinant == 0)  continue; // Texture is not mapped across this triangle
+
+        CVector3 tangent = edge1 * uvEdge2.y - edge2 * uvEdge1.y;
+        if (determinant < 0)  tangent *= -1.0f;
+
+        tangents[i0] += tangent;
+        tangents[i1] += tangent;
+        tangents[i2] += tangent;
+    }
+
+    // Remove the part of each tangent along the normal (Gram-Schmidt) and normalise
+    for (uint32_t v = 0; v < numVertices; ++v)
+    {
+        const CVector3& normal = normals[v];
+        CVector3 tangent = Normalise(tangents[v] - Dot(tangents[v], normal) * normal);
+        if (Dot(tangent, tangent) == 0)
+        {
+            // No usable tangent - use the axis least aligned with the normal to build one
+            CVector3 axis = (std::abs(normal.x) < 0.9f) ? CVector3{ 1, 0, 0 } : CVector3{ 0, 1, 0 };
+            tangent = Normalise(axis - Dot(axis, normal) * normal);
+        }
+        tangents[v] = tangent;
+    }
+}
@@ -0,0 +1,25 @@
+//--------------------------------------------------------------------------------------
+// Tangent calculation for meshes that were imported without tangents
+//--------------------------------------------------------------------------------------
+// Normal and parallax mapping need a tangent in each vertex. Rather than importing a mesh file again with tangent
+// calculation switched on, the tangents can be added to geometry that has already been imported (see MeshLibrary
+// in the Assignment project, which shares one import between the variants of a mesh with and without tangents).
+
+#ifndef _MESH_TANGENTS_H_INCLUDED_
+#define _MESH_TANGENTS_H_INCLUDED_
+
+#include "CVector2.h"
+#include "CVector3.h"
+
+#include <cstdint>
+
+
+// Calculate a unit tangent for each vertex of an indexed triangle list. The tangent points along the direction
+// of increasing u, averaged over the triangles using the vertex (larger triangles contribute more), and is made
+// perpendicular to the vertex normal. Vertices whose triangles have no usable texture mapping get any tangent
+// perpendicular to the normal. Indices must be less than numVertices, tangents must have room for numVertices
+void CalculateTangents(const CVector3* positions, const CVector3* normals, const CVector2* uvs, uint32_t numVertices,
+                       const uint32_t* indices, uint32_t numIndices, CVector3* tangents);
+
+
+#endif //_MESH_TANGENTS_H_INCLUDED_
@@ -0,0 +1,168 @@
+//--------------------------------------------------------------------------------------
+// Class encapsulating a model
+//--------------------------------------------------------------------------------------
+// Holds a pointer to a mesh as well as position, rotation and scaling, which are converted to a world matrix when required
+// This is more of a convenience class, the mesh does most of the difficult work.
+
+#include "Model.h"
+
+#include <algorithm>
+
+
+// A coarser LOD is only chosen when its projected error is below this fraction of the allowed error, so a model
+// at the switching distance doesn't keep changing LOD as the camera moves slightly
+const float LOD_HYSTERESIS = 0.8f;
+
+// Counters for all models, see GetLODCounters
+static LODCounters gLODCounters;
+
+
+Model::Model(IMesh* mesh, CVector3 position /*= { 0,0,0 }*/, CVector3 rotation /*= { 0,0,0 }*/, float scale /*= 1*/)
+    : mMesh(mesh)
+{
+    // Set default transforms from mesh
+    mTransforms.resize(mesh->NumberNodes());
+    mWorldMatrices.resize(mesh->NumberNodes());
+    for (unsigned int i = 0; i < mTransforms.size(); ++i)
+        mTransforms[i] = CTransform(mesh->GetNodeDefaultMatrix(i));
+}
+
+
+
+// The render function simply passes this model's matrices over to the mesh's Render function.
+// All other per-frame constants must have been set already along with shaders, textures, samplers, states etc.
+void Model::Render()
+{
+    // Build the matrices from the transforms - only done here, once per render
+    for (unsigned int i = 0; i < mTransforms.size(); ++i)
+        mWorldMatrices[i] = mTransforms[i].GetAffineMatrix();
+
+    mMesh->Render(mWorldMatrices, mLOD);
+
+    gLODCounters.trianglesDrawn += mMesh->NumberTriangles(mLOD);
+    gLODCounters.trianglesSaved += mMesh->NumberTriangles(0) - mMesh->NumberTriangles(mLOD);
+    ++gLODCounters.modelsAtLOD[std::min(mLOD, MAX_MESH_LODS)];
+}
+
+
+// Choose the LOD from the model's size on screen
+unsigned int Model::SelectLOD(CVector3 cameraPosition, float pixelsPerUnit, float maxPixelError /*= 1*/)
+{
+    unsigned int numLODs = mMesh->NumberLODs();
+    if (numLODs == 0)  return mLOD;
+
+    // Mesh units to pixels at the nearest point of the bounding sphere, full detail if the camera is inside it.
+    // LOD errors are in mesh units so are scaled by the model's largest scale
+    CBounds bounds = WorldBounds();
+    float distance = Length(cameraPosition - bounds.centre) - bounds.radius;
+    unsigned int lod = 0;
+    if (!bounds.IsEmpty() && distance > 0)
+    {
+        CVector3 scale = mTransforms[0].scale;
+        float pixelsPerMeshUnit = std::max(scale.x, std::max(scale.y, scale.z)) * pixelsPerUnit / distance;
+
+        // Errors increase with each LOD, find the coarsest within the limit. Only move to a coarser LOD than the
+        // current one if it is also within the hysteresis limit
+        auto coarsestWithin = [&](float pixelError)
+        {
+            unsigned int coarsest = 0;
+            while (coarsest < numLODs && mMesh->GetLODError(coarsest + 1) * pixelsPerMeshUnit <= pixelError)  ++coarsest;
+            return coarsest;
+        };
+        lod = coarsestWithin(maxPixelError);
+        if (lod > mLOD)  lod = std::max(mLOD, coarsestWithin(maxPixelError * LOD_HYSTERESIS));
+    }
+
+    if (lod != mLOD)  ++gLODCounters.lodChanges;
+    mLOD = lod;
+    return mLOD;
+}
+
+
+// Level of detail counters for all models
+LODCounters GetLODCounters()
+{
+    return gLODCounters;
+}
+
+void ResetLODCounters()
+{
+    gLODCounters = LODCounters();
+}
+
+
+// World space bounds of the geometry a node moves, using the model's current transforms
+CBounds Model::NodeWorldBounds(int node)
+{
+    CalculateAbsoluteMatrices();
+    return TransformBounds(mMesh->GetNodeBounds(node), mWorldMatrices[node]);
+}
+
+// World space bounds of the whole model in its current pose
+CBounds Model::WorldBounds()
+{
+    CalculateAbsoluteMatrices();
+    CBounds bounds;
+    for (unsigned int i = 0; i < mTransforms.size(); ++i)
+        bounds = MergeBounds(bounds, TransformBounds(mMesh->GetNodeBounds(i), mWorldMatrices[i]));
+    return bounds;
+}
+
+
+// Control a given node in the model using keys provided. Amount of motion performed depends on frame time
+void Model::Control(int node, float frameTime, KeyCode turnUp, KeyCode turnDown, KeyCode turnLeft, KeyCode turnRight,
+                                               KeyCode turnCW, KeyCode turnCCW, KeyCode moveForward, KeyCode moveBackward,
+                                               float rotationSpeed, float movementSpeed)
+{
+    auto& transform = mTransforms[node]; // Use reference to node transform to make code below more readable
+
+	// Rotations are around the node's local axes, combined as quaternions so no matrices are built
+	if (KeyHeld( turnUp ))
+	{
+		transform.RotateLocal(QuaternionRotationX(rotationSpeed * frameTime));
+	}
+	if (KeyHeld( turnDown ))
+	{
+		transform.RotateLocal(QuaternionRotationX(-rotationSpeed * frameTime));
+	}
+	if (KeyHeld( turnRight ))
+	{
+		transform.RotateLocal(QuaternionRotationY(rotationSpeed * frameTime));
+	}
+	if (KeyHeld( turnLeft ))
+	{
+		transform.RotateLocal(QuaternionRotationY(-rotationSpeed * frameTime));
+	}
+	if (KeyHeld( turnCW ))
+	{
+		transform.RotateLocal(QuaternionRotationZ(rotationSpeed * frameTime));
+	}
+	if (KeyHeld( turnCCW ))
+	{
+		transform.RotateLocal(QuaternionRotationZ(-rotationSpeed * frameTime));
+	}
+
+	// Renormalise the rotation to stop rounding errors building up over many frames
+	transform.rotation = Normalise(transform.rotation);
+
+	// Local Z movement - move in the direction of the Z axis, get axis from rotation (already normalised)
+    CVector3 localZDir = transform.GetZAxis();
+	if (KeyHeld( moveForward ))
+	{
+		transform.position += localZDir * movementSpeed * frameTime;
+	}
+	if (KeyHeld( moveBackward ))
+	{
+		transform.position -= localZDir * movementSpeed * frameTime;
+	}
+}
+
+
+// Fill mWorldMatrices with each node's absolute world matrix. Parents come before children in the hierarchy
+// so each parent's absolute matrix is ready when its children need it
+void Model::CalculateAbsoluteMatrices()
+{
+    mWorldMatrices[0] = mTransforms[0].GetAffineMatrix();
+    for (unsigned int i = 1; i < mTransforms.size(); ++i)
+        mWorldMatrices[i] = mTransforms[i].GetAffineMatrix() * mWorldMatrices[mMesh->GetNodeParent(i)];
+}
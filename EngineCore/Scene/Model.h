@@ -0,0 +1,131 @@
+//--------------------------------------------------------------------------------------
+// Class encapsulating a model
+//--------------------------------------------------------------------------------------
+// Holds a pointer to a mesh as well as position, rotation and scaling, which are converted to a world matrix when required
+// This is more of a convenience class, the mesh does most of the difficult work. Models use meshes through the
+// IMesh interface so this class has no graphics API code.
+
+#include "IMesh.h"
+#include "MeshData.h"
+#include "CVector3.h"
+#include "CMatrix4x4.h"
+#include "CTransform.h"
+#include "Input.h"
+
+#include <algorithm>
+#include <vector>
+
+#ifndef _MODEL_H_INCLUDED_
+#define _MODEL_H_INCLUDED_
+
+class Model
+{
+public:
+	//-------------------------------------
+	// Construction / Usage
+	//-------------------------------------
+
+    Model(IMesh* mesh, CVector3 position = { 0,0,0 }, CVector3 rotation = { 0,0,0 }, float scale = 1);
+
+
+    // The render function simply passes this model's matrices over to the mesh's Render function.
+    // All other per-frame constants must have been set already along with shaders, textures, samplers, states etc.
+    void Render();
+
+
+	// Control a given node in the model using keys provided. Amount of motion performed depends on frame time
+	// and the speeds given (radians per second and units per second)
+	void Control(int node, float frameTime, KeyCode turnUp, KeyCode turnDown, KeyCode turnLeft, KeyCode turnRight,  
+				                            KeyCode turnCW, KeyCode turnCCW, KeyCode moveForward, KeyCode moveBackward,
+				                            float rotationSpeed, float movementSpeed );
+
+
+	//-------------------------------------
+	// Data access
+	//-------------------------------------
+
+    //********************************
+    // All functions now accept a "node" parameter which specifies which node in the hierarchy to use. Defaults to 0, the root.
+    // The hierarchy is stored in depth-first order
+
+	// Getters - model stores a transform (position, rotation, scale) for each node, matrices are built from those when needed
+	CVector3 Position(int node = 0)  { return mTransforms[node].position; }
+	CVector3 Rotation(int node = 0)  { return GetEulerAngles(mTransforms[node].rotation); } // Rotation is stored as a quaternion, convert to Euler angles
+	CVector3 Scale(int node = 0)     { return mTransforms[node].scale; }
+	CMatrix4x4 WorldMatrix(int node = 0)  { return mTransforms[node].GetMatrix(); }
+	CTransform Transform(int node = 0)    { return mTransforms[node]; }
+
+    // Setters - each only updates one part of the transform, the others are unaffected
+	void SetPosition(CVector3 position, int node = 0)  { mTransforms[node].position = position; }
+	void SetRotation(CVector3 rotation, int node = 0)  { mTransforms[node].rotation = QuaternionFromEulerAngles(rotation); }
+
+	// Two ways to set scale: x,y,z separately, or all to the same value
+	void SetScale(CVector3 scale, int node = 0)  { mTransforms[node].scale = scale; }
+	void SetScale(float scale)  { SetScale({ scale, scale, scale });}
+
+    // The matrix is split into position, rotation and scale so it must not contain shear
+    void SetWorldMatrix(CMatrix4x4 matrix, int node = 0)  { mTransforms[node] = CTransform(matrix); }
+    void SetTransform(const CTransform& transform, int node = 0)  { mTransforms[node] = transform; }
+
+
+    // World space bounds of the geometry a node moves, using the model's current transforms. Empty if it moves none
+    CBounds NodeWorldBounds(int node);
+
+    // World space bounds of the whole model in its current pose, the union of all the node world bounds
+    CBounds WorldBounds();
+
+
+    // Level of detail used by Render, see IMesh. Starts at 0 (full detail)
+    unsigned int LOD()  { return mLOD; }
+    void SetLOD(unsigned int lod)  { mLOD = std::min(lod, mMesh->NumberLODs()); }
+
+    // Choose the LOD from the model's size on screen: the coarsest LOD whose error, projected to the nearest point of
+    // the model's bounding sphere, is no more than maxPixelError pixels. pixelsPerUnit is the size in pixels of one
+    // unit at distance 1 from the camera, i.e. viewport width / (2 * tan(horizontal FOV / 2)). To stop models
+    // flickering between LODs when near a switching distance, a coarser LOD is only chosen once its error is well
+    // under the limit (LOD_HYSTERESIS). Returns the LOD chosen
+    unsigned int SelectLOD(CVector3 cameraPosition, float pixelsPerUnit, float maxPixelError = 1);
+
+
+	//-------------------------------------
+	// Private data / members
+	//-------------------------------------
+private:
+    IMesh* mMesh;
+
+    unsigned int mLOD = 0;
+
+	// Transforms for the model
+    // Now that meshes have multiple parts, we need multiple transforms. The root transform (the first one) is the world transform
+    // for the entire model. The remaining transforms are relative to their parent part. The hierarchy is defined in the mesh (nodes)
+	std::vector<CTransform> mTransforms;
+
+    // Matrices built from the transforms above when rendering. Kept between frames to avoid reallocating
+    // World matrices are always affine so the smaller 3x4 matrix type is used
+    // Also used to hold absolute world matrices when calculating bounds
+	std::vector<CAffine3x4> mWorldMatrices;
+
+
+	//-------------------------------------
+	// Private helper functions
+	//-------------------------------------
+
+    // Fill mWorldMatrices with each node's absolute world matrix (rather than relative to its parent)
+    void CalculateAbsoluteMatrices();
+};
+
+
+// Level of detail counters for all models, accumulated from when they were last reset. Reset each frame to get
+// per-frame figures
+struct LODCounters
+{
+    uint64_t     trianglesDrawn = 0;
+    uint64_t     trianglesSaved = 0; // Compared to drawing every model at full detail
+    unsigned int lodChanges = 0;     // Times SelectLOD changed a model's LOD
+    unsigned int modelsAtLOD[MAX_MESH_LODS + 1] = {}; // Models rendered at each LOD
+};
+LODCounters GetLODCounters();
+void ResetLODCounters();
+
+
+#endif //_MODEL_H_INCLUDED_
@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------------------
+// Vertex elements - what each part of a vertex holds and in what format
+//--------------------------------------------------------------------------------------
+// Device-independent, the renderer maps semantics and formats to its own (e.g. HLSL semantics and DXGI formats).
+// Kept apart from MeshData.h so projects with their own maths classes can describe vertex layouts (see
+// VertexLayout.h) without pulling in the mesh data.
+
+#ifndef _VERTEX_ELEMENT_H_INCLUDED_
+#define _VERTEX_ELEMENT_H_INCLUDED_
+
+#include <cstdint>
+
+
+// What a vertex element holds. The renderer maps these to its own names (e.g. HLSL semantics)
+enum class VertexSemantic : uint32_t
+{
+    Position,
+    Normal,
+    Tangent,
+    UV,
+    Bones,
+    Weights,
+    Colour,
+};
+
+// Data type of a vertex element
+enum class VertexFormat : uint32_t
+{
+    Float2,
+    Float3,
+    Float4,
+    UByte4, // Four unsigned bytes, read as integers (bone indexes)
+
+    // Compact formats, see VertexPacking.h
+    UShort4Norm, // Four 16-bit unsigned values, read as 0 to 1 (positions, w unused)
+    Short2Norm,  // Two 16-bit signed values, read as -1 to 1 (octahedral normals and tangents)
+    Half2,       // Two 16-bit floats (UVs)
+    UByte4Norm,  // Four unsigned bytes, read as 0 to 1 (bone weights)
+};
+
+// Size in bytes of a vertex element with the given format
+constexpr uint32_t VertexFormatSize(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float2:      return 8;
+        case VertexFormat::Float3:      return 12;
+        case VertexFormat::Float4:      return 16;
+        case VertexFormat::UByte4:      return 4;
+        case VertexFormat::UShort4Norm: return 8;
+        case VertexFormat::Short2Norm:  return 4;
+        case VertexFormat::Half2:       return 4;
+        case VertexFormat::UByte4Norm:  return 4;
+    }
+    return 0;
+}
+
+
+// One element in a vertex, e.g. the normal is a Float3 at byte 12
+struct VertexElement
+{
+    VertexSemantic semantic;
+    VertexFormat   format;
+    uint32_t       offset; // Byte offset from the start of the vertex
+};
+
+
+#endif //_VERTEX_ELEMENT_H_INCLUDED_
@@ -0,0 +1,240 @@
+//--------------------------------------------------------------------------------------
+// Vertex layouts described at compile time
+//--------------------------------------------------------------------------------------
+// A vertex layout is declared once, as a list of attributes each giving a semantic, a format and the C++ type
+// holding it:
+//     using BasicVertexLayout = VertexLayout<VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>,
+//                                            VertexAttribute<VertexSemantic::Normal,   VertexFormat::Float3, CVector3>,
+//                                            VertexAttribute<VertexSemantic::UV,       VertexFormat::Float2, CVector2>>;
+//     using BasicVertex = BasicVertexLayout::Vertex;
+// Everything else is generated from that list by the compiler: the vertex structure, the byte offsets and stride,
+// the device-independent element array (the same description as MeshData.h uses, which the renderer converts to
+// its input layout, e.g. InputElementDescs in GraphicsHelpers.h), a key identifying the layout for caching input
+// layouts and shader signatures, and a routine to interleave separate arrays into vertices. Hand-written vertex
+// structures and element lists could drift apart, these can't.
+//
+// The attribute types can be anything trivially copyable of the format's size, so each project can use its own
+// maths classes. Compact formats (see VertexPacking.h) are held as already packed values.
+
+#ifndef _VERTEX_LAYOUT_H_INCLUDED_
+#define _VERTEX_LAYOUT_H_INCLUDED_
+
+#include "VertexElement.h"
+#include "Hash.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+
+// One attribute in a vertex layout: what it holds, the format the GPU reads and the C++ type holding it
+template <VertexSemantic S, VertexFormat F, class T>
+struct VertexAttribute
+{
+    static constexpr VertexSemantic semantic = S;
+    static constexpr VertexFormat   format   = F;
+    using Type = T;
+
+    static_assert(sizeof(T) == VertexFormatSize(F), "Vertex attribute type is not the size of its format");
+    static_assert(std::is_trivially_copyable<T>::value, "Vertex attribute type must be copyable as bytes");
+};
+
+
+// Return a key identifying a vertex layout, to cache input layouts and shader signatures by. Layouts generated by
+// VertexLayout have their key as a compile-time constant, which matches the key of the same layout built at run
+// time (e.g. a sub-mesh layout from MeshData.h)
+constexpr uint64_t VertexLayoutKey(const VertexElement* elements, size_t numElements, uint32_t vertexSize)
+{
+    uint64_t key = HashValue(numElements);
+    for (size_t i = 0; i < numElements; ++i)
+    {
+        key = HashValue(static_cast<uint32_t>(elements[i].semantic), key);
+        key = HashValue(static_cast<uint32_t>(elements[i].format),   key);
+        key = HashValue(elements[i].offset,                          key);
+    }
+    return HashValue(vertexSize, key);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Generated vertex structure
+//--------------------------------------------------------------------------------------
+
+// The attribute values one after another, each attribute then the storage for the rest. The last attribute has
+// its own specialisation, so there is no empty member to add padding. An aggregate, so vertices can be brace-
+// initialised with a flat list of attribute values as a hand-written structure can
+template <class... Attributes>
+struct VertexStorage;
+
+template <class A>
+struct VertexStorage<A>
+{
+    typename A::Type value;
+
+    // Access an attribute by semantic, e.g. vertex.Get<VertexSemantic::Normal>()
+    template <VertexSemantic S>
+    constexpr typename A::Type& Get()
+    {
+        static_assert(S == A::semantic, "Vertex layout has no attribute with this semantic");
+        return value;
+    }
+    template <VertexSemantic S>
+    constexpr const typename A::Type& Get() const
+    {
+        static_assert(S == A::semantic, "Vertex layout has no attribute with this semantic");
+        return value;
+    }
+};
+
+template <class A, class... Rest>
+struct VertexStorage<A, Rest...>
+{
+    typename A::Type        value;
+    VertexStorage<Rest...> rest;
+
+    template <VertexSemantic S>
+    constexpr auto& Get()        { return Select<S>(std::integral_constant<bool, S == A::semantic>()); }
+    template <VertexSemantic S>
+    constexpr auto& Get() const  { return Select<S>(std::integral_constant<bool, S == A::semantic>()); }
+
+    // Implementation of Get - this attribute or one of the rest
+    template <VertexSemantic S> constexpr auto& Select(std::true_type)         { return value; }
+    template <VertexSemantic S> constexpr auto& Select(std::false_type)        { return rest.template Get<S>(); }
+    template <VertexSemantic S> constexpr auto& Select(std::true_type)  const  { return value; }
+    template <VertexSemantic S> constexpr auto& Select(std::false_type) const  { return rest.template Get<S>(); }
+};
+
+
+// Byte offset of the attribute at the given index in a list of attributes
+template <class... Attributes>
+constexpr uint32_t VertexAttributeOffset(size_t index)
+{
+    const uint32_t sizes[] = { VertexFormatSize(Attributes::format)... };
+    uint32_t offset = 0;
+    for (size_t i = 0; i < index; ++i)  offset += sizes[i];
+    return offset;
+}
+
+// Index of the attribute with the given semantic in a list of attributes, or the number of attributes if none has it
+template <class... Attributes>
+constexpr size_t VertexAttributeIndex(VertexSemantic semantic)
+{
+    const VertexSemantic semantics[] = { Attributes::semantic... };
+    for (size_t i = 0; i < sizeof...(Attributes); ++i)
+    {
+        if (semantics[i] == semantic)  return i;
+    }
+    return sizeof...(Attributes);
+}
+
+// Element array for a list of attributes, the index sequence numbers the attributes
+template <class... Attributes, size_t... I>
+constexpr std::array<VertexElement, sizeof...(Attributes)> VertexLayoutElements(std::index_sequence<I...>)
+{
+    return {{ { Attributes::semantic, Attributes::format, VertexAttributeOffset<Attributes...>(I) }... }};
+}
+
+// True if no two attributes in the list have the same semantic
+template <class... Attributes>
+constexpr bool VertexSemanticsUnique()
+{
+    const VertexSemantic semantics[] = { Attributes::semantic... };
+    for (size_t i = 0; i < sizeof...(Attributes); ++i)
+    {
+        for (size_t j = i + 1; j < sizeof...(Attributes); ++j)
+        {
+            if (semantics[i] == semantics[j])  return false;
+        }
+    }
+    return true;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Vertex layout
+//--------------------------------------------------------------------------------------
+
+template <class... Attributes>
+struct VertexLayout
+{
+    static_assert(sizeof...(Attributes) > 0, "Vertex layout must have at least one attribute");
+    static_assert(VertexSemanticsUnique<Attributes...>(), "Vertex layout has two attributes with the same semantic");
+
+    static constexpr uint32_t NumElements = sizeof...(Attributes);
+    static constexpr uint32_t Stride      = VertexAttributeOffset<Attributes...>(sizeof...(Attributes)); // Size of a vertex
+
+    // Attributes in order with their byte offsets
+    static constexpr std::array<VertexElement, sizeof...(Attributes)> Elements =
+        VertexLayoutElements<Attributes...>(std::index_sequence_for<Attributes...>());
+
+    // Identifies the layout, see VertexLayoutKey
+    static constexpr uint64_t Key = VertexLayoutKey(&Elements[0], NumElements, Stride);
+
+    // A single vertex, construct with the attribute values in order
+    using Vertex = VertexStorage<Attributes...>;
+    static_assert(sizeof(Vertex) == Stride, "Vertex attribute types have padding between them");
+
+
+    // Byte offset of the attribute with the given semantic
+    template <VertexSemantic S>
+    static constexpr uint32_t Offset()
+    {
+        static_assert(VertexAttributeIndex<Attributes...>(S) < NumElements, "Vertex layout has no attribute with this semantic");
+        return VertexAttributeOffset<Attributes...>(VertexAttributeIndex<Attributes...>(S));
+    }
+
+    // True if the given run-time layout (e.g. of a sub-mesh in MeshData.h) is exactly this one, so its vertex data
+    // can be used as an array of Vertex
+    static bool Matches(const VertexElement* elements, size_t numElements, uint32_t vertexSize)
+    {
+        if (numElements != NumElements || vertexSize != Stride)  return false;
+        for (size_t i = 0; i < numElements; ++i)
+        {
+            if (elements[i].semantic != Elements[i].semantic || elements[i].format != Elements[i].format ||
+                elements[i].offset   != Elements[i].offset)  return false;
+        }
+        return true;
+    }
+
+
+    // Interleave separate arrays, one for each attribute in layout order, into the given vertices. The sizes and
+    // offsets are all known at compile time, so each vertex is a fixed run of vector loads and stores with no
+    // per-element loops or branches on the layout
+    static void Interleave(Vertex* vertices, uint32_t numVertices, const typename Attributes::Type*... attributes)
+    {
+        if (numVertices == 0)  return;
+
+        // Attributes of 12 bytes are copied as 16, one vector load and store rather than two smaller ones. The extra
+        // bytes read are from the next element in the array, and the extra bytes written are overwritten by the next
+        // attribute or vertex, so the last vertex is copied exactly
+        unsigned char* vertex = reinterpret_cast<unsigned char*>(vertices);
+        for (uint32_t v = 0; v < numVertices - 1; ++v)
+        {
+            CopyVertex<true>(std::index_sequence_for<Attributes...>(), vertex, v, attributes...);
+            vertex += Stride;
+        }
+        CopyVertex<false>(std::index_sequence_for<Attributes...>(), vertex, numVertices - 1, attributes...);
+    }
+
+private:
+    // Copy the attributes of one vertex in order, widening 12 byte copies to 16 if Wide is set (see Interleave)
+    template <bool Wide, size_t... I>
+    static void CopyVertex(std::index_sequence<I...>, unsigned char* vertex, uint32_t v, const typename Attributes::Type*... attributes)
+    {
+        int expand[] = { (std::memcpy(vertex + std::integral_constant<uint32_t, VertexAttributeOffset<Attributes...>(I)>::value, attributes + v,
+                                      (Wide && sizeof(typename Attributes::Type) == 12) ? 16 : sizeof(typename Attributes::Type)), 0)... };
+        (void)expand;
+    }
+};
+
+// Definitions needed if the members are used by address (e.g. Elements.data() at run time)
+template <class... Attributes> constexpr uint32_t VertexLayout<Attributes...>::NumElements;
+template <class... Attributes> constexpr uint32_t VertexLayout<Attributes...>::Stride;
+template <class... Attributes> constexpr std::array<VertexElement, sizeof...(Attributes)> VertexLayout<Attributes...>::Elements;
+template <class... Attributes> constexpr uint64_t VertexLayout<Attributes...>::Key;
+
+
+#endif //_VERTEX_LAYOUT_H_INCLUDED_
@@ -0,0 +1,316 @@
+//--------------------------------------------------------------------------------------
+// Compact vertex formats - packing imported vertices into fewer bytes
+//--------------------------------------------------------------------------------------
+
+#include "VertexPacking.h"
+#include "CVector2.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <memory>
+
+
+//--------------------------------------------------------------------------------------
+// Encoding and decoding of single values
+//--------------------------------------------------------------------------------------
+// The decoding functions match what the GPU does when reading the formats, and the decoding in the shaders
+
+// Convert a float to a half float (IEEE 754 binary16), rounding to nearest even. Values too large for a half
+// become the largest half value rather than infinity
+static uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &value, 4);
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t absBits = bits & 0x7fffffff;
+
+    if (absBits >= 0x477fe000)  return sign | 0x7bff; // 65504, the largest half (also used for infinity and NaN)
+
+    if (absBits < 0x38800000) // Below the smallest normal half (2^-14), a denormal half counts in steps of 2^-24
+    {
+        float absValue;
+        std::memcpy(&absValue, &absBits, 4);
+        return sign | static_cast<uint16_t>(std::nearbyint(absValue * 16777216.0f)); // Rounding to 1024 gives the smallest normal correctly
+    }
+
+    // Rebias the exponent (127 to 15) and round the mantissa from 23 bits to 10. A carry out of the mantissa
+    // correctly increases the exponent
+    uint32_t half = (absBits - 0x38000000) >> 13;
+    uint32_t remainder = absBits & 0x1fff;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (half & 1)))  ++half;
+    return sign | static_cast<uint16_t>(half);
+}
+
+static float HalfToFloat(uint16_t half)
+{
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+    float value;
+    if (exponent == 0)
+    {
+        value = mantissa / 16777216.0f; // Denormal
+    }
+    else
+    {
+        uint32_t bits = ((exponent + 112) << 23) | (mantissa << 13); // Infinity and NaN are never written by FloatToHalf
+        std::memcpy(&value, &bits, 4);
+    }
+    return (half & 0x8000) ? -value : value;
+}
+
+
+// Unsigned normalised 16-bit value, 0 to 65535 for 0 to 1, for a coordinate that is decoded with value * scale + bias
+static uint16_t PackUnorm16(float value, float scale, float bias)
+{
+    float t = (scale > 0) ? (value - bias) / scale : 0;
+    return static_cast<uint16_t>(std::lround(std::min(std::max(t, 0.0f), 1.0f) * 65535));
+}
+
+
+// Signed normalised 16-bit values, -32767 to 32767 for -1 to 1 (-32768 is unused, it also reads as -1)
+static float Snorm16ToFloat(int16_t value)
+{
+    return std::max(value / 32767.0f, -1.0f);
+}
+
+
+// Octahedral encoding of a unit vector: project onto the octahedron |x|+|y|+|z| = 1, then fold the lower half
+// (z < 0) out over the corners of the upper half to cover the square -1 to 1
+static CVector2 OctahedralEncode(const CVector3& v)
+{
+    float l1Norm = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+    CVector2 e = { v.x / l1Norm, v.y / l1Norm };
+    if (v.z < 0)
+    {
+        CVector2 folded = { (1 - std::abs(e.y)) * (e.x >= 0 ? 1.0f : -1.0f),
+                            (1 - std::abs(e.x)) * (e.y >= 0 ? 1.0f : -1.0f) };
+        e = folded;
+    }
+    return e;
+}
+
+// Matches DecodeNormal in the shaders
+static CVector3 OctahedralDecode(const CVector2& e)
+{
+    CVector3 v = { e.x, e.y, 1 - std::abs(e.x) - std::abs(e.y) };
+    float t = std::max(-v.z, 0.0f);
+    v.x += (v.x >= 0) ? -t : t;
+    v.y += (v.y >= 0) ? -t : t;
+    return Normalise(v);
+}
+
+// Pack a unit vector as two 16-bit octahedral values. Of the four nearest 16-bit pairs the one that decodes closest
+// to the original vector is chosen, which roughly halves the error of simple rounding. Returns the angle error in degrees
+static float PackOctahedral(const CVector3& v, int16_t* packed)
+{
+    CVector3 unit = Normalise(v);
+    if (Dot(unit, unit) == 0)  unit = { 0, 0, 1 }; // Zero length vectors would encode as NaN
+
+    CVector2 e = OctahedralEncode(unit);
+    float baseX = std::floor(e.x * 32767), baseY = std::floor(e.y * 32767);
+    float bestAngle = FLT_MAX;
+    for (int i = 0; i < 4; ++i)
+    {
+        int16_t x = static_cast<int16_t>(std::min(std::max(baseX + (i & 1), -32767.0f), 32767.0f));
+        int16_t y = static_cast<int16_t>(std::min(std::max(baseY + (i >> 1), -32767.0f), 32767.0f));
+        CVector3 decoded = OctahedralDecode({ Snorm16ToFloat(x), Snorm16ToFloat(y) });
+        float angle = std::atan2(Length(Cross(decoded, unit)), Dot(decoded, unit)); // More accurate than acos for small angles
+        if (angle < bestAngle)
+        {
+            bestAngle = angle;
+            packed[0] = x;
+            packed[1] = y;
+        }
+    }
+    return bestAngle * (180.0f / 3.14159265f);
+}
+
+
+// Pack bone weights into unsigned normalised bytes. Rounding each one alone can leave the total a step or two away
+// from 1, which would scale the skinned vertex, so the difference goes on the largest weight. Returns the largest error
+static float PackWeights(const float* weights, uint8_t* packed)
+{
+    int quantised[4];
+    int total = 0, largest = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        quantised[i] = static_cast<int>(std::lround(std::min(std::max(weights[i], 0.0f), 1.0f) * 255));
+        total += quantised[i];
+        if (weights[i] > weights[largest])  largest = i;
+    }
+    if (total > 0)  quantised[largest] = std::min(std::max(quantised[largest] + 255 - total, 0), 255);
+
+    float error = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        packed[i] = static_cast<uint8_t>(quantised[i]);
+        error = std::max(error, std::abs(packed[i] / 255.0f - weights[i]));
+    }
+    return error;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Packing mesh data
+//--------------------------------------------------------------------------------------
+
+// Return the compact format for an element if it should be packed, otherwise its current format
+static VertexFormat PackedFormat(const VertexElement& element, uint32_t compactElements)
+{
+    switch (element.semantic)
+    {
+        case VertexSemantic::Position:
+            if ((compactElements & VERTEX_COMPACT_POSITIONS) && element.format == VertexFormat::Float3)  return VertexFormat::UShort4Norm;
+            break;
+        case VertexSemantic::Normal:
+        case VertexSemantic::Tangent:
+            if ((compactElements & VERTEX_COMPACT_NORMALS)   && element.format == VertexFormat::Float3)  return VertexFormat::Short2Norm;
+            break;
+        case VertexSemantic::UV:
+            if ((compactElements & VERTEX_COMPACT_UVS)       && element.format == VertexFormat::Float2)  return VertexFormat::Half2;
+            break;
+        case VertexSemantic::Weights:
+            if ((compactElements & VERTEX_COMPACT_WEIGHTS)   && element.format == VertexFormat::Float4)  return VertexFormat::UByte4Norm;
+            break;
+        default:
+            break;
+    }
+    return element.format;
+}
+
+
+// Pack the full precision (float) elements of the vertices in the given mesh data into compact formats. Elements
+// not selected, and elements that are already compact, are copied unchanged. Sets the mesh's position scale and
+// bias if positions are packed. Optionally returns the largest errors introduced
+void PackVertices(MeshData& mesh, uint32_t compactElements, VertexPackingErrors* errors /*= nullptr*/)
+{
+    VertexPackingErrors maxErrors;
+
+    // Positions are packed across the bounding box of the whole mesh. They are left alone if any are already packed,
+    // since that used the mesh's existing scale and bias
+    CVector3 boxMin = { FLT_MAX, FLT_MAX, FLT_MAX };
+    CVector3 boxMax = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+    bool hasFloatPositions = false, hasPackedPositions = false;
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        for (auto& element : subMesh.layout)
+        {
+            if (element.semantic != VertexSemantic::Position)  continue;
+            if (element.format != VertexFormat::Float3)
+            {
+                hasPackedPositions = true;
+                continue;
+            }
+            hasFloatPositions = true;
+            const unsigned char* position = subMesh.vertices + element.offset;
+            for (uint32_t v = 0; v < subMesh.numVertices; ++v, position += subMesh.vertexSize)
+            {
+                const CVector3& p = *(const CVector3*)position;
+                boxMin = { std::min(boxMin.x, p.x), std::min(boxMin.y, p.y), std::min(boxMin.z, p.z) };
+                boxMax = { std::max(boxMax.x, p.x), std::max(boxMax.y, p.y), std::max(boxMax.z, p.z) };
+            }
+        }
+    }
+    if (hasPackedPositions || !hasFloatPositions)  compactElements &= ~VERTEX_COMPACT_POSITIONS;
+    if (compactElements & VERTEX_COMPACT_POSITIONS)
+    {
+        mesh.positionBias  = boxMin;
+        mesh.positionScale = boxMax - boxMin; // 0 on a flat axis, every position then decodes to the bias
+    }
+    const CVector3& scale = mesh.positionScale;
+    const CVector3& bias  = mesh.positionBias;
+
+
+    for (auto& subMesh : mesh.subMeshes)
+    {
+        // New layout with the packed formats
+        std::vector<VertexElement> layout;
+        uint32_t vertexSize = 0;
+        bool anyPacked = false;
+        for (auto& element : subMesh.layout)
+        {
+            VertexFormat format = PackedFormat(element, compactElements);
+            anyPacked = anyPacked || (format != element.format);
+            layout.push_back({ element.semantic, format, vertexSize });
+            vertexSize += VertexFormatSize(format);
+        }
+        if (!anyPacked)  continue;
+
+
+        // Pack each element of each vertex
+        auto vertices = std::make_unique<unsigned char[]>(static_cast<size_t>(subMesh.numVertices) * vertexSize);
+        for (uint32_t v = 0; v < subMesh.numVertices; ++v)
+        {
+            const unsigned char* vertexIn = subMesh.vertices + static_cast<size_t>(v) * subMesh.vertexSize;
+            unsigned char* vertexOut = vertices.get() + static_cast<size_t>(v) * vertexSize;
+            for (size_t e = 0; e < layout.size(); ++e)
+            {
+                const unsigned char* in = vertexIn + subMesh.layout[e].offset;
+                unsigned char* out = vertexOut + layout[e].offset;
+                if (layout[e].format == subMesh.layout[e].format)
+                {
+                    std::memcpy(out, in, VertexFormatSize(layout[e].format)); // Not packed
+                    continue;
+                }
+
+                switch (layout[e].format)
+                {
+                    case VertexFormat::UShort4Norm:
+                    {
+                        const CVector3& p = *(const CVector3*)in;
+                        uint16_t* packed = (uint16_t*)out;
+                        packed[0] = PackUnorm16(p.x, scale.x, bias.x);
+                        packed[1] = PackUnorm16(p.y, scale.y, bias.y);
+                        packed[2] = PackUnorm16(p.z, scale.z, bias.z);
+                        packed[3] = 0; // Unused
+                        CVector3 decoded = { packed[0] / 65535.0f * scale.x + bias.x,
+                                             packed[1] / 65535.0f * scale.y + bias.y,
+                                             packed[2] / 65535.0f * scale.z + bias.z };
+                        maxErrors.position = std::max(maxErrors.position, Length(decoded - p));
+                        break;
+                    }
+
+                    case VertexFormat::Short2Norm:
+                    {
+                        float error = PackOctahedral(*(const CVector3*)in, (int16_t*)out);
+                        float& maxError = (layout[e].semantic == VertexSemantic::Tangent) ? maxErrors.tangentDegrees : maxErrors.normalDegrees;
+                        maxError = std::max(maxError, error);
+                        break;
+                    }
+
+                    case VertexFormat::Half2:
+                    {
+                        const CVector2& uv = *(const CVector2*)in;
+                        uint16_t* packed = (uint16_t*)out;
+                        packed[0] = FloatToHalf(uv.x);
+                        packed[1] = FloatToHalf(uv.y);
+                        maxErrors.uv = std::max({ maxErrors.uv, std::abs(HalfToFloat(packed[0]) - uv.x), std::abs(HalfToFloat(packed[1]) - uv.y) });
+                        break;
+                    }
+
+                    case VertexFormat::UByte4Norm:
+                        maxErrors.weight = std::max(maxErrors.weight, PackWeights((const float*)in, (uint8_t*)out));
+                        break;
+
+                    default:
+                        break;
+                }
+            }
+        }
+
+
+        // Replace the sub-mesh's vertices, freeing the old ones if the mesh data owns them (i.e. not a mapped file)
+        for (auto& buffer : mesh.buffers)
+        {
+            if (buffer.get() == subMesh.vertices)  buffer.reset();
+        }
+        subMesh.layout = std::move(layout);
+        subMesh.vertexSize = vertexSize;
+        subMesh.vertices = vertices.get();
+        mesh.buffers.push_back(std::move(vertices));
+    }
+
+    if (errors != nullptr)  *errors = maxErrors;
+}
@@ -0,0 +1,49 @@
+//--------------------------------------------------------------------------------------
+// Compact vertex formats - packing imported vertices into fewer bytes
+//--------------------------------------------------------------------------------------
+// Imported vertices use floats throughout: up to 64 bytes for a skinned vertex with tangents. Vertex fetch is
+// often the limit for dense meshes, so vertices can be packed into smaller formats that the GPU converts back
+// to floats as it reads them:
+//     Positions          - 16-bit unsigned normalised across the mesh bounding box, decoded with the mesh's
+//                          positionScale and positionBias (see MeshData.h). 8 bytes rather than 12
+//     Normals / tangents - octahedral encoding (the unit sphere folded out onto a square) in two 16-bit signed
+//                          normalised values. 4 bytes rather than 12 each
+//     UVs                - half floats. 4 bytes rather than 8
+//     Bone weights       - unsigned normalised bytes, adjusted to sum to exactly 1. 4 bytes rather than 16
+// A skinned vertex with tangents goes from 64 to 28 bytes, a static vertex without from 32 to 16.
+// Positions and normals need decoding in the vertex shader, UVs and weights don't (the input layout does it).
+
+#ifndef _VERTEX_PACKING_H_INCLUDED_
+#define _VERTEX_PACKING_H_INCLUDED_
+
+#include "MeshData.h"
+
+#include <cstdint>
+
+
+// Vertex elements to store in a compact form, combine with |
+const uint32_t VERTEX_COMPACT_POSITIONS = 1;
+const uint32_t VERTEX_COMPACT_NORMALS   = 2; // Normals and tangents
+const uint32_t VERTEX_COMPACT_UVS       = 4;
+const uint32_t VERTEX_COMPACT_WEIGHTS   = 8;
+const uint32_t VERTEX_COMPACT_ALL       = VERTEX_COMPACT_POSITIONS | VERTEX_COMPACT_NORMALS | VERTEX_COMPACT_UVS | VERTEX_COMPACT_WEIGHTS;
+
+
+// Largest error introduced by packing, found by decoding every packed value and comparing it with the original
+struct VertexPackingErrors
+{
+    float position       = 0; // Distance in model units
+    float normalDegrees  = 0; // Angle between original and decoded normal
+    float tangentDegrees = 0;
+    float uv             = 0; // Largest difference in u or v
+    float weight         = 0; // Largest difference in a bone weight
+};
+
+
+// Pack the full precision (float) elements of the vertices in the given mesh data into compact formats. Elements
+// not selected, and elements that are already compact, are copied unchanged. Sets the mesh's position scale and
+// bias if positions are packed. Optionally returns the largest errors introduced
+void PackVertices(MeshData& mesh, uint32_t compactElements, VertexPackingErrors* errors = nullptr);
+
+
+#endif //_VERTEX_PACKING_H_INCLUDED_
@@ -0,0 +1,44 @@
+//--------------------------------------------------------------------------------------
+// Hash functions for cache keys
+//--------------------------------------------------------------------------------------
+// 64-bit FNV-1a. Not cryptographic, but quick and well distributed, which is all a cache key needs.
+// Hash a block of memory with HashBytes, and combine further values (flags, sizes, other hashes) into
+// the result by passing it back in as the seed. Results are the same on every platform and build.
+
+#ifndef _HASH_H_INCLUDED_
+#define _HASH_H_INCLUDED_
+
+#include <cstddef>
+#include <cstdint>
+
+// Starting value for a new hash
+const uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+// Return the hash of a block of memory, continuing from the given seed (pass a previous hash to combine them)
+inline uint64_t HashBytes(const void* data, size_t size, uint64_t seed = HASH_SEED)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// Combine an integer value into a hash. The value is hashed as 8 little-endian bytes so the result does
+// not depend on the type or platform. Can be used at compile time (e.g. VertexLayout.h)
+constexpr uint64_t HashValue(uint64_t value, uint64_t seed = HASH_SEED)
+{
+    uint64_t hash = seed;
+    for (int i = 0; i < 8; ++i)
+    {
+        hash ^= static_cast<unsigned char>(value >> (i * 8));
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+
+#endif //_HASH_H_INCLUDED_
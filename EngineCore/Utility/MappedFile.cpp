@@ -0,0 +1,118 @@
+//--------------------------------------------------------------------------------------
+// Read-only memory mapped file
+//--------------------------------------------------------------------------------------
+
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <utility>
+
+
+MappedFile::MappedFile(MappedFile&& other)
+{
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other)
+{
+    if (this != &other)
+    {
+        Close();
+        std::swap(mData, other.mData);
+        std::swap(mSize, other.mSize);
+#ifdef _WIN32
+        std::swap(mFile, other.mFile);
+        std::swap(mMapping, other.mMapping);
+#endif
+    }
+    return *this;
+}
+
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& fileName)
+{
+    Close();
+
+    HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)  return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    void* data = (mapping != nullptr) ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        if (mapping != nullptr)  CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+
+    mFile = file;
+    mMapping = mapping;
+    mData = static_cast<const unsigned char*>(data);
+    mSize = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mData    != nullptr)  UnmapViewOfFile(mData);
+    if (mMapping != nullptr)  CloseHandle(mMapping);
+    if (mFile    != nullptr)  CloseHandle(mFile);
+    mData = nullptr;
+    mMapping = nullptr;
+    mFile = nullptr;
+    mSize = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& fileName)
+{
+    Close();
+
+    int file = open(fileName.c_str(), O_RDONLY);
+    if (file < 0)  return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size == 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping stays valid after the file descriptor is closed
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED)  return false;
+
+    mData = static_cast<const unsigned char*>(data);
+    mSize = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (mData != nullptr)  munmap(const_cast<unsigned char*>(mData), mSize);
+    mData = nullptr;
+    mSize = 0;
+}
+
+#endif
@@ -0,0 +1,50 @@
+//--------------------------------------------------------------------------------------
+// Read-only memory mapped file
+//--------------------------------------------------------------------------------------
+// The operating system maps the file straight into the address space and pages it in as it is read, so
+// there is no copy into a buffer. Data in the file can be used in place for as long as the object exists.
+// Uses file mappings on Windows and mmap elsewhere.
+
+#ifndef _MAPPED_FILE_H_INCLUDED_
+#define _MAPPED_FILE_H_INCLUDED_
+
+#include <cstddef>
+#include <string>
+
+class MappedFile
+{
+public:
+    MappedFile() {}
+    ~MappedFile()  { Close(); }
+
+    // Can be moved but not copied
+    MappedFile(MappedFile&& other);
+    MappedFile& operator=(MappedFile&& other);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+
+    // Map the given file into memory, closing any file already open. Returns false if the file
+    // cannot be opened or is empty
+    bool Open(const std::string& fileName);
+
+    // Unmap the file. Pointers returned by Data are no longer valid
+    void Close();
+
+
+    bool                 IsOpen() const { return mData != nullptr; }
+    const unsigned char* Data()   const { return mData; }
+    size_t               Size()   const { return mSize; }
+
+private:
+    const unsigned char* mData = nullptr;
+    size_t               mSize = 0;
+
+#ifdef _WIN32
+    void* mFile    = nullptr; // Windows HANDLEs, kept as void* so this header does not need windows.h
+    void* mMapping = nullptr;
+#endif
+};
+
+
+#endif //_MAPPED_FILE_H_INCLUDED_
@@ -0,0 +1,113 @@
+//--------------------------------------------------------------------------------------
+// Range allocator - sub-allocates ranges of a fixed size buffer
+//--------------------------------------------------------------------------------------
+
+#include "RangeAllocator.h"
+
+#include <algorithm>
+#include <iterator>
+
+
+RangeAllocator::RangeAllocator(uint32_t capacity /*= 0*/)
+{
+    Grow(capacity);
+}
+
+
+uint32_t RangeAllocator::Allocate(uint32_t size)
+{
+    if (size == 0)  return INVALID_RANGE;
+
+    // First fit keeps allocations towards the start of the buffer, leaving the large free range at the end
+    for (auto free = mFree.begin(); free != mFree.end(); ++free)
+    {
+        if (free->second < size)  continue;
+
+        uint32_t start = free->first;
+        uint32_t remaining = free->second - size;
+        mFree.erase(free);
+        if (remaining > 0)  mFree[start + size] = remaining;
+
+        mAllocated[start] = size;
+        mUsed += size;
+        return start;
+    }
+    return INVALID_RANGE;
+}
+
+
+void RangeAllocator::Free(uint32_t start)
+{
+    auto allocated = mAllocated.find(start);
+    if (allocated == mAllocated.end())  return;
+    uint32_t size = allocated->second;
+    mAllocated.erase(allocated);
+    mUsed -= size;
+
+    // Merge with the free ranges either side if they touch this one
+    auto next = mFree.lower_bound(start);
+    if (next != mFree.end() && next->first == start + size)
+    {
+        size += next->second;
+        next = mFree.erase(next);
+    }
+    if (next != mFree.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == start)
+        {
+            previous->second += size;
+            return;
+        }
+    }
+    mFree[start] = size;
+}
+
+
+void RangeAllocator::Grow(uint32_t newCapacity)
+{
+    if (newCapacity <= mCapacity)  return;
+
+    // Extend the last free range if it reaches the end of the buffer, otherwise add a new one
+    uint32_t extra = newCapacity - mCapacity;
+    if (!mFree.empty() && mFree.rbegin()->first + mFree.rbegin()->second == mCapacity)
+    {
+        mFree.rbegin()->second += extra;
+    }
+    else
+    {
+        mFree[mCapacity] = extra;
+    }
+    mCapacity = newCapacity;
+}
+
+
+std::vector<RangeAllocator::Move> RangeAllocator::Defragment()
+{
+    std::vector<Move> moves;
+    if (mFree.empty() || (mFree.size() == 1 && mFree.begin()->first == mUsed))  return moves; // Already packed
+
+    // Slide each range down to the end of the one before. The map is ordered by start so each destination is
+    // at or before its source, and after the destinations of all the ranges before it
+    std::map<uint32_t, uint32_t> packed;
+    uint32_t end = 0;
+    for (auto& range : mAllocated)
+    {
+        if (range.first != end)  moves.push_back({ range.first, end, range.second });
+        packed.emplace_hint(packed.end(), end, range.second);
+        end += range.second;
+    }
+    mAllocated.swap(packed);
+
+    mFree.clear();
+    if (end < mCapacity)  mFree[end] = mCapacity - end;
+    return moves;
+}
+
+
+uint32_t RangeAllocator::LargestFree() const
+{
+    uint32_t largest = 0;
+    for (auto& free : mFree)  largest = std::max(largest, free.second);
+    return largest;
+}
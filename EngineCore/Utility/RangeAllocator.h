@@ -0,0 +1,68 @@
+//--------------------------------------------------------------------------------------
+// Range allocator - sub-allocates ranges of a fixed size buffer
+//--------------------------------------------------------------------------------------
+// Hands out ranges [start, start + size) of a buffer of a given capacity, e.g. vertices in one large GPU vertex
+// buffer shared by many meshes. Only the bookkeeping is here, the caller owns the buffer itself. Units are
+// whatever the caller wants (vertices, indices, bytes). First fit, and freed ranges merge with free neighbours.
+// Freeing leaves gaps, Defragment packs the allocations to the start of the buffer and returns the copies
+// the caller must make to its buffer to match.
+
+#ifndef _RANGE_ALLOCATOR_H_INCLUDED_
+#define _RANGE_ALLOCATOR_H_INCLUDED_
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class RangeAllocator
+{
+public:
+    // Returned by Allocate when there is no free range large enough
+    static const uint32_t INVALID_RANGE = ~0u;
+
+    explicit RangeAllocator(uint32_t capacity = 0);
+
+
+    // Allocate a range of the given size, returning its start or INVALID_RANGE if there is no free range large
+    // enough (Grow the buffer and try again). The size must be greater than 0
+    uint32_t Allocate(uint32_t size);
+
+    // Free the range starting at the given position (as returned by Allocate)
+    void Free(uint32_t start);
+
+    // Increase the capacity, the new space is added at the end. Existing ranges are unchanged
+    void Grow(uint32_t newCapacity);
+
+
+    // A copy to make when defragmenting. Moves are in increasing order of start, and each one only moves a
+    // range towards the start of the buffer, so making them in order never overwrites a range not yet moved.
+    // The source and destination of a single move can overlap (use memmove or a temporary buffer)
+    struct Move
+    {
+        uint32_t from;
+        uint32_t to;
+        uint32_t size;
+    };
+
+    // Pack all allocated ranges to the start of the buffer, leaving all free space in one range at the end.
+    // Returns the copies to make to the buffer, ranges not listed have not moved
+    std::vector<Move> Defragment();
+
+
+    uint32_t Capacity()       const { return mCapacity; }
+    uint32_t Used()           const { return mUsed; }                  // Total size of allocated ranges
+    uint32_t LargestFree()    const;                                   // Largest size that can be allocated without growing
+    uint32_t NumFreeRanges()  const { return static_cast<uint32_t>(mFree.size()); } // More than one means fragmented
+    uint32_t NumAllocations() const { return static_cast<uint32_t>(mAllocated.size()); }
+
+private:
+    // Both maps are keyed on the start of the range and hold its size
+    std::map<uint32_t, uint32_t> mAllocated;
+    std::map<uint32_t, uint32_t> mFree; // Free ranges never touch, neighbouring ones are merged
+
+    uint32_t mCapacity = 0;
+    uint32_t mUsed = 0;
+};
+
+
+#endif //_RANGE_ALLOCATOR_H_INCLUDED_
@@ -0,0 +1,114 @@
+//--------------------------------------------------------------------------------------
+// Task pool - background threads for work that finishes on one owning thread
+//--------------------------------------------------------------------------------------
+
+#include "TaskPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+
+
+TaskPool::TaskPool(unsigned int numThreads /*= 0*/)
+{
+    if (numThreads == 0)  numThreads = std::max(2u, std::thread::hardware_concurrency()) - 1;
+    for (unsigned int i = 0; i < numThreads; ++i)
+    {
+        mThreads.emplace_back(&TaskPool::WorkerThread, this);
+    }
+}
+
+
+TaskPool::~TaskPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mWorkMutex);
+        mStopping = true;
+        mWork.clear();
+    }
+    mWorkReady.notify_all();
+    for (auto& thread : mThreads)  thread.join();
+}
+
+
+void TaskPool::Submit(Work work)
+{
+    {
+        std::lock_guard<std::mutex> lock(mWorkMutex);
+        mWork.push_back(std::move(work));
+    }
+    ++mNumSubmitted;
+    mWorkReady.notify_one();
+}
+
+
+unsigned int TaskPool::RunCompletions(float maxSeconds /*= 0*/)
+{
+    auto start = std::chrono::steady_clock::now();
+    unsigned int numRun = 0;
+    while (true)
+    {
+        Completion completion;
+        {
+            std::lock_guard<std::mutex> lock(mCompletionMutex);
+            if (mCompletions.empty())  break;
+            completion = std::move(mCompletions.front());
+            mCompletions.pop_front();
+        }
+
+        // Counted before running so a completion that throws is not run again
+        ++mNumCompleted;
+        ++numRun;
+        if (completion)  completion();
+
+        if (maxSeconds > 0 && std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= maxSeconds)  break;
+    }
+    return numRun;
+}
+
+
+void TaskPool::WaitAll()
+{
+    while (NumPending() > 0)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mCompletionMutex);
+            mCompletionReady.wait(lock, [this] { return !mCompletions.empty(); });
+        }
+        RunCompletions();
+    }
+}
+
+
+void TaskPool::WorkerThread()
+{
+    while (true)
+    {
+        Work work;
+        {
+            std::unique_lock<std::mutex> lock(mWorkMutex);
+            mWorkReady.wait(lock, [this] { return mStopping || !mWork.empty(); });
+            if (mStopping)  return;
+            work = std::move(mWork.front());
+            mWork.pop_front();
+        }
+
+        // Exceptions are passed back to the owning thread as a completion that rethrows them
+        Completion completion;
+        try
+        {
+            completion = work();
+        }
+        catch (...)
+        {
+            std::exception_ptr exception = std::current_exception();
+            completion = [exception]() { std::rethrow_exception(exception); };
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mCompletionMutex);
+            mCompletions.push_back(std::move(completion));
+        }
+        mCompletionReady.notify_one();
+    }
+}
@@ -0,0 +1,76 @@
+//--------------------------------------------------------------------------------------
+// Task pool - background threads for work that finishes on one owning thread
+//--------------------------------------------------------------------------------------
+// Work such as file reading, decoding and mesh processing runs on a pool of worker threads, in the order it was
+// submitted. Each piece of work returns a completion - a function that is queued back to the thread that owns the
+// pool (e.g. the render thread) and run there by RunCompletions, for anything that must happen on that thread such
+// as creating GPU resources. Only the owning thread may call the methods here, the work itself can do anything
+// thread-safe. An exception thrown by work is passed back and rethrown from RunCompletions.
+
+#ifndef _TASK_POOL_H_INCLUDED_
+#define _TASK_POOL_H_INCLUDED_
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskPool
+{
+public:
+    // Run on the owning thread with the results of some work. Work can return an empty function if it has
+    // nothing to finish
+    using Completion = std::function<void()>;
+    using Work       = std::function<Completion()>;
+
+    // Start the worker threads, by default one fewer than the hardware threads so the owning thread keeps a core
+    explicit TaskPool(unsigned int numThreads = 0);
+
+    // Work already started is finished, the rest of the queue and any completions not yet run are discarded
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+
+    // Queue work to run on a worker thread. Work is started in the order it is submitted, so work can safely
+    // wait for the results of work submitted before it
+    void Submit(Work work);
+
+    // Run completions of finished work on the calling thread, in the order the work finished. Stops once maxSeconds
+    // have passed (at least one completion is run if any are waiting), 0 for no limit. Returns the number run. If
+    // the work threw an exception it is rethrown here, completions after it are left for the next call
+    unsigned int RunCompletions(float maxSeconds = 0);
+
+    // Block until all submitted work has finished and its completions have run
+    void WaitAll();
+
+
+    unsigned int NumThreads()   const { return static_cast<unsigned int>(mThreads.size()); }
+    unsigned int NumSubmitted() const { return mNumSubmitted; }
+    unsigned int NumCompleted() const { return mNumCompleted; }  // Work whose completion has run
+    unsigned int NumPending()   const { return mNumSubmitted - mNumCompleted; }
+
+private:
+    void WorkerThread();
+
+    std::vector<std::thread> mThreads;
+
+    std::mutex              mWorkMutex;
+    std::condition_variable mWorkReady;
+    std::deque<Work>        mWork;
+    bool                    mStopping = false;
+
+    std::mutex              mCompletionMutex;
+    std::condition_variable mCompletionReady;
+    std::deque<Completion>  mCompletions;
+
+    // Only used on the owning thread
+    unsigned int mNumSubmitted = 0;
+    unsigned int mNumCompleted = 0;
+};
+
+
+#endif //_TASK_POOL_H_INCLUDED_
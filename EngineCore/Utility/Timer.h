@@ -1,11 +1,13 @@
 //--------------------------------------------------------------------------------------
 // Timer class - works like a stopwatch
 //--------------------------------------------------------------------------------------
+// Uses std::chrono::steady_clock, which is the high-resolution performance counter on Windows
+// and a monotonic clock on other platforms, so the class has no platform-specific code
 
 #ifndef _TIMER_H_INCLUDED_
 #define _TIMER_H_INCLUDED_
 
-#include "Windows.h"
+#include <chrono>
 
 class Timer
 {
@@ -15,7 +17,7 @@ public:
 
 	Timer();
 
-	
+
 	// Timer control //
 
 	// Start the timer running
@@ -42,28 +44,20 @@ public:
 
 
 private:
-	// Is the timer running
-	bool mRunning;
-
+	using Clock = std::chrono::steady_clock;
 
-	// Using high resolution timer and if so its frequency
-	bool          mHighRes;
-	LARGE_INTEGER mHighResFreq;
-
-	// Start time and last lap start time of high-resolution timer
-	LARGE_INTEGER mHighResStart;
-	LARGE_INTEGER mHighResLap;
-
-	// Time when high-resolution timer was stopped (if it has been)
-	LARGE_INTEGER mHighResStop;
+	// Current time, or the stop time if the timer is stopped
+	Clock::time_point CurrentTime();
 
+	// Is the timer running
+	bool mRunning;
 
-	// Start time and last lap start time of low-resolution timer
-	DWORD mLowResStart;
-	DWORD mLowResLap;
+	// Start time and last lap start time
+	Clock::time_point mStart;
+	Clock::time_point mLap;
 
-	// Time when low-resolution timer was stopped (if it has been)
-	DWORD mLowResStop;
+	// Time when timer was stopped (if it has been)
+	Clock::time_point mStop;
 };
 
 
@@ -133,27 +133,14 @@ ID3D11Buffer* gPerModelConstantBuffer; // This variable controls the GPU-side co
 //--------------------------------------------------------------------------------------
 
 // The content of a single vertex in the geometry to render. Stores the vertex position as usual as well a texture coordinate (for textures).
-struct BasicVertex
-{
-    CVector3 position; // Model space position of the vertex (x,y,z)
-    CVector3 normal;   // Model space vertex normal (for lighting) (x,y,z)
-    CVector2 uv;       // Texture coordinate (aka UVs) for the vertex (u,v)
-};
-
-
-
-// Describe the "input layout" //
-
-// This describes the contents of the BasicVertex structure above so DirectX will know what to expect when reading vertex data.
-// See earlier lab exercise comments for details. This structure should also match the vertex shader input structure
-D3D11_INPUT_ELEMENT_DESC gBasicVertexDesc[] =
-{
-    // Data Type,  Type Index,  Data format                   Slot  Offset    Other values can be ignored for now 
-    { "Position",  0,           DXGI_FORMAT_R32G32B32_FLOAT,  0,    0,        D3D11_INPUT_PER_VERTEX_DATA,  0 }, // Position has 3 floats starting at offset 0
-    { "Normal",    0,           DXGI_FORMAT_R32G32B32_FLOAT,  0,    12,       D3D11_INPUT_PER_VERTEX_DATA,  0 }, // Normal has 3 floats starting at offset 12 (= size of the earlier 3 floats)
-    { "UV",        0,           DXGI_FORMAT_R32G32_FLOAT,     0,    24,       D3D11_INPUT_PER_VERTEX_DATA,  0 }, // UV has 3 floats starting at offset 24 (= size of the earlier 6 floats)
-};
-int gBasicVertexDescCount = sizeof(gBasicVertexDesc) / sizeof(gBasicVertexDesc[0]); // This gives a count of rows in the array above
+// The vertex structure, and the description of it DirectX needs (see CreateVertexLayout in SceneHelpers.h), are both
+// generated from this list of attributes so they can't get out of step. The list should match the vertex shader input structure
+using BasicVertexLayout = VertexLayout<
+    VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>, // Model space position of the vertex (x,y,z)
+    VertexAttribute<VertexSemantic::Normal,   VertexFormat::Float3, CVector3>, // Model space vertex normal (for lighting) (x,y,z)
+    VertexAttribute<VertexSemantic::UV,       VertexFormat::Float2, CVector2>  // Texture coordinate (aka UVs) for the vertex (u,v)
+>;
+using BasicVertex = BasicVertexLayout::Vertex;
 
 
 
@@ -270,9 +257,9 @@ bool InitGeometry()
 
 
     // These lines create a "vertex layout" to describe to DirectX what is in a BasicVertex (position, normals, colours etc.)
-    // We type the description in the gBasicVertexDesc array above, and this code converts it to an object the GPU can use.
+    // The description is generated from BasicVertexLayout above, and this code converts it to an object the GPU can use.
     // The DirectX code for this has been moved to a helper function in Utility/SceneHelpers.cpp
-    gBasicVertexLayout = CreateVertexLayout(gBasicVertexDesc, gBasicVertexDescCount);
+    gBasicVertexLayout = CreateVertexLayout<BasicVertexLayout>();
     if (gBasicVertexLayout == nullptr)
     {
         gLastError = "Error creating vertex layout";
@@ -13,7 +13,7 @@
 
 // Create a "vertex layout" object that describes for DirectX what is in your geometry vertices (position, colour, normal etc.) 
 // Returns a DirectX layout object on success, nullptr on failure
-ID3D11InputLayout* CreateVertexLayout(D3D11_INPUT_ELEMENT_DESC* vertexDescData, int numDescElements)
+ID3D11InputLayout* CreateVertexLayout(const D3D11_INPUT_ELEMENT_DESC* vertexDescData, int numDescElements)
 {
     ID3D11InputLayout* vertexLayout;
 
@@ -7,15 +7,80 @@
 #define _SCENE_HELPERS_H_INCLUDED_
 
 #include "CMatrix4x4.h"
+#include "VertexLayout.h"
 #include "../Common.h"
 
+#include <array>
+#include <utility>
+
 //--------------------------------------------------------------------------------------
 // Geometry creation
 //--------------------------------------------------------------------------------------
 
 // Create a "vertex layout" object that describes for DirectX what is in your geometry vertices (position, colour, normal etc.) 
 // Returns a DirectX layout object on success, nullptr on failure
-ID3D11InputLayout* CreateVertexLayout(D3D11_INPUT_ELEMENT_DESC* vertexDescData, int numDescElements);
+ID3D11InputLayout* CreateVertexLayout(const D3D11_INPUT_ELEMENT_DESC* vertexDescData, int numDescElements);
+
+
+// HLSL semantic name and DXGI format of the device-independent vertex elements (see VertexElement.h)
+constexpr const char* VertexSemanticName(VertexSemantic semantic)
+{
+    switch (semantic)
+    {
+        case VertexSemantic::Position: return "Position";
+        case VertexSemantic::Normal:   return "Normal";
+        case VertexSemantic::Tangent:  return "Tangent";
+        case VertexSemantic::UV:       return "UV";
+        case VertexSemantic::Bones:    return "Bones";
+        case VertexSemantic::Weights:  return "Weights";
+        case VertexSemantic::Colour:   return "Colour";
+    }
+    return "";
+}
+
+constexpr DXGI_FORMAT VertexDXGIFormat(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float2:      return DXGI_FORMAT_R32G32_FLOAT;
+        case VertexFormat::Float3:      return DXGI_FORMAT_R32G32B32_FLOAT;
+        case VertexFormat::Float4:      return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        case VertexFormat::UByte4:      return DXGI_FORMAT_R8G8B8A8_UINT;
+        case VertexFormat::UShort4Norm: return DXGI_FORMAT_R16G16B16A16_UNORM;
+        case VertexFormat::Short2Norm:  return DXGI_FORMAT_R16G16_SNORM;
+        case VertexFormat::Half2:       return DXGI_FORMAT_R16G16_FLOAT;
+        case VertexFormat::UByte4Norm:  return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+constexpr D3D11_INPUT_ELEMENT_DESC InputElementDesc(const VertexElement& element)
+{
+    return { VertexSemanticName(element.semantic), 0, VertexDXGIFormat(element.format), 0, element.offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+}
+
+// The DirectX description of a vertex layout declared with VertexLayout.h, generated by the compiler so it always
+// matches the vertex structure
+template <class Layout, size_t... I>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, Layout::NumElements> InputElementDescs(std::index_sequence<I...>)
+{
+    return {{ InputElementDesc(Layout::Elements[I])... }};
+}
+
+template <class Layout>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, Layout::NumElements> InputElementDescs()
+{
+    return InputElementDescs<Layout>(std::make_index_sequence<Layout::NumElements>());
+}
+
+// Create a "vertex layout" object for a vertex layout declared with VertexLayout.h, e.g. CreateVertexLayout<BasicVertexLayout>()
+// Returns a DirectX layout object on success, nullptr on failure
+template <class Layout>
+ID3D11InputLayout* CreateVertexLayout()
+{
+    constexpr auto vertexDesc = InputElementDescs<Layout>();
+    return CreateVertexLayout(vertexDesc.data(), static_cast<int>(vertexDesc.size()));
+}
 
 
 // Create a vertex buffer on the GPU and copy the given data into it
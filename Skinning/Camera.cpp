@@ -10,59 +10,85 @@ void Camera::Control(float frameTime, KeyCode turnUp, KeyCode turnDown, KeyCode
                                       KeyCode moveForward, KeyCode moveBackward, KeyCode moveLeft, KeyCode moveRight)
 {
 	//**** ROTATION ****
+	// Pitch around the camera's own X axis, but yaw around the world Y axis so the camera never rolls
 	if (KeyHeld(Key_Down))
 	{
-		mRotation.x += ROTATION_SPEED * frameTime; // Use of frameTime to ensure same speed on different machines
+		mTransform.RotateLocal(QuaternionRotationX(ROTATION_SPEED * frameTime)); // Use of frameTime to ensure same speed on different machines
+		mMatricesDirty = true;
 	}
 	if (KeyHeld(Key_Up))
 	{
-		mRotation.x -= ROTATION_SPEED * frameTime;
+		mTransform.RotateLocal(QuaternionRotationX(-ROTATION_SPEED * frameTime));
+		mMatricesDirty = true;
 	}
 	if (KeyHeld(Key_Right))
 	{
-		mRotation.y += ROTATION_SPEED * frameTime;
+		mTransform.RotateWorld(QuaternionRotationY(ROTATION_SPEED * frameTime));
+		mMatricesDirty = true;
 	}
 	if (KeyHeld(Key_Left))
 	{
-		mRotation.y -= ROTATION_SPEED * frameTime;
+		mTransform.RotateWorld(QuaternionRotationY(-ROTATION_SPEED * frameTime));
+		mMatricesDirty = true;
+	}
+	if (mMatricesDirty)
+	{
+		mTransform.rotation = Normalise(mTransform.rotation); // Stop rounding errors building up over many frames
 	}
 
 	//**** LOCAL MOVEMENT ****
+	// Move along the camera's local X and Z axes, taken from the rotation
 	if (KeyHeld(Key_D))
 	{
-		mPosition.x += MOVEMENT_SPEED * frameTime * mWorldMatrix.e00; // See comments on local movement in UpdateCube code above
-		mPosition.y += MOVEMENT_SPEED * frameTime * mWorldMatrix.e01; 
-		mPosition.z += MOVEMENT_SPEED * frameTime * mWorldMatrix.e02; 
+		mTransform.position += MOVEMENT_SPEED * frameTime * mTransform.GetXAxis();
+		mMatricesDirty = true;
 	}
 	if (KeyHeld(Key_A))
 	{
-		mPosition.x -= MOVEMENT_SPEED * frameTime * mWorldMatrix.e00;
-		mPosition.y -= MOVEMENT_SPEED * frameTime * mWorldMatrix.e01;
-		mPosition.z -= MOVEMENT_SPEED * frameTime * mWorldMatrix.e02;
+		mTransform.position -= MOVEMENT_SPEED * frameTime * mTransform.GetXAxis();
+		mMatricesDirty = true;
 	}
 	if (KeyHeld(Key_W))
 	{
-		mPosition.x += MOVEMENT_SPEED * frameTime * mWorldMatrix.e20;
-		mPosition.y += MOVEMENT_SPEED * frameTime * mWorldMatrix.e21;
-		mPosition.z += MOVEMENT_SPEED * frameTime * mWorldMatrix.e22;
+		mTransform.position += MOVEMENT_SPEED * frameTime * mTransform.GetZAxis();
+		mMatricesDirty = true;
 	}
 	if (KeyHeld(Key_S))
 	{
-		mPosition.x -= MOVEMENT_SPEED * frameTime * mWorldMatrix.e20;
-		mPosition.y -= MOVEMENT_SPEED * frameTime * mWorldMatrix.e21;
-		mPosition.z -= MOVEMENT_SPEED * frameTime * mWorldMatrix.e22;
+		mTransform.position -= MOVEMENT_SPEED * frameTime * mTransform.GetZAxis();
+		mMatricesDirty = true;
 	}
 }
 
 
+// Return the world point under the given pixel (0,0 is top-left) at the given depth (0 = near clip, 1 = far clip)
+CVector3 Camera::WorldPointFromPixel(CVector2 pixel, float depth, CVector2 viewportSize)
+{
+    // Convert pixel to projection space (-1 to 1 in x and y, y upwards)
+    float x = pixel.x / viewportSize.x * 2.0f - 1.0f;
+    float y = 1.0f - pixel.y / viewportSize.y * 2.0f;
+
+    // Reverse the view and projection by transforming by the inverse view-projection matrix, then divide by w
+    CMatrix4x4 m = Inverse(ViewProjectionMatrix());
+    float invW = 1.0f / (x * m.e03 + y * m.e13 + depth * m.e23 + m.e33);
+    return { (x * m.e00 + y * m.e10 + depth * m.e20 + m.e30) * invW,
+             (x * m.e01 + y * m.e11 + depth * m.e21 + m.e31) * invW,
+             (x * m.e02 + y * m.e12 + depth * m.e22 + m.e32) * invW };
+}
+
+
 // Update the matrices used for the camera in the rendering pipeline
 void Camera::UpdateMatrices()
 {
+    // Nothing to do if the camera hasn't changed since the matrices were last built
+    if (!mMatricesDirty)  return;
+    mMatricesDirty = false;
+
     // "World" matrix for the camera - treat it like a model at first
-    mWorldMatrix = MatrixRotationZ(mRotation.z) * MatrixRotationX(mRotation.x) * MatrixRotationY(mRotation.y) * MatrixTranslation(mPosition);
+    mWorldMatrix = mTransform.GetAffineMatrix();
 
     // View matrix is the usual matrix used for the camera in shaders, it is the inverse of the world matrix (see lectures)
-    mViewMatrix = InverseAffine(mWorldMatrix);
+    mViewMatrix = InverseAffine(mWorldMatrix).ToMatrix4x4();
 
     // Projection matrix, how to flatten the 3D world onto the screen (needs field of view, near and far clip, aspect ratio)
     float tanFOVx = std::tan(mFOVx * 0.5f);
@@ -4,8 +4,10 @@
 // Holds position, rotation, near/far clip and field of view. These to a view and projection matrices as required
 
 #include "Common.h"
+#include "CVector2.h"
 #include "CVector3.h"
 #include "CMatrix4x4.h"
+#include "CTransform.h"
 #include "MathHelpers.h"
 #include "Input.h"
 
@@ -23,7 +25,8 @@ public:
 	// Constructor - initialise all settings, sensible defaults provided for everything.
 	Camera(CVector3 position = {0,0,0}, CVector3 rotation = {0,0,0}, 
            float fov = PI/3, float aspectRatio = 4.0f / 3.0f, float nearClip = 0.1f, float farClip = 10000.0f)
-        : mPosition(position), mRotation(rotation), mFOVx(fov), mAspectRatio(aspectRatio), mNearClip(nearClip), mFarClip(farClip)
+        : mTransform(position, QuaternionFromEulerAngles(rotation)), mFOVx(fov), mAspectRatio(aspectRatio), mNearClip(nearClip), mFarClip(farClip),
+          mMatricesDirty(true)
     {
     }
 
@@ -38,24 +41,29 @@ public:
 	//-------------------------------------
 
 	// Getters / setters
-	CVector3 Position()  { return mPosition; }
-	CVector3 Rotation()  { return mRotation;	}
-	void SetPosition(CVector3 position)  { mPosition = position; }
-	void SetRotation(CVector3 rotation)  { mRotation = rotation; }
+	CVector3 Position()  { return mTransform.position; }
+	CVector3 Rotation()  { return GetEulerAngles(mTransform.rotation); } // Rotation is stored as a quaternion, convert to Euler angles
+	void SetPosition(CVector3 position)  { mTransform.position = position; mMatricesDirty = true; }
+	void SetRotation(CVector3 rotation)  { mTransform.rotation = QuaternionFromEulerAngles(rotation); mMatricesDirty = true; }
 
 	float FOV()       { return mFOVx;     }
 	float NearClip()  { return mNearClip; }
 	float FarClip()   { return mFarClip;  }
 
-	void SetFOV     (float fov     )  { mFOVx     = fov;      }
-	void SetNearClip(float nearClip)  { mNearClip = nearClip; }
-	void SetFarClip (float farClip )  { mFarClip  = farClip;  }
+	void SetFOV     (float fov     )  { mFOVx     = fov;      mMatricesDirty = true; }
+	void SetNearClip(float nearClip)  { mNearClip = nearClip; mMatricesDirty = true; }
+	void SetFarClip (float farClip )  { mFarClip  = farClip;  mMatricesDirty = true; }
 
 	// Read only access to camera matrices, updated on request from position, rotation and camera settings
+	// Matrices are only rebuilt if something has changed since they were last requested
 	CMatrix4x4 ViewMatrix()            { UpdateMatrices(); return mViewMatrix;           }
 	CMatrix4x4 ProjectionMatrix()      { UpdateMatrices(); return mProjectionMatrix;     }
 	CMatrix4x4 ViewProjectionMatrix()  { UpdateMatrices(); return mViewProjectionMatrix; }
 
+	// Return the world point under the given pixel (0,0 is top-left) at the given depth (0 = near clip, 1 = far clip)
+	// Use depths 0 and 1 to get a ray from the camera through the pixel, e.g. for picking
+	CVector3 WorldPointFromPixel(CVector2 pixel, float depth, CVector2 viewportSize);
+
 	
 //-------------------------------------
 // Private members
@@ -64,9 +72,8 @@ private:
 	// Update the matrices used for the camera in the rendering pipeline
 	void UpdateMatrices();
 
-	// Postition and rotations for the camera (rarely scale cameras)
-	CVector3 mPosition;
-	CVector3 mRotation;
+	// Postition and rotation for the camera (rarely scale cameras so scale is left at 1)
+	CTransform mTransform;
 
 	// Camera settings: field of view, aspect ratio, near and far clip plane distances.
 	// Note that the FOVx angle is measured in radians (radians = degrees * PI/180) from left to right of screen
@@ -76,12 +83,15 @@ private:
 	float mFarClip;
 
 	// Current view, projection and combined view-projection matrices (DirectX matrix type)
-	CMatrix4x4 mWorldMatrix; // Easiest to treat the camera like a model and give it a "world" matrix...
+	CAffine3x4 mWorldMatrix; // Easiest to treat the camera like a model and give it a "world" matrix...
 	CMatrix4x4 mViewMatrix;  // ...then the view matrix used in the shaders is the inverse of its world matrix
 
 	CMatrix4x4 mProjectionMatrix;     // Projection matrix holds the field of view and near/far clip distances
 	CMatrix4x4 mViewProjectionMatrix; // Combine (multiply) the view and projection matrices together, which
 	                                  // can sometimes save a matrix multiply in the shader (optional)
+
+	// Set whenever the transform or camera settings change, so UpdateMatrices knows the matrices above are out of date
+	bool mMatricesDirty;
 };
 
 
@@ -11,6 +11,7 @@
 
 #include "CVector3.h"
 #include "CMatrix4x4.h"
+#include "CAffine3x4.h"
 
 
 //--------------------------------------------------------------------------------------
@@ -91,9 +92,17 @@ static const int MAX_BONES = 64;
 struct PerModelConstants
 {
     CMatrix4x4 worldMatrix;
+    CAffine3x4 normalMatrix; // Inverse transpose of world matrix, to transform normals correctly when there is non-uniform scaling
     CVector3   objectColour; // Allows each light model to be tinted to match the light colour they cast
     float      padding6;
-    CMatrix4x4 boneMatrices[/*** MISSING - fill in this array size - easy. Relates to another MISSING*/];
+
+    // Decoding of compact vertices (see VertexPacking.h in the engine core), set by Mesh::Render
+    CVector3   positionScale;
+    uint32_t   compactNormals; // Non-zero if normals are octahedral encoded
+    CVector3   positionBias;
+    float      padding7;
+    // Bone matrices are affine so are sent as 3x4 matrices (48 bytes each rather than 64), see CAffine3x4.h
+    CAffine3x4 boneMatrices[/*** MISSING - fill in this array size - easy. Relates to another MISSING*/];
 };
 extern PerModelConstants gPerModelConstants;      // This variable holds the CPU-side constant buffer described above
 extern ID3D11Buffer*     gPerModelConstantBuffer; // This variable controls the GPU-side constant buffer related to the above structure
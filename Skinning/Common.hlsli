@@ -106,9 +106,50 @@ static const int MAX_BONES = //*** MISSING - what is the maximum number of bones
 cbuffer PerModelConstants : register(b1) // The b1 gives this constant buffer the number 1 - used in the C++ code
 {
     float4x4 gWorldMatrix;
+    row_major float3x4 gNormalMatrix; // Inverse transpose of world matrix (3x4 like the bone matrices below), for transforming normals
 
     float3   gObjectColour;
     float    padding6;  // See notes on padding in structure above
 
-    float4x4 gBoneMatrices[MAX_BONES];
+    // Decoding of compact vertices, see the functions below
+    float3   gPositionScale;
+    uint     gCompactNormals;
+    float3   gPositionBias;
+    float    padding7;
+
+    // Bone matrices are affine so C++ sends them as 3x4 matrices (CAffine3x4), saving a quarter of the space. Each one
+    // is three float4s holding the columns of the usual 4x4 matrix, which is a row_major float3x4 here
+    row_major float3x4 gBoneMatrices[MAX_BONES];
+}
+
+
+// Meshes can store their vertices in compact formats (see VertexPacking.h in the engine core). UVs and weights are
+// converted back to floats as the GPU reads them, but positions and normals need decoding. The same shaders are used
+// for full precision meshes, which have a position scale of 1, bias of 0 and no compact normals so are unchanged
+
+// Positions can be 16-bit values from 0 to 1 across the mesh's bounding box
+float3 DecodePosition(float3 position)
+{
+    return position * gPositionScale + gPositionBias;
+}
+
+// Normals and tangents can be octahedral encoded in two 16-bit values (read with z = 0). This unfolds the square
+// back onto the octahedron and normalises to get to the sphere
+float3 DecodeNormal(float3 normal)
+{
+    if (gCompactNormals)
+    {
+        normal.z = 1 - abs(normal.x) - abs(normal.y);
+        float t = saturate(-normal.z);
+        normal.xy += (normal.xy >= 0) ? -t : t;
+        normal = normalize(normal);
+    }
+    return normal;
+}
+
+
+// Transform a position (w = 1) or vector (w = 0) by a bone matrix. The missing row of the 3x4 matrix is 0,0,0,1 so w is unchanged
+float4 BoneTransform(uint bone, float4 v)
+{
+    return float4(mul(gBoneMatrices[bone], v), v.w);
 }
@@ -0,0 +1,319 @@
+//--------------------------------------------------------------------------------------
+// Geometry arena - shared GPU vertex and index buffers for all meshes
+//--------------------------------------------------------------------------------------
+
+#include "GeometryArena.h"
+#include "InputLayoutCache.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+
+
+GeometryArena gGeometryArena;
+
+// Smallest buffer created for a pool, in vertices or indices. Buffers double in size when full
+const uint32_t MIN_POOL_CAPACITY = 64 * 1024;
+
+
+void GeometryArena::Release()
+{
+    for (auto& pool : mPools)  ReleaseBuffers(*pool);
+    mPools.clear();
+    mGeometry.clear();
+    mFreeHandles.clear();
+    mBoundPool = NO_POOL;
+}
+
+
+// Direct3D description of a vertex element from the device-independent mesh data. The semantic names
+// must match those used in the vertex shaders
+static D3D11_INPUT_ELEMENT_DESC ToD3DElement(const VertexElement& element)
+{
+    static const char* semanticNames[] = { "position", "normal", "tangent", "uv", "bones", "weights", "colour" };
+    static const DXGI_FORMAT formats[] = { DXGI_FORMAT_R32G32_FLOAT, DXGI_FORMAT_R32G32B32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R8G8B8A8_UINT,
+                                           DXGI_FORMAT_R16G16B16A16_UNORM, DXGI_FORMAT_R16G16_SNORM, DXGI_FORMAT_R16G16_FLOAT, DXGI_FORMAT_R8G8B8A8_UNORM };
+    return { semanticNames[static_cast<int>(element.semantic)], 0, formats[static_cast<int>(element.format)], 0,
+             element.offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+}
+
+static bool operator==(const VertexElement& a, const VertexElement& b)
+{
+    return a.semantic == b.semantic && a.format == b.format && a.offset == b.offset;
+}
+
+
+//--------------------------------------------------------------------------------------
+
+GeometryArena::Handle GeometryArena::Add(const SubMeshData& subMesh)
+{
+    uint32_t poolIndex = FindPool(subMesh);
+    Pool& pool = *mPools[poolIndex];
+
+    // Lay out the index block: full detail indices then each distinct LOD's indices
+    Geometry geometry;
+    geometry.pool = poolIndex;
+    geometry.range.numVertices = subMesh.numVertices;
+    geometry.range.numIndices  = subMesh.numIndices;
+    geometry.range.numLODs     = static_cast<uint32_t>(std::min<size_t>(subMesh.lods.size(), MAX_MESH_LODS));
+    geometry.range.allIndices  = subMesh.numIndices;
+    for (uint32_t l = 0; l < geometry.range.numLODs; ++l)
+    {
+        geometry.range.lodIndices[l] = subMesh.lods[l].numIndices;
+        if (l > 0 && subMesh.lods[l].indices == subMesh.lods[l - 1].indices)
+        {
+            geometry.range.lodOffsets[l] = geometry.range.lodOffsets[l - 1];
+            continue;
+        }
+        geometry.range.lodOffsets[l] = geometry.range.allIndices;
+        geometry.range.allIndices += subMesh.lods[l].numIndices;
+    }
+
+    // Copy the vertices and indices into the pool's buffers. Empty sub-meshes take no space
+    if (subMesh.numVertices > 0)
+    {
+        geometry.range.baseVertex = Allocate(pool.vertexBuffer, pool.vertices, subMesh.numVertices, pool.vertexSize, D3D11_BIND_VERTEX_BUFFER);
+        D3D11_BOX box = { geometry.range.baseVertex * pool.vertexSize, 0, 0, (geometry.range.baseVertex + subMesh.numVertices) * pool.vertexSize, 1, 1 };
+        gD3DContext->UpdateSubresource(pool.vertexBuffer, 0, &box, subMesh.vertices, 0, 0);
+    }
+    if (geometry.range.allIndices > 0)
+    {
+        uint32_t indexSize = IndexFormatSize(pool.indexFormat);
+        geometry.range.startIndex = Allocate(pool.indexBuffer, pool.indices, geometry.range.allIndices, indexSize, D3D11_BIND_INDEX_BUFFER);
+        auto upload = [&](uint32_t offset, uint32_t count, const void* indices)
+        {
+            if (count == 0)  return;
+            D3D11_BOX box = { (geometry.range.startIndex + offset) * indexSize, 0, 0, (geometry.range.startIndex + offset + count) * indexSize, 1, 1 };
+            gD3DContext->UpdateSubresource(pool.indexBuffer, 0, &box, indices, 0, 0);
+        };
+        upload(0, subMesh.numIndices, subMesh.indices);
+        for (uint32_t l = 0; l < geometry.range.numLODs; ++l)
+        {
+            if (l == 0 || subMesh.lods[l].indices != subMesh.lods[l - 1].indices)
+            {
+                upload(geometry.range.lodOffsets[l], subMesh.lods[l].numIndices, subMesh.lods[l].indices);
+            }
+        }
+    }
+    ++pool.numGeometry;
+
+    Handle handle;
+    if (!mFreeHandles.empty())
+    {
+        handle = mFreeHandles.back();
+        mFreeHandles.pop_back();
+        mGeometry[handle] = geometry;
+    }
+    else
+    {
+        handle = static_cast<Handle>(mGeometry.size());
+        mGeometry.push_back(geometry);
+    }
+    return handle;
+}
+
+
+void GeometryArena::Remove(const Handle* handles, uint32_t count)
+{
+    // Free every range first, noting which pools lost geometry
+    std::vector<uint32_t> changedPools;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        Handle handle = handles[i];
+        if (handle >= mGeometry.size() || mGeometry[handle].pool == NO_POOL)  continue;
+        Geometry& geometry = mGeometry[handle];
+        Pool& pool = *mPools[geometry.pool];
+
+        if (geometry.range.numVertices > 0)  pool.vertices.Free(geometry.range.baseVertex);
+        if (geometry.range.allIndices  > 0)  pool.indices .Free(geometry.range.startIndex);
+        --pool.numGeometry;
+        if (std::find(changedPools.begin(), changedPools.end(), geometry.pool) == changedPools.end())  changedPools.push_back(geometry.pool);
+
+        geometry.pool = NO_POOL;
+        mFreeHandles.push_back(handle);
+    }
+
+    // An empty pool gives its memory back, otherwise close the gaps left by the removed geometry in one pass
+    for (uint32_t poolIndex : changedPools)
+    {
+        Pool& pool = *mPools[poolIndex];
+        if (pool.numGeometry == 0)
+        {
+            ReleaseBuffers(pool);
+            if (mBoundPool == poolIndex)  mBoundPool = NO_POOL;
+        }
+        else
+        {
+            Defragment(poolIndex);
+        }
+    }
+}
+
+
+const GeometryArena::Range& GeometryArena::Bind(Handle handle)
+{
+    const Geometry& geometry = mGeometry[handle];
+    if (geometry.pool == mBoundPool)
+    {
+        mBindCallsAvoided += 4;
+        return geometry.range;
+    }
+
+    const Pool& pool = *mPools[geometry.pool];
+    UINT stride = pool.vertexSize;
+    UINT offset = 0;
+    gD3DContext->IASetVertexBuffers(0, 1, &pool.vertexBuffer, &stride, &offset);
+    gD3DContext->IASetInputLayout(pool.inputLayout);
+    gD3DContext->IASetIndexBuffer(pool.indexBuffer, (pool.indexFormat == IndexFormat::UInt16) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT, 0);
+    gD3DContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST); // Using triangle lists only
+    mBindCalls += 4;
+
+    mBoundPool = geometry.pool;
+    return geometry.range;
+}
+
+
+GeometryArena::Stats GeometryArena::GetStats() const
+{
+    Stats stats;
+    for (auto& pool : mPools)
+    {
+        if (pool->vertexBuffer == nullptr && pool->indexBuffer == nullptr)  continue;
+        ++stats.numPools;
+        stats.numGeometry += pool->numGeometry;
+        uint32_t indexSize = IndexFormatSize(pool->indexFormat);
+        stats.bytesUsed   += uint64_t(pool->vertices.Used()) * pool->vertexSize + uint64_t(pool->indices.Used()) * indexSize;
+        stats.bytesWasted += uint64_t(pool->vertices.Capacity() - pool->vertices.Used()) * pool->vertexSize +
+                             uint64_t(pool->indices .Capacity() - pool->indices .Used()) * indexSize;
+        stats.indexBytesSaved += uint64_t(pool->indices.Used()) * (sizeof(uint32_t) - indexSize);
+    }
+    stats.bindCalls        = mBindCalls;
+    stats.bindCallsAvoided = mBindCallsAvoided;
+    stats.numDefragments   = mNumDefragments;
+    stats.bytesMoved       = mBytesMoved;
+    return stats;
+}
+
+
+//--------------------------------------------------------------------------------------
+// Private helper functions
+//--------------------------------------------------------------------------------------
+
+uint32_t GeometryArena::FindPool(const SubMeshData& subMesh)
+{
+    for (uint32_t p = 0; p < mPools.size(); ++p)
+    {
+        if (mPools[p]->vertexSize == subMesh.vertexSize && mPools[p]->layout == subMesh.layout &&
+            mPools[p]->indexFormat == subMesh.indexFormat)  return p;
+    }
+
+    // New vertex layout, get the input layout to describe to DirectX what is in each vertex - shared with any other
+    // pool using the same layout (see InputLayoutCache.h). The buffers are created when the first geometry is allocated
+    std::unique_ptr<Pool> pool(new Pool);
+    pool->layout = subMesh.layout;
+    pool->indexFormat = subMesh.indexFormat;
+    pool->vertexSize = subMesh.vertexSize;
+
+    std::vector<D3D11_INPUT_ELEMENT_DESC> vertexElements;
+    for (auto& element : subMesh.layout)  vertexElements.push_back(ToD3DElement(element));
+
+    pool->inputLayout = GetInputLayout(vertexElements.data(), static_cast<int>(vertexElements.size()));
+    if (pool->inputLayout == nullptr)  throw std::runtime_error("Failure creating input layout for geometry arena");
+
+    mPools.push_back(std::move(pool));
+    return static_cast<uint32_t>(mPools.size() - 1);
+}
+
+
+uint32_t GeometryArena::Allocate(ID3D11Buffer*& buffer, RangeAllocator& ranges, uint32_t size, uint32_t elementSize, UINT bindFlags)
+{
+    uint32_t start = ranges.Allocate(size);
+    if (start != RangeAllocator::INVALID_RANGE)  return start;
+
+    // No space - create a larger buffer and copy the existing contents into it
+    uint32_t oldCapacity = ranges.Capacity();
+    uint32_t newCapacity = std::max({ oldCapacity * 2, oldCapacity + size, MIN_POOL_CAPACITY });
+
+    D3D11_BUFFER_DESC bufferDesc;
+    bufferDesc.BindFlags = bindFlags;
+    bufferDesc.Usage = D3D11_USAGE_DEFAULT; // Filled with UpdateSubresource and CopySubresourceRegion
+    bufferDesc.ByteWidth = newCapacity * elementSize;
+    bufferDesc.CPUAccessFlags = 0;
+    bufferDesc.MiscFlags = 0;
+    bufferDesc.StructureByteStride = 0;
+    ID3D11Buffer* newBuffer;
+    if (FAILED(gD3DDevice->CreateBuffer(&bufferDesc, nullptr, &newBuffer)))
+    {
+        throw std::runtime_error("Failure creating geometry arena buffer");
+    }
+
+    if (buffer != nullptr)
+    {
+        D3D11_BOX box = { 0, 0, 0, oldCapacity * elementSize, 1, 1 };
+        gD3DContext->CopySubresourceRegion(newBuffer, 0, 0, 0, 0, buffer, 0, &box);
+        mBytesMoved += box.right;
+        buffer->Release();
+    }
+    buffer = newBuffer;
+    mBoundPool = NO_POOL;
+
+    ranges.Grow(newCapacity);
+    return ranges.Allocate(size);
+}
+
+
+void GeometryArena::Defragment(uint32_t poolIndex)
+{
+    Pool& pool = *mPools[poolIndex];
+
+    // Copy every range, moved or not, into a new buffer of the same size. A copy within one buffer is not allowed
+    // to overlap, which moving ranges towards the start often would
+    auto repack = [&](ID3D11Buffer*& buffer, RangeAllocator& ranges, uint32_t elementSize, uint32_t Range::* start, uint32_t Range::* count)
+    {
+        auto moves = ranges.Defragment();
+        if (moves.empty())  return;
+
+        std::unordered_map<uint32_t, uint32_t> newStarts;
+        for (auto& move : moves)  newStarts[move.from] = move.to;
+
+        D3D11_BUFFER_DESC bufferDesc;
+        buffer->GetDesc(&bufferDesc);
+        ID3D11Buffer* newBuffer;
+        if (FAILED(gD3DDevice->CreateBuffer(&bufferDesc, nullptr, &newBuffer)))
+        {
+            throw std::runtime_error("Failure creating geometry arena buffer");
+        }
+
+        for (auto& geometry : mGeometry)
+        {
+            if (geometry.pool != poolIndex || geometry.range.*count == 0)  continue;
+
+            uint32_t oldStart = geometry.range.*start;
+            auto moved = newStarts.find(oldStart);
+            if (moved != newStarts.end())  geometry.range.*start = moved->second;
+
+            D3D11_BOX box = { oldStart * elementSize, 0, 0, (oldStart + geometry.range.*count) * elementSize, 1, 1 };
+            gD3DContext->CopySubresourceRegion(newBuffer, 0, geometry.range.*start * elementSize, 0, 0, buffer, 0, &box);
+            mBytesMoved += box.right - box.left;
+        }
+        buffer->Release();
+        buffer = newBuffer;
+        mBoundPool = NO_POOL;
+    };
+    uint64_t movedBefore = mBytesMoved;
+    repack(pool.vertexBuffer, pool.vertices, pool.vertexSize,  &Range::baseVertex, &Range::numVertices);
+    repack(pool.indexBuffer,  pool.indices,  IndexFormatSize(pool.indexFormat), &Range::startIndex, &Range::allIndices);
+    if (mBytesMoved != movedBefore)  ++mNumDefragments;
+}
+
+
+void GeometryArena::ReleaseBuffers(Pool& pool)
+{
+    if (pool.indexBuffer)   pool.indexBuffer ->Release();
+    if (pool.vertexBuffer)  pool.vertexBuffer->Release();
+    pool.indexBuffer  = nullptr;
+    pool.vertexBuffer = nullptr;
+    pool.vertices = RangeAllocator();
+    pool.indices  = RangeAllocator();
+    pool.numGeometry = 0;
+}
@@ -0,0 +1,161 @@
+//--------------------------------------------------------------------------------------
+// Geometry arena - shared GPU vertex and index buffers for all meshes
+//--------------------------------------------------------------------------------------
+// Rather than a vertex and index buffer for every sub-mesh, sub-meshes with the same vertex layout and index format
+// (16 or 32-bit) share one large vertex buffer, index buffer and input layout (a "pool"). Each sub-mesh is addressed by its base vertex and start
+// index within those buffers, so consecutive sub-meshes of the same format are drawn without changing any input
+// assembler state. Ranges within the buffers are handed out by a RangeAllocator (see RangeAllocator.h), buffers
+// grow as needed, and removing geometry defragments its pool so the free space stays in one piece. Remove all of
+// a mesh's sub-meshes in one call so each pool is defragmented once rather than once per sub-mesh.
+// A sub-mesh's simplified LODs (see MeshSimplify.h) use its vertices, their indices are stored straight after its
+// own indices so the whole chain is allocated, moved and freed as one block.
+
+#ifndef _GEOMETRY_ARENA_H_INCLUDED_
+#define _GEOMETRY_ARENA_H_INCLUDED_
+
+#include "Common.h"
+#include "MeshData.h"
+#include "RangeAllocator.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class GeometryArena
+{
+public:
+    // Identifies geometry added to the arena. Stays the same when the geometry is moved by defragmentation
+    typedef uint32_t Handle;
+
+    // Where some geometry currently is in its pool's buffers, the parameters for DrawIndexed
+    struct Range
+    {
+        uint32_t baseVertex  = 0;
+        uint32_t numVertices = 0;
+        uint32_t startIndex  = 0;
+        uint32_t numIndices  = 0; // Full detail
+
+        // Simplified LODs, drawn with lodIndices[i] indices from startIndex + lodOffsets[i]. LODs that are the
+        // same as the one before share its indices
+        uint32_t numLODs = 0;
+        uint32_t lodOffsets[MAX_MESH_LODS] = {};
+        uint32_t lodIndices[MAX_MESH_LODS] = {};
+
+        uint32_t allIndices = 0; // Size of the whole index block - full detail and all LODs
+    };
+
+    // Memory and binding counters
+    struct Stats
+    {
+        uint64_t bytesUsed = 0;        // Vertices and indices in use
+        uint64_t bytesWasted = 0;      // Buffer space not in use (free gaps and unused space at the end)
+        uint64_t indexBytesSaved = 0;  // By using 16-bit indices rather than 32-bit
+        uint32_t numPools = 0;         // Vertex formats with buffers (each has a vertex and an index buffer)
+        uint32_t numGeometry = 0;
+        uint64_t bindCalls = 0;        // Input assembler calls made by Bind
+        uint64_t bindCallsAvoided = 0; // Input assembler calls skipped because the pool was already bound
+        uint32_t numDefragments = 0;
+        uint64_t bytesMoved = 0;       // Copied on the GPU by defragmentation and buffer growth
+    };
+
+
+    GeometryArena() {}
+    ~GeometryArena()  { Release(); }
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+
+    // Copy a sub-mesh's vertices and indices into the buffers of the pool for its vertex layout, creating the pool
+    // or growing its buffers if needed. Will throw a std::runtime_error exception on failure
+    Handle Add(const SubMeshData& subMesh);
+
+    // Remove geometry from the arena and defragment its pool. Handles of other geometry stay valid but their
+    // ranges may change. A pool with no geometry left releases its buffers
+    void Remove(Handle geometry)  { Remove(&geometry, 1); }
+
+    // Remove several pieces of geometry (e.g. all the sub-meshes of a mesh), then defragment each pool they were in once
+    void Remove(const Handle* geometry, uint32_t count);
+
+    // Release all GPU buffers, call before the device is released. All geometry should have been removed first
+    void Release();
+
+
+    // Set the input assembler to draw the given geometry (vertex buffer, index buffer, input layout and topology)
+    // and return its range to pass to DrawIndexed. Nothing is set if the geometry's pool is already bound
+    const Range& Bind(Handle geometry);
+
+    // Forget which pool is bound, call after any other code has changed the input assembler state
+    void ResetBindings()  { mBoundPool = NO_POOL; }
+
+
+    Stats GetStats() const;
+
+
+//--------------------------------------------------------------------------------------
+// Private data structures
+//--------------------------------------------------------------------------------------
+private:
+    static const uint32_t NO_POOL = ~0u;
+
+    // Buffers shared by all geometry with one vertex layout and index format
+    struct Pool
+    {
+        std::vector<VertexElement> layout;
+        uint32_t                   vertexSize = 0;
+        IndexFormat                indexFormat = IndexFormat::UInt32;
+        ID3D11InputLayout*         inputLayout = nullptr; // Owned by the input layout cache
+
+        ID3D11Buffer*  vertexBuffer = nullptr;
+        RangeAllocator vertices;     // Allocated in vertices
+        ID3D11Buffer*  indexBuffer = nullptr;
+        RangeAllocator indices;      // Allocated in indices
+
+        uint32_t numGeometry = 0;
+    };
+
+    struct Geometry
+    {
+        uint32_t pool = NO_POOL; // NO_POOL for unused handles
+        Range    range;
+    };
+
+
+//--------------------------------------------------------------------------------------
+// Private helper functions
+//--------------------------------------------------------------------------------------
+private:
+    // Return the index of the pool for the sub-mesh's vertex layout and index format, creating it if needed
+    uint32_t FindPool(const SubMeshData& subMesh);
+
+    // Allocate a range in one of a pool's buffers, growing the buffer if there is no space. Returns the start
+    uint32_t Allocate(ID3D11Buffer*& buffer, RangeAllocator& ranges, uint32_t size, uint32_t elementSize, UINT bindFlags);
+
+    // Pack a pool's geometry to the start of its buffers, copying the data into new buffers
+    void Defragment(uint32_t poolIndex);
+
+    // Release a pool's buffers and reset it to empty. The pool is kept in case its layout is used again
+    void ReleaseBuffers(Pool& pool);
+
+
+//--------------------------------------------------------------------------------------
+// Member data
+//--------------------------------------------------------------------------------------
+private:
+    std::vector<std::unique_ptr<Pool>> mPools; // Pools that become empty are kept for reuse by the same layout
+    std::vector<Geometry>              mGeometry; // Indexed by handle
+    std::vector<Handle>                mFreeHandles;
+
+    uint32_t mBoundPool = NO_POOL;
+
+    uint64_t mBindCalls = 0;
+    uint64_t mBindCallsAvoided = 0;
+    uint32_t mNumDefragments = 0;
+    uint64_t mBytesMoved = 0;
+};
+
+
+// All meshes share one arena (see Mesh.cpp)
+extern GeometryArena gGeometryArena;
+
+
+#endif //_GEOMETRY_ARENA_H_INCLUDED_
@@ -0,0 +1,161 @@
+//--------------------------------------------------------------------------------------
+// Input layout cache - shares input layouts between everything with the same vertex elements
+//--------------------------------------------------------------------------------------
+
+#include "InputLayoutCache.h"
+#include "Shader.h" // Needed for helper function CreateSignatureForVertexLayout
+#include "Hash.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+//--------------------------------------------------------------------------------------
+// Global Variables
+//--------------------------------------------------------------------------------------
+
+// Precompiled signatures, indexed by which optional elements they have (see SignatureIndex)
+const int NUM_LAYOUT_SIGNATURES = 8;
+std::vector<char> gLayoutSignatures[NUM_LAYOUT_SIGNATURES];
+
+std::unordered_map<uint64_t, ID3D11InputLayout*> gInputLayouts; // Keyed by LayoutHash
+InputLayoutCacheStats gInputLayoutStats;
+
+
+//--------------------------------------------------------------------------------------
+// Helper functions
+//--------------------------------------------------------------------------------------
+
+// Hash of everything in a vertex layout, including the text of the semantic names
+static uint64_t LayoutHash(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements)
+{
+    uint64_t hash = HashValue(numElements);
+    for (int elt = 0; elt < numElements; ++elt)
+    {
+        const D3D11_INPUT_ELEMENT_DESC& element = vertexLayout[elt];
+        hash = HashBytes(element.SemanticName, std::strlen(element.SemanticName) + 1, hash); // Include the null so names don't run together
+        hash = HashValue(element.SemanticIndex, hash);
+        hash = HashValue(element.Format, hash);
+        hash = HashValue(element.InputSlot, hash);
+        hash = HashValue(element.AlignedByteOffset, hash);
+        hash = HashValue(element.InputSlotClass, hash);
+        hash = HashValue(element.InstanceDataStepRate, hash);
+    }
+    return hash;
+}
+
+
+// Return the index of the precompiled signature for a vertex layout, or -1 if it is not one of the layouts the mesh
+// loader produces. Bit 0 is set for a tangent, bit 1 for uvs and bit 2 for bones and weights, matching the numbers
+// of the LayoutSignature*_vs.hlsl files. The order and formats of the elements don't affect the signature
+static int SignatureIndex(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements)
+{
+    static const char* semanticNames[] = { "position", "normal", "tangent", "uv", "bones", "weights" };
+    enum { Position, Normal, Tangent, UV, Bones, Weights, NumSemantics };
+
+    unsigned int found = 0; // Bit for each semantic
+    for (int elt = 0; elt < numElements; ++elt)
+    {
+        const D3D11_INPUT_ELEMENT_DESC& element = vertexLayout[elt];
+        int semantic = 0;
+        while (semantic < NumSemantics && std::strcmp(element.SemanticName, semanticNames[semantic]) != 0)  ++semantic;
+        if (semantic == NumSemantics || element.SemanticIndex != 0 || (found & (1 << semantic)) != 0)  return -1;
+
+        // Bone indices are read as integers, everything else as floats
+        bool isInteger = (element.Format == DXGI_FORMAT_R8G8B8A8_UINT);
+        if (isInteger != (semantic == Bones))  return -1;
+
+        found |= 1 << semantic;
+    }
+    auto has = [&](int semantic) { return (found & (1 << semantic)) != 0; };
+    if (!has(Position) || !has(Normal) || has(Bones) != has(Weights))  return -1; // Bones and weights go together
+
+    return (has(Tangent) ? 1 : 0) | (has(UV) ? 2 : 0) | (has(Bones) ? 4 : 0);
+}
+
+
+//--------------------------------------------------------------------------------------
+// Input layout cache
+//--------------------------------------------------------------------------------------
+
+// Load the precompiled signatures, call when loading shaders
+bool LoadLayoutSignatures()
+{
+    bool allLoaded = true;
+    for (int i = 0; i < NUM_LAYOUT_SIGNATURES; ++i)
+    {
+        // Compiled shader object files are read in the same way as in LoadVertexShader
+        std::ifstream signatureFile("LayoutSignature" + std::to_string(i) + "_vs.cso", std::ios::in | std::ios::binary | std::ios::ate);
+        if (!signatureFile.is_open())
+        {
+            allLoaded = false;
+            continue;
+        }
+        std::streamoff fileSize = signatureFile.tellg();
+        gLayoutSignatures[i].resize(static_cast<size_t>(fileSize));
+        signatureFile.seekg(0, std::ios::beg);
+        signatureFile.read(gLayoutSignatures[i].data(), fileSize);
+        if (signatureFile.fail())
+        {
+            gLayoutSignatures[i].clear();
+            allLoaded = false;
+        }
+    }
+    return allLoaded;
+}
+
+
+// Return an input layout for the given vertex elements, creating it if there is not one already
+ID3D11InputLayout* GetInputLayout(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements)
+{
+    uint64_t key = LayoutHash(vertexLayout, numElements);
+    auto existing = gInputLayouts.find(key);
+    if (existing != gInputLayouts.end())
+    {
+        ++gInputLayoutStats.hits;
+        return existing->second;
+    }
+
+    // Use a precompiled signature if there is one for this layout, otherwise compile one
+    ID3D11InputLayout* inputLayout = nullptr;
+    HRESULT hr;
+    int signature = SignatureIndex(vertexLayout, numElements);
+    if (signature >= 0 && !gLayoutSignatures[signature].empty())
+    {
+        hr = gD3DDevice->CreateInputLayout(vertexLayout, static_cast<UINT>(numElements),
+                                           gLayoutSignatures[signature].data(), gLayoutSignatures[signature].size(), &inputLayout);
+    }
+    else
+    {
+        auto shaderSignature = CreateSignatureForVertexLayout(vertexLayout, numElements);
+        if (shaderSignature == nullptr)  return nullptr;
+        ++gInputLayoutStats.runtimeCompiles;
+
+        hr = gD3DDevice->CreateInputLayout(vertexLayout, static_cast<UINT>(numElements),
+                                           shaderSignature->GetBufferPointer(), shaderSignature->GetBufferSize(), &inputLayout);
+        shaderSignature->Release();
+    }
+    if (FAILED(hr))  return nullptr;
+
+    gInputLayouts[key] = inputLayout;
+    ++gInputLayoutStats.numLayouts;
+    return inputLayout;
+}
+
+
+// Release all the input layouts and signatures
+void ReleaseInputLayouts()
+{
+    for (auto& inputLayout : gInputLayouts)  inputLayout.second->Release();
+    gInputLayouts.clear();
+    for (auto& signature : gLayoutSignatures)  signature.clear();
+}
+
+
+InputLayoutCacheStats GetInputLayoutCacheStats()
+{
+    return gInputLayoutStats;
+}
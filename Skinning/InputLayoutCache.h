@@ -0,0 +1,36 @@
+//--------------------------------------------------------------------------------------
+// Input layout cache - shares input layouts between everything with the same vertex elements
+//--------------------------------------------------------------------------------------
+// Input layouts are looked up by a hash of their D3D11_INPUT_ELEMENT_DESC array, so each distinct layout is
+// only created once however many meshes use it. Creating a layout needs a matching shader signature: the
+// layouts the mesh loader produces use the precompiled signatures in LayoutSignature*_vs.hlsl, any other layout
+// falls back to compiling one at runtime with CreateSignatureForVertexLayout (see Shader.h)
+
+#ifndef _INPUT_LAYOUT_CACHE_H_INCLUDED_
+#define _INPUT_LAYOUT_CACHE_H_INCLUDED_
+
+#include "Common.h"
+
+// Load the precompiled signatures, call when loading shaders. Returns false if any are missing, which is not
+// fatal - layouts needing them will compile their signature at runtime instead
+bool LoadLayoutSignatures();
+
+// Return an input layout for the given vertex elements, creating it if there is not one already. The cache owns
+// the layout, do not release it. Returns nullptr on failure
+ID3D11InputLayout* GetInputLayout(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements);
+
+// Release all the input layouts and signatures, call when releasing shaders
+void ReleaseInputLayouts();
+
+
+// Counters for checking the cache is doing its job
+struct InputLayoutCacheStats
+{
+    unsigned int numLayouts = 0;         // Distinct layouts created
+    unsigned int hits = 0;               // GetInputLayout calls that returned an existing layout
+    unsigned int runtimeCompiles = 0;    // Layouts that needed a signature compiling (no precompiled signature)
+};
+InputLayoutCacheStats GetInputLayoutCacheStats();
+
+
+#endif //_INPUT_LAYOUT_CACHE_H_INCLUDED_
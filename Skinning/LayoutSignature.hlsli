@@ -0,0 +1,26 @@
+//--------------------------------------------------------------------------------------
+// Vertex layout signatures
+//--------------------------------------------------------------------------------------
+// Creating an input layout needs the signature of a vertex shader that reads exactly the elements in the layout.
+// The mesh loader only produces a few layouts - position and normal, then optionally tangent, uv, and bones with
+// weights - so there is a LayoutSignature*_vs.hlsl file for each combination, each including this file with the
+// optional elements it has defined. They are compiled with the other shaders and loaded by LoadLayoutSignatures
+// (see InputLayoutCache.h), so no shader needs compiling when a mesh is loaded. These shaders are never used for
+// rendering. Compact vertex formats (see VertexPacking.h) are still read as floats so they share these signatures
+
+float4 main(float3 position : position,
+            float3 normal   : normal
+#ifdef HAS_TANGENT
+          , float3 tangent  : tangent
+#endif
+#ifdef HAS_UV
+          , float2 uv       : uv
+#endif
+#ifdef HAS_BONES
+          , uint4  bones    : bones
+          , float4 weights  : weights
+#endif
+           ) : SV_Position
+{
+    return 0;
+}
@@ -0,0 +1,2 @@
+// Input layout signature: position, normal (see LayoutSignature.hlsli)
+#include "LayoutSignature.hlsli"
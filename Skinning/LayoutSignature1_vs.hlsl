@@ -0,0 +1,3 @@
+// Input layout signature: position, normal, tangent (see LayoutSignature.hlsli)
+#define HAS_TANGENT
+#include "LayoutSignature.hlsli"
@@ -0,0 +1,3 @@
+// Input layout signature: position, normal, uv (see LayoutSignature.hlsli)
+#define HAS_UV
+#include "LayoutSignature.hlsli"
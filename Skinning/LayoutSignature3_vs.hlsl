@@ -0,0 +1,4 @@
+// Input layout signature: position, normal, tangent, uv (see LayoutSignature.hlsli)
+#define HAS_TANGENT
+#define HAS_UV
+#include "LayoutSignature.hlsli"
@@ -0,0 +1,3 @@
+// Input layout signature: position, normal, bones and weights (see LayoutSignature.hlsli)
+#define HAS_BONES
+#include "LayoutSignature.hlsli"
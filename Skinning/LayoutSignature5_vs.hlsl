@@ -0,0 +1,4 @@
+// Input layout signature: position, normal, tangent, bones and weights (see LayoutSignature.hlsli)
+#define HAS_TANGENT
+#define HAS_BONES
+#include "LayoutSignature.hlsli"
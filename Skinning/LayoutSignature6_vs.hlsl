@@ -0,0 +1,4 @@
+// Input layout signature: position, normal, uv, bones and weights (see LayoutSignature.hlsli)
+#define HAS_UV
+#define HAS_BONES
+#include "LayoutSignature.hlsli"
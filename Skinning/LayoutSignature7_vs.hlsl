@@ -0,0 +1,5 @@
+// Input layout signature: position, normal, tangent, uv, bones and weights (see LayoutSignature.hlsli)
+#define HAS_TANGENT
+#define HAS_UV
+#define HAS_BONES
+#include "LayoutSignature.hlsli"
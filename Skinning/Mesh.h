@@ -3,19 +3,23 @@
 //--------------------------------------------------------------------------------------
 // The mesh class splits the mesh into sub-meshes that only use one texture each.
 // The class also doesn't load textures, filters or shaders as the outer code is
-// expected to select these things
+// expected to select these things. Implements the engine core's IMesh interface so Model can use it
 
 #include "common.h"
+#include "IMesh.h"
+#include "MeshData.h"
+#include "MeshClusters.h"
+#include "MeshNodes.h"
+#include "GeometryArena.h"
 
-#include <assimp/scene.h>
-
+#include <algorithm>
 #include <string>
 #include <vector>
 
 #ifndef _MESH_H_INCLUDED_
 #define _MESH_H_INCLUDED_
 
-class Mesh
+class Mesh : public IMesh
 {
 //--------------------------------------------------------------------------------------
 // Construction / Usage
@@ -24,23 +28,57 @@ public:
 
     // Pass the name of the mesh file to load. Uses assimp (http://www.assimp.org/) to support many file types
     // Optionally request tangents to be calculated (for normal and parallax mapping - see later lab)
+    // The imported mesh is saved to the mesh cache (see MeshCache.h) and later loads of the same file with the same
+    // settings use the cooked mesh instead, skipping assimp entirely.
+    // Vertices can be stored in compact formats to save memory and bandwidth, pass any of the VERTEX_COMPACT_...
+    // flags from VertexPacking.h. The vertex shaders decode them using the per-model constants set in Render
+    // Simplified levels of detail can be generated for distant models (up to MAX_MESH_LODS, see MeshSimplify.h)
     // Will throw a std::runtime_error exception on failure (since constructors can't return errors).
-    Mesh(const std::string& fileName, bool requireTangents = false);
-    ~Mesh();
+    Mesh(const std::string& fileName, bool requireTangents = false, uint32_t compactVertices = 0, uint32_t numLODs = 0);
+    ~Mesh() override;
 
 
     // How many nodes are in the hierarchy for this mesh. Nodes can control individual parts (rigid body animation),
 	// or bones (skinned animation), or they can be dummy nodes to create child parts in a more convenient way
-    unsigned int NumberNodes()  { return static_cast<unsigned int>(mNodes.size()); }
+    unsigned int NumberNodes() override  { return static_cast<unsigned int>(mNodes.size()); }
 
     // The default matrix for a given node - used to set the initial position for a new model
-    CMatrix4x4 GetNodeDefaultMatrix(unsigned int node) { return mNodes[node].defaultMatrix; }
+    CAffine3x4 GetNodeDefaultMatrix(unsigned int node) override  { return mNodes[node].defaultMatrix; }
+
+    // The parent of a given node. The root node (0) is its own parent
+    unsigned int GetNodeParent(unsigned int node) override  { return mNodes[node].parentIndex; }
+
+    // The index of the node with the given name, or NO_NODE if there is none. Uses a hash table built when the
+    // mesh is loaded so it is fast even for large rigs. If several nodes have the same name the first is returned
+    unsigned int FindNode(const std::string& name)  { return ::FindNode(mNodeNames, name); }
+
+
+    // Bounding volumes calculated at import (see MeshBounds.h). Node bounds are in the node's own space, sub-mesh
+    // bounds in the space their vertices are in (the node holding them for rigid meshes, the mesh root for skinned)
+    const CBounds& GetNodeBounds(unsigned int node) override  { return mNodes[node].bounds; }
+    const CBounds& GetSubMeshBounds(unsigned int subMesh)     { return mSubMeshes[subMesh].bounds; }
+    unsigned int NumberSubMeshes()  { return static_cast<unsigned int>(mSubMeshes.size()); }
+
+    // Bounds of the whole mesh in its default pose, i.e. for a model using the default matrices of every node
+    const CBounds& GetBounds()  { return mBounds; }
+
+
+    // Levels of detail. LOD 0 is full detail, LODs 1 to NumberLODs() are simplified (see IMesh.h)
+    unsigned int NumberLODs() override  { return static_cast<unsigned int>(mLODErrors.size() - 1); }
+    float GetLODError(unsigned int lod) override  { return mLODErrors[std::min(lod, NumberLODs())]; }
+    unsigned int NumberTriangles(unsigned int lod) override  { return mLODTriangles[std::min(lod, NumberLODs())]; }
+
+
+    // Rigid meshes drawn at full detail are culled cluster by cluster (see MeshClusters.h) against the camera in the
+    // per-frame constants. Back-facing clusters are culled too, unless this is turned off for a mesh that is drawn
+    // without back-face culling (e.g. with blending). Skinned meshes are not culled as their vertices move
+    void SetBackfaceCulling(bool cullBackfaces)  { mBackfaceCulling = cullBackfaces; }
 
  
-	// Render the mesh with the given matrices
+	// Render the mesh with the given matrices and LOD
 	// Handles rigid body meshes (including single part meshes) as well as skinned meshes
 	// LIMITATION: The mesh must use a single texture throughout
-    void Render(std::vector<CMatrix4x4>& modelMatrices);
+    void Render(std::vector<CAffine3x4>& modelMatrices, unsigned int lod) override;
 
 
 
@@ -50,18 +88,13 @@ public:
 private:
 
     // A mesh is made of multiple sub-meshes. Each one uses a single material (texture).
-    // Each sub-mesh has a vertex / index buffer on the GPU. Could share buffers for performance but that would be complex.
+    // The vertices and indices are held in the GPU buffers shared by all meshes with the same vertex layout
+    // (see GeometryArena.h), so drawing sub-meshes one after another rarely needs any buffers changed
     struct SubMesh
     {
-        unsigned int       vertexSize = 0;         // Size in bytes of a single vertex (depends on what it contains, uvs, tangents etc.)
-        ID3D11InputLayout* vertexLayout = nullptr; // DirectX specification of data held in a single vertex
-
-        // GPU-side vertex and index buffers
-        unsigned int       numVertices = 0;
-        ID3D11Buffer*      vertexBuffer = nullptr;
-
-        unsigned int       numIndices = 0;
-        ID3D11Buffer*      indexBuffer  = nullptr;
+        GeometryArena::Handle    geometry;
+        CBounds                  bounds;
+        std::vector<MeshCluster> clusters; // For full detail culling, see MeshClusters.h
     };
 
 
@@ -69,19 +102,8 @@ private:
     // A node can contain several sub-meshes (because a single node might use multiple textures)
     // A node can also have child nodes. The children will follow the motion of the parent node
     // Each node has a default matrix which is it's initial/ default position. Models using this mesh are
-    // given these default matrices as a starting position.
-    struct Node
-    {
-        std::string  name;
-
-        CMatrix4x4   defaultMatrix; // Starting position/rotation/scale for this node. Relative to parent. Used when first creating a model from this mesh
-        CMatrix4x4   offsetMatrix;
-
-        unsigned int parentIndex;   // Index of the parent node (from the mNodes vector below). Root node refers to itself (0)
-
-        std::vector<unsigned int> childNodes; // Child nodes that are controlled by this node (indexes into the mNodes vector below)
-        std::vector<unsigned int> subMeshes;  // The geometry representing this node (indexes into the mSubMeshes vector below)
-    };
+    // given these default matrices as a starting position. Nodes are held in the device-independent NodeData
+    // structure (see MeshData.h) as they need no GPU resources.
 
 
 //--------------------------------------------------------------------------------------
@@ -89,14 +111,21 @@ private:
 //--------------------------------------------------------------------------------------
 private:
 
-    // Count the number of nodes with given assimp node as root
-    unsigned int CountNodes(aiNode* assimpNode);
+    // Add each sub-mesh in the mesh data to the shared GPU buffers
+    void CreateSubMeshes(const MeshData& mesh, const std::string& fileName);
+
+    // Remove all the sub-meshes from the shared GPU buffers together, so each buffer is only defragmented once
+    void RemoveSubMeshes();
 
-    // Help build the arrays of submeshes and nodes from the assimp data - recursive
-    unsigned int ReadNodes(aiNode* assimpNode,unsigned int nodeIndex, unsigned int parentIndex);
+    // Calculate mBounds from the node bounds and default matrices
+    void CalculateDefaultBounds();
 
 	// Helper function for Render function - renders a given sub-mesh. World matrices / textures / states etc. must already be set
-	void RenderSubMesh(const SubMesh& subMesh);
+	void RenderSubMesh(const SubMesh& subMesh, unsigned int lod);
+
+    // Render the visible clusters of a sub-mesh at full detail, culled with the given world matrix and the camera in
+    // the per-frame constants. Other settings as for RenderSubMesh
+    void RenderSubMeshClusters(const SubMesh& subMesh, const CMatrix4x4& worldMatrix, const CVector3& modelCameraPosition);
 
 
 
@@ -106,11 +135,32 @@ private:
 private:
 
     std::vector<SubMesh> mSubMeshes; // The mesh geometry. Nodes refer to sub-meshes in this vector
-    std::vector<Node>    mNodes;     // The mesh hierarchy. First entry is root. remainder aree stored in depth-first order
+    std::vector<NodeData> mNodes;    // The mesh hierarchy. First entry is root. remainder aree stored in depth-first order
+    NodeNameIndex mNodeNames;        // Node index for each name, see FindNode
+
+    CBounds mBounds; // Whole mesh in its default pose
+
+    // For each LOD, including the full detail LOD 0: the largest error over all sub-meshes and the total triangles
+    std::vector<float>        mLODErrors;
+    std::vector<unsigned int> mLODTriangles;
 
 	bool mHasBones; // If any submesh has bones, then all submeshes are given bones - makes rendering easier (one shader for the whole mesh)
+
+    // Decoding of compact vertices, sent to the shaders in the per-model constants
+    CVector3 mPositionScale;
+    CVector3 mPositionBias;
+    bool     mCompactNormals;
+
+    bool mBackfaceCulling = true;           // Cull back-facing clusters, see SetBackfaceCulling
+    std::vector<IndexRange> mVisibleRanges; // Clusters to draw, reused for each sub-mesh to avoid allocations
 };
 
 
+// Cluster culling counts for all meshes, accumulated from when they were last reset. Reset each frame to get
+// per-frame figures
+ClusterCullStats GetClusterCullStats();
+void ResetClusterCullStats();
+
+
 #endif //_MESH_H_INCLUDED_
 
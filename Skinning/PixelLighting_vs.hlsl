@@ -19,7 +19,7 @@ LightingPixelShaderInput main(BasicVertex modelVertex)
     LightingPixelShaderInput output; // This is the data the pixel shader requires from this vertex shader
 
     // Input position is x,y,z only - need a 4th element to multiply by a 4x4 matrix. Use 1 for a point (0 for a vector) - recall lectures
-    float4 modelPosition = float4(modelVertex.position, 1); 
+    float4 modelPosition = float4(DecodePosition(modelVertex.position), 1); // Decoding does nothing unless the mesh has compact vertices
 
     // Multiply by the world matrix passed from C++ to transform the model vertex position into world space. 
     // In a similar way use the view matrix to transform the vertex from world space into view space (camera's point of view)
@@ -28,11 +28,11 @@ LightingPixelShaderInput main(BasicVertex modelVertex)
     float4 viewPosition      = mul(gViewMatrix,       worldPosition);
     output.projectedPosition = mul(gProjectionMatrix, viewPosition);
 
-    // Also transform model normals into world space using world matrix - lighting will be calculated in world space
+    // Also transform model normals into world space - lighting will be calculated in world space
     // Pass this normal to the pixel shader as it is needed to calculate per-pixel lighting
-    float4 modelNormal = float4(modelVertex.normal, 0);      // For normals add a 0 in the 4th element to indicate it is a vector
-    output.worldNormal = mul(gWorldMatrix, modelNormal).xyz; // Only needed the 4th element to do this multiplication by 4x4 matrix...
-                                                             //... it is not needed for lighting so discard afterwards with the .xyz
+    // The normal matrix (calculated once per model on the CPU) keeps normals correct if the world matrix has non-uniform scaling
+    float4 modelNormal = float4(DecodeNormal(modelVertex.normal), 0);  // For normals add a 0 in the 4th element to indicate it is a vector
+    output.worldNormal = mul(gNormalMatrix, modelNormal); // 3x4 matrix gives a float3 result
     output.worldPosition = worldPosition.xyz; // Also pass world position to pixel shader for lighting
 
     // Pass texture coordinates (UVs) on to the pixel shader, the vertex shader doesn't need them
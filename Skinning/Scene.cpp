@@ -5,23 +5,27 @@
 
 #include "Scene.h"
 #include "Mesh.h"
+#include "GeometryArena.h"
 #include "Model.h"
 #include "Camera.h"
 #include "State.h"
 #include "Shader.h"
 #include "Input.h"
 #include "Common.h"
+#include "VertexPacking.h"
 
 #include "CVector2.h" 
 #include "CVector3.h" 
 #include "CMatrix4x4.h"
 #include "MathHelpers.h"     // Helper functions for maths
+#include "MathTrig.h"        // Sin/cos functions
 #include "GraphicsHelpers.h" // Helper functions to unclutter the code here
 
 #include "ColourRGBA.h" 
 
 #include <sstream>
 #include <memory>
+#include <cmath>
 
 
 //--------------------------------------------------------------------------------------
@@ -34,6 +38,14 @@
 const float ROTATION_SPEED = 2.0f;  // 2 radians per second for rotation
 const float MOVEMENT_SPEED = 50.0f; // 50 units per second for movement (what a unit of length is depends on 3D model - i.e. an artist decision usually)
 
+// Vertex elements stored in compact formats to save GPU memory and bandwidth (see VertexPacking.h). Set to 0 for full float vertices
+const uint32_t COMPACT_VERTICES = VERTEX_COMPACT_ALL;
+
+// Simplified levels of detail generated for the character and crate (see MeshSimplify.h), and the largest error in
+// pixels allowed when models choose which to draw (see Model::SelectLOD)
+const uint32_t MESH_LODS = 4;
+const float    MAX_LOD_PIXEL_ERROR = 1.0f;
+
 
 // Meshes, models and cameras, same meaning as TL-Engine. Meshes prepared in InitGeometry function, Models & camera in InitScene
 Mesh* gCharacterMesh;
@@ -117,10 +129,11 @@ bool InitGeometry()
     // Load mesh geometry data, just like TL-Engine this doesn't create anything in the scene. Create a Model for that.
     try 
     {
-        gCharacterMesh = new Mesh("Man.x");
-        gCrateMesh     = new Mesh("CargoContainer.x");
-        gGroundMesh    = new Mesh("Hills.x");
-        gLightMesh     = new Mesh("Light.x");
+        gCharacterMesh = new Mesh("Man.x", false, COMPACT_VERTICES, MESH_LODS);
+        gCrateMesh     = new Mesh("CargoContainer.x", false, COMPACT_VERTICES, MESH_LODS);
+        gGroundMesh    = new Mesh("Hills.x", false, COMPACT_VERTICES);
+        gLightMesh     = new Mesh("Light.x", false, COMPACT_VERTICES);
+        gLightMesh->SetBackfaceCulling(false); // Lights are drawn with no culling, see RenderSceneFromCamera
     }
     catch (std::runtime_error e)  // Constructors cannot return error messages so use exceptions to catch mesh errors (fairly standard approach this)
     {
@@ -256,6 +269,8 @@ void ReleaseResources()
     delete gGroundMesh;     gGroundMesh    = nullptr;
     delete gCrateMesh;      gCrateMesh     = nullptr;
     delete gCharacterMesh;  gCharacterMesh = nullptr;
+
+    gGeometryArena.Release(); // After the meshes, which remove their geometry from it
 }
 
 
@@ -373,7 +388,8 @@ void RenderScene()
     vp.TopLeftY = 0;
     gD3DContext->RSSetViewports(1, &vp);
 
-    // Render the scene from the main camera
+    // Render the scene from the main camera. Nothing else sets vertex / index buffers so the geometry arena's
+    // record of what is bound stays valid from frame to frame
     RenderSceneFromCamera(gCamera);
 
 
@@ -392,18 +408,31 @@ void RenderScene()
 void UpdateScene(float frameTime)
 {
 	// Control character part. First parameter is node number - index from flattened depth-first array of model parts. 0 is root
-	gCharacter->Control(17, frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma );
+	gCharacter->Control(17, frameTime, Key_I, Key_K, Key_J, Key_L, Key_U, Key_O, Key_Period, Key_Comma, ROTATION_SPEED, MOVEMENT_SPEED );
 
     // Orbit the light - a bit of a cheat with the static variable [ask the tutor if you want to know what this is]
 	static float rotate = 0.0f;
     static bool go = true;
-	gLights[0].model->SetPosition( gCharacter->Position() + CVector3{ cos(rotate) * gLightOrbit, 10, sin(rotate) * gLightOrbit } );
+    float sinRotate, cosRotate;
+    SinCos(rotate, sinRotate, cosRotate);
+	gLights[0].model->SetPosition( gCharacter->Position() + CVector3{ cosRotate * gLightOrbit, 10, sinRotate * gLightOrbit } );
     if (go)  rotate -= gLightOrbitSpeed * frameTime;
+    if (rotate < -2.0f * PI)  rotate += 2.0f * PI; // Keep the angle small to keep the sin/cos accurate
     if (KeyHit(Key_1))  go = !go;
 
 	// Control camera (will update its view matrix)
 	gCamera->Control(frameTime, Key_Up, Key_Down, Key_Left, Key_Right, Key_W, Key_S, Key_A, Key_D );
 
+    // Choose levels of detail from each model's size on screen. The LOD counters cover one frame: the LOD changes made
+    // here and the triangles drawn by the render that follows, they are read for the window title before resetting
+    LODCounters lodCounters = GetLODCounters();
+    ResetLODCounters();
+    ClusterCullStats clusterStats = GetClusterCullStats(); // Likewise for the clusters culled by the last render
+    ResetClusterCullStats();
+    float pixelsPerUnit = gViewportWidth / (2 * std::tan(gCamera->FOV() * 0.5f));
+    gCharacter->SelectLOD(gCamera->Position(), pixelsPerUnit, MAX_LOD_PIXEL_ERROR);
+    gCrate    ->SelectLOD(gCamera->Position(), pixelsPerUnit, MAX_LOD_PIXEL_ERROR);
+
 
     // Show frame time / FPS in the window title //
     const float fpsUpdateTime = 0.5f; // How long between updates (in seconds)
@@ -418,8 +447,20 @@ void UpdateScene(float frameTime)
         std::ostringstream frameTimeMs;
         frameTimeMs.precision(2);
         frameTimeMs << std::fixed << avgFrameTime * 1000;
+        // Also show the shared geometry buffer memory and how many input assembler calls sharing them has saved,
+        // and the triangles drawn and saved by levels of detail and cluster culling in the last frame
+        auto geometryStats = gGeometryArena.GetStats();
         std::string windowTitle = "CO2409 Week 22: Skinning - Frame Time: " + frameTimeMs.str() +
-                                  "ms, FPS: " + std::to_string(static_cast<int>(1 / avgFrameTime + 0.5f));
+                                  "ms, FPS: " + std::to_string(static_cast<int>(1 / avgFrameTime + 0.5f)) +
+                                  ", Geometry: " + std::to_string(geometryStats.bytesUsed / 1024) + "KB used (" +
+                                  std::to_string(geometryStats.indexBytesSaved / 1024) + "KB saved by 16-bit indices), " +
+                                  std::to_string(geometryStats.bytesWasted / 1024) + "KB free, " +
+                                  std::to_string(geometryStats.bindCallsAvoided) + "/" +
+                                  std::to_string(geometryStats.bindCalls + geometryStats.bindCallsAvoided) + " binds avoided" +
+                                  ", Triangles: " + std::to_string(lodCounters.trianglesDrawn) + " drawn, " +
+                                  std::to_string(lodCounters.trianglesSaved) + " saved by LODs, " +
+                                  std::to_string(clusterStats.frustumCulled + clusterStats.backfaceCulled) + "/" +
+                                  std::to_string(clusterStats.numClusters) + " clusters culled";
         SetWindowTextA(gHWnd, windowTitle.c_str());
         totalFrameTime = 0;
         frameCount = 0;
@@ -4,6 +4,7 @@
 //--------------------------------------------------------------------------------------
 
 #include "Shader.h"
+#include "InputLayoutCache.h"
 #include <fstream>
 #include <vector>
 #include <d3dcompiler.h>
@@ -46,12 +47,17 @@ bool LoadShaders()
         return false;
     }
 
+    // Signatures for creating input layouts (see InputLayoutCache.h). Not an error if they are missing, layouts
+    // will just compile their signatures when meshes are loaded
+    LoadLayoutSignatures();
+
     return true;
 }
 
 
 void ReleaseShaders()
 {
+    ReleaseInputLayouts();
     if (gLightModelPixelShader)       gLightModelPixelShader->Release();
     if (gSkinningVertexShader)        gSkinningVertexShader->Release();
     if (gBasicTransformVertexShader)  gBasicTransformVertexShader->Release();
@@ -145,6 +151,10 @@ ID3DBlob* CreateSignatureForVertexLayout(const D3D11_INPUT_ELEMENT_DESC vertexLa
         else if (format == DXGI_FORMAT_R32G32_FLOAT)       shaderSource += "float2";
         else if (format == DXGI_FORMAT_R32_FLOAT)          shaderSource += "float";
         else if (format == DXGI_FORMAT_R8G8B8A8_UINT)      shaderSource += "uint4";
+        else if (format == DXGI_FORMAT_R16G16B16A16_UNORM) shaderSource += "float4";
+        else if (format == DXGI_FORMAT_R16G16_SNORM)       shaderSource += "float2";
+        else if (format == DXGI_FORMAT_R16G16_FLOAT)       shaderSource += "float2";
+        else if (format == DXGI_FORMAT_R8G8B8A8_UNORM)     shaderSource += "float4";
         else return nullptr; // Unsupported type in layout
 
         uint8_t index = static_cast<uint8_t>(vertexLayout[elt].SemanticIndex);
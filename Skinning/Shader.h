@@ -51,7 +51,7 @@ ID3D11Buffer* CreateConstantBuffer(int size);
 ID3D11VertexShader* LoadVertexShader(std::string shaderName);
 ID3D11PixelShader*  LoadPixelShader (std::string shaderName);
 
-// Helper function. Returns nullptr on failure.
+// Helper function. Returns nullptr on failure. Only needed for layouts without a precompiled signature (see InputLayoutCache.h)
 ID3DBlob* CreateSignatureForVertexLayout(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements);
 
 
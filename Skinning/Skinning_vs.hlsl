@@ -18,12 +18,12 @@ LightingPixelShaderInput main(SkinningVertex modelVertex)
 {
     LightingPixelShaderInput output; // This is the data the pixel shader requires from this vertex shader
 
-    // Add 4th element to vertex position and normal (1 for positions, 0 for vectors)
-    float4 modelPosition = float4(modelVertex.position, 1); 
-    float4 modelNormal   = float4(modelVertex.normal,   0);
+    // Add 4th element to vertex position and normal (1 for positions, 0 for vectors). Decoding does nothing unless the mesh has compact vertices
+    float4 modelPosition = float4(DecodePosition(modelVertex.position), 1); 
+    float4 modelNormal   = float4(DecodeNormal(modelVertex.normal),     0);
 
     float4 worldPosition;
-	worldPosition  = mul( gBoneMatrices[modelVertex.bones[0]], modelPosition ) * modelVertex.weights[0];
+	worldPosition  = BoneTransform( modelVertex.bones[0], modelPosition ) * modelVertex.weights[0];
                      //*** MISSING - The above line multiplies the vertex position by the first bone's matrix, using the weight of the first bone
 	                 //***           Now you need to do the same for each bone, adding all the results together to get a weighted average for this vertex (as discussed in lecture)
 	
@@ -44,13 +44,14 @@ ID3D11RasterizerState* gTwoSided; // This is used to make sure both sides of a t
 // Geometry definitions and data
 //--------------------------------------------------------------------------------------
 
-// The content of a single vertex in the geometry to render. Currently just stores the position of the vertex (x,y,z). 
-// However, we can store other information for each vertex (for example, a colour for the vertex) so we use a structure.
-struct SimpleVertex
-{
-    CVector3 position; 
-	ColourRGBA colour;
-};
+// The content of a single vertex in the geometry to render. Currently just stores the position of the vertex (x,y,z) and a colour.
+// Each attribute of a vertex is listed with the name the vertex shader knows it by, the data format the GPU reads and the C++
+// type holding it. The compiler generates the SimpleVertex structure from this list
+using SimpleVertexLayout = VertexLayout<
+    VertexAttribute<VertexSemantic::Position, VertexFormat::Float3, CVector3>,
+    VertexAttribute<VertexSemantic::Colour,   VertexFormat::Float4, ColourRGBA>
+>;
+using SimpleVertex = SimpleVertexLayout::Vertex;
 
 
 //****
@@ -59,22 +60,16 @@ struct SimpleVertex
 
 // This describes the contents of the SimpleVertex structure above so DirectX will know what to expect when reading vertex data.
 //
-// There is one row in the layout array below for each data element in our SimpleVertex structure. So the first row below describes
-// the fact that each vertex has a "Position" which is made of three 32-bit floats, that is offset 0 bytes from the start of the
-// vertex structure. Note that in this array the floats are referred to as RGB colours even though they will hold x,y,z values.
-// The "slot", and other values in the array below can be ignored in most cases.
+// There is one row in the layout array for each attribute in the list above. So the first row describes the fact that each vertex
+// has a "Position" which is made of three 32-bit floats, that is offset 0 bytes from the start of the vertex structure. Note that
+// in this array the floats are referred to as RGB colours even though they will hold x,y,z values.
 //
-// This should also match the vertex shader input structure (see Shaders\transform3Dto2D_vs.hlsl). So, in total there are three
-// structures maintained to keep C++ code and shader working correctly together. Watch out for this detail when working on advanced
-// code in the future.
+// The array is generated from the same list as the vertex structure (see InputElementDescs in Shader.h), so they can't get out of
+// step. It should also match the vertex shader input structure (see Shaders\transform3Dto2D_vs.hlsl), watch out for this detail
+// when working on advanced code in the future.
 //
-D3D11_INPUT_ELEMENT_DESC gSimpleVertexDesc[] =
-{
-    // Data Type,  Type Index,  Data format                      Slot  Offset    Other values can be ignored for now 
-    { "Position",  0,           DXGI_FORMAT_R32G32B32_FLOAT,     0,    0,        D3D11_INPUT_PER_VERTEX_DATA, 0 },
-    { "Colour",    0,           DXGI_FORMAT_R32G32B32A32_FLOAT,  0,    12,       D3D11_INPUT_PER_VERTEX_DATA,  0 },
-};
-int gSimpleVertexDescCount = sizeof(gSimpleVertexDesc) / sizeof(gSimpleVertexDesc[0]); // This gives a count of rows in the array above
+constexpr auto gSimpleVertexDesc = InputElementDescs<SimpleVertexLayout>();
+constexpr int gSimpleVertexDescCount = static_cast<int>(gSimpleVertexDesc.size()); // This gives a count of rows in the array above
 
 
 //****
@@ -83,7 +78,8 @@ int gSimpleVertexDescCount = sizeof(gSimpleVertexDesc) / sizeof(gSimpleVertexDes
 
 // A CPU-side array of vertices for the geometry we wish to render. Each vertex is the SimpleVertex structure above.
 // Each triplet of vertices defines a single triangle in 3D. This is the 12 triangles of a cube.
-SimpleVertex gCubeVertices[] =
+// constexpr so the table is built by the compiler and placed in read-only data rather than filled in at startup
+constexpr SimpleVertex gCubeVertices[] =
 {
 	CVector3{ -1.0f, -1.0f, -1.0f }, ColourRGBA{ 0.0, 0.0, 0.0, 1.0 },
 	CVector3{ -1.0f,  1.0f, -1.0f }, ColourRGBA{ 1.0, 1.0, 1.0, 1.0 },
@@ -145,7 +141,8 @@ SimpleVertex gCubeVertices[] =
 	CVector3{ 1.0f,  1.0f,  1.0f }, ColourRGBA{ 0.5, 0.0, 1.0, 1.0 },
 
 };
-int gCubeNumVertices = sizeof(gCubeVertices) / sizeof(gCubeVertices[0]); // Total number of vertices in the array above
+constexpr int gCubeNumVertices = sizeof(gCubeVertices) / sizeof(gCubeVertices[0]); // Total number of vertices in the array above
+static_assert(gCubeNumVertices == 36, "Cube should be 12 triangles");
 
 //****
 
@@ -179,8 +176,8 @@ bool InitGeometry()
 
 
     // These lines convert the vertex layout described above into an object (gSimpleVertexLayout) used when rendering
-    auto shaderSignature = CreateSignatureForVertexLayout(gSimpleVertexDesc, gSimpleVertexDescCount);
-    hr = gD3DDevice->CreateInputLayout(gSimpleVertexDesc, gSimpleVertexDescCount,
+    auto shaderSignature = CreateSignatureForVertexLayout(gSimpleVertexDesc.data(), gSimpleVertexDescCount);
+    hr = gD3DDevice->CreateInputLayout(gSimpleVertexDesc.data(), gSimpleVertexDescCount,
                                        shaderSignature->GetBufferPointer(), shaderSignature->GetBufferSize(), &gSimpleVertexLayout);
     if (shaderSignature)  shaderSignature->Release();
     if (FAILED(hr))
@@ -293,7 +290,7 @@ void RenderScene()
 
 
     // 4) Draw 3 vertices, starting at vertex 0. This will draw a triangle using the vertex data and shaders selected
-    gD3DContext->Draw(36, 0);
+    gD3DContext->Draw(gCubeNumVertices, 0);
 
 
 
@@ -5,8 +5,12 @@
 #ifndef _SHADER_H_INCLUDED_
 #define _SHADER_H_INCLUDED_
 
+#include "VertexLayout.h"
+
 #include <d3d11.h>
+#include <array>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -23,4 +27,56 @@ ID3D11PixelShader*  LoadPixelShader (std::string shaderName);
 ID3DBlob* CreateSignatureForVertexLayout(const D3D11_INPUT_ELEMENT_DESC vertexLayout[], int numElements);
 
 
+// HLSL semantic name and DXGI format of the device-independent vertex elements (see VertexElement.h)
+constexpr const char* VertexSemanticName(VertexSemantic semantic)
+{
+    switch (semantic)
+    {
+        case VertexSemantic::Position: return "Position";
+        case VertexSemantic::Normal:   return "Normal";
+        case VertexSemantic::Tangent:  return "Tangent";
+        case VertexSemantic::UV:       return "UV";
+        case VertexSemantic::Bones:    return "Bones";
+        case VertexSemantic::Weights:  return "Weights";
+        case VertexSemantic::Colour:   return "Colour";
+    }
+    return "";
+}
+
+constexpr DXGI_FORMAT VertexDXGIFormat(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::Float2:      return DXGI_FORMAT_R32G32_FLOAT;
+        case VertexFormat::Float3:      return DXGI_FORMAT_R32G32B32_FLOAT;
+        case VertexFormat::Float4:      return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        case VertexFormat::UByte4:      return DXGI_FORMAT_R8G8B8A8_UINT;
+        case VertexFormat::UShort4Norm: return DXGI_FORMAT_R16G16B16A16_UNORM;
+        case VertexFormat::Short2Norm:  return DXGI_FORMAT_R16G16_SNORM;
+        case VertexFormat::Half2:       return DXGI_FORMAT_R16G16_FLOAT;
+        case VertexFormat::UByte4Norm:  return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+    return DXGI_FORMAT_UNKNOWN;
+}
+
+constexpr D3D11_INPUT_ELEMENT_DESC InputElementDesc(const VertexElement& element)
+{
+    return { VertexSemanticName(element.semantic), 0, VertexDXGIFormat(element.format), 0, element.offset, D3D11_INPUT_PER_VERTEX_DATA, 0 };
+}
+
+// The DirectX description of a vertex layout declared with VertexLayout.h, generated by the compiler so it always
+// matches the vertex structure
+template <class Layout, size_t... I>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, Layout::NumElements> InputElementDescs(std::index_sequence<I...>)
+{
+    return {{ InputElementDesc(Layout::Elements[I])... }};
+}
+
+template <class Layout>
+constexpr std::array<D3D11_INPUT_ELEMENT_DESC, Layout::NumElements> InputElementDescs()
+{
+    return InputElementDescs<Layout>(std::make_index_sequence<Layout::NumElements>());
+}
+
+
 #endif //_SHADER_H_INCLUDED_
@@ -145,8 +145,10 @@ CMatrix4x4 operator*( const CMatrix4x4& m1, const CMatrix4x4& m2 )
 // They can be used as temporaries in calculations, e.g.
 //     CMatrix4x4 m = MatrixScaling( 3.0f ) * MatrixTranslation( CVector3(10.0f, -10.0f, 20.0f) );
 
+// Identity, translation and scaling are constexpr so constant matrices can be built at compile time
+
 // Return an identity matrix
-CMatrix4x4 MatrixIdentity()
+constexpr CMatrix4x4 MatrixIdentity()
 {
     return CMatrix4x4{ 1, 0, 0, 0,
                        0, 1, 0, 0,
@@ -155,7 +157,7 @@ CMatrix4x4 MatrixIdentity()
 }
 
 // Return a translation matrix of the given vector
-CMatrix4x4 MatrixTranslation(const CVector3& t)
+constexpr CMatrix4x4 MatrixTranslation(const CVector3& t)
 {
     return CMatrix4x4{  1,   0,   0,  0,
                         0,   1,   0,  0,
@@ -202,16 +204,16 @@ CMatrix4x4 MatrixRotationZ(float z)
 
 
 // Return a matrix that is a scaling in X,Y and Z of the values in the given vector
-CMatrix4x4 MatrixScaling(const CVector3& s)
+constexpr CMatrix4x4 MatrixScaling(const CVector3& s)
 {
     return CMatrix4x4{ s.x,   0,   0,  0,
                          0, s.y,   0,  0,
-                         0,   0, s.x,  0,
+                         0,   0, s.z,  0,
                          0,   0,   0,  1 };
 }
 
 // Return a matrix that is a uniform scaling of the given amount
-CMatrix4x4 MatrixScaling(const float s)
+constexpr CMatrix4x4 MatrixScaling(const float s)
 {
     return CMatrix4x4{ s, 0, 0, 0,
                        0, s, 0, 0,
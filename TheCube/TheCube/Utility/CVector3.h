@@ -22,12 +22,8 @@ public:
 	CVector3() {}
 
 	// Construct by value
-	CVector3( const float xIn, const float yIn, const float zIn)
-	{
-		x = xIn;
-		y = yIn;
-		z = zIn;
-	}
+	constexpr CVector3( const float xIn, const float yIn, const float zIn)
+		: x(xIn), y(yIn), z(zIn) {}
 	
 	// Set the vector through a pointer to three floats
     void Set( const float* pfElts )
@@ -38,26 +34,26 @@ public:
 	}
 
 	// Dot product of this with another vector
-    float Dot( const CVector3& v ) const
+    constexpr float Dot( const CVector3& v ) const
 	{
 	    return x*v.x + y*v.y + z*v.z;
 	}
 };
 	
 // Subtracting of two given vectors (order is important - non-member version)
-inline CVector3 Subtract( const CVector3& v,  const CVector3& w  )
+constexpr CVector3 Subtract( const CVector3& v,  const CVector3& w  )
 {
     return CVector3( v.x - w.x, v.y - w.y, v.z - w.z );
 }
 
 // Dot product of two given vectors (order not important) - non-member version
-inline float Dot( const CVector3& v1, const CVector3& v2 )
+constexpr float Dot( const CVector3& v1, const CVector3& v2 )
 {
     return v1.x*v2.x + v1.y*v2.y + v1.z*v2.z;
 }
 
 // Cross product of two given vectors (order is important) - non-member version
-inline CVector3 Cross( const CVector3& v1, const CVector3& v2 )
+constexpr CVector3 Cross( const CVector3& v1, const CVector3& v2 )
 {
 	return CVector3(v1.y*v2.z - v1.z*v2.y, v1.z*v2.x - v1.x*v2.z, v1.x*v2.y - v1.y*v2.x);
 }
@@ -95,8 +91,8 @@ CVector3 Normalise( const CVector3& v )
 	}
 }
 
-const CVector3 kXAxis(1.0f, 0.0f, 0.0f);
-const CVector3 kYAxis(0.0f, 1.0f, 0.0f);
-const CVector3 kZAxis(0.0f, 0.0f, 1.0f);
+constexpr CVector3 kXAxis(1.0f, 0.0f, 0.0f);
+constexpr CVector3 kYAxis(0.0f, 1.0f, 0.0f);
+constexpr CVector3 kZAxis(0.0f, 0.0f, 1.0f);
 
 #endif // _CVECTOR3_H_DEFINED_
@@ -21,13 +21,8 @@ public:
     ColourRGBA() {}
 
 	// Construct by value
-    ColourRGBA( const float rIn, const float gIn, const float bIn, const float aIn = 1.0f)
-	{
-		r = rIn;
-		g = gIn;
-		b = bIn;
-        a = aIn;
-    }
+    constexpr ColourRGBA( const float rIn, const float gIn, const float bIn, const float aIn = 1.0f)
+		: r(rIn), g(gIn), b(bIn), a(aIn) {}
 	
 	// Set the vector through a pointer to three floats
     void Set( const float* pfElts )